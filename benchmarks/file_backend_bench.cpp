@@ -0,0 +1,175 @@
+/**
+ * AudioCaptureX File Backend Benchmark
+ * Writes many concurrent WAV streams through each file backend and reports
+ * throughput and per-block write latency, after checking the files read back
+ */
+
+#include "include/wav_reader.hpp"
+#include "include/wav_writer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+const int kBlockFrames = 480; // 10 ms blocks, as delivered by a capture callback
+
+struct Result
+{
+    double seconds = 0.0;
+    std::vector<double> latencies;
+    bool ok = true;
+};
+
+void writeStream(const std::string &filename, FileBackendType type, int seconds, Result &result)
+{
+    std::vector<float> block(kBlockFrames * kChannelCount);
+    for (size_t i = 0; i < block.size(); ++i)
+    {
+        block[i] = static_cast<float>(i % 97) / 97.0f - 0.5f;
+    }
+
+    WavFormat format;
+    format.sampleFormat = WavSampleFormat::Float32;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavWriter writer;
+    if (!writer.open(filename, format, createFileBackend(type)))
+    {
+        result.ok = false;
+        return;
+    }
+
+    int blocks = seconds * kSampleRate / kBlockFrames;
+    result.latencies.reserve(blocks);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < blocks; ++i)
+    {
+        auto before = std::chrono::steady_clock::now();
+        result.ok = writer.writeFrames(block.data(), kBlockFrames) && result.ok;
+        result.latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - before).count());
+    }
+
+    result.ok = writer.finalize() && result.ok;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Reopen a finished stream and check that its header covers every frame written
+bool verifyStream(const std::string &filename, int seconds)
+{
+    uint64_t frames = static_cast<uint64_t>(seconds * kSampleRate / kBlockFrames) * kBlockFrames;
+
+    WavReader reader;
+    if (!reader.open(filename))
+    {
+        std::cerr << "Failed to reopen " << filename << std::endl;
+        return false;
+    }
+
+    uint64_t dataBytes = reader.getBytes(0, reader.getFrameCount()).size();
+    if (reader.getFrameCount() != frames || dataBytes != frames * kChannelCount * sizeof(float))
+    {
+        std::cerr << filename << ": wrote " << frames << " frames, header reports " << reader.getFrameCount()
+                  << " frames of " << dataBytes << " bytes" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool runBenchmark(const std::string &directory, FileBackendType type, int streams, int seconds)
+{
+    std::vector<Result> results(streams);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < streams; ++i)
+    {
+        std::string filename = directory + "/bench-" + fileBackendName(type) + "-" + std::to_string(i) + ".wav";
+        threads.emplace_back(writeStream, filename, type, seconds, std::ref(results[i]));
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> latencies;
+    bool ok = true;
+    for (const auto &result : results)
+    {
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        ok = ok && result.ok;
+    }
+
+    // Numbers for files that do not read back are meaningless
+    bool verified = true;
+    for (int i = 0; i < streams; ++i)
+    {
+        verified = verifyStream(directory + "/bench-" + fileBackendName(type) + "-" + std::to_string(i) + ".wav", seconds) &&
+                   verified;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) {
+        return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(p * (latencies.size() - 1))];
+    };
+
+    double megabytes = static_cast<double>(streams) * seconds * kSampleRate * kChannelCount * sizeof(float) / (1024.0 * 1024.0);
+
+    if (verified)
+    {
+        std::cout << std::left << std::setw(10) << fileBackendName(type) << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << megabytes / elapsed << " MB/s"
+                  << std::setw(10) << percentile(0.5) << " us p50"
+                  << std::setw(10) << percentile(0.99) << " us p99"
+                  << std::setw(12) << percentile(1.0) << " us max"
+                  << (ok ? "" : "  (write errors)") << std::endl;
+    }
+    else
+    {
+        std::cout << std::left << std::setw(10) << fileBackendName(type) << "  FAILED: files do not read back" << std::endl;
+    }
+
+    for (int i = 0; i < streams; ++i)
+    {
+        std::filesystem::remove(directory + "/bench-" + fileBackendName(type) + "-" + std::to_string(i) + ".wav");
+    }
+
+    return verified && ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string directory = argc > 1 ? argv[1] : ".";
+    int streams = argc > 2 ? std::stoi(argv[2]) : 32;
+    int seconds = argc > 3 ? std::stoi(argv[3]) : 60;
+
+    std::cout << "Writing " << streams << " streams of " << seconds << " s ("
+              << kChannelCount << " channels, " << kSampleRate << " Hz, float32) to " << directory << std::endl;
+
+    bool passed = true;
+    for (FileBackendType type : {FileBackendType::Stdio, FileBackendType::Pwrite, FileBackendType::IoUring, FileBackendType::Direct})
+    {
+        passed = runBenchmark(directory, type, streams, seconds) && passed;
+    }
+
+    return passed ? 0 : 1;
+}
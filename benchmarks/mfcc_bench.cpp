@@ -0,0 +1,108 @@
+/**
+ * AudioCaptureX MFCC Benchmark
+ * Reports the cost per frame of a few MFCC settings, see tests/mfcc_test.cpp
+ * for their accuracy
+ */
+
+#include "include/mfcc_extractor.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 16000;
+const int kChannelCount = 1;
+const size_t kBlockFrames = 160; // 10 ms blocks, as delivered by a capture callback
+const double kPi = 3.14159265358979323846;
+
+// Mono chirp over noise with a slow amplitude envelope, so every band changes over time
+std::vector<float> synthesize(double seconds)
+{
+    size_t frames = static_cast<size_t>(seconds * kSampleRate);
+    std::vector<float> samples(frames * kChannelCount);
+
+    std::mt19937 random(1);
+    std::normal_distribution<float> noise(0.0f, 0.02f);
+    double phase = 0.0;
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        double time = static_cast<double>(frame) / kSampleRate;
+        phase += 2.0 * kPi * (200.0 + 3000.0 * std::fmod(time, 1.0)) / kSampleRate;
+        float value = static_cast<float>(0.4 * (0.6 + 0.4 * std::sin(2.0 * kPi * 1.5 * time)) * std::sin(phase));
+
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            samples[frame * kChannelCount + channel] = value + noise(random);
+        }
+    }
+
+    return samples;
+}
+
+void runBenchmark(const std::string &name, const std::vector<float> &samples, const MfccSettings &settings)
+{
+    MelExtractor mel(kSampleRate, kChannelCount, settings.mel);
+    MfccExtractor extractor(kSampleRate, kChannelCount, settings);
+    FeatureRing melFrames(1024, mel.getBandCount());
+    FeatureRing features(1024, extractor.getFeatureCount());
+    size_t frames = samples.size() / kChannelCount;
+
+    // The log-mel analysis alone, for the share of the cepstra and deltas in the cost
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; frame += kBlockFrames)
+    {
+        mel.process(samples.data() + frame * kChannelCount, std::min(kBlockFrames, frames - frame), melFrames);
+    }
+    double melElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; frame += kBlockFrames)
+    {
+        extractor.process(samples.data() + frame * kChannelCount, std::min(kBlockFrames, frames - frame), features);
+    }
+    extractor.finish(features);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double outputFrames = static_cast<double>(std::max<uint64_t>(1, features.getFrameCount()));
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(8) << elapsed * 1e9 / outputFrames << " ns/frame (log-mel alone " << std::setw(5)
+              << melElapsed * 1e9 / outputFrames << ")" << std::setprecision(1) << std::setw(8)
+              << frames / static_cast<double>(kSampleRate) / elapsed << "x realtime" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    double seconds = argc > 1 ? std::stod(argv[1]) : 60.0;
+
+    MfccSettings speech;
+    speech.mel.bandCount = 40;
+
+    MfccSettings wide;
+    wide.mel.bandCount = 80;
+    wide.coefficientCount = 20;
+    wide.deltaWindow = 3;
+
+    MfccSettings plain = speech;
+    plain.deltas = false;
+    plain.lifter = 0.0f;
+
+    std::cout << "Extracting " << seconds << " s in " << kBlockFrames << " frame blocks" << std::endl;
+    std::vector<float> samples = synthesize(seconds);
+    runBenchmark("13 of 40 bands, deltas", samples, speech);
+    runBenchmark("20 of 80 bands, window 3", samples, wide);
+    runBenchmark("13 of 40 bands, plain", samples, plain);
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/**
+ * AudioCaptureX Onset Benchmark
+ * Runs an onset detector per stream on concurrent threads and reports the cost
+ * per frame, how far ahead of real time the streams run and the onsets found
+ */
+
+#include "include/onset_detector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+const size_t kBlockFrames = 480; // 10 ms blocks, as delivered by a capture callback
+const double kBurstInterval = 0.25;
+
+struct Result
+{
+    double seconds = 0.0;
+    size_t onsets = 0;
+};
+
+// Stereo background noise with a decaying noise burst every kBurstInterval seconds
+std::vector<float> synthesize(double seconds, unsigned seed)
+{
+    size_t frames = static_cast<size_t>(seconds * kSampleRate);
+    size_t interval = static_cast<size_t>(kBurstInterval * kSampleRate);
+    std::vector<float> samples(frames * kChannelCount);
+
+    std::mt19937 random(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        float envelope = 0.5f * std::exp(-static_cast<float>(frame % interval) / (0.03f * kSampleRate));
+        float value = (0.001f + envelope) * noise(random);
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            samples[frame * kChannelCount + channel] = value;
+        }
+    }
+
+    return samples;
+}
+
+void runStream(const std::vector<float> &samples, Result &result)
+{
+    OnsetDetector detector(kSampleRate, kChannelCount);
+    std::vector<OnsetEvent> onsets;
+    size_t frames = samples.size() / kChannelCount;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; frame += kBlockFrames)
+    {
+        size_t count = std::min(kBlockFrames, frames - frame);
+        detector.process(samples.data() + frame * kChannelCount, count, onsets);
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.onsets = onsets.size();
+}
+
+void runBenchmark(int streams, double seconds)
+{
+    // Each stream gets its own signal so the threads do not share cache lines of input
+    std::vector<std::vector<float>> signals;
+    for (int i = 0; i < streams; ++i)
+    {
+        signals.push_back(synthesize(seconds, static_cast<unsigned>(i + 1)));
+    }
+
+    std::vector<Result> results(streams);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < streams; ++i)
+    {
+        threads.emplace_back(runStream, std::cref(signals[i]), std::ref(results[i]));
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double slowest = 0.0;
+    size_t onsets = 0;
+    for (const auto &result : results)
+    {
+        slowest = std::max(slowest, result.seconds);
+        onsets += result.onsets;
+    }
+
+    // The burst the stream opens with is not an onset, there is nothing before it
+    size_t expected = static_cast<size_t>(streams) * (static_cast<size_t>(std::ceil(seconds / kBurstInterval)) - 1);
+    double nanoseconds = slowest * 1e9 / (seconds * kSampleRate);
+
+    std::cout << std::setw(4) << streams << " streams" << std::fixed << std::setprecision(1)
+              << std::setw(10) << nanoseconds << " ns/frame"
+              << std::setw(10) << seconds / slowest << "x realtime per stream"
+              << std::setw(10) << streams * seconds / elapsed << " stream-seconds/s"
+              << std::setw(8) << onsets << " of " << expected << " onsets" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    int maxStreams = argc > 1 ? std::stoi(argv[1]) : 32;
+    double seconds = argc > 2 ? std::stod(argv[2]) : 30.0;
+
+    std::cout << "Detecting onsets in " << seconds << " s streams (" << kChannelCount << " channels, " << kSampleRate
+              << " Hz) in " << kBlockFrames << " frame blocks on " << std::thread::hardware_concurrency() << " cores"
+              << std::endl;
+
+    for (int streams = 1; streams < maxStreams; streams *= 2)
+    {
+        runBenchmark(streams, seconds);
+    }
+
+    runBenchmark(maxStreams, seconds);
+
+    return 0;
+}
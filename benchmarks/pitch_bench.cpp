@@ -0,0 +1,139 @@
+/**
+ * AudioCaptureX Pitch Benchmark
+ * Tracks a synthetic harmonic glide with several pitch settings and reports
+ * the cost per frame and the accuracy of the estimates
+ *
+ * Cost is wall time per input frame of 48 kHz stereo fed in 480 frame blocks
+ * on one thread, so it varies with the machine; compare settings within a run.
+ */
+
+#include "include/pitch_detector.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+const size_t kBlockFrames = 480; // 10 ms blocks, as delivered by a capture callback
+const double kPi = 3.14159265358979323846;
+
+// Stereo harmonic tone gliding exponentially between two frequencies, with noise
+void synthesize(double seconds, double startFrequency, double endFrequency, std::vector<float> &samples,
+                std::vector<double> &frequencies)
+{
+    size_t frames = static_cast<size_t>(seconds * kSampleRate);
+    samples.resize(frames * kChannelCount);
+    frequencies.resize(frames);
+
+    std::mt19937 random(1);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    double phase = 0.0;
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        double frequency = startFrequency * std::pow(endFrequency / startFrequency, static_cast<double>(frame) / frames);
+        frequencies[frame] = frequency;
+        phase += 2.0 * kPi * frequency / kSampleRate;
+
+        float value = 0.0f;
+        for (int harmonic = 1; harmonic <= 5; ++harmonic)
+        {
+            value += static_cast<float>(0.3 / harmonic * std::sin(harmonic * phase));
+        }
+
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            samples[frame * kChannelCount + channel] = value + noise(random);
+        }
+    }
+}
+
+void runBenchmark(const std::string &name, const PitchSettings &settings, double seconds)
+{
+    std::vector<float> samples;
+    std::vector<double> frequencies;
+    synthesize(seconds, settings.minFrequency * 1.25, settings.maxFrequency * 0.8, samples, frequencies);
+
+    PitchDetector detector(kSampleRate, kChannelCount, settings);
+    std::vector<PitchEstimate> estimates;
+    size_t frames = frequencies.size();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frames; frame += kBlockFrames)
+    {
+        size_t count = std::min(kBlockFrames, frames - frame);
+        detector.process(samples.data() + frame * kChannelCount, count, estimates);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Error in cents against the frequency at the centre of each window
+    std::vector<double> errors;
+    size_t voiced = 0;
+    size_t gross = 0;
+    for (const PitchEstimate &estimate : estimates)
+    {
+        if (estimate.frequency <= 0.0f || estimate.framePosition >= frames)
+        {
+            continue;
+        }
+
+        double cents = std::abs(1200.0 * std::log2(estimate.frequency / frequencies[estimate.framePosition]));
+        errors.push_back(cents);
+        voiced++;
+        gross += cents > 50.0 ? 1 : 0;
+    }
+
+    std::sort(errors.begin(), errors.end());
+    double nanoseconds = elapsed * 1e9 / frames;
+
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(8) << nanoseconds << " ns/frame"
+              << std::setw(8) << seconds / elapsed << "x realtime"
+              << std::setw(8) << 100.0 * voiced / std::max<size_t>(1, estimates.size()) << "% voiced"
+              << std::setprecision(2)
+              << std::setw(8) << (errors.empty() ? 0.0 : errors[errors.size() / 2]) << " cents median"
+              << std::setw(6) << gross << " gross errors" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    double seconds = argc > 1 ? std::stod(argv[1]) : 30.0;
+
+    std::cout << "Tracking " << seconds << " s glides (" << kChannelCount << " channels, " << kSampleRate
+              << " Hz) in " << kBlockFrames << " frame blocks" << std::endl;
+
+    PitchSettings machinery;
+    machinery.minFrequency = 40.0f;
+    machinery.maxFrequency = 500.0f;
+
+    PitchSettings voice;
+    voice.minFrequency = 70.0f;
+    voice.maxFrequency = 800.0f;
+
+    PitchSettings coarse = voice;
+    coarse.hopSeconds = 0.02;
+
+    PitchSettings instrument;
+    instrument.minFrequency = 100.0f;
+    instrument.maxFrequency = 2000.0f;
+
+    runBenchmark("default 60-1000 Hz", PitchSettings(), seconds);
+    runBenchmark("machinery 40-500 Hz", machinery, seconds);
+    runBenchmark("voice 70-800 Hz", voice, seconds);
+    runBenchmark("voice, 20 ms hop", coarse, seconds);
+    runBenchmark("instrument 100-2000 Hz", instrument, seconds);
+
+    return 0;
+}
@@ -1,10 +1,17 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include "audio_stage.hpp"
+#include "level_stats.hpp"
+#include "recording_store.hpp"
+#include "ring_buffer.hpp"
+#include "sample_convert.hpp"
+#include "wav_file_sink.hpp"
 #include <cubeb/cubeb.h>
 #include <thread>
 #include <vector>
@@ -13,16 +20,94 @@ namespace AudioCaptureX
 {
 
 /**
- * @brief Callback function type for audio data
- * @param audioData Vector containing audio samples (interleaved)
- * @param frameCount Number of audio frames
- * @param sampleRate Sample rate in Hz
- * @param channelCount Number of audio channels
+ * @brief Cause of a gap in the captured audio
  */
-using AudioDataCallback = std::function<void(const std::vector<float> &audioData,
-                                             int frameCount,
-                                             int sampleRate,
-                                             int channelCount)>;
+enum class GapReason
+{
+    DeviceLost,    // The input device failed and the stream was reopened
+    Discontinuity, // The backend dropped frames or the stream stalled
+    StreamRestart, // The stream was recreated for another buffer size or to return to the selected device
+};
+
+/**
+ * @brief How gaps are filled in the recording
+ */
+enum class GapFill
+{
+    None,        // Only report gaps, the recording gets shorter than wall time
+    Silence,     // Insert silence for the missing frames
+    Interpolate, // Insert a linear ramp between the frames around short gaps, silence in long ones
+};
+
+/**
+ * @brief A stretch of time missing from the captured audio
+ */
+struct GapEvent
+{
+    GapReason reason = GapReason::DeviceLost;
+    uint64_t framePosition = 0; // Timeline frames before the gap (recording position when gaps are filled)
+    uint64_t frameCount = 0;    // Frames of audio missing at the stream sample rate
+};
+
+/**
+ * @brief Callback function type for gap notifications (called from a background thread)
+ * @param gap Description of the gap
+ */
+using GapCallback = std::function<void(const GapEvent &gap)>;
+
+/**
+ * @brief Lock-free copy of the captured audio for a consumer on another thread
+ *
+ * The capture callback writes whole interleaved frames into the ring and counts
+ * the frames that did not fit instead of blocking. AudioMixer reads its inputs
+ * through taps.
+ */
+struct CaptureTap
+{
+    /**
+     * @brief Constructor
+     * @param capacityFrames Minimum number of frames the ring can hold
+     * @param channelCount Channels per frame, frames from captures with another layout are dropped
+     */
+    CaptureTap(size_t capacityFrames, int channelCount)
+        : samples(capacityFrames * channelCount)
+        , channelCount(channelCount)
+    {
+    }
+
+    RingBuffer<float> samples;                  // Interleaved frames, written by the capture callback
+    const int channelCount;                     // Channels per frame
+    std::atomic<uint32_t> latencyFrames{0};     // Buffer size of the capture stream
+    std::atomic<uint64_t> droppedFrames{0};     // Frames lost because the ring was full or the layout differs
+};
+
+/**
+ * @brief Runtime statistics of a capture session
+ */
+struct CaptureStats
+{
+    uint64_t framesWritten = 0;          // Frames streamed to the output file
+    uint64_t bytesWritten = 0;           // Sample bytes streamed to the output file
+    uint64_t droppedFrames = 0;          // Frames dropped because the file sink or recording store could not keep up
+    double writeThroughput = 0.0;        // Sustained file sink write throughput in MB/s
+    uint64_t recordedFrames = 0;         // Frames held by the in-memory recording
+    uint64_t recordingRawBytes = 0;      // Size of the in-memory recording as float samples
+    uint64_t recordingResidentBytes = 0; // Memory used by the in-memory recording
+    uint64_t recordingSpilledBytes = 0;  // Bytes of the in-memory recording moved to disk
+    uint32_t latencyFrames = 0;          // Buffer size of the current stream
+    uint32_t lowestLatencyFrames = 0;    // Smallest buffer size used in the session
+    uint32_t highestLatencyFrames = 0;   // Largest buffer size used in the session
+    uint32_t latencyChanges = 0;         // Number of times adaptive latency resized the buffer
+    uint64_t xruns = 0;                  // Callbacks that arrived too late or ran too long
+    uint32_t failovers = 0;              // Times the stream was reopened after a device failure
+    double lastFailoverMs = 0.0;         // Time from the last device failure to resumed capture
+    double maxFailoverMs = 0.0;          // Longest time from a device failure to resumed capture
+    uint32_t gaps = 0;                   // Gaps detected in the captured audio
+    uint64_t gapFrames = 0;              // Frames missing because of gaps (lost frames)
+    uint64_t stageDroppedFrames = 0;     // Frames the processing stages could not keep up with
+    uint64_t clippedSamples = 0;         // Captured samples at or above the clip level, all channels
+    std::vector<ChannelLevelStats> channelLevels; // Clip counters and level histogram per channel
+};
 
 /**
  * @brief Audio capture class for cross-platform audio input
@@ -80,6 +165,12 @@ public:
      */
     int getSampleRate() const noexcept;
 
+    /**
+     * @brief Get the sample rate the capture streams at, also before it starts
+     * @return Sample rate in Hz
+     */
+    int getStreamSampleRate() const noexcept;
+
     /**
      * @brief Get current channel count
      * @return Number of channels, or 0 if not capturing
@@ -111,6 +202,217 @@ public:
      */
     void setOutputFile(const std::string &filename);
 
+    /**
+     * @brief Set sample format used when saving WAV files
+     * @param format Output sample format (default is 16-bit PCM)
+     */
+    void setOutputFormat(WavSampleFormat format);
+
+    /**
+     * @brief Get sample format used when saving WAV files
+     * @return Output sample format
+     */
+    WavSampleFormat getOutputFormat() const noexcept;
+
+    /**
+     * @brief Set container used when writing WAV files
+     * @param container Output container (default is RIFF, promoted to RF64 above 4 GB)
+     */
+    void setOutputContainer(WavContainer container);
+
+    /**
+     * @brief Get container used when writing WAV files
+     * @return Output container
+     */
+    WavContainer getOutputContainer() const noexcept;
+
+    /**
+     * @brief Stream audio to the output file while capturing instead of keeping it in memory
+     * @param enabled true to write during capture, false to record in memory (default)
+     * @return true if the mode was changed, false if capture is running
+     */
+    bool setStreamingOutput(bool enabled);
+
+    /**
+     * @brief Check if audio is streamed to the output file while capturing
+     * @return true if streaming output is enabled, false otherwise
+     */
+    bool isStreamingOutput() const noexcept;
+
+    /**
+     * @brief Compress audio recorded in memory
+     *
+     * Blocks are losslessly compressed on a background thread and decoded when
+     * the recording is saved. Audio from 16 or 24-bit devices typically shrinks
+     * to a third to a half of its float size.
+     *
+     * @param enabled true to compress (default), false to keep float samples
+     */
+    void setRecordingCompression(bool enabled);
+
+    /**
+     * @brief Limit the memory used by the in-memory recording
+     *
+     * Once the recording exceeds the budget, its oldest blocks are moved to a
+     * temporary file in the background and read back by saveRecordedAudio().
+     *
+     * @param bytes Maximum resident bytes, zero for no limit (default)
+     */
+    void setRecordingMemoryBudget(uint64_t bytes);
+
+    /**
+     * @brief Keep capturing when the input device fails
+     *
+     * On a stream error the capture stays active: a background thread reopens
+     * the selected device as soon as it reappears, or the fallback device if one
+     * is set and available. The recording and callbacks continue on the new
+     * stream and the outage is reported as a gap. While on the fallback, the
+     * capture moves back to the selected device once it reappears, woken by the
+     * backend's device notifications or found by polling where there are none.
+     * The switch is reported as a GapReason::StreamRestart gap.
+     *
+     * @param enabled true to recover from device failures, false to end the capture (default)
+     * @return true if the mode was changed, false if capture is running
+     */
+    bool setDeviceRecovery(bool enabled);
+
+    /**
+     * @brief Set device used when the selected input device is unavailable during recovery
+     * @param deviceIndex Index of the device (use getAvailableInputDevices to get list), -1 for none
+     * @return true if the fallback was set, false if the index is invalid or capture is running
+     */
+    bool setFallbackInputDevice(int deviceIndex);
+
+    /**
+     * @brief Set how gaps are filled so that the recording stays aligned with wall time
+     *
+     * Gaps are found by comparing the frames received with the monotonic clock,
+     * corrected for the device clock rate measured through the stream position.
+     * They are always reported and counted, this only controls the recording.
+     *
+     * @param mode Gap fill mode (default is none)
+     * @return true if the mode was changed, false if capture is running
+     */
+    bool setGapFill(GapFill mode);
+
+    /**
+     * @brief Set the callback notified about gaps in the captured audio
+     * @param callback Function called with each gap, from a background thread
+     */
+    void setGapCallback(GapCallback callback);
+
+    /**
+     * @brief Tune the stream buffer size to the machine while capturing
+     *
+     * The stream starts at the device minimum latency. A supervisor thread watches
+     * callback timing and doubles the buffer as soon as callbacks run late, and
+     * halves it again after a calm period that grows each time a smaller size
+     * fails. The stream is recreated at the new size, opening the replacement
+     * before the old one is stopped. Frames captured between stopping the old
+     * stream and the first callback of the new one are lost: the gap is reported
+     * with GapReason::StreamRestart, filled according to the gap fill mode and
+     * marked in the recording with a "Stream restart" marker.
+     *
+     * @param enabled true to adapt the latency, false for a fixed 4096 frames (default)
+     * @return true if the mode was changed, false if capture is running
+     */
+    bool setAdaptiveLatency(bool enabled);
+
+    /**
+     * @brief Play the input on the default output device while capturing
+     *
+     * Input and output run on a single duplex stream at the lowest latency the
+     * backend supports, and the input is copied to the output inside the capture
+     * callback.
+     *
+     * @param enabled true to monitor the input, false to capture only (default)
+     * @return true if the mode was changed, false if capture is running
+     */
+    bool setMonitoring(bool enabled);
+
+    /**
+     * @brief Check if the input is monitored while capturing
+     * @return true if monitoring is enabled, false otherwise
+     */
+    bool isMonitoring() const noexcept;
+
+    /**
+     * @brief Set gain applied to the monitored signal (can be changed while capturing)
+     * @param gain Linear gain (default is 1.0)
+     */
+    void setMonitorGain(float gain) noexcept;
+
+    /**
+     * @brief Set which input channel feeds each output channel when monitoring
+     * @param channelMap Input channel index per output channel, -1 for silence
+     *                   (empty maps each input channel to the same output channel)
+     * @return true if the map was changed, false if capture is running
+     */
+    bool setMonitorChannelMap(const std::vector<int> &channelMap);
+
+    /**
+     * @brief Copy captured audio into a tap read by another thread (e.g. AudioMixer)
+     * @param tap Tap receiving every captured frame, null to remove it
+     * @return true if the tap was set, false if capture is running
+     */
+    bool setTap(std::shared_ptr<CaptureTap> tap);
+
+    /**
+     * @brief Attach a processing stage that receives the recorded audio on a background thread
+     * @param stage Stage prepared at the start of each capture session
+     * @return true if the stage was added, false if it is null or capture is running
+     */
+    bool addStage(std::shared_ptr<AudioStage> stage);
+
+    /**
+     * @brief Detach all processing stages
+     * @return true if the stages were removed, false if capture is running
+     */
+    bool clearStages();
+
+    /**
+     * @brief Set how often streamed output is synced to disk with a valid header
+     *
+     * A crash then loses at most one interval of audio; interrupted files can be
+     * repaired with recoverWavFile() or the wav-recover tool.
+     *
+     * @param interval Time between checkpoints, zero to disable (default)
+     */
+    void setCheckpointInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Set backend used to write WAV files
+     * @param type File backend (default is stdio, unsupported backends fall back automatically)
+     */
+    void setFileBackend(FileBackendType type);
+
+    /**
+     * @brief Get statistics of the current or last capture session
+     * @return Capture statistics
+     */
+    CaptureStats getStats() const;
+
+    /**
+     * @brief Mark the current position of the recording (lock-free, callable from any thread)
+     *
+     * The marker is stamped with the frame being captured when it is added: the
+     * recording position after the last callback advanced by the time since.
+     * Markers are written to the WAV file as cue points labelled in a LIST adtl
+     * chunk. Frames the file sink drops are not counted, so markers after a
+     * drop point that many frames late, and markers past the end of the file
+     * are moved onto its last frame.
+     *
+     * @param label Text shown for the marker
+     * @return true if the marker was added, false if not capturing or the session has too many markers
+     */
+    bool addMarker(const std::string &label);
+
+    /**
+     * @brief Get the markers of the current or last capture session
+     * @return Markers ordered by frame position
+     */
+    std::vector<WavCue> getMarkers() const;
+
     /**
      * @brief Save recorded audio as WAV file
      * @return true if saved successfully, false otherwise
@@ -118,22 +420,96 @@ public:
     bool saveRecordedAudio() const;
 
 private:
+    // Marker claimed by addMarker(), readable once ready is set
+    struct MarkerSlot
+    {
+        std::atomic<bool> ready{false};
+        WavCue cue;
+    };
+
     // Internal callback for cubeb
     static long dataCallback(cubeb_stream *stream, void *user_ptr, const void *input_buffer, void *output_buffer, long nframes);
     static void stateCallback(cubeb_stream *stream, void *user_ptr, cubeb_state state);
+    static void deviceCollectionChanged(cubeb *context, void *user_ptr);
 
     // Instance method called by static callback
     void onAudioData(const std::vector<float> &audioData, int frameCount);
 
+    // Copy the input to the duplex output with the monitor gain and channel map
+    void writeMonitorOutput(const float *input, float *output, long frameCount) noexcept;
+
     // Initialize cubeb
     bool initializeCubeb();
 
     // Cleanup resources
     void cleanup();
 
-    // Background thread function
+    // Background thread adapting the latency and recovering failed streams while capturing
     void captureThread();
 
+    // Reopen the capture stream after a device failure, false to retry later
+    bool recoverStream();
+
+    // Move the capture from the fallback back to the selected device, false if it is not available
+    bool returnToSelectedDevice();
+
+    // Find an input device by its backend identifier
+    bool findInputDevice(const std::string &deviceId, cubeb_devid &devid, std::string &name, int &index) const;
+
+    // Report queued gaps to the gap callback
+    void reportGaps();
+
+    // Compare frames received with the clock, returns the number of missing frames (audio thread)
+    uint64_t detectGap(long frameCount, std::chrono::steady_clock::time_point now) noexcept;
+
+    // Write fill frames for a gap into the recording (audio thread)
+    void fillGap(const float *nextFrame, uint64_t frameCount) noexcept;
+
+    // Measure the device clock against the monotonic clock through the stream position
+    void updateDeviceClockRatio();
+
+    // Stop and join the background thread
+    void stopCaptureThread();
+
+    // Create a stream on the current device (not started)
+    bool openStream(uint32_t latencyFrames, cubeb_stream **newStream);
+
+    // Replace the running stream with one on the current device, marking the switch in the recording
+    bool replaceStream(uint32_t latencyFrames, const std::string &marker);
+
+    // Replace the running stream with one using a different buffer size
+    bool restartStream(uint32_t latencyFrames);
+
+    // Count callbacks that ran late or too long (called on the audio thread)
+    void updateCallbackTiming(long frameCount, std::chrono::steady_clock::time_point start) noexcept;
+
+    // Record the buffer size of a newly started stream
+    void setLatency(uint32_t latencyFrames) noexcept;
+
+    // Output file name with the WAV extension
+    std::string getWavFilename() const;
+
+    // Output layout for the current stream
+    WavFormat getWavFormat() const;
+
+    // Finalize the streamed output file, if any
+    void closeFileSink();
+
+    // INFO entries of the session: stage summaries and level statistics
+    std::vector<WavInfoEntry> getRecordingInfo() const;
+
+    // Hand frames to the recording and the stages (audio thread)
+    void storeFrames(const float *samples, long frameCount) noexcept;
+
+    // Queue silent frames for the recording and the stages (audio thread)
+    void storeSilence(uint64_t frameCount) noexcept;
+
+    // Claim a marker slot, false once the session has too many markers
+    bool appendMarker(uint64_t framePosition, const std::string &label);
+
+    // Publish the recording position reached by a callback for addMarker() (audio thread)
+    void publishPosition(std::chrono::steady_clock::time_point callbackStart) noexcept;
+
     // Member variables
     cubeb *context;
     cubeb_stream *stream;
@@ -146,17 +522,90 @@ private:
     std::thread captureThreadHandle;
     mutable std::mutex mutex;
     std::condition_variable cv;
+    std::mutex captureThreadMutex;
 
     std::atomic<int> sampleRate;
     std::atomic<int> channelCount;
     std::string currentDeviceName;
+    std::string selectedDeviceId;
 
     int inputDeviceIndex;
     bool initialized;
 
     // Audio recording
-    std::vector<char> recordedAudio;
+    std::unique_ptr<RecordingStore> recordedAudio;
+    bool recordingCompression;
     std::string outputFile;
+    WavSampleFormat outputFormat;
+    WavContainer outputContainer;
+    bool streamingOutput;
+    std::chrono::milliseconds checkpointInterval;
+    FileBackendType fileBackendType;
+    std::unique_ptr<WavFileSink> fileSink;
+
+    // Device recovery
+    bool deviceRecovery;
+    std::string fallbackDeviceId;
+    std::atomic<bool> onFallbackDevice;
+    std::atomic<bool> devicesChanged;
+    GapCallback gapCallback;
+    std::atomic<bool> streamLost;
+    std::atomic<bool> streamRecovered;
+    std::atomic<int64_t> streamLostTime;
+    std::atomic<uint32_t> failovers;
+    std::atomic<int64_t> lastFailoverTime;
+    std::atomic<int64_t> maxFailoverTime;
+
+    // Gap detection, the timeline is only touched by the audio thread
+    GapFill gapFill;
+    RingBuffer<GapEvent> gapEvents;
+    std::vector<float> gapFillBuffer;
+    std::vector<float> lastFrame;
+    int64_t timelineStart;
+    uint64_t timelineFrames;
+    double timelineBaseline;
+    std::atomic<double> deviceClockRatio;
+    uint64_t clockReferencePosition;
+    int64_t clockReferenceTime;
+    std::atomic<uint32_t> gaps;
+    std::atomic<uint64_t> gapFrames;
+
+    // Latency
+    bool adaptiveLatency;
+    uint32_t minLatencyFrames;
+    std::atomic<bool> restartingStream;
+    std::atomic<bool> streamRestarted;
+    int64_t restartCallbackTime;
+    std::atomic<int64_t> lastCallbackTime;
+    std::atomic<uint32_t> latencyFrames;
+    std::atomic<uint32_t> lowestLatencyFrames;
+    std::atomic<uint32_t> highestLatencyFrames;
+    std::atomic<uint32_t> latencyChanges;
+    std::atomic<uint64_t> xruns;
+
+    // Monitoring
+    bool monitoring;
+    std::atomic<float> monitorGain;
+    std::vector<int> monitorChannelMap;
+    std::vector<int> monitorRouting; // Effective map for the running stream
+
+    // Copy of the captured audio for another consumer
+    std::shared_ptr<CaptureTap> tap;
+
+    // Processing stages
+    std::vector<std::shared_ptr<AudioStage>> stages;
+    std::unique_ptr<StageRunner> stageRunner;
+
+    // Clipping and level distribution of the captured audio
+    std::unique_ptr<LevelStats> levelStats;
+
+    // Markers, slots are claimed through markerCount without locking
+    std::unique_ptr<MarkerSlot[]> markers;
+    std::atomic<uint32_t> markerCount;
+    uint64_t recordingPosition;             // Frames handed to the recording, audio thread only
+    std::atomic<uint32_t> positionSequence; // Odd while the audio thread updates the published position
+    std::atomic<uint64_t> positionFrames;   // Recording position after the last callback
+    std::atomic<int64_t> positionTime;      // Start of the last callback
 };
 
 } // namespace AudioCaptureX
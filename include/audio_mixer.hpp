@@ -0,0 +1,158 @@
+#pragma once
+
+#include "audio_capture.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Runtime statistics of one mixer input
+ */
+struct MixerInputStats
+{
+    uint64_t underruns = 0;       // Times the input ran dry and was muted until it refilled
+    uint64_t droppedFrames = 0;   // Frames lost in the capture tap
+    uint64_t discardedFrames = 0; // Frames skipped to realign the input
+    uint32_t bufferedFrames = 0;  // Frames waiting to be mixed
+    uint32_t targetFrames = 0;    // Buffered frames the drift control steers towards
+    double rateRatio = 1.0;       // Input frames consumed per output frame
+};
+
+/**
+ * @brief Mixes several captures into one stream
+ *
+ * Each input reads a capture through a CaptureTap. process() pulls the same
+ * amount of time from every input, so it can run on an output callback or any
+ * other thread without locks. Inputs are aligned on the latency of their
+ * capture streams plus an optional per-input delay. Every device runs on its
+ * own clock, so each input is resampled by a ratio within 0.5% of unity that
+ * keeps its buffered audio at the aligned level.
+ */
+class AudioMixer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the inputs and the mix in Hz
+     * @param channelCount Channels of the inputs and the mix
+     */
+    explicit AudioMixer(int sampleRate = 48000, int channelCount = 2);
+
+    AudioMixer(const AudioMixer &) = delete;
+    AudioMixer &operator=(const AudioMixer &) = delete;
+
+    /**
+     * @brief Add a capture as input (can be called while mixing, from one thread at a time)
+     *
+     * Installs a tap on the capture, which must not be running. Captures with
+     * another channel count stay silent in the mix. Captures streaming at
+     * another sample rate than the mixer are rejected.
+     *
+     * @param capture Capture to mix
+     * @param gain Linear gain of the input
+     * @return Input index, or -1 if the rates differ, the tap could not be set or the mixer is full
+     */
+    int addInput(AudioCapture &capture, float gain = 1.0f);
+
+    /**
+     * @brief Set gain of an input (can be called while mixing, ramped over one block)
+     * @param input Input index
+     * @param gain Linear gain
+     */
+    void setInputGain(int input, float gain) noexcept;
+
+    /**
+     * @brief Delay an input relative to the others
+     *
+     * The mixer already compensates the buffer size of each capture stream; this
+     * covers the rest, such as microphones at different distances.
+     *
+     * @param input Input index
+     * @param frames Extra delay in frames
+     */
+    void setInputDelay(int input, uint32_t frames) noexcept;
+
+    /**
+     * @brief Produce mixed frames (real-time safe, single consumer)
+     *
+     * Inputs that have not buffered enough audio yet contribute silence.
+     * The mix is not limited and may exceed [-1.0, 1.0].
+     *
+     * @param output Destination for frameCount interleaved frames
+     * @param frameCount Number of frames to produce
+     */
+    void process(float *output, size_t frameCount) noexcept;
+
+    /**
+     * @brief Get number of inputs
+     */
+    int getInputCount() const noexcept;
+
+    /**
+     * @brief Get sample rate of the mix in Hz
+     */
+    int getSampleRate() const noexcept;
+
+    /**
+     * @brief Get channel count of the mix
+     */
+    int getChannelCount() const noexcept;
+
+    /**
+     * @brief Get statistics of an input
+     * @param input Input index
+     * @return Input statistics (all zero for an invalid index)
+     */
+    MixerInputStats getInputStats(int input) const;
+
+private:
+    struct Input
+    {
+        std::shared_ptr<CaptureTap> tap;
+        std::atomic<float> gain{1.0f};
+        std::atomic<uint32_t> delayFrames{0};
+
+        // Mixer thread state
+        std::vector<float> staging;   // Frames read from the tap, the first one is interpolation history
+        std::vector<float> resampled; // Input resampled to the output block
+        size_t stagedFrames = 0;
+        double position = 0.0;        // Read position in staging
+        double averageFill = 0.0;     // Smoothed buffered frames
+        float appliedGain = 0.0f;     // Gain at the end of the last block
+        bool primed = false;          // Buffered enough audio to play
+
+        std::atomic<uint64_t> underruns{0};
+        std::atomic<uint64_t> discardedFrames{0};
+        std::atomic<uint32_t> bufferedFrames{0};
+        std::atomic<uint32_t> targetFrames{0};
+        std::atomic<double> rateRatio{1.0};
+    };
+
+    // Mix one block of an input into the output
+    void mixInput(Input &input, float *output, size_t frameCount, uint32_t alignedFrames) noexcept;
+
+    // Read from the tap until staging holds frameCount frames, false on underrun
+    bool fillStaging(Input &input, size_t frameCount) noexcept;
+
+    // Drop buffered frames, oldest first
+    void discardFrames(Input &input, size_t frameCount) noexcept;
+
+    // Move the frames still needed to the front of staging
+    void compactStaging(Input &input) noexcept;
+
+    // Frames buffered by an input, as seen from the mixer thread
+    double fillLevel(const Input &input) const noexcept;
+
+    int sampleRate;
+    int channelCount;
+    std::vector<std::unique_ptr<Input>> inputs; // Fixed slots, the first inputCount are in use
+    std::atomic<size_t> inputCount;
+    size_t largestBlock; // Most frames requested by one process() call
+};
+
+} // namespace AudioCaptureX
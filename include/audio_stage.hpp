@@ -0,0 +1,209 @@
+#pragma once
+
+#include "sample_queue.hpp"
+#include "wav_writer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Callback function type for audio data
+ * @param audioData Vector containing audio samples (interleaved)
+ * @param frameCount Number of audio frames
+ * @param sampleRate Sample rate in Hz
+ * @param channelCount Number of audio channels
+ */
+using AudioDataCallback = std::function<void(const std::vector<float> &audioData,
+                                             int frameCount,
+                                             int sampleRate,
+                                             int channelCount)>;
+
+/**
+ * @brief Mono mix of interleaved input kept for windowed analysis
+ *
+ * Samples are addressed by their position since the start of the stream.
+ * Analysis stages append each block, read windows in place and discard the
+ * samples their next window no longer reaches.
+ */
+class MonoHistory
+{
+public:
+    /**
+     * @brief Constructor
+     * @param channelCount Number of interleaved input channels averaged into each sample
+     */
+    explicit MonoHistory(int channelCount = 1);
+
+    /**
+     * @brief Append the mono mix of interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     */
+    void append(const float *samples, size_t frameCount);
+
+    /**
+     * @brief Append silent samples
+     * @param frameCount Number of samples
+     */
+    void appendSilence(size_t frameCount);
+
+    /**
+     * @brief Drop the samples before a position (amortized constant time per sample)
+     * @param position Position of the first sample kept, clamped to getEnd()
+     */
+    void discard(uint64_t position);
+
+    /**
+     * @brief Get a sample in place
+     * @param position Position between getStart() and getEnd()
+     * @return Pointer to the sample, the ones up to getEnd() follow it
+     */
+    const float *data(uint64_t position) const noexcept;
+
+    /**
+     * @brief Get the position of the oldest sample kept
+     */
+    uint64_t getStart() const noexcept;
+
+    /**
+     * @brief Get the position after the newest sample
+     */
+    uint64_t getEnd() const noexcept;
+
+private:
+    int channelCount;
+    std::vector<float> samples; // Mono input, the sample at start is at offset
+    size_t offset;
+    uint64_t start;
+};
+
+/**
+ * @brief Processing stage attached to a capture
+ *
+ * Stages see the same audio as the recording, filled gaps included, in order
+ * and on a background thread owned by the capture. They may take longer than
+ * an audio callback would allow for a single block but must keep up on average.
+ */
+class AudioStage
+{
+public:
+    virtual ~AudioStage() = default;
+
+    /**
+     * @brief Prepare for a capture session
+     * @param sampleRate Sample rate in Hz
+     * @param channelCount Number of interleaved channels
+     * @param recordingFile WAV file the session is recorded to, for sidecar output
+     * @return true to receive the audio of the session, false to sit it out
+     */
+    virtual bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) = 0;
+
+    /**
+     * @brief Process the next block of audio
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     */
+    virtual void process(const float *samples, size_t frameCount) = 0;
+
+    /**
+     * @brief Called after the last block of the session
+     */
+    virtual void finish()
+    {
+    }
+
+    /**
+     * @brief Describe the session in the recording's INFO list, called after finish()
+     * @param info Entries to append to
+     */
+    virtual void describe([[maybe_unused]] std::vector<WavInfoEntry> &info) const
+    {
+    }
+};
+
+/**
+ * @brief Feeds captured audio to stages on a background thread
+ *
+ * Mirrors WavFileSink: the capture callback pushes samples and runs of silence
+ * into a SampleQueue, and the stage thread hands them to each prepared stage
+ * in order.
+ */
+class StageRunner
+{
+public:
+    StageRunner();
+
+    /**
+     * @brief Destructor - stops the stage thread
+     */
+    ~StageRunner();
+
+    StageRunner(const StageRunner &) = delete;
+    StageRunner &operator=(const StageRunner &) = delete;
+
+    /**
+     * @brief Prepare the stages and start the stage thread
+     * @param stages Stages to run
+     * @param sampleRate Sample rate in Hz
+     * @param channelCount Number of interleaved channels
+     * @param recordingFile WAV file the session is recorded to
+     * @return true if at least one stage takes part in the session, false otherwise
+     */
+    bool start(const std::vector<std::shared_ptr<AudioStage>> &stages, int sampleRate, int channelCount,
+               const std::string &recordingFile);
+
+    /**
+     * @brief Queue interleaved frames for the stages (real-time safe)
+     * @param samples Interleaved float samples
+     * @param frameCount Number of frames
+     * @return true if the frames were queued, false if they were dropped
+     */
+    bool push(const float *samples, long frameCount) noexcept;
+
+    /**
+     * @brief Queue silent frames without copying samples (real-time safe)
+     * @param frameCount Number of frames
+     * @return true if the silence was queued, false if it was dropped
+     */
+    bool pushSilence(uint64_t frameCount) noexcept;
+
+    /**
+     * @brief Process all queued audio, finish the stages and stop the stage thread
+     */
+    void stop();
+
+    /**
+     * @brief Get number of frames dropped because the stages could not keep up
+     */
+    uint64_t getDroppedFrames() const noexcept;
+
+    /**
+     * @brief Get the INFO entries the stages gave for the last stopped session
+     */
+    const std::vector<WavInfoEntry> &getInfo() const noexcept;
+
+private:
+    // Background thread draining the queue into the stages
+    void stageThread();
+
+    // Hand one block to every stage
+    void processBlock(const float *samples, size_t frameCount);
+
+    std::vector<std::shared_ptr<AudioStage>> activeStages;
+    std::vector<WavInfoEntry> info;
+    SampleQueue queue;
+
+    std::thread stageThreadHandle;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> droppedFrames;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Consecutive feature frames read in place from a FeatureRing
+ *
+ * The frames form a contiguous row-major tensor of frameCount rows of
+ * featureCount values, ready to hand to a model without copying.
+ */
+struct FeatureView
+{
+    const float *data = nullptr; // frameCount * featureCount values, null if the frames are not available
+    uint64_t firstFrame = 0;     // Index of the first frame since the ring was reset
+    size_t frameCount = 0;
+    size_t featureCount = 0;
+};
+
+/**
+ * @brief Lock-free ring of fixed-size feature frames read in place
+ *
+ * One producer appends frames while any number of consumers read them. Every
+ * frame is stored twice, at its slot and again one capacity later, so any run
+ * of frames that fits the ring is contiguous in memory. The producer never
+ * waits: the oldest frames are overwritten, and a view stays intact until the
+ * producer starts the frame one capacity after its first frame.
+ * Consumers check isValid() after using a view, as with a sequence lock, and
+ * should size the ring with headroom beyond the longest view they read.
+ * clear() starts a new run of frames without touching the storage, so it is
+ * safe while consumers read; reset() reallocates and is not.
+ */
+class FeatureRing
+{
+public:
+    /**
+     * @brief Constructor
+     * @param frameCapacity Number of frames kept
+     * @param featureCount Values per frame
+     */
+    explicit FeatureRing(size_t frameCapacity = 0, size_t featureCount = 0);
+
+    FeatureRing(const FeatureRing &) = delete;
+    FeatureRing &operator=(const FeatureRing &) = delete;
+
+    /**
+     * @brief Reallocate storage and discard any frames (not thread-safe)
+     * @param frameCapacity Number of frames kept
+     * @param featureCount Values per frame
+     */
+    void reset(size_t frameCapacity, size_t featureCount);
+
+    /**
+     * @brief Discard the published frames, keeping the storage (producer side)
+     *
+     * Frame indices keep counting from getFrameCount(). Views of earlier
+     * frames fail isValid() and no new view includes them.
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Get the number of frames kept
+     */
+    size_t capacity() const noexcept;
+
+    /**
+     * @brief Get the number of values per frame
+     */
+    size_t featureCount() const noexcept;
+
+    /**
+     * @brief Get storage for the next frame (producer side)
+     *
+     * The producer writes featureCount values and publishes them with
+     * commitFrame(). The storage holds the oldest frame until then.
+     *
+     * @return featureCount values, null if the ring has no storage
+     */
+    float *beginFrame() noexcept;
+
+    /**
+     * @brief Publish the frame filled after beginFrame() (producer side)
+     */
+    void commitFrame() noexcept;
+
+    /**
+     * @brief Get number of frames published since the ring was reset
+     */
+    uint64_t getFrameCount() const noexcept;
+
+    /**
+     * @brief Get index of the first frame published since the ring was last cleared
+     */
+    uint64_t getFirstFrame() const noexcept;
+
+    /**
+     * @brief View published frames in place
+     * @param firstFrame Index of the first frame
+     * @param frameCount Number of frames, less than capacity()
+     * @return View of the frames, empty if any of them is not published yet or already overwritten
+     */
+    FeatureView getFrames(uint64_t firstFrame, size_t frameCount) const noexcept;
+
+    /**
+     * @brief View the most recent frames in place
+     * @param frameCount Number of frames, less than capacity()
+     * @return View of the last frameCount frames, empty if fewer were published
+     */
+    FeatureView getLatest(size_t frameCount) const noexcept;
+
+    /**
+     * @brief Check that the producer has not overwritten a view's frames since it was taken
+     * @param view View returned by getFrames() or getLatest()
+     */
+    bool isValid(const FeatureView &view) const noexcept;
+
+private:
+    std::unique_ptr<float[]> storage; // 2 * frameCapacity frames, the second half mirrors the first
+    size_t frameCapacity;
+    size_t features;
+
+    // Written by the producer only, read by every consumer
+    alignas(64) std::atomic<uint64_t> published;
+    std::atomic<uint64_t> cleared; // Frames before this one were discarded by clear()
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Fast Fourier transform of real signals
+ *
+ * Radix-2 transform with precomputed twiddle factors. A real input of size N is
+ * packed into a complex transform of size N/2 and unpacked into the N/2 + 1
+ * non-negative frequency bins.
+ */
+class RealFft
+{
+public:
+    /**
+     * @brief Constructor
+     * @param size Transform size, a power of two of at least 4
+     */
+    explicit RealFft(size_t size);
+
+    /**
+     * @brief Get the transform size
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Transform real samples
+     * @param input size() samples
+     * @param output Destination for size() / 2 + 1 bins
+     */
+    void forward(const float *input, std::complex<float> *output) noexcept;
+
+    /**
+     * @brief Transform real samples and keep the squared magnitudes
+     * @param input size() samples
+     * @param power Destination for size() / 2 + 1 values
+     */
+    void power(const float *input, float *power) noexcept;
+
+private:
+    size_t n;
+    std::vector<size_t> bitReverse;                // Input permutation of the half size transform
+    std::vector<std::complex<float>> twiddles;     // Factors of the half size transform
+    std::vector<std::complex<float>> unpackFactors; // Factors separating the packed real transform
+    std::vector<std::complex<float>> work;
+    std::vector<std::complex<float>> spectrum;
+};
+
+/**
+ * @brief Fill a periodic Hann window
+ * @param window Destination, its size is the window length
+ */
+void hannWindow(std::vector<float> &window);
+
+} // namespace AudioCaptureX
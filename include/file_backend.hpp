@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Output file abstraction used by the WAV writers
+ *
+ * Data is appended sequentially with write(), while writeAt() is used to
+ * patch already written regions such as the WAV header.
+ */
+class FileBackend
+{
+public:
+    virtual ~FileBackend() = default;
+
+    /**
+     * @brief Create or truncate the file for writing
+     * @param path File path
+     * @return true if the file was opened, false otherwise
+     */
+    virtual bool open(const std::string &path) = 0;
+
+    /**
+     * @brief Append data at the end of the file
+     * @param data Bytes to write
+     * @param size Number of bytes
+     * @return true if all bytes were written, false otherwise
+     */
+    virtual bool write(const void *data, size_t size) = 0;
+
+    /**
+     * @brief Overwrite data at the given offset without moving the append position
+     * @param offset Offset from the start of the file
+     * @param data Bytes to write
+     * @param size Number of bytes
+     * @return true if all bytes were written, false otherwise
+     */
+    virtual bool writeAt(uint64_t offset, const void *data, size_t size) = 0;
+
+    /**
+     * @brief Flush pending data and make it durable on the storage device
+     * @return true if the data reached the device, false otherwise
+     */
+    virtual bool sync() = 0;
+
+    /**
+     * @brief Flush pending data and close the file
+     * @return true if the file was closed cleanly, false otherwise
+     */
+    virtual bool close() = 0;
+};
+
+/**
+ * @brief Available file backends
+ */
+enum class FileBackendType
+{
+    Stdio,   // Buffered stdio streams (default, all platforms)
+    Pwrite,  // Unbuffered positional writes (POSIX)
+    IoUring, // Asynchronous io_uring submissions with registered buffers (Linux)
+    Direct,  // O_DIRECT writes from aligned double buffers, bypassing the page cache (Linux, macOS)
+};
+
+/**
+ * @brief Get a human readable name for the given backend
+ * @param type Backend type
+ * @return Backend name (e.g. "io_uring")
+ */
+const char *fileBackendName(FileBackendType type) noexcept;
+
+/**
+ * @brief Create a backend based on buffered stdio streams
+ * @return New file backend
+ */
+std::unique_ptr<FileBackend> createStdioFileBackend();
+
+/**
+ * @brief Create a file backend of the given type
+ *
+ * Backends that are not supported on this platform or kernel fall back to the
+ * closest available one: io_uring falls back to pwrite, and pwrite and
+ * direct fall back to stdio on platforms without POSIX file descriptors.
+ *
+ * @param type Requested backend type
+ * @return New file backend
+ */
+std::unique_ptr<FileBackend> createFileBackend(FileBackendType type);
+
+} // namespace AudioCaptureX
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "fft.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Pair of spectral peaks hashed into a compact code
+ */
+struct Landmark
+{
+    uint32_t hash = 0;  // Anchor frequency, target frequency and time distance
+    uint32_t frame = 0; // Analysis frame of the anchor peak
+};
+
+/**
+ * @brief Fingerprint of one recording
+ */
+struct Fingerprint
+{
+    double frameSeconds = 0.0; // Duration of one analysis frame
+    std::vector<Landmark> landmarks;
+};
+
+/**
+ * @brief Streaming landmark fingerprinter
+ *
+ * Audio is mixed to mono and resampled to 8 kHz, so fingerprints of any sample
+ * rate share one time and frequency grid. Peaks that dominate their time and
+ * frequency neighbourhood in the spectrogram are paired with the next few
+ * peaks close in frequency, and each pair is hashed with its time distance.
+ * The hashes do not depend on level and survive noise, mixing and lossy
+ * coding as long as the strongest peaks do.
+ */
+class Fingerprinter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     */
+    Fingerprinter(int sampleRate, int channelCount);
+
+    /**
+     * @brief Analyse interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param landmarks Receives the landmarks completed by this block
+     */
+    void process(const float *samples, size_t frameCount, std::vector<Landmark> &landmarks);
+
+    /**
+     * @brief Get duration of one analysis frame in seconds
+     */
+    static double frameSeconds() noexcept;
+
+private:
+    struct Peak
+    {
+        uint32_t frame = 0;
+        uint16_t bin = 0;
+        uint16_t pairs = 0;
+    };
+
+    // Lowpass and resample the mono signal to the analysis rate
+    void resample(std::vector<Landmark> &landmarks);
+
+    // Transform one analysis window and look for peaks in the delayed frame
+    void analyseFrame(std::vector<Landmark> &landmarks);
+
+    // Pair a new peak with earlier anchors
+    void addPeak(uint32_t frame, uint16_t bin, std::vector<Landmark> &landmarks);
+
+    double step;                // Input samples per analysis sample
+    std::vector<float> filter;  // Anti-aliasing lowpass
+    MonoHistory mono;           // Input history for the lowpass
+    double position;            // Next analysis sample position, relative to the oldest sample in mono
+    std::vector<float> analysis; // Resampled signal waiting for the window
+    RealFft fft;
+    std::vector<float> window;
+    std::vector<float> windowed;
+    std::vector<std::vector<float>> spectra; // Recent log spectra, indexed by frame modulo size
+    uint32_t frameCount;
+    std::vector<Peak> peaks; // Recent peaks, oldest first
+};
+
+/**
+ * @brief Stage writing the fingerprint of each recording to a sidecar file
+ *
+ * The sidecar has the recording name with the .afp extension (see
+ * fingerprintSidecarPath()) and is written while capturing.
+ */
+class FingerprintStage : public AudioStage
+{
+public:
+    FingerprintStage();
+    ~FingerprintStage() override;
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+    void finish() override;
+
+    /**
+     * @brief Get number of landmarks written in the current or last session
+     */
+    uint64_t getLandmarkCount() const noexcept;
+
+private:
+    std::unique_ptr<Fingerprinter> fingerprinter;
+    std::vector<Landmark> pending;
+    FILE *file;
+    std::string path;
+    uint64_t landmarkCount;
+};
+
+/**
+ * @brief Candidate match of a query in an indexed recording
+ */
+struct FingerprintMatch
+{
+    uint32_t recording = 0;  // Identifier given to FingerprintIndex::add()
+    int64_t offset = 0;      // Recording frame minus query frame
+    uint32_t queryStart = 0; // First matching query frame
+    uint32_t queryEnd = 0;   // Last matching query frame
+    double score = 0.0;      // Landmarks agreeing on the offset, a hash repeating n times counts 1 / n
+};
+
+/**
+ * @brief Hash index over the fingerprints of many recordings
+ *
+ * Landmarks are kept sorted by hash in one array, so the index costs 12 bytes
+ * per landmark and a lookup is a binary search. Matches are found by voting
+ * for the time offset between query and recording. A hash that repeats
+ * within the query or a recording, as in periodic audio, has its votes
+ * shared among its occurrences, so it cannot build up a score on its own.
+ */
+class FingerprintIndex
+{
+public:
+    /**
+     * @brief Add the landmarks of a recording (call build() afterwards)
+     * @param recording Identifier reported in matches
+     * @param landmarks Landmarks of the recording
+     */
+    void add(uint32_t recording, const std::vector<Landmark> &landmarks);
+
+    /**
+     * @brief Sort the index, required before find()
+     */
+    void build();
+
+    /**
+     * @brief Get number of indexed landmarks
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Find recordings sharing a segment with the query
+     * @param landmarks Landmarks of the query
+     * @param minScore Lowest score that makes a match
+     * @return Matches sorted by score, best first, at most one per recording and offset
+     */
+    std::vector<FingerprintMatch> find(const std::vector<Landmark> &landmarks, double minScore) const;
+
+private:
+    struct Entry
+    {
+        uint32_t hash;
+        uint32_t recording;
+        uint32_t frame;
+    };
+
+    std::vector<Entry> entries;
+};
+
+/**
+ * @brief Get the fingerprint sidecar path of a recording
+ * @param recordingFile Recording path
+ * @return Path with the extension replaced by .afp
+ */
+std::string fingerprintSidecarPath(const std::string &recordingFile);
+
+/**
+ * @brief Read a fingerprint sidecar file
+ * @param filename Sidecar path
+ * @param fingerprint Receives the fingerprint
+ * @return true if the file was read, false otherwise
+ */
+bool readFingerprintFile(const std::string &filename, Fingerprint &fingerprint);
+
+/**
+ * @brief Write a fingerprint sidecar file
+ * @param filename Sidecar path
+ * @param fingerprint Fingerprint to write
+ * @return true if the file was written, false otherwise
+ */
+bool writeFingerprintFile(const std::string &filename, const Fingerprint &fingerprint);
+
+/**
+ * @brief Fingerprint an existing WAV file
+ * @param filename WAV file path
+ * @param fingerprint Receives the fingerprint
+ * @return true if the file was read, false otherwise
+ */
+bool fingerprintWavFile(const std::string &filename, Fingerprint &fingerprint);
+
+} // namespace AudioCaptureX
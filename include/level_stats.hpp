@@ -0,0 +1,94 @@
+#pragma once
+
+#include "wav_writer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Clipping and level distribution of one channel
+ */
+struct ChannelLevelStats
+{
+    uint64_t clippedSamples = 0;     // Samples at or above the clip level
+    uint64_t clipRuns = 0;           // Runs of at least LevelStats::kMinClipRun consecutive clipped samples
+    uint64_t longestClipRun = 0;     // Most consecutive clipped samples
+    std::vector<uint64_t> histogram; // Samples per level bin, see LevelStats::binDecibels()
+};
+
+/**
+ * @brief Per-channel clip counters and level histogram of the captured audio
+ *
+ * Updated from the capture callback by a single writer and readable from any
+ * thread. Sample levels are binned in sixths of an octave (1.003 dB) from
+ * 0 dBFS down, exactly, using the float exponent and four mantissa compares
+ * rather than a logarithm, eight samples at a time with SSE2 or NEON.
+ */
+class LevelStats
+{
+public:
+    // Level bins, the last one holds everything below -120 dBFS including silence
+    static const size_t kBinCount = 121;
+
+    // Absolute sample value counted as clipped (-0.009 dBFS)
+    static constexpr float kClipLevel = 0.999f;
+
+    // Consecutive clipped samples that make a clip run
+    static const uint64_t kMinClipRun = 3;
+
+    LevelStats();
+
+    /**
+     * @brief Clear the statistics for a new session (not real-time safe)
+     * @param channelCount Number of interleaved channels
+     */
+    void reset(int channelCount);
+
+    /**
+     * @brief Add interleaved frames (real-time safe, single writer)
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     */
+    void process(const float *samples, long frameCount) noexcept;
+
+    /**
+     * @brief Get the statistics of each channel
+     */
+    std::vector<ChannelLevelStats> getChannels() const;
+
+    /**
+     * @brief Describe the session in the recording's INFO list
+     * @param info Entries to append to (ICMT summary and ILVL histograms)
+     */
+    void describe(std::vector<WavInfoEntry> &info) const;
+
+    /**
+     * @brief Get the upper edge of a level bin
+     * @param bin Bin index
+     * @return Level in dBFS, bin covers the levels from the next bin's edge up to this one
+     */
+    static double binDecibels(size_t bin) noexcept;
+
+private:
+    // Add the block histogram and run state to the shared counters
+    void publish() noexcept;
+
+    int channelCount;
+    std::unique_ptr<std::atomic<uint64_t>[]> clippedSamples;
+    std::unique_ptr<std::atomic<uint64_t>[]> clipRuns;
+    std::unique_ptr<std::atomic<uint64_t>[]> longestClipRun;
+    std::unique_ptr<std::atomic<uint64_t>[]> histogram; // kBinCount per channel
+
+    // Writer state
+    std::vector<uint32_t> blockHistogram; // kBinCount per channel
+    std::vector<uint64_t> blockClipped;
+    std::vector<uint64_t> runLength; // Current run of clipped samples per channel
+    uint64_t activeRuns;             // Channels with a run in progress
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,161 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Loudness measured every 100 ms
+ *
+ * Loudness values are in LUFS and -infinity for silence.
+ */
+struct LoudnessReading
+{
+    uint64_t framePosition = 0; // Frame of the recording the reading ends at
+    float momentary = 0.0f;     // Last 400 ms
+    float shortTerm = 0.0f;     // Last 3 s
+    float integrated = 0.0f;    // Gated loudness since the start
+    float truePeak = 0.0f;      // Highest true peak of the last 100 ms in dBTP
+};
+
+/**
+ * @brief Loudness of a whole session
+ */
+struct LoudnessSummary
+{
+    float integrated = 0.0f;    // Gated programme loudness in LUFS
+    float loudnessRange = 0.0f; // Spread of the short-term loudness in LU (EBU Tech 3342)
+    float maxMomentary = 0.0f;  // Loudest 400 ms in LUFS
+    float maxShortTerm = 0.0f;  // Loudest 3 s in LUFS
+    float maxTruePeak = 0.0f;   // Highest true peak in dBTP
+    uint64_t frameCount = 0;    // Frames measured
+};
+
+/**
+ * @brief Streaming ITU-R BS.1770 / EBU R128 loudness meter
+ *
+ * Channels are K-weighted by two biquads, two channels per SIMD register in
+ * double precision, and their mean square is summed in 100 ms steps with the
+ * BS.1770 channel weights (surround channels of 5.0 and 5.1 at +1.5 dB, LFE
+ * excluded). Integrated loudness and loudness range are gated from histograms
+ * with 0.01 LU bins, so memory does not grow with the recording. True peak is
+ * taken from the signal oversampled four times with the BS.1770 interpolation
+ * filter.
+ */
+class LoudnessMeter
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     */
+    LoudnessMeter(int sampleRate, int channelCount);
+
+    /**
+     * @brief Measure interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param readings Receives one reading per completed 100 ms step
+     */
+    void process(const float *samples, size_t frameCount, std::vector<LoudnessReading> &readings);
+
+    /**
+     * @brief Get the loudness of everything measured so far
+     */
+    LoudnessSummary getSummary() const;
+
+private:
+    // Loudness histogram with energy sums for gating
+    struct Histogram
+    {
+        std::vector<uint64_t> counts;
+        std::vector<double> energies;
+    };
+
+    // K-weight frames and add their squares to the step energy of each channel
+    void filterFrames(const float *samples, size_t frameCount);
+
+    // Find the highest true peak of the frames
+    float measureTruePeak(const float *samples, size_t frameCount);
+
+    // Close the current 100 ms step
+    void finishStep(std::vector<LoudnessReading> &readings);
+
+    // Add a block loudness to a histogram
+    void addBlock(Histogram &histogram, double energy);
+
+    // Gated mean energy of the blocks at or above the gate
+    static double gatedEnergy(const Histogram &histogram, double gate);
+
+    int channelCount;
+    size_t pairCount;              // Channels rounded up to pairs
+    size_t stepFrames;             // Frames per 100 ms step
+    double coefficients[10];       // Shelf and highpass biquads: b0 b1 b2 a1 a2 each
+    std::vector<double> filterState; // Four values per channel and biquad
+    std::vector<double> channelEnergy; // Sum of squares of the current step per channel
+    std::vector<double> channelWeights;
+    std::vector<float> peakHistory;    // Last inputs of each channel for the interpolation filter
+    std::vector<float> peakBuffer;     // One channel of history and new frames
+    std::vector<double> stepEnergies;  // Weighted mean square of the last 30 steps, by step modulo 30
+    size_t stepFilled;                 // Frames in the current step
+    uint64_t stepCount;
+    uint64_t frameCount;
+    float stepPeak;
+    float maxPeak;
+    double maxMomentary;
+    double maxShortTerm;
+    Histogram momentaryBlocks; // 400 ms blocks for the integrated loudness
+    Histogram shortTermBlocks; // 3 s blocks for the loudness range
+};
+
+/**
+ * @brief Stage metering the loudness of the capture
+ *
+ * Readings are published on a lock-free queue every 100 ms, read them with
+ * readReadings() from any single thread. The session summary is written to
+ * the comment of the recording's INFO list.
+ */
+class LoudnessStage : public AudioStage
+{
+public:
+    LoudnessStage();
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+    void finish() override;
+    void describe(std::vector<WavInfoEntry> &info) const override;
+
+    /**
+     * @brief Take queued readings (single consumer)
+     * @param readings Destination for the readings
+     * @param maxCount Maximum number of readings to read
+     * @return Number of readings read
+     */
+    size_t readReadings(LoudnessReading *readings, size_t maxCount) noexcept;
+
+    /**
+     * @brief Get number of readings lost because the queue was full
+     */
+    uint64_t getDroppedReadings() const noexcept;
+
+    /**
+     * @brief Get the loudness of the last session (valid after stopCapture())
+     */
+    LoudnessSummary getSummary() const;
+
+private:
+    std::unique_ptr<LoudnessMeter> meter;
+    std::vector<LoudnessReading> found;
+    RingBuffer<LoudnessReading> readings;
+    std::atomic<uint64_t> droppedReadings;
+    LoudnessSummary summary;
+};
+
+} // namespace AudioCaptureX
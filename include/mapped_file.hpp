@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Reading through the mapping avoids copying the file into buffers. Pages are
+ * loaded on first access, and ranges that were read can be released so a
+ * process streaming through large files keeps a bounded resident set.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /**
+     * @brief Map a file for reading
+     * @param path File path
+     * @return true if the file was mapped, false otherwise (empty files cannot be mapped)
+     */
+    bool open(const std::string &path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Check if a file is mapped
+     */
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Get the start of the mapping
+     */
+    const uint8_t *data() const noexcept;
+
+    /**
+     * @brief Get the size of the file in bytes
+     */
+    uint64_t size() const noexcept;
+
+    /**
+     * @brief Tell the system the file is read front to back, for more read-ahead
+     */
+    void adviseSequential() noexcept;
+
+    /**
+     * @brief Drop the pages of an already read range from the resident set
+     *
+     * The range stays readable, later accesses load it from the file again.
+     * Windows trims the working set of views itself, there this does nothing.
+     *
+     * @param offset Start of the range
+     * @param size Number of bytes
+     */
+    void release(uint64_t offset, uint64_t size) noexcept;
+
+private:
+    const uint8_t *mapping;
+    uint64_t mappingSize;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "feature_ring.hpp"
+#include "fft.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Log-mel spectrogram configuration
+ */
+struct MelSettings
+{
+    int bandCount = 80;           // Mel bands per frame
+    double windowSeconds = 0.025; // Analysis window, zero padded to a power of two for the FFT
+    double hopSeconds = 0.01;     // Time between frames
+    float minFrequency = 0.0f;    // Lower edge of the first band
+    float maxFrequency = 0.0f;    // Upper edge of the last band, 0 for the Nyquist frequency
+    float logFloor = 1e-10f;      // Band energies are clamped to this before the logarithm
+};
+
+/**
+ * @brief Streaming log-mel spectrogram
+ *
+ * Each hop the mono mix of the last window is Hann windowed, transformed, and
+ * its power spectrum summed into triangular bands equally spaced on the HTK
+ * mel scale (2595 log10(1 + f / 700)), with a peak weight of 1. The band
+ * weights are stored sparsely, only the bins under each triangle. Frames hold
+ * the natural logarithm of the band energies and are written straight into a
+ * FeatureRing. Frame k covers the input frames [k * hop, k * hop + window).
+ */
+class MelExtractor
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     * @param settings Bands, window and hop
+     */
+    MelExtractor(int sampleRate, int channelCount, const MelSettings &settings = MelSettings());
+
+    /**
+     * @brief Analyse interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param features Receives one frame of getBandCount() values per completed hop
+     */
+    void process(const float *samples, size_t frameCount, FeatureRing &features);
+
+    /**
+     * @brief Get number of mel bands per frame
+     */
+    size_t getBandCount() const noexcept;
+
+    /**
+     * @brief Get number of input frames between two feature frames
+     */
+    size_t getHopFrames() const noexcept;
+
+    /**
+     * @brief Get number of input frames covered by a feature frame
+     */
+    size_t getWindowFrames() const noexcept;
+
+    /**
+     * @brief Check if settings can be used at a sample rate
+     */
+    static bool validSettings(const MelSettings &settings, int sampleRate) noexcept;
+
+private:
+    // Bins under one triangular band, weights start at weightOffset
+    struct Band
+    {
+        size_t firstBin = 0;
+        size_t binCount = 0;
+        size_t weightOffset = 0;
+    };
+
+    // Compute the log-mel frame of the analysis window starting at the given sample
+    void analyseWindow(const float *input, float *frame);
+
+    float logFloor;
+    size_t windowSize;
+    size_t hopSize;
+    RealFft fft;
+    std::vector<float> window;
+    std::vector<float> windowed; // Zero padded beyond windowSize
+    std::vector<float> power;
+    std::vector<Band> bands;
+    std::vector<float> weights; // Sparse band weights, one run per band
+    MonoHistory mono;
+    uint64_t nextWindow; // Start of the next analysis window
+};
+
+/**
+ * @brief Stage writing log-mel frames into a ring read in place
+ *
+ * Consumers on any thread read the most recent frames as contiguous tensors
+ * from getFeatures() without copying, see FeatureRing. The ring is allocated
+ * by the constructor and only cleared when a session starts, so consumers may
+ * keep polling across sessions: views of the previous session fail isValid()
+ * and frame indices keep counting from FeatureRing::getFirstFrame().
+ */
+class MelStage : public AudioStage
+{
+public:
+    /**
+     * @brief Constructor
+     * @param settings Bands, window and hop
+     * @param ringSeconds Time of frames kept in the ring
+     */
+    explicit MelStage(const MelSettings &settings = MelSettings(), double ringSeconds = 10.0);
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+
+    /**
+     * @brief Get the ring the frames are written to
+     */
+    const FeatureRing &getFeatures() const noexcept;
+
+    /**
+     * @brief Get number of input frames between two feature frames of the session
+     */
+    size_t getHopFrames() const noexcept;
+
+private:
+    MelSettings settings;
+    std::unique_ptr<MelExtractor> extractor; // Used by the stage thread only
+    FeatureRing features;
+    std::atomic<size_t> hopFrames;
+};
+
+} // namespace AudioCaptureX
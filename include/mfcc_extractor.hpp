@@ -0,0 +1,148 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "feature_ring.hpp"
+#include "mel_extractor.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief MFCC configuration
+ */
+struct MfccSettings
+{
+    MelSettings mel;           // Log-mel frames the cepstra are computed from
+    int coefficientCount = 13; // Cepstral coefficients per frame, c0 included
+    float lifter = 22.0f;      // Sinusoidal liftering parameter, 0 to disable
+    bool deltas = true;        // Append delta and delta-delta coefficients
+    int deltaWindow = 2;       // Frames on each side of the delta regression
+};
+
+/**
+ * @brief Streaming MFCC extractor with delta features
+ *
+ * Runs a MelExtractor and takes the orthonormal DCT-II of each log-mel frame,
+ * with the liftering folded into the DCT matrix. Deltas are the regression
+ * sum(n * (c[t + n] - c[t - n])) / (2 * sum(n^2)) over deltaWindow frames on
+ * each side, and delta-deltas the same regression over the deltas; frames
+ * before the start are the first frame repeated. Output frame t holds the
+ * cepstra, deltas and delta-deltas of mel frame t, so its timing matches the
+ * log-mel frames, but it is only written 2 * deltaWindow hops later. finish()
+ * writes the last frames with the final frame repeated past the end. The DCT
+ * and regressions run on four coefficients at a time with SSE2 or NEON.
+ */
+class MfccExtractor
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     * @param settings Mel analysis, coefficients and deltas
+     */
+    MfccExtractor(int sampleRate, int channelCount, const MfccSettings &settings = MfccSettings());
+
+    /**
+     * @brief Analyse interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param features Receives one frame of getFeatureCount() values per completed hop
+     */
+    void process(const float *samples, size_t frameCount, FeatureRing &features);
+
+    /**
+     * @brief Write the frames still waiting for their deltas, after the last input
+     * @param features Receives the remaining frames
+     */
+    void finish(FeatureRing &features);
+
+    /**
+     * @brief Get number of values per output frame
+     */
+    size_t getFeatureCount() const noexcept;
+
+    /**
+     * @brief Get number of input frames between two feature frames
+     */
+    size_t getHopFrames() const noexcept;
+
+    /**
+     * @brief Check if settings can be used at a sample rate
+     */
+    static bool validSettings(const MfccSettings &settings, int sampleRate) noexcept;
+
+private:
+    // Turn new log-mel frames into cepstra and write every frame whose deltas are complete
+    void update(FeatureRing &features, bool flushing);
+
+    // Compute the delta-deltas of the next output frame and write it
+    void writeFrame(FeatureRing &features);
+
+    // Row of a frame in a history ring, indices before 0 or from count on repeat the edge frame
+    const float *historyRow(const std::vector<float> &history, int64_t index, uint64_t count) const noexcept;
+
+    // Delta regression around a frame of a history ring into a padded row
+    void regression(const std::vector<float> &history, int64_t index, uint64_t count, float *output) const noexcept;
+
+    int channelCount;
+    MelExtractor mel;
+    FeatureRing melFrames;
+    size_t coefficientCount;
+    size_t paddedCount; // coefficientCount rounded up to a multiple of 4
+    int deltaWindow;    // 0 without deltas
+    float deltaScale;   // 1 / (2 * sum(n^2))
+    size_t historyRows;
+    std::vector<float> dct;         // Band-major, paddedCount liftered weights per band
+    std::vector<float> cepstra;     // Ring of historyRows padded rows
+    std::vector<float> deltas;      // Ring of historyRows padded rows
+    std::vector<float> deltaDeltas; // One padded row
+    uint64_t melCount;   // Log-mel frames taken from melFrames
+    uint64_t deltaCount; // Frames with deltas computed
+    uint64_t outputCount;
+};
+
+/**
+ * @brief Stage writing MFCC frames into a ring read in place
+ *
+ * Like MelStage, consumers read the most recent frames as contiguous tensors
+ * from getFeatures(), and the ring is allocated once and cleared when a
+ * session starts. Each frame holds the coefficients, then the deltas and
+ * delta-deltas if enabled.
+ */
+class MfccStage : public AudioStage
+{
+public:
+    /**
+     * @brief Constructor
+     * @param settings Mel analysis, coefficients and deltas
+     * @param ringSeconds Time of frames kept in the ring
+     */
+    explicit MfccStage(const MfccSettings &settings = MfccSettings(), double ringSeconds = 10.0);
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+    void finish() override;
+
+    /**
+     * @brief Get the ring the frames are written to
+     */
+    const FeatureRing &getFeatures() const noexcept;
+
+    /**
+     * @brief Get number of input frames between two feature frames of the session
+     */
+    size_t getHopFrames() const noexcept;
+
+private:
+    MfccSettings settings;
+    std::unique_ptr<MfccExtractor> extractor; // Used by the stage thread only
+    FeatureRing features;
+    std::atomic<size_t> hopFrames;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Ring storage mapped twice back to back
+ *
+ * The same memory appears at data() and again at data() + size(), so any run
+ * of up to size() bytes starting inside the first copy is contiguous, across
+ * the wrap included. The double mapping uses memfd_create on Linux, shared
+ * memory elsewhere on POSIX, and a pagefile section on Windows. Where none of
+ * these works the buffer falls back to 2 * size() bytes of heap, and write()
+ * keeps the second copy up to date in software.
+ */
+class MirroredBuffer
+{
+public:
+    MirroredBuffer();
+
+    /**
+     * @brief Destructor - unmaps the buffer
+     */
+    ~MirroredBuffer();
+
+    MirroredBuffer(const MirroredBuffer &) = delete;
+    MirroredBuffer &operator=(const MirroredBuffer &) = delete;
+
+    /**
+     * @brief Allocate the buffer, discarding any previous one
+     * @param minimumBytes Minimum size of one copy, rounded up by roundSize()
+     * @return true if the buffer was allocated, false otherwise
+     */
+    bool allocate(size_t minimumBytes);
+
+    /**
+     * @brief Free the buffer
+     */
+    void release() noexcept;
+
+    /**
+     * @brief Get the start of the first copy, the second one follows at data() + size()
+     */
+    uint8_t *data() const noexcept;
+
+    /**
+     * @brief Get the size of one copy in bytes
+     */
+    size_t size() const noexcept;
+
+    /**
+     * @brief Check if the two copies are the same memory rather than the heap fallback
+     */
+    bool isMirrored() const noexcept;
+
+    /**
+     * @brief Copy bytes into the ring, wrapping at size() (real-time safe)
+     * @param offset Position in the ring, less than size()
+     * @param source Bytes to copy
+     * @param byteCount Number of bytes, at most size()
+     */
+    void write(size_t offset, const void *source, size_t byteCount) noexcept;
+
+    /**
+     * @brief Round a size up to the granularity of the double mapping
+     */
+    static size_t roundSize(size_t minimumBytes) noexcept;
+
+private:
+    // Map one region twice, false if the system does not allow it
+    bool mapMirrored(size_t bytes);
+
+    uint8_t *mapping;
+    size_t bufferSize;
+    bool mirrored;
+    std::unique_ptr<uint8_t[]> heap; // Fallback storage of 2 * bufferSize bytes
+#ifdef _WIN32
+    void *sectionHandle;
+#endif
+};
+
+/**
+ * @brief Thread-safe pool of mirrored buffers kept for reuse
+ *
+ * Setting up a double mapping takes several system calls and faults in fresh
+ * pages. Buffers returned to the pool are handed out again for requests that
+ * round to the same size, so sessions and streams that start and stop often
+ * do not map and unmap memory each time.
+ */
+class MirroredBufferPool
+{
+public:
+    /**
+     * @brief Constructor
+     * @param maxIdleBuffers Number of returned buffers kept, the rest are freed
+     */
+    explicit MirroredBufferPool(size_t maxIdleBuffers = 8);
+
+    MirroredBufferPool(const MirroredBufferPool &) = delete;
+    MirroredBufferPool &operator=(const MirroredBufferPool &) = delete;
+
+    /**
+     * @brief Get a buffer, reusing an idle one of the same rounded size if possible
+     * @param minimumBytes Minimum size of one copy
+     * @return Allocated buffer, null if the allocation failed
+     */
+    std::unique_ptr<MirroredBuffer> acquire(size_t minimumBytes);
+
+    /**
+     * @brief Return a buffer for later reuse
+     * @param buffer Buffer from acquire(), may be null
+     */
+    void recycle(std::unique_ptr<MirroredBuffer> buffer);
+
+    /**
+     * @brief Get number of buffers waiting for reuse
+     */
+    size_t getIdleCount() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<MirroredBuffer>> idle;
+    size_t maxIdleBuffers;
+};
+
+} // namespace AudioCaptureX
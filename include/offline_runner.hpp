@@ -0,0 +1,95 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "level_stats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Outcome of processing one file offline
+ */
+struct OfflineResult
+{
+    uint64_t frameCount = 0;                      // Frames processed
+    int sampleRate = 0;                           // Sample rate of the file in Hz
+    int channelCount = 0;                         // Channels of the file
+    double seconds = 0.0;                         // Wall time spent on the file
+    double realtimeFactor = 0.0;                  // Audio duration divided by wall time
+    std::vector<ChannelLevelStats> channelLevels; // Clip counters and level histogram per channel
+    std::vector<WavInfoEntry> info;               // INFO entries a live recording of the audio would carry
+};
+
+/**
+ * @brief Runs recorded WAV files through capture callbacks and stages as fast as possible
+ *
+ * The file is split into chunks decoded in parallel by worker threads, each
+ * with its own reader. Stages keep state from one block to the next, so each
+ * stage sees the chunks in order on a thread of its own while the stages run
+ * concurrently with each other. The data callback and the level statistics run
+ * on the calling thread, in blocks as a capture would deliver them. Chunks in
+ * flight are bounded, so memory does not grow with the file.
+ */
+class OfflineRunner
+{
+public:
+    /**
+     * @brief Constructor
+     * @param callback Function called with each block of audio (optional)
+     */
+    explicit OfflineRunner(AudioDataCallback callback = nullptr);
+
+    /**
+     * @brief Set the audio data callback
+     * @param callback Function called with each block of audio
+     */
+    void setCallback(AudioDataCallback callback);
+
+    /**
+     * @brief Attach a processing stage, prepared again for every file
+     * @param stage Stage to run
+     */
+    void addStage(std::shared_ptr<AudioStage> stage);
+
+    /**
+     * @brief Detach all processing stages
+     */
+    void clearStages();
+
+    /**
+     * @brief Set the number of threads decoding chunks
+     * @param count Decoder threads, 0 for one per hardware thread
+     */
+    void setDecoderThreads(unsigned count);
+
+    /**
+     * @brief Set the frames per data callback
+     * @param frames Frames per block (default 4096, the default capture buffer)
+     */
+    void setBlockFrames(size_t frames);
+
+    /**
+     * @brief Process a WAV file
+     *
+     * The stages are prepared with the file as recording file, so sidecar
+     * output such as fingerprints is written next to it.
+     *
+     * @param filename WAV file to read
+     * @param result Receives the statistics of the file
+     * @return true if the whole file was processed, false otherwise
+     */
+    bool run(const std::string &filename, OfflineResult &result);
+
+private:
+    AudioDataCallback callback;
+    std::vector<std::shared_ptr<AudioStage>> stages;
+    unsigned decoderThreads;
+    size_t blockFrames;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "fft.hpp"
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Transient found in the captured audio
+ */
+struct OnsetEvent
+{
+    uint64_t framePosition = 0; // Frame of the recording where the transient starts
+    float strength = 0.0f;      // Spectral flux of the onset relative to its threshold
+};
+
+/**
+ * @brief Streaming onset detector
+ *
+ * Spectral flux of the log-compressed magnitude spectrum (512 points, hop of
+ * 256 at 48 kHz), compared against the mean flux of the last 100 ms scaled by
+ * the threshold factor. A flux peak above the threshold is an onset, which is
+ * then placed on the sample where the short-term energy first rises steeply.
+ */
+class OnsetDetector
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     * @param threshold Factor over the recent mean flux that makes an onset (lower is more sensitive)
+     * @param minIntervalSeconds Shortest time between two onsets
+     */
+    OnsetDetector(int sampleRate, int channelCount, float threshold = 2.0f, double minIntervalSeconds = 0.03);
+
+    /**
+     * @brief Analyse interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param onsets Receives the onsets confirmed by this block
+     */
+    void process(const float *samples, size_t frameCount, std::vector<OnsetEvent> &onsets);
+
+private:
+    // Compute the flux of the next analysis frame and test the previous one for a peak
+    void analyseFrame(std::vector<OnsetEvent> &onsets);
+
+    // Find the sample of steepest energy rise between two positions
+    uint64_t locateOnset(uint64_t start, uint64_t end);
+
+    float threshold;
+    uint64_t minInterval;
+    size_t hopSize;
+    RealFft fft;
+    std::vector<float> window;
+    std::vector<float> windowed;
+    std::vector<float> power;
+    std::vector<float> previousMagnitude;
+    std::vector<float> fluxHistory; // Recent flux values, indexed by frame modulo size
+    std::vector<float> rise;        // Energy rise at each position searched by locateOnset()
+    MonoHistory mono;
+    uint64_t frameIndex;
+    uint64_t nextOnset; // Earliest position of the next onset
+    float previousFlux;
+};
+
+/**
+ * @brief Stage publishing onsets on a lock-free queue
+ *
+ * Events are sample accurate positions in the recording. Read them with
+ * readEvents() from any single thread.
+ */
+class OnsetStage : public AudioStage
+{
+public:
+    /**
+     * @brief Constructor
+     * @param threshold Factor over the recent mean flux that makes an onset (lower is more sensitive)
+     * @param minIntervalSeconds Shortest time between two onsets
+     */
+    explicit OnsetStage(float threshold = 2.0f, double minIntervalSeconds = 0.03);
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+
+    /**
+     * @brief Take queued onsets (single consumer)
+     * @param events Destination for the events
+     * @param maxCount Maximum number of events to read
+     * @return Number of events read
+     */
+    size_t readEvents(OnsetEvent *events, size_t maxCount) noexcept;
+
+    /**
+     * @brief Get number of onsets lost because the queue was full
+     */
+    uint64_t getDroppedEvents() const noexcept;
+
+private:
+    float threshold;
+    double minIntervalSeconds;
+    std::unique_ptr<OnsetDetector> detector;
+    std::vector<OnsetEvent> found;
+    RingBuffer<OnsetEvent> events;
+    std::atomic<uint64_t> droppedEvents;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Pitch measured over one hop
+ */
+struct PitchEstimate
+{
+    uint64_t framePosition = 0; // Frame of the recording at the centre of the analysis window
+    float frequency = 0.0f;     // Fundamental frequency in Hz, 0 when no periodicity was found
+    float confidence = 0.0f;    // Periodicity from 0 (noise) to 1 (perfectly periodic)
+};
+
+/**
+ * @brief Pitch tracker configuration
+ */
+struct PitchSettings
+{
+    float minFrequency = 60.0f;   // Lowest fundamental reported, sets the window length
+    float maxFrequency = 1000.0f; // Highest fundamental reported
+    double hopSeconds = 0.01;     // Time between estimates
+    float threshold = 0.15f;      // YIN dip threshold, lower rejects more noisy periods
+};
+
+/**
+ * @brief Streaming YIN pitch estimator
+ *
+ * Each hop the squared difference function of the last window is computed for
+ * every lag of the frequency range, normalized by its cumulative mean, and the
+ * first dip below the threshold is refined by parabolic interpolation. The
+ * window is one period of the lowest frequency, so the cost per frame grows
+ * with the square of the period range over the hop; raise minFrequency or the
+ * hop to track more streams.
+ */
+class PitchDetector
+{
+public:
+    /**
+     * @brief Constructor
+     * @param sampleRate Sample rate of the input in Hz
+     * @param channelCount Number of interleaved input channels
+     * @param settings Frequency range, hop and threshold
+     */
+    PitchDetector(int sampleRate, int channelCount, const PitchSettings &settings = PitchSettings());
+
+    /**
+     * @brief Analyse interleaved frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param estimates Receives one estimate per completed hop
+     */
+    void process(const float *samples, size_t frameCount, std::vector<PitchEstimate> &estimates);
+
+private:
+    // Estimate the pitch of the analysis window starting at the given sample
+    PitchEstimate analyseWindow(const float *window);
+
+    float sampleRate;
+    float threshold;
+    size_t minLag;
+    size_t maxLag;
+    size_t windowSize;
+    size_t hopSize;
+    std::vector<float> difference; // Difference function, then its cumulative mean normalization
+    MonoHistory mono;
+    uint64_t nextWindow; // Start of the next analysis window
+};
+
+/**
+ * @brief Stage publishing pitch estimates on a lock-free queue
+ *
+ * One estimate per hop, voiced or not. Read them with readEstimates() from any
+ * single thread.
+ */
+class PitchStage : public AudioStage
+{
+public:
+    /**
+     * @brief Constructor
+     * @param settings Frequency range, hop and threshold
+     */
+    explicit PitchStage(const PitchSettings &settings = PitchSettings());
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+
+    /**
+     * @brief Take queued estimates (single consumer)
+     * @param estimates Destination for the estimates
+     * @param maxCount Maximum number of estimates to read
+     * @return Number of estimates read
+     */
+    size_t readEstimates(PitchEstimate *estimates, size_t maxCount) noexcept;
+
+    /**
+     * @brief Get number of estimates lost because the queue was full
+     */
+    uint64_t getDroppedEstimates() const noexcept;
+
+private:
+    PitchSettings settings;
+    std::unique_ptr<PitchDetector> detector;
+    std::vector<PitchEstimate> found;
+    RingBuffer<PitchEstimate> estimates;
+    std::atomic<uint64_t> droppedEstimates;
+};
+
+} // namespace AudioCaptureX
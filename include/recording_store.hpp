@@ -0,0 +1,236 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief In-memory recording storage with background compression
+ *
+ * The capture callback fills fixed-size blocks taken from a preallocated pool
+ * and hands full blocks to a worker thread, which compresses them with the
+ * lossless sample codec and refills the pool. Blocks are decoded one at a time
+ * when the recording is read back, so only compressed data stays resident.
+ * With a memory budget the worker also moves the oldest blocks to a temporary
+ * file once the resident size exceeds it.
+ */
+class RecordingStore
+{
+public:
+    /**
+     * @brief Callback receiving decoded recording blocks in order
+     * @param samples Interleaved samples of the block
+     * @param frameCount Number of frames in the block
+     * @return true to continue, false to stop reading
+     */
+    using BlockReader = std::function<bool(const float *samples, uint64_t frameCount)>;
+
+    /**
+     * @brief Callback converting decoded samples on a worker thread
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @param output Receives frameCount frames of the converted format
+     */
+    using BlockTransform = std::function<void(const float *samples, uint64_t frameCount, uint8_t *output)>;
+
+    /**
+     * @brief Callback receiving converted chunks in order
+     * @param data Converted frames
+     * @param frameCount Number of frames
+     * @return true to continue, false to stop reading
+     */
+    using ChunkReader = std::function<bool(const uint8_t *data, uint64_t frameCount)>;
+
+    RecordingStore();
+
+    /**
+     * @brief Destructor - stops the worker thread
+     */
+    ~RecordingStore();
+
+    RecordingStore(const RecordingStore &) = delete;
+    RecordingStore &operator=(const RecordingStore &) = delete;
+
+    /**
+     * @brief Limit the memory held by the recording
+     *
+     * Blocks beyond the budget are spilled, oldest first, to an unnamed file in
+     * the system temporary directory (TMPDIR on POSIX systems) and read back
+     * transparently.
+     *
+     * @param bytes Maximum resident bytes, zero for no limit (default)
+     */
+    void setMemoryBudget(uint64_t bytes) noexcept;
+
+    /**
+     * @brief Discard any previous recording and start accepting audio
+     * @param channelCount Number of interleaved channels
+     * @param compress true to compress full blocks, false to keep them as float
+     */
+    void start(int channelCount, bool compress);
+
+    /**
+     * @brief Append interleaved frames (real-time safe, single producer)
+     * @param samples Interleaved float samples
+     * @param frameCount Number of frames
+     */
+    void append(const float *samples, long frameCount) noexcept;
+
+    /**
+     * @brief Append silent frames without storing samples (real-time safe, single producer)
+     * @param frameCount Number of frames
+     */
+    void appendSilence(uint64_t frameCount) noexcept;
+
+    /**
+     * @brief Store the partial block and wait until every block is compressed
+     *
+     * Must only be called once append() can no longer run.
+     */
+    void finish();
+
+    /**
+     * @brief Check if no frames were recorded
+     */
+    bool empty() const noexcept;
+
+    /**
+     * @brief Get number of recorded frames
+     */
+    uint64_t getFrameCount() const noexcept;
+
+    /**
+     * @brief Get number of frames dropped because the worker could not keep up
+     */
+    uint64_t getDroppedFrames() const noexcept;
+
+    /**
+     * @brief Get bytes of memory held by the recording, including empty blocks
+     */
+    uint64_t getResidentBytes() const noexcept;
+
+    /**
+     * @brief Get bytes of the recording moved to the spill file
+     */
+    uint64_t getSpilledBytes() const noexcept;
+
+    /**
+     * @brief Get size of the recording as float samples
+     */
+    uint64_t getRawBytes() const noexcept;
+
+    /**
+     * @brief Decode stored blocks in order (call after finish())
+     * @param reader Callback receiving each decoded block
+     * @return true if every block was decoded and accepted, false otherwise
+     */
+    bool read(const BlockReader &reader) const;
+
+    /**
+     * @brief Decode and convert stored blocks on several threads (call after finish())
+     *
+     * Consecutive blocks are grouped into chunks of 64k frames. Worker threads
+     * decode and convert whole chunks, a block at a time so the float samples
+     * stay in cache, while the calling thread hands finished chunks to the
+     * reader in order. At most two chunks per worker are in flight.
+     *
+     * @param frameBytes Size of a converted frame in bytes
+     * @param transform Conversion run on the worker threads
+     * @param reader Callback receiving each converted chunk on the calling thread
+     * @param threadCount Worker threads, zero for one per hardware thread
+     * @return true if every block was decoded and accepted, false otherwise
+     */
+    bool readParallel(size_t frameBytes, const BlockTransform &transform, const ChunkReader &reader,
+                      unsigned threadCount = 0) const;
+
+private:
+    // Samples waiting for the worker, null samples stand for a run of silence
+    struct PendingBlock
+    {
+        float *samples = nullptr;
+        uint64_t frameCount = 0;
+    };
+
+    struct Block
+    {
+        uint64_t frameCount = 0;
+        bool silent = false;                // Silence, no samples are stored
+        std::unique_ptr<float[]> samples;   // Uncompressed samples
+        std::vector<uint8_t> encoded;       // Compressed samples when samples is null
+        uint64_t spillOffset = 0;           // Position in the spill file
+        uint64_t spillSize = 0;             // Bytes in the spill file, zero while resident
+        bool spilledRaw = false;            // Spilled bytes are float samples rather than encoded
+    };
+
+    // Samples of a block that is not silent, decoded into decoded if compressed, null on failure
+    const float *loadBlock(const Block &block, float *decoded, std::vector<uint8_t> &spilled) const;
+
+    // Background thread compressing full blocks and refilling the pool
+    void workerThread();
+
+    // Move queued blocks into storage, returns false if nothing was queued
+    bool storePending();
+
+    // Keep the pool of empty blocks full
+    void refillPool();
+
+    // Move the oldest resident blocks to the spill file until within budget
+    void spillBlocks();
+
+    bool openSpillFile();
+
+    void stopWorker();
+
+    // Queue the partially filled block, if any (audio thread)
+    bool queueCurrentBlock() noexcept;
+
+    // Free every block and stored sample (worker must be stopped)
+    void release();
+
+    float *allocateBlock();
+    void freeBlock(float *block);
+    uint64_t blockBytes() const noexcept;
+
+    int channelCount;
+    bool compress;
+
+    // Audio thread state
+    float *currentBlock;
+    uint32_t currentFrames;
+
+    RingBuffer<PendingBlock> pending;
+    RingBuffer<float *> pool;
+
+    std::vector<Block> blocks;
+    std::vector<uint8_t> encodeBuffer;
+    mutable std::mutex blocksMutex;
+    mutable std::mutex spillReadMutex; // Parallel reads share the spill file position
+
+    // Worker state, blocks before firstResidentBlock live in the spill file
+    FILE *spillFile;
+    size_t firstResidentBlock;
+    bool spillFailed;
+#ifdef _WIN32
+    std::string spillPath; // Open files cannot be deleted on Windows
+#endif
+
+    std::thread workerThreadHandle;
+    std::atomic<bool> running;
+    std::atomic<uint64_t> frameCount;
+    std::atomic<uint64_t> residentBytes;
+    std::atomic<uint64_t> spilledBytes;
+    std::atomic<uint64_t> memoryBudget;
+    std::atomic<uint64_t> droppedFrames;
+};
+
+} // namespace AudioCaptureX
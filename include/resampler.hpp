@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Streaming sample rate converter for interleaved frames
+ *
+ * Polyphase Kaiser-windowed sinc filter for the exact ratio of two integer
+ * rates, with one filter phase per output position between two input frames.
+ * The cutoff is at 93% of the lower Nyquist frequency with about 90 dB of
+ * stopband rejection. Ratios needing more than 1024 phases use the nearest
+ * of 1024. Channels are filtered from planar history with SIMD dot products.
+ * Output is aligned with the input, the filter delay is compensated.
+ */
+class Resampler
+{
+public:
+    /**
+     * @brief Constructor
+     * @param inputRate Sample rate of the input in Hz
+     * @param outputRate Sample rate of the output in Hz
+     * @param channelCount Number of interleaved channels
+     */
+    Resampler(int inputRate, int outputRate, int channelCount);
+
+    /**
+     * @brief Convert interleaved frames
+     * @param samples Interleaved input samples
+     * @param frameCount Number of input frames
+     * @param output Receives the interleaved output frames that are complete, appended
+     */
+    void process(const float *samples, size_t frameCount, std::vector<float> &output);
+
+    /**
+     * @brief Complete the output after the last input
+     *
+     * Brings the total output to the input length at the output rate, rounded up.
+     *
+     * @param output Receives the remaining interleaved output frames, appended
+     */
+    void flush(std::vector<float> &output);
+
+    /**
+     * @brief Forget the input so far and start a new stream
+     */
+    void reset();
+
+private:
+    // Append output frames while the filter window is covered by the history
+    void produce(std::vector<float> &output, uint64_t maxFrames);
+
+    int channelCount;
+    uint64_t upFactor;   // Output rate over the common divisor, the phase denominator
+    uint64_t downFactor; // Input rate over the common divisor, the phase step per output frame
+    size_t phaseCount;
+    size_t tapCount;                 // Taps per phase, a multiple of 4
+    std::vector<float> coefficients; // tapCount per phase
+    std::vector<float> history;      // Planar input, historyCapacity frames per channel
+    size_t historyCapacity;
+    size_t historyFrames;
+    uint64_t phase; // Position between history frame 0 and 1 in units of 1/upFactor
+    uint64_t inputFrames;
+    uint64_t outputFrames;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Lock-free single producer, single consumer ring buffer
+ *
+ * One thread may write while another thread reads without locks, which makes it
+ * safe to feed from the audio callback. Capacity is rounded up to a power of two.
+ */
+template <typename T>
+class RingBuffer
+{
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Minimum number of elements the buffer can hold
+     */
+    explicit RingBuffer(size_t capacity = 0)
+    {
+        reset(capacity);
+    }
+
+    RingBuffer(const RingBuffer &) = delete;
+    RingBuffer &operator=(const RingBuffer &) = delete;
+
+    /**
+     * @brief Reallocate storage and discard any content (not thread-safe)
+     * @param capacity Minimum number of elements the buffer can hold
+     */
+    void reset(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+
+        buffer.reset(capacity > 0 ? new T[size]() : nullptr);
+        mask = capacity > 0 ? size - 1 : 0;
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get the buffer capacity in elements
+     */
+    size_t capacity() const noexcept
+    {
+        return buffer ? mask + 1 : 0;
+    }
+
+    /**
+     * @brief Number of elements ready to be read (consumer side)
+     */
+    size_t readAvailable() const noexcept
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of elements that can be written (producer side)
+     */
+    size_t writeAvailable() const noexcept
+    {
+        return capacity() - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+    }
+
+    /**
+     * @brief Write elements (producer side)
+     * @param data Elements to write
+     * @param count Number of elements
+     * @return Number of elements written, which may be less than count when full
+     */
+    size_t write(const T *data, size_t count) noexcept
+    {
+        size_t writePos = head.load(std::memory_order_relaxed);
+        count = std::min(count, capacity() - (writePos - tail.load(std::memory_order_acquire)));
+
+        size_t offset = writePos & mask;
+        size_t first = std::min(count, capacity() - offset);
+        std::copy(data, data + first, buffer.get() + offset);
+        std::copy(data + first, data + count, buffer.get());
+
+        head.store(writePos + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Read elements (consumer side)
+     * @param data Destination for the elements
+     * @param count Maximum number of elements to read
+     * @return Number of elements read
+     */
+    size_t read(T *data, size_t count) noexcept
+    {
+        size_t readPos = tail.load(std::memory_order_relaxed);
+        count = std::min(count, head.load(std::memory_order_acquire) - readPos);
+
+        size_t offset = readPos & mask;
+        size_t first = std::min(count, capacity() - offset);
+        std::copy(buffer.get() + offset, buffer.get() + offset + first, data);
+        std::copy(buffer.get(), buffer.get() + (count - first), data + first);
+
+        tail.store(readPos + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    std::unique_ptr<T[]> buffer;
+    size_t mask = 0;
+
+    // Producer and consumer indices live on separate cache lines
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Losslessly compress a block of interleaved float samples
+ *
+ * Blocks whose samples are exact multiples of 2^-15 or 2^-23 (audio that came
+ * from a 16 or 24-bit converter) are coded as integers with a fixed second
+ * order predictor and Rice-coded residuals, per channel. Anything else is
+ * stored verbatim, so decoding always reproduces the input bit for bit.
+ *
+ * @param samples Interleaved samples
+ * @param frameCount Number of frames
+ * @param channelCount Number of channels
+ * @param output Receives the encoded block (replaced)
+ */
+void encodeSampleBlock(const float *samples, size_t frameCount, int channelCount, std::vector<uint8_t> &output);
+
+/**
+ * @brief Decode a block produced by encodeSampleBlock
+ * @param data Encoded block
+ * @param size Encoded size in bytes
+ * @param frameCount Number of frames in the block
+ * @param channelCount Number of channels
+ * @param samples Destination for frameCount * channelCount interleaved samples
+ * @return true if the block was decoded, false if it is corrupt
+ */
+bool decodeSampleBlock(const uint8_t *data, size_t size, size_t frameCount, int channelCount, float *samples);
+
+} // namespace AudioCaptureX
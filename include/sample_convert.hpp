@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Sample formats supported for WAV output
+ */
+enum class WavSampleFormat
+{
+    Pcm16,   // 16-bit signed integer PCM
+    Pcm24,   // 24-bit signed integer PCM, packed little-endian
+    Float32, // 32-bit IEEE float
+};
+
+/**
+ * @brief Get the size in bytes of one sample in the given format
+ * @param format Sample format
+ * @return Number of bytes per sample
+ */
+int bytesPerSample(WavSampleFormat format) noexcept;
+
+/**
+ * @brief Get a human readable name for the given format
+ * @param format Sample format
+ * @return Format name (e.g. "24 bits PCM")
+ */
+const char *sampleFormatName(WavSampleFormat format) noexcept;
+
+/**
+ * @brief Convert float samples in [-1.0, 1.0] to 16-bit PCM
+ * @param input Source samples (values outside the range are clamped)
+ * @param output Destination buffer with room for sampleCount samples
+ * @param sampleCount Number of samples to convert
+ */
+void convertFloatToPcm16(const float *input, int16_t *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Convert float samples in [-1.0, 1.0] to packed 24-bit PCM
+ * @param input Source samples (values outside the range are clamped)
+ * @param output Destination buffer with room for sampleCount * 3 bytes
+ * @param sampleCount Number of samples to convert
+ */
+void convertFloatToPcm24(const float *input, uint8_t *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Convert float samples to the given output format
+ * @param input Source samples
+ * @param format Destination format
+ * @param output Destination buffer with room for sampleCount * bytesPerSample(format) bytes
+ * @param sampleCount Number of samples to convert
+ */
+void convertSamples(const float *input, WavSampleFormat format, void *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Convert 16-bit PCM samples to float in [-1.0, 1.0)
+ * @param input Source samples
+ * @param output Destination buffer with room for sampleCount samples
+ * @param sampleCount Number of samples to convert
+ */
+void convertPcm16ToFloat(const int16_t *input, float *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Convert packed 24-bit PCM samples to float in [-1.0, 1.0)
+ * @param input Source samples, 3 bytes little-endian each
+ * @param output Destination buffer with room for sampleCount samples
+ * @param sampleCount Number of samples to convert
+ */
+void convertPcm24ToFloat(const uint8_t *input, float *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Convert samples of the given format to float
+ * @param input Source samples
+ * @param format Source format
+ * @param output Destination buffer with room for sampleCount samples
+ * @param sampleCount Number of samples to convert
+ */
+void convertToFloat(const void *input, WavSampleFormat format, float *output, size_t sampleCount) noexcept;
+
+/**
+ * @brief Copy a subset of the channels of interleaved frames
+ * @param input Interleaved source frames
+ * @param inputChannels Channels per source frame
+ * @param channels Source channel of each destination channel
+ * @param outputChannels Channels per destination frame
+ * @param output Destination buffer with room for frameCount * outputChannels samples
+ * @param frameCount Number of frames
+ */
+void selectChannels(const float *input, int inputChannels, const int *channels, int outputChannels, float *output,
+                    size_t frameCount) noexcept;
+
+} // namespace AudioCaptureX
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "ring_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Hands captured audio and runs of silence from the capture callback to a consumer thread
+ *
+ * Samples go through a lock-free ring and silence through a queue of markers
+ * tagged with the ring position they belong at, so a long gap costs one
+ * marker instead of a ring full of zeros. WavFileSink and StageRunner both
+ * drain their audio through one of these.
+ */
+class SampleQueue
+{
+public:
+    SampleQueue();
+
+    SampleQueue(const SampleQueue &) = delete;
+    SampleQueue &operator=(const SampleQueue &) = delete;
+
+    /**
+     * @brief Reallocate storage and discard any content (not thread-safe)
+     * @param frameCapacity Frames the ring can hold
+     * @param channelCount Number of interleaved channels
+     */
+    void reset(size_t frameCapacity, int channelCount);
+
+    /**
+     * @brief Queue interleaved frames (producer side, real-time safe)
+     * @param samples Interleaved float samples
+     * @param frameCount Number of frames
+     * @return true if the frames were queued, false if the ring was too full to take them all
+     */
+    bool push(const float *samples, long frameCount) noexcept;
+
+    /**
+     * @brief Queue silent frames without copying samples (producer side, real-time safe)
+     * @param frameCount Number of frames
+     * @return true if the silence was queued, false if the marker queue was full
+     */
+    bool pushSilence(uint64_t frameCount) noexcept;
+
+    /**
+     * @brief Hand everything queued to the consumer until running is cleared (consumer side)
+     *
+     * Blocks of at most chunkFrames frames are passed to consume in queue order,
+     * with runs of silence passed as zeroed blocks. Everything queued before
+     * running was cleared is consumed before this returns.
+     *
+     * @param running Flag cleared by the owner to stop draining
+     * @param chunkFrames Maximum frames per block
+     * @param consume Called with (const float *samples, size_t frameCount, bool silence)
+     * @param poll Called once per iteration, also while the queue is empty
+     */
+    template <typename Consume, typename Poll>
+    void drain(const std::atomic<bool> &running, size_t chunkFrames, Consume &&consume, Poll &&poll);
+
+private:
+    // Run of silence starting at a sample position of the ring stream
+    struct SilenceMarker
+    {
+        uint64_t samplePosition = 0;
+        uint64_t frameCount = 0;
+    };
+
+    RingBuffer<float> ring;
+    RingBuffer<SilenceMarker> silenceMarkers;
+    uint64_t samplesPushed;
+    int channelCount;
+};
+
+template <typename Consume, typename Poll>
+void SampleQueue::drain(const std::atomic<bool> &running, size_t chunkFrames, Consume &&consume, Poll &&poll)
+{
+    std::vector<float> chunk(chunkFrames * channelCount);
+
+    uint64_t samplesRead = 0;
+    SilenceMarker marker;
+    bool hasMarker = false;
+
+    while (true)
+    {
+        poll();
+
+        // Check the stop flag before reading so everything queued before it was cleared is consumed.
+        // Samples are checked before markers, a marker is always queued before the samples after it.
+        bool stopping = !running.load();
+        size_t available = ring.readAvailable();
+
+        if (!hasMarker)
+        {
+            hasMarker = silenceMarkers.read(&marker, 1) == 1;
+        }
+
+        if (hasMarker && marker.samplePosition == samplesRead)
+        {
+            hasMarker = false;
+            std::fill(chunk.begin(), chunk.end(), 0.0f);
+
+            for (uint64_t done = 0; done < marker.frameCount;)
+            {
+                size_t frames = static_cast<size_t>(std::min<uint64_t>(chunkFrames, marker.frameCount - done));
+                consume(static_cast<const float *>(chunk.data()), frames, true);
+                done += frames;
+            }
+
+            continue;
+        }
+
+        if (available == 0)
+        {
+            if (stopping && !hasMarker)
+            {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        // Stop at the next run of silence
+        size_t limit = chunk.size();
+        if (hasMarker)
+        {
+            limit = static_cast<size_t>(std::min<uint64_t>(limit, marker.samplePosition - samplesRead));
+        }
+
+        size_t samples = ring.read(chunk.data(), std::min(available, limit));
+        samplesRead += samples;
+        consume(static_cast<const float *>(chunk.data()), samples / channelCount, false);
+    }
+}
+
+} // namespace AudioCaptureX
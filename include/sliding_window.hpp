@@ -0,0 +1,212 @@
+#pragma once
+
+#include "audio_stage.hpp"
+#include "mirrored_buffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Sliding window configuration
+ */
+struct WindowSettings
+{
+    double windowSeconds = 1.0;  // Length of each window
+    double strideSeconds = 0.1;  // Time between the starts of two windows
+    double historySeconds = 1.0; // Audio kept beyond one window, for consumers that fall behind
+    bool mixToMono = true;       // Average the channels, otherwise windows hold interleaved frames
+};
+
+/**
+ * @brief Consecutive frames read in place from a SlidingWindow
+ */
+struct SampleWindow
+{
+    const float *data = nullptr; // frameCount * channelCount samples, null if the frames are not available
+    uint64_t firstFrame = 0;     // Index of the first frame since the window was reset
+    size_t frameCount = 0;
+    int channelCount = 0;
+    uint64_t generation = 0; // Reset of the ring the view was taken after
+};
+
+/**
+ * @brief Lock-free ring of recent audio read as contiguous windows
+ *
+ * One producer, such as an AudioDataCallback, writes blocks while any number
+ * of consumers read fixed-length windows at a fixed stride, for example 1 s
+ * every 100 ms for a keyword spotter. The ring lives in a MirroredBuffer, so
+ * every window is contiguous in place and is never assembled by copying.
+ * Window k covers the frames [k * stride, k * stride + window). As with
+ * FeatureRing, the producer never waits: consumers check isValid() after
+ * using a view to detect that it was overwritten meanwhile.
+ *
+ * reset() may run on the producer thread while consumers read. It keeps the
+ * storage when the rounded size is unchanged, and every reset starts a new
+ * generation that views from before it fail isValid() against. Storage of
+ * another size is kept as well and reused when the stream returns to that
+ * size, so the memory of a view stays mapped for the lifetime of the ring.
+ */
+class SlidingWindow
+{
+public:
+    /**
+     * @brief Constructor
+     * @param pool Pool the ring storage is taken from and returned to, null to allocate it directly
+     */
+    explicit SlidingWindow(std::shared_ptr<MirroredBufferPool> pool = nullptr);
+
+    /**
+     * @brief Destructor - returns the storage to the pool
+     */
+    ~SlidingWindow();
+
+    SlidingWindow(const SlidingWindow &) = delete;
+    SlidingWindow &operator=(const SlidingWindow &) = delete;
+
+    /**
+     * @brief Size the ring for a stream and discard any audio (producer side)
+     * @param sampleRate Sample rate in Hz
+     * @param channelCount Number of interleaved input channels
+     * @param settings Window length, stride and history
+     * @return true if the ring was allocated, false otherwise
+     */
+    bool reset(int sampleRate, int channelCount, const WindowSettings &settings = WindowSettings());
+
+    /**
+     * @brief Append interleaved frames (producer side, real-time safe)
+     * @param samples Interleaved samples with the channel count given to reset()
+     * @param frameCount Number of frames
+     */
+    void write(const float *samples, size_t frameCount) noexcept;
+
+    /**
+     * @brief Get number of frames written since the ring was reset
+     */
+    uint64_t getFrameCount() const noexcept;
+
+    /**
+     * @brief Get number of complete windows written since the ring was reset
+     */
+    uint64_t getWindowCount() const noexcept;
+
+    /**
+     * @brief View a window in place
+     * @param index Index of the window, below getWindowCount()
+     * @return View of the window, empty if it is not complete yet or already overwritten
+     */
+    SampleWindow getWindow(uint64_t index) const noexcept;
+
+    /**
+     * @brief View written frames in place
+     * @param firstFrame Index of the first frame
+     * @param frameCount Number of frames, at most getCapacityFrames()
+     * @return View of the frames, empty if any of them is not written yet or already overwritten
+     */
+    SampleWindow getFrames(uint64_t firstFrame, size_t frameCount) const noexcept;
+
+    /**
+     * @brief View the most recent frames in place
+     * @param frameCount Number of frames, at most getCapacityFrames()
+     * @return View of the last frameCount frames, empty if fewer were written
+     */
+    SampleWindow getLatest(size_t frameCount) const noexcept;
+
+    /**
+     * @brief Check that the producer has not overwritten a view's frames since it was taken
+     * @param view View returned by getWindow(), getFrames() or getLatest()
+     */
+    bool isValid(const SampleWindow &view) const noexcept;
+
+    /**
+     * @brief Get number of frames per window
+     */
+    size_t getWindowFrames() const noexcept;
+
+    /**
+     * @brief Get number of frames between the starts of two windows
+     */
+    size_t getStrideFrames() const noexcept;
+
+    /**
+     * @brief Get the longest view in frames
+     */
+    size_t getCapacityFrames() const noexcept;
+
+    /**
+     * @brief Get number of channels in the views
+     */
+    int getChannelCount() const noexcept;
+
+private:
+    // Session parameters, changed by reset() only
+    struct Layout
+    {
+        float *ring = nullptr;
+        size_t ringSamples = 0;    // Samples in one copy of the ring
+        size_t maxViewSamples = 0; // Longest view, leaving room for the block being written
+        int inputChannels = 0;
+        int outputChannels = 0;
+        size_t windowFrames = 0;
+        size_t strideFrames = 0;
+        uint64_t start = 0; // Sample position of the first frame of the session
+    };
+
+    // Append output samples, reserving their space before overwriting the oldest ones
+    void append(const float *samples, size_t sampleCount) noexcept;
+
+    // Copy the layout as one consistent snapshot, returns its generation (consumer side)
+    uint64_t readLayout(Layout &copy) const noexcept;
+
+    // Publish a new layout under the generation sequence lock (producer side)
+    void publishLayout(const Layout &next) noexcept;
+
+    std::shared_ptr<MirroredBufferPool> pool;
+    std::unique_ptr<MirroredBuffer> buffer;
+    std::vector<std::unique_ptr<MirroredBuffer>> retired; // Replaced storage, one per size, kept for older views
+    Layout layout;
+
+    // Written by the producer only, read by every consumer
+    alignas(64) std::atomic<uint64_t> generation; // Odd while reset() changes the layout
+    alignas(64) std::atomic<uint64_t> written;    // Samples readable, counted across resets
+    alignas(64) std::atomic<uint64_t> reserved;   // Samples readable or being overwritten
+};
+
+/**
+ * @brief Stage keeping the recent audio of a capture as sliding windows
+ *
+ * Windows are read from getWindows() on any thread. The stage runs on the
+ * stage thread; for the lowest latency a SlidingWindow can instead be fed
+ * straight from an AudioDataCallback. Its storage is taken from the pool at
+ * the first session, kept across sessions while consumers keep reading, and
+ * returned to the pool when the stage is destroyed.
+ */
+class WindowStage : public AudioStage
+{
+public:
+    /**
+     * @brief Constructor
+     * @param settings Window length, stride and history
+     * @param pool Pool the ring storage is taken from, null to allocate it directly
+     */
+    explicit WindowStage(const WindowSettings &settings = WindowSettings(),
+                         std::shared_ptr<MirroredBufferPool> pool = nullptr);
+
+    bool prepare(int sampleRate, int channelCount, const std::string &recordingFile) override;
+    void process(const float *samples, size_t frameCount) override;
+
+    /**
+     * @brief Get the ring the audio is written to
+     */
+    const SlidingWindow &getWindows() const noexcept;
+
+private:
+    WindowSettings settings;
+    SlidingWindow windows;
+};
+
+} // namespace AudioCaptureX
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "sample_queue.hpp"
+#include "wav_writer.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Streams captured audio to a WAV file while recording
+ *
+ * The capture callback pushes samples into a SampleQueue and a background
+ * thread converts and writes them, so long recordings never have
+ * to be held in memory and the audio thread never touches the disk.
+ */
+class WavFileSink
+{
+public:
+    WavFileSink();
+
+    /**
+     * @brief Destructor - closes the file if still open
+     */
+    ~WavFileSink();
+
+    WavFileSink(const WavFileSink &) = delete;
+    WavFileSink &operator=(const WavFileSink &) = delete;
+
+    /**
+     * @brief Set how often the writer thread checkpoints the file (applies on open)
+     *
+     * Each checkpoint syncs the written audio to the storage device and rewrites
+     * the header sizes, so a crash loses at most one interval of audio.
+     *
+     * @param interval Time between checkpoints, zero to only write the header on close
+     */
+    void setCheckpointInterval(std::chrono::milliseconds interval);
+
+    /**
+     * @brief Create the file and start the writer thread
+     * @param filename Output file path
+     * @param format Output layout
+     * @param backend File backend to use (stdio if null)
+     * @return true if the sink is ready to receive audio, false otherwise
+     */
+    bool open(const std::string &filename, const WavFormat &format, std::unique_ptr<FileBackend> backend = nullptr);
+
+    /**
+     * @brief Queue interleaved frames for writing (real-time safe)
+     * @param samples Interleaved float samples
+     * @param frameCount Number of frames
+     * @return true if the frames were queued, false if they were dropped
+     */
+    bool push(const float *samples, long frameCount) noexcept;
+
+    /**
+     * @brief Queue silent frames for writing without copying samples (real-time safe)
+     * @param frameCount Number of frames
+     * @return true if the silence was queued, false if it was dropped
+     */
+    bool pushSilence(uint64_t frameCount) noexcept;
+
+    /**
+     * @brief Set the LIST INFO entries written when the file is closed
+     * @param info Entries with four character ids
+     */
+    void setInfo(const std::vector<WavInfoEntry> &info);
+
+    /**
+     * @brief Set the cue points written when the file is closed
+     * @param cues Cue points in any order
+     */
+    void setCues(const std::vector<WavCue> &cues);
+
+    /**
+     * @brief Write all queued audio, finalize the file and stop the writer thread
+     * @return true if the file was written completely, false otherwise
+     */
+    bool close();
+
+    /**
+     * @brief Check if the sink is accepting audio
+     */
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Get output file path
+     */
+    const std::string &getFilename() const noexcept;
+
+    /**
+     * @brief Get the output layout (container reflects RF64 promotion after close)
+     */
+    const WavFormat &getFormat() const noexcept;
+
+    /**
+     * @brief Get number of frames written to the file
+     */
+    uint64_t getFramesWritten() const noexcept;
+
+    /**
+     * @brief Get number of frames dropped because the writer could not keep up
+     */
+    uint64_t getDroppedFrames() const noexcept;
+
+    /**
+     * @brief Get number of sample bytes written to the file
+     */
+    uint64_t getBytesWritten() const noexcept;
+
+    /**
+     * @brief Get sustained write throughput, measured over the time spent writing
+     * @return Throughput in MB/s, or 0 if nothing was written yet
+     */
+    double getWriteThroughput() const noexcept;
+
+private:
+    // Background thread draining the queue into the writer
+    void writerThread();
+
+    WavWriter writer;
+    SampleQueue queue;
+    std::string filename;
+    int channelCount;
+    std::chrono::milliseconds checkpointInterval;
+    std::vector<WavInfoEntry> info; // Handed to the writer once its thread has stopped
+    std::vector<WavCue> cues;
+
+    std::thread writerThreadHandle;
+    std::atomic<bool> running;
+    std::atomic<bool> writeFailed;
+    std::atomic<uint64_t> framesWritten;
+    std::atomic<uint64_t> droppedFrames;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<int64_t> writeNanoseconds;
+};
+
+} // namespace AudioCaptureX
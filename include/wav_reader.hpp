@@ -0,0 +1,137 @@
+#pragma once
+
+#include "mapped_file.hpp"
+#include "wav_writer.hpp"
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Random access WAV reader working directly on a memory mapping
+ *
+ * Reads RIFF, RF64 and Wave64 files with 16-bit or packed 24-bit PCM or
+ * 32-bit float samples, the formats WavWriter produces. The header is parsed
+ * with dr_wav, after which every access is pointer arithmetic into the
+ * mapping: seeking is O(1) and reads never allocate. Samples in the format a
+ * caller wants are returned as spans into the mapping, other formats are
+ * converted while reading. The positional methods are const and may be
+ * called from several threads at once.
+ */
+class WavReader
+{
+public:
+    WavReader();
+
+    WavReader(const WavReader &) = delete;
+    WavReader &operator=(const WavReader &) = delete;
+
+    /**
+     * @brief Map a WAV file and parse its header
+     * @param filename File path
+     * @return true if the file holds a supported sample format, false otherwise
+     */
+    bool open(const std::string &filename);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close() noexcept;
+
+    /**
+     * @brief Check if a file is open
+     */
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Get the layout of the audio in the file
+     */
+    const WavFormat &getFormat() const noexcept;
+
+    /**
+     * @brief Get number of frames in the file
+     *
+     * A data chunk cut short by an interrupted recording ends with the file.
+     */
+    uint64_t getFrameCount() const noexcept;
+
+    /**
+     * @brief Get frames as stored in the file
+     * @param firstFrame First frame
+     * @param frameCount Number of frames, clamped to the end of the file
+     * @return Bytes of the frames in the mapping
+     */
+    std::span<const uint8_t> getBytes(uint64_t firstFrame, uint64_t frameCount) const noexcept;
+
+    /**
+     * @brief Get 16-bit PCM samples without copying
+     * @param firstFrame First frame
+     * @param frameCount Number of frames, clamped to the end of the file
+     * @return Interleaved samples in the mapping, empty if the file is not 16-bit PCM
+     */
+    std::span<const int16_t> getPcm16(uint64_t firstFrame, uint64_t frameCount) const noexcept;
+
+    /**
+     * @brief Get float samples without copying
+     * @param firstFrame First frame
+     * @param frameCount Number of frames, clamped to the end of the file
+     * @return Interleaved samples in the mapping, empty if the file is not float or its data is not 4-byte aligned
+     */
+    std::span<const float> getFloat(uint64_t firstFrame, uint64_t frameCount) const noexcept;
+
+    /**
+     * @brief Read frames as float, converting them if the file is PCM
+     * @param firstFrame First frame
+     * @param output Destination with room for frameCount * channelCount samples
+     * @param frameCount Number of frames
+     * @return Number of frames read, less than frameCount at the end of the file
+     */
+    uint64_t readFrames(uint64_t firstFrame, float *output, uint64_t frameCount) const noexcept;
+
+    /**
+     * @brief Move the read position used by the sequential readFrames()
+     * @param frame Frame to continue reading from
+     * @return true if the frame is within the file, false otherwise
+     */
+    bool seek(uint64_t frame) noexcept;
+
+    /**
+     * @brief Get the read position of the sequential readFrames()
+     */
+    uint64_t tell() const noexcept;
+
+    /**
+     * @brief Read frames as float from the read position and advance it
+     * @param output Destination with room for frameCount * channelCount samples
+     * @param frameCount Number of frames
+     * @return Number of frames read, less than frameCount at the end of the file
+     */
+    uint64_t readFrames(float *output, uint64_t frameCount) noexcept;
+
+    /**
+     * @brief Tell the system the file is read front to back, for more read-ahead
+     */
+    void adviseSequential() noexcept;
+
+    /**
+     * @brief Drop already read frames from the resident set, see MappedFile::release()
+     * @param firstFrame First frame
+     * @param frameCount Number of frames
+     */
+    void release(uint64_t firstFrame, uint64_t frameCount) noexcept;
+
+private:
+    // Frames available from firstFrame, at most frameCount
+    uint64_t clampFrames(uint64_t firstFrame, uint64_t frameCount) const noexcept;
+
+    MappedFile file;
+    WavFormat format;
+    uint64_t dataOffset; // Start of the sample data in the file
+    uint64_t frameCount;
+    uint64_t frameBytes;
+    uint64_t position;
+};
+
+} // namespace AudioCaptureX
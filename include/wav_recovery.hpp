@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief Repair the header of a WAV file whose recording was interrupted
+ *
+ * Supports RIFF, RF64 and Wave64 files. The data chunk is extended to cover
+ * every complete frame up to the end of the file, a trailing partial frame is
+ * cut off and the container sizes are rewritten. RIFF files written by this
+ * library are promoted to RF64 when the recovered data exceeds 4 GB. Files
+ * whose header already matches their size are left untouched.
+ *
+ * @param filename Path of the WAV file to repair in place
+ * @return true if the file is valid after the call, false otherwise
+ */
+bool recoverWavFile(const std::string &filename);
+
+} // namespace AudioCaptureX
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "file_backend.hpp"
+#include "sample_convert.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+/**
+ * @brief WAV container types
+ */
+enum class WavContainer
+{
+    Riff, // Standard RIFF WAV, promoted in place to RF64 if the file exceeds 4 GB
+    Rf64, // EBU RF64 with 64-bit sizes in the ds64 chunk
+    W64,  // Sony Wave64
+};
+
+/**
+ * @brief Layout of the audio in a WAV file
+ */
+struct WavFormat
+{
+    WavSampleFormat sampleFormat = WavSampleFormat::Pcm16;
+    WavContainer container = WavContainer::Riff;
+    int channelCount = 0;
+    int sampleRate = 0;
+};
+
+/**
+ * @brief Entry of the LIST INFO chunk describing a recording
+ */
+struct WavInfoEntry
+{
+    std::string id;   // Four character code, e.g. "ICMT" for comments
+    std::string text; // Value, written NUL terminated
+};
+
+/**
+ * @brief Labelled position in a recording, written as a cue point
+ */
+struct WavCue
+{
+    uint64_t framePosition = 0; // Frame of the recording the cue points at
+    std::string label;          // Written as the cue's label in the LIST adtl chunk
+};
+
+/**
+ * @brief Get a human readable name for the given container
+ * @param container WAV container
+ * @return Container name (e.g. "RF64")
+ */
+const char *containerName(WavContainer container) noexcept;
+
+/**
+ * @brief Sequential WAV writer with RIFF, RF64 and Wave64 support
+ *
+ * The header has a fixed size for the lifetime of the file: RIFF files reserve a
+ * JUNK chunk where the RF64 ds64 chunk goes, so a recording that grows past the
+ * 4 GB RIFF limit is promoted to RF64 by rewriting the header only.
+ */
+class WavWriter
+{
+public:
+    WavWriter();
+
+    /**
+     * @brief Destructor - finalizes the file if still open
+     */
+    ~WavWriter();
+
+    WavWriter(const WavWriter &) = delete;
+    WavWriter &operator=(const WavWriter &) = delete;
+
+    /**
+     * @brief Create the file and write a placeholder header
+     * @param filename Output file path
+     * @param format Output layout
+     * @param backend File backend to use (stdio if null)
+     * @return true if the file was created, false otherwise
+     */
+    bool open(const std::string &filename, const WavFormat &format, std::unique_ptr<FileBackend> backend = nullptr);
+
+    /**
+     * @brief Convert and append interleaved float frames
+     * @param samples Interleaved samples
+     * @param frameCount Number of frames
+     * @return true if all frames were written, false otherwise
+     */
+    bool writeFrames(const float *samples, uint64_t frameCount);
+
+    /**
+     * @brief Append frames already converted to the output sample format
+     * @param data Interleaved samples in the output format
+     * @param frameCount Number of frames
+     * @return true if all frames were written, false otherwise
+     */
+    bool writeConverted(const void *data, uint64_t frameCount);
+
+    /**
+     * @brief Set the LIST INFO entries appended after the audio by finalize()
+     *
+     * Entries with the same id are joined into one, as readers only show one.
+     * Wave64 files carry no INFO list and ignore the entries.
+     *
+     * @param info Entries with four character ids
+     */
+    void setInfo(const std::vector<WavInfoEntry> &info);
+
+    /**
+     * @brief Set the cue points appended after the audio by finalize()
+     *
+     * Cues are written as a cue chunk with their labels in a LIST adtl chunk.
+     * Cues past the last frame written are moved onto it, cue positions are
+     * 32-bit so cues past 2^32 frames are skipped, and Wave64 files ignore the
+     * cues.
+     *
+     * @param cues Cue points in any order
+     */
+    void setCues(const std::vector<WavCue> &cues);
+
+    /**
+     * @brief Make written frames durable and update the header to cover them
+     *
+     * After a checkpoint the file is a valid WAV file containing every frame
+     * written so far, even if the process dies before finalize().
+     *
+     * @return true if the checkpoint reached the storage device, false otherwise
+     */
+    bool checkpoint();
+
+    /**
+     * @brief Write the final header and close the file
+     * @return true if the file is complete and valid, false otherwise
+     */
+    bool finalize();
+
+    /**
+     * @brief Check if a file is open for writing
+     */
+    bool isOpen() const noexcept;
+
+    /**
+     * @brief Get number of frames written so far
+     */
+    uint64_t getFramesWritten() const noexcept;
+
+    /**
+     * @brief Get the output layout (container reflects RF64 promotion after finalize)
+     */
+    const WavFormat &getFormat() const noexcept;
+
+private:
+    // Build the header for the current data size
+    std::vector<uint8_t> buildHeader() const;
+
+    // Build the chunks written after the sample data
+    std::vector<uint8_t> buildTrailer() const;
+
+    // Size of the header preceding the sample data
+    uint64_t headerSize() const noexcept;
+
+    // Promote RIFF output to RF64 once it no longer fits 32-bit sizes
+    void promoteContainer(uint64_t padding);
+
+    std::unique_ptr<FileBackend> backend;
+    WavFormat format;
+    uint64_t framesWritten;
+    uint64_t dataBytes;
+    uint64_t trailerBytes; // Chunks after the sample data, known at finalize()
+    std::vector<WavInfoEntry> info;
+    std::vector<WavCue> cues;
+    std::vector<uint8_t> convertBuffer;
+};
+
+} // namespace AudioCaptureX
@@ -12,6 +12,53 @@
 namespace AudioCaptureX
 {
 
+namespace
+{
+
+// Stream layout requested from the device
+const uint32_t kStreamSampleRate = 48000;
+const uint32_t kStreamChannels = 2;
+
+// Buffer size unless monitoring or adaptive latency asks for the device minimum
+const uint32_t kDefaultLatencyFrames = 4096;
+
+// Adaptive latency limits and timing
+const uint32_t kMaxLatencyFrames = 8192;
+const std::chrono::milliseconds kLatencyCheckInterval(500);
+const std::chrono::seconds kLatencyStepDownDelay(10);
+const std::chrono::seconds kMaxLatencyStepDownDelay(300);
+
+// Time between attempts to reopen a failed device
+const std::chrono::milliseconds kRecoveryRetryInterval(250);
+
+// Time between checks for the selected device while on the fallback, device notifications wake the check earlier
+const std::chrono::seconds kFallbackCheckInterval(2);
+
+// Gap events waiting to be reported
+const size_t kGapEventCapacity = 64;
+
+// Frames generated per write when interpolating a gap
+const size_t kGapFillChunkFrames = 1024;
+
+// Longer gaps are filled with silence even in interpolation mode (about 100 ms)
+const uint64_t kMaxInterpolatedFrames = 4800;
+
+// Device clock deviation from the monotonic clock that is followed without a gap
+const double kClockTolerance = 100e-6;
+
+// Stream position is compared with the clock over at least this long
+const std::chrono::seconds kClockMeasureInterval(10);
+
+// Markers kept per capture session
+const uint32_t kMaxMarkers = 4096;
+
+int64_t steadyNanoseconds(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
 AudioCapture::AudioCapture(AudioDataCallback callback)
     : context(nullptr)
     , stream(nullptr)
@@ -23,7 +70,54 @@ AudioCapture::AudioCapture(AudioDataCallback callback)
     , channelCount(0)
     , inputDeviceIndex(-1)
     , initialized(false)
+    , recordedAudio(std::make_unique<RecordingStore>())
+    , recordingCompression(true)
     , outputFile("captured-audio.wav")
+    , outputFormat(WavSampleFormat::Pcm16)
+    , outputContainer(WavContainer::Riff)
+    , streamingOutput(false)
+    , checkpointInterval(0)
+    , fileBackendType(FileBackendType::Stdio)
+    , deviceRecovery(false)
+    , onFallbackDevice(false)
+    , devicesChanged(false)
+    , streamLost(false)
+    , streamRecovered(false)
+    , streamLostTime(0)
+    , failovers(0)
+    , lastFailoverTime(0)
+    , maxFailoverTime(0)
+    , gapFill(GapFill::None)
+    , gapEvents(kGapEventCapacity)
+    , timelineStart(0)
+    , timelineFrames(0)
+    , timelineBaseline(0.0)
+    , deviceClockRatio(1.0)
+    , clockReferencePosition(0)
+    , clockReferenceTime(0)
+    , gaps(0)
+    , gapFrames(0)
+    , adaptiveLatency(false)
+    , minLatencyFrames(0)
+    , restartingStream(false)
+    , streamRestarted(false)
+    , restartCallbackTime(0)
+    , lastCallbackTime(0)
+    , latencyFrames(0)
+    , lowestLatencyFrames(0)
+    , highestLatencyFrames(0)
+    , latencyChanges(0)
+    , xruns(0)
+    , monitoring(false)
+    , monitorGain(1.0f)
+    , stageRunner(std::make_unique<StageRunner>())
+    , levelStats(std::make_unique<LevelStats>())
+    , markers(std::make_unique<MarkerSlot[]>(kMaxMarkers))
+    , markerCount(0)
+    , recordingPosition(0)
+    , positionSequence(0)
+    , positionFrames(0)
+    , positionTime(0)
 {
     if (!initializeCubeb())
     {
@@ -48,10 +142,66 @@ AudioCapture::AudioCapture(AudioCapture &&other) noexcept
     , sampleRate(other.sampleRate.load())
     , channelCount(other.channelCount.load())
     , currentDeviceName(std::move(other.currentDeviceName))
+    , selectedDeviceId(std::move(other.selectedDeviceId))
     , inputDeviceIndex(other.inputDeviceIndex)
     , initialized(other.initialized)
     , recordedAudio(std::move(other.recordedAudio))
+    , recordingCompression(other.recordingCompression)
     , outputFile(std::move(other.outputFile))
+    , outputFormat(other.outputFormat)
+    , outputContainer(other.outputContainer)
+    , streamingOutput(other.streamingOutput)
+    , checkpointInterval(other.checkpointInterval)
+    , fileBackendType(other.fileBackendType)
+    , fileSink(std::move(other.fileSink))
+    , deviceRecovery(other.deviceRecovery)
+    , fallbackDeviceId(std::move(other.fallbackDeviceId))
+    , onFallbackDevice(other.onFallbackDevice.load())
+    , devicesChanged(other.devicesChanged.load())
+    , gapCallback(std::move(other.gapCallback))
+    , streamLost(other.streamLost.load())
+    , streamRecovered(other.streamRecovered.load())
+    , streamLostTime(other.streamLostTime.load())
+    , failovers(other.failovers.load())
+    , lastFailoverTime(other.lastFailoverTime.load())
+    , maxFailoverTime(other.maxFailoverTime.load())
+    , gapFill(other.gapFill)
+    , gapEvents(kGapEventCapacity)
+    , gapFillBuffer(std::move(other.gapFillBuffer))
+    , lastFrame(std::move(other.lastFrame))
+    , timelineStart(other.timelineStart)
+    , timelineFrames(other.timelineFrames)
+    , timelineBaseline(other.timelineBaseline)
+    , deviceClockRatio(other.deviceClockRatio.load())
+    , clockReferencePosition(other.clockReferencePosition)
+    , clockReferenceTime(other.clockReferenceTime)
+    , gaps(other.gaps.load())
+    , gapFrames(other.gapFrames.load())
+    , adaptiveLatency(other.adaptiveLatency)
+    , minLatencyFrames(other.minLatencyFrames)
+    , restartingStream(other.restartingStream.load())
+    , streamRestarted(other.streamRestarted.load())
+    , restartCallbackTime(other.restartCallbackTime)
+    , lastCallbackTime(other.lastCallbackTime.load())
+    , latencyFrames(other.latencyFrames.load())
+    , lowestLatencyFrames(other.lowestLatencyFrames.load())
+    , highestLatencyFrames(other.highestLatencyFrames.load())
+    , latencyChanges(other.latencyChanges.load())
+    , xruns(other.xruns.load())
+    , monitoring(other.monitoring)
+    , monitorGain(other.monitorGain.load())
+    , monitorChannelMap(std::move(other.monitorChannelMap))
+    , monitorRouting(std::move(other.monitorRouting))
+    , tap(std::move(other.tap))
+    , stages(std::move(other.stages))
+    , stageRunner(std::move(other.stageRunner))
+    , levelStats(std::move(other.levelStats))
+    , markers(std::move(other.markers))
+    , markerCount(other.markerCount.load())
+    , recordingPosition(other.recordingPosition)
+    , positionSequence(other.positionSequence.load())
+    , positionFrames(other.positionFrames.load())
+    , positionTime(other.positionTime.load())
 {
     other.context = nullptr;
     other.stream = nullptr;
@@ -76,10 +226,65 @@ AudioCapture &AudioCapture::operator=(AudioCapture &&other) noexcept
         sampleRate = other.sampleRate.load();
         channelCount = other.channelCount.load();
         currentDeviceName = std::move(other.currentDeviceName);
+        selectedDeviceId = std::move(other.selectedDeviceId);
         inputDeviceIndex = other.inputDeviceIndex;
         initialized = other.initialized;
         recordedAudio = std::move(other.recordedAudio);
+        recordingCompression = other.recordingCompression;
         outputFile = std::move(other.outputFile);
+        outputFormat = other.outputFormat;
+        outputContainer = other.outputContainer;
+        streamingOutput = other.streamingOutput;
+        checkpointInterval = other.checkpointInterval;
+        fileBackendType = other.fileBackendType;
+        fileSink = std::move(other.fileSink);
+        deviceRecovery = other.deviceRecovery;
+        fallbackDeviceId = std::move(other.fallbackDeviceId);
+        onFallbackDevice = other.onFallbackDevice.load();
+        devicesChanged = other.devicesChanged.load();
+        gapCallback = std::move(other.gapCallback);
+        streamLost = other.streamLost.load();
+        streamRecovered = other.streamRecovered.load();
+        streamLostTime = other.streamLostTime.load();
+        failovers = other.failovers.load();
+        lastFailoverTime = other.lastFailoverTime.load();
+        maxFailoverTime = other.maxFailoverTime.load();
+        gapFill = other.gapFill;
+        gapFillBuffer = std::move(other.gapFillBuffer);
+        lastFrame = std::move(other.lastFrame);
+        timelineStart = other.timelineStart;
+        timelineFrames = other.timelineFrames;
+        timelineBaseline = other.timelineBaseline;
+        deviceClockRatio = other.deviceClockRatio.load();
+        clockReferencePosition = other.clockReferencePosition;
+        clockReferenceTime = other.clockReferenceTime;
+        gaps = other.gaps.load();
+        gapFrames = other.gapFrames.load();
+        adaptiveLatency = other.adaptiveLatency;
+        minLatencyFrames = other.minLatencyFrames;
+        restartingStream = other.restartingStream.load();
+        streamRestarted = other.streamRestarted.load();
+        restartCallbackTime = other.restartCallbackTime;
+        lastCallbackTime = other.lastCallbackTime.load();
+        latencyFrames = other.latencyFrames.load();
+        lowestLatencyFrames = other.lowestLatencyFrames.load();
+        highestLatencyFrames = other.highestLatencyFrames.load();
+        latencyChanges = other.latencyChanges.load();
+        xruns = other.xruns.load();
+        monitoring = other.monitoring;
+        monitorGain = other.monitorGain.load();
+        monitorChannelMap = std::move(other.monitorChannelMap);
+        monitorRouting = std::move(other.monitorRouting);
+        tap = std::move(other.tap);
+        stages = std::move(other.stages);
+        stageRunner = std::move(other.stageRunner);
+        levelStats = std::move(other.levelStats);
+        markers = std::move(other.markers);
+        markerCount = other.markerCount.load();
+        recordingPosition = other.recordingPosition;
+        positionSequence = other.positionSequence.load();
+        positionFrames = other.positionFrames.load();
+        positionTime = other.positionTime.load();
 
         other.context = nullptr;
         other.stream = nullptr;
@@ -121,6 +326,7 @@ bool AudioCapture::initializeCubeb()
     // Use first available device as default
     inputDeviceId = collection.device[0].devid;
     currentDeviceName = collection.device[0].friendly_name ? collection.device[0].friendly_name : "Unknown Device";
+    selectedDeviceId = collection.device[0].device_id ? collection.device[0].device_id : "";
     inputDeviceIndex = 0;
 
     cubeb_device_collection_destroy(context, &collection);
@@ -178,50 +384,160 @@ bool AudioCapture::startCapture(int deviceIndex)
         return false;
     }
 
-    // Set up stream parameters
-    cubeb_stream_params input_params;
-    input_params.format = CUBEB_SAMPLE_FLOAT32LE;
-    input_params.rate = 48000; // Default sample rate
-    input_params.channels = 2; // Default stereo
-    input_params.layout = CUBEB_LAYOUT_UNDEFINED;
-    input_params.prefs = CUBEB_STREAM_PREF_NONE;
+    // Release the stream of the previous session
+    if (stream)
+    {
+        cubeb_stream_destroy(stream);
+        stream = nullptr;
+    }
+
+    // Monitoring plays the input through a duplex stream
+    if (monitoring)
+    {
+        monitorRouting = monitorChannelMap;
+        if (monitorRouting.empty())
+        {
+            for (uint32_t channel = 0; channel < kStreamChannels; ++channel)
+            {
+                monitorRouting.push_back(static_cast<int>(channel));
+            }
+        }
+
+        for (int channel : monitorRouting)
+        {
+            if (channel >= static_cast<int>(kStreamChannels))
+            {
+                std::cerr << "Invalid monitor channel map: input has " << kStreamChannels << " channels" << std::endl;
+                return false;
+            }
+        }
+    }
 
-    uint32_t latency_frames = 4096; // Default latency
+    uint32_t latency_frames = kDefaultLatencyFrames;
 
-    int r = cubeb_stream_init(context, &stream, "AudioCaptureX Input",
-                             inputDeviceId, &input_params, nullptr, nullptr,
-                             latency_frames, dataCallback, stateCallback, this);
+    // Monitoring wants the shortest round trip, adaptive latency starts there
+    if (monitoring || adaptiveLatency)
+    {
+        cubeb_stream_params params;
+        params.format = CUBEB_SAMPLE_FLOAT32LE;
+        params.rate = kStreamSampleRate;
+        params.channels = kStreamChannels;
+        params.layout = CUBEB_LAYOUT_UNDEFINED;
+        params.prefs = CUBEB_STREAM_PREF_NONE;
+
+        uint32_t min_latency = 0;
+        if (cubeb_get_min_latency(context, &params, &min_latency) == CUBEB_OK && min_latency > 0)
+        {
+            latency_frames = min_latency;
+        }
+    }
 
-    if (r != CUBEB_OK)
+    minLatencyFrames = latency_frames;
+
+    if (!openStream(latency_frames, &stream))
     {
-        std::cerr << "Error creating stream: " << r << std::endl;
         return false;
     }
 
-    // Get actual stream parameters
-    cubeb_stream_get_latency(stream, &latency_frames);
-    sampleRate = input_params.rate;
-    channelCount = input_params.channels;
+    sampleRate = kStreamSampleRate;
+    channelCount = kStreamChannels;
+
+    if (streamingOutput)
+    {
+        fileSink = std::make_unique<WavFileSink>();
+        fileSink->setCheckpointInterval(checkpointInterval);
+        if (!fileSink->open(getWavFilename(), getWavFormat(), createFileBackend(fileBackendType)))
+        {
+            std::cerr << "Failed to open output file: " << getWavFilename() << std::endl;
+            fileSink.reset();
+            cubeb_stream_destroy(stream);
+            stream = nullptr;
+            return false;
+        }
+    }
+    else
+    {
+        // Clear previous recording
+        recordedAudio->start(channelCount, recordingCompression);
+    }
 
-    // Clear previous recording
-    recordedAudio.clear();
+    if (!stages.empty())
+    {
+        stageRunner->start(stages, sampleRate, channelCount, getWavFilename());
+    }
 
     // Start the stream
-    r = cubeb_stream_start(stream);
+    lastCallbackTime = 0;
+    streamLost = false;
+    streamRecovered = false;
+    streamRestarted = false;
+    onFallbackDevice = false;
+    devicesChanged = false;
+    failovers = 0;
+    lastFailoverTime = 0;
+    maxFailoverTime = 0;
+
+    // Buffers used by the audio thread when filling gaps
+    gapFillBuffer.assign(kGapFillChunkFrames * kStreamChannels, 0.0f);
+    lastFrame.assign(kStreamChannels, 0.0f);
+    timelineStart = 0;
+    timelineFrames = 0;
+    timelineBaseline = 0.0;
+    deviceClockRatio = 1.0;
+    clockReferenceTime = 0;
+    gaps = 0;
+    gapFrames = 0;
+    levelStats->reset(channelCount);
+    for (uint32_t index = 0; index < std::min(markerCount.load(), kMaxMarkers); ++index)
+    {
+        markers[index].ready = false;
+        markers[index].cue = WavCue();
+    }
+    markerCount = 0;
+    recordingPosition = 0;
+    positionFrames = 0;
+    positionTime = 0;
+    xruns = 0;
+    latencyChanges = 0;
+    lowestLatencyFrames = 0;
+    highestLatencyFrames = 0;
+    setLatency(latency_frames);
+
+    int r = cubeb_stream_start(stream);
     if (r != CUBEB_OK)
     {
         std::cerr << "Error starting stream: " << r << std::endl;
         cubeb_stream_destroy(stream);
         stream = nullptr;
+        stageRunner->stop();
+        closeFileSink();
+        recordedAudio->finish();
         return false;
     }
 
     shouldStop = false;
     capturing = true;
 
+    // Device notifications tell the background thread when the selected device may be back
+    if (deviceRecovery && !fallbackDeviceId.empty())
+    {
+        cubeb_register_device_collection_changed(context, CUBEB_DEVICE_TYPE_INPUT, deviceCollectionChanged, this);
+    }
+
+    captureThreadHandle = std::thread(&AudioCapture::captureThread, this);
+
     std::cout << "Audio capture started on device: " << currentDeviceName << std::endl;
     std::cout << "Sample rate: " << sampleRate << " Hz, Channels: " << channelCount << std::endl;
 
+    if (monitoring)
+    {
+        uint32_t input_latency = 0;
+        uint32_t output_latency = 0;
+        cubeb_stream_get_input_latency(stream, &input_latency);
+        cubeb_stream_get_latency(stream, &output_latency);
+        std::cout << "Monitoring round-trip latency: " << (input_latency + output_latency) * 1000.0 / sampleRate << " ms" << std::endl;
+    }
+
     return true;
 }
 
@@ -229,13 +545,26 @@ bool AudioCapture::stopCapture()
 {
     if (!capturing.load())
     {
+        // Stream may have stopped on its own
+        stopCaptureThread();
+        if (stageRunner)
+        {
+            stageRunner->stop();
+        }
+
+        closeFileSink();
+        if (recordedAudio)
+        {
+            recordedAudio->finish();
+        }
+
         return true; // Already stopped
     }
 
     std::cout << "Stopping audio capture..." << std::endl;
 
-    // Set stop flag first
-    shouldStop = true;
+    // Set stop flag first, the latency supervisor must not restart the stream anymore
+    stopCaptureThread();
 
     // Stop the stream
     if (stream)
@@ -247,6 +576,12 @@ bool AudioCapture::stopCapture()
         }
     }
 
+    // No more callbacks, finish the stages first so their summaries reach the file
+    stageRunner->stop();
+    closeFileSink();
+    recordedAudio->finish();
+    reportGaps();
+
     // Set capturing to false after everything is stopped
     capturing = false;
 
@@ -254,239 +589,1294 @@ bool AudioCapture::stopCapture()
     return true;
 }
 
-bool AudioCapture::isCapturing() const noexcept
-{
-    return capturing.load();
-}
-
-void AudioCapture::setCallback(AudioDataCallback callback)
-{
-    std::lock_guard<std::mutex> lock(mutex);
-    this->callback = std::move(callback);
-}
-
-int AudioCapture::getSampleRate() const noexcept
-{
-    return sampleRate.load();
-}
-
-int AudioCapture::getChannelCount() const noexcept
+bool AudioCapture::openStream(uint32_t latencyFrames, cubeb_stream **newStream)
 {
-    return channelCount.load();
-}
+    // Set up stream parameters
+    cubeb_stream_params input_params;
+    input_params.format = CUBEB_SAMPLE_FLOAT32LE;
+    input_params.rate = kStreamSampleRate;
+    input_params.channels = kStreamChannels;
+    input_params.layout = CUBEB_LAYOUT_UNDEFINED;
+    input_params.prefs = CUBEB_STREAM_PREF_NONE;
 
-std::vector<std::string> AudioCapture::getAvailableInputDevices() const
-{
-    std::vector<std::string> devices;
+    cubeb_stream_params output_params = input_params;
+    output_params.channels = static_cast<uint32_t>(monitorRouting.size());
 
-    if (!initialized || !context)
-    {
-        return devices;
-    }
+    int r = cubeb_stream_init(context, newStream, "AudioCaptureX Input",
+                             inputDeviceId, &input_params, nullptr, monitoring ? &output_params : nullptr,
+                             latencyFrames, dataCallback, stateCallback, this);
 
-    cubeb_device_collection collection;
-    int r = cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection);
     if (r != CUBEB_OK)
     {
-        std::cerr << "Error enumerating devices: " << r << std::endl;
-        return devices;
-    }
-
-    for (size_t i = 0; i < collection.count; ++i)
-    {
-                const char* name = collection.device[i].friendly_name ?
-                          collection.device[i].friendly_name :
-                          collection.device[i].device_id;
-        if (name)
-        {
-            devices.emplace_back(name);
-        }
+        std::cerr << "Error creating stream: " << r << std::endl;
+        *newStream = nullptr;
+        return false;
     }
 
-    cubeb_device_collection_destroy(context, &collection);
-    return devices;
+    return true;
 }
 
-bool AudioCapture::setInputDevice(int deviceIndex)
+bool AudioCapture::replaceStream(uint32_t latencyFrames, const std::string &marker)
 {
-    if (!initialized || !context)
+    // Open the replacement first so the switch only costs starting it
+    cubeb_stream *newStream = nullptr;
+    if (!openStream(latencyFrames, &newStream))
     {
-        std::cerr << "Audio system not initialized" << std::endl;
         return false;
     }
 
-    if (capturing.load())
-    {
-        std::cerr << "Cannot change device while capturing" << std::endl;
-        return false;
-    }
+    // The old stream reports STOPPED, which must not end the capture
+    restartingStream = true;
+    cubeb_stream_stop(stream);
+    cubeb_stream *oldStream = stream;
+    stream = newStream;
+
+    // The first callback of the new stream measures the frames lost since the last one of the old stream
+    restartCallbackTime = lastCallbackTime.load();
+    streamRestarted = true;
+    appendMarker(positionFrames.load(), marker);
+    lastCallbackTime = 0;
+    clockReferenceTime = 0;
+    setLatency(latencyFrames);
+
+    int r = cubeb_stream_start(stream);
+    restartingStream = false;
+    cubeb_stream_destroy(oldStream);
 
-    cubeb_device_collection collection;
-    int r = cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection);
     if (r != CUBEB_OK)
     {
-        std::cerr << "Error enumerating devices: " << r << std::endl;
+        std::cerr << "Error restarting stream: " << r << std::endl;
+        capturing = false;
         return false;
     }
 
-    if (deviceIndex < 0 || deviceIndex >= static_cast<int>(collection.count))
+    return true;
+}
+
+bool AudioCapture::restartStream(uint32_t latencyFrames)
+{
+    if (!replaceStream(latencyFrames, "Stream restart"))
     {
-        std::cerr << "Invalid device index: " << deviceIndex << std::endl;
-        cubeb_device_collection_destroy(context, &collection);
         return false;
     }
 
-    // Set new device
-    inputDeviceId = collection.device[deviceIndex].devid;
-    inputDeviceIndex = deviceIndex;
-    currentDeviceName = collection.device[deviceIndex].friendly_name ?
-                       collection.device[deviceIndex].friendly_name :
-                       collection.device[deviceIndex].device_id;
-
-    cubeb_device_collection_destroy(context, &collection);
+    latencyChanges++;
 
-    std::cout << "Input device set to: " << currentDeviceName << std::endl;
+    std::cout << "Capture latency set to " << latencyFrames << " frames ("
+              << latencyFrames * 1000.0 / sampleRate.load() << " ms)" << std::endl;
     return true;
 }
 
-std::string AudioCapture::getCurrentInputDevice() const
+void AudioCapture::setLatency(uint32_t frames) noexcept
 {
-    return currentDeviceName;
-}
+    latencyFrames = frames;
 
-long AudioCapture::dataCallback(cubeb_stream *stream, void *user_ptr, const void *input_buffer, void *output_buffer, long nframes)
-{
-    AudioCapture *capture = static_cast<AudioCapture *>(user_ptr);
-    if (!capture || !input_buffer)
+    if (tap)
     {
-        return 0;
+        tap->latencyFrames = frames;
     }
 
-    // Convert input buffer to float vector
-    const float *input_samples = static_cast<const float *>(input_buffer);
-    int sample_count = nframes * capture->channelCount.load();
-
-    std::vector<float> audio_data(input_samples, input_samples + sample_count);
-
-    // Store for recording
-    capture->recordedAudio.insert(capture->recordedAudio.end(),
-                                 reinterpret_cast<const char*>(input_samples),
-                                 reinterpret_cast<const char*>(input_samples) + sample_count * sizeof(float));
-
-    // Call user callback
-    capture->onAudioData(audio_data, nframes);
+    if (lowestLatencyFrames.load() == 0 || frames < lowestLatencyFrames.load())
+    {
+        lowestLatencyFrames = frames;
+    }
 
-    return nframes;
+    if (frames > highestLatencyFrames.load())
+    {
+        highestLatencyFrames = frames;
+    }
 }
 
-void AudioCapture::stateCallback(cubeb_stream *stream, void *user_ptr, cubeb_state state)
+void AudioCapture::updateCallbackTiming(long frameCount, std::chrono::steady_clock::time_point start) noexcept
 {
-    AudioCapture *capture = static_cast<AudioCapture *>(user_ptr);
-    if (!capture)
+    int64_t startTime = steadyNanoseconds(start);
+    int64_t previousTime = lastCallbackTime.exchange(startTime, std::memory_order_relaxed);
+    int64_t rate = sampleRate.load(std::memory_order_relaxed);
+    if (rate <= 0)
     {
         return;
     }
 
-    switch (state)
+    // The device buffer holds one latency period, a longer wait overflowed it
+    int64_t bufferTime = (static_cast<int64_t>(latencyFrames.load(std::memory_order_relaxed)) + frameCount) * 1000000000 / rate;
+    bool late = previousTime > 0 && startTime - previousTime > bufferTime;
+
+    // Using most of the period leaves no headroom for scheduling jitter
+    int64_t periodTime = static_cast<int64_t>(frameCount) * 1000000000 / rate;
+    bool overloaded = steadyNanoseconds(std::chrono::steady_clock::now()) - startTime > periodTime * 3 / 4;
+
+    if (late || overloaded)
     {
-        case CUBEB_STATE_STARTED:
-            std::cout << "Stream started" << std::endl;
-            break;
-        case CUBEB_STATE_STOPPED:
-            std::cout << "Stream stopped" << std::endl;
-            capture->capturing = false;
-            break;
-        case CUBEB_STATE_DRAINED:
-            std::cout << "Stream drained" << std::endl;
-            break;
-        case CUBEB_STATE_ERROR:
-            std::cerr << "Stream error" << std::endl;
-            capture->capturing = false;
-            break;
-        default:
-            break;
+        xruns.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void AudioCapture::onAudioData(const std::vector<float> &audioData, int frameCount)
+void AudioCapture::captureThread()
 {
-    std::lock_guard<std::mutex> lock(mutex);
-    if (callback)
+    uint64_t lastXruns = xruns.load();
+    auto calmSince = std::chrono::steady_clock::now();
+    auto lastStepDown = std::chrono::steady_clock::time_point();
+    auto lastDeviceCheck = std::chrono::steady_clock::time_point();
+    std::chrono::steady_clock::duration stepDownDelay = kLatencyStepDownDelay;
+
+    std::unique_lock<std::mutex> lock(captureThreadMutex);
+    while (true)
     {
-        callback(audioData, frameCount, sampleRate.load(), channelCount.load());
-    }
-}
+        bool lost = streamLost.load();
+        std::chrono::steady_clock::duration interval = lost ? std::chrono::steady_clock::duration(kRecoveryRetryInterval) : kLatencyCheckInterval;
+
+        // A stream error or a device notification wakes the thread right away
+        if (cv.wait_for(lock, interval, [this, lost] { return shouldStop.load() || streamLost.load() != lost || devicesChanged.load(); }) &&
+            shouldStop.load())
+        {
+            break;
+        }
 
+        bool changed = devicesChanged.exchange(false);
+        if (!capturing.load())
+        {
+            continue;
+        }
 
-void AudioCapture::setOutputFile(const std::string &filename)
-{
-    outputFile = filename;
+        lock.unlock();
+
+        reportGaps();
+
+        if (streamLost.load())
+        {
+            if (recoverStream())
+            {
+                calmSince = std::chrono::steady_clock::now();
+                lastXruns = xruns.load();
+            }
+        }
+        else
+        {
+            updateDeviceClockRatio();
+
+            // Back to the selected device once it reappears, polled as well since not every backend notifies
+            auto now = std::chrono::steady_clock::now();
+            if (onFallbackDevice.load() && (changed || now - lastDeviceCheck >= kFallbackCheckInterval))
+            {
+                lastDeviceCheck = now;
+                if (returnToSelectedDevice())
+                {
+                    calmSince = now;
+                    lastXruns = xruns.load();
+                }
+            }
+        }
+
+        if (!streamLost.load() && adaptiveLatency)
+        {
+            uint64_t count = xruns.load();
+            bool glitched = count != lastXruns;
+            lastXruns = count;
+
+            uint32_t latency = latencyFrames.load();
+            auto now = std::chrono::steady_clock::now();
+
+            if (glitched)
+            {
+                calmSince = now;
+
+                if (latency < kMaxLatencyFrames)
+                {
+                    // A size that glitches soon after stepping down gets retried less often
+                    if (now - lastStepDown < stepDownDelay)
+                    {
+                        stepDownDelay = std::min<std::chrono::steady_clock::duration>(stepDownDelay * 2, kMaxLatencyStepDownDelay);
+                    }
+
+                    restartStream(std::min(latency * 2, kMaxLatencyFrames));
+                    lastXruns = xruns.load();
+                }
+            }
+            else if (latency > minLatencyFrames && now - calmSince >= stepDownDelay)
+            {
+                calmSince = now;
+                lastStepDown = now;
+                restartStream(std::max(latency / 2, minLatencyFrames));
+                lastXruns = xruns.load();
+            }
+        }
+
+        lock.lock();
+    }
 }
 
-bool AudioCapture::saveRecordedAudio() const
+bool AudioCapture::recoverStream()
 {
-    if (recordedAudio.empty())
+    // The failed stream delivers no more callbacks
+    if (stream)
+    {
+        cubeb_stream_destroy(stream);
+        stream = nullptr;
+    }
+
+    // Prefer the selected device when it comes back, otherwise use the fallback
+    cubeb_devid devid = nullptr;
+    std::string name;
+    int index = -1;
+    bool fallback = !findInputDevice(selectedDeviceId, devid, name, index);
+    if (fallback && (fallbackDeviceId.empty() || !findInputDevice(fallbackDeviceId, devid, name, index)))
     {
-        std::cerr << "No audio data to save" << std::endl;
         return false;
     }
 
-    // Create WAV filename
-    std::string wavFile = outputFile;
-    if (wavFile.substr(wavFile.find_last_of(".") + 1) != "wav")
     {
-        wavFile = wavFile.substr(0, wavFile.find_last_of(".")) + ".wav";
+        std::lock_guard<std::mutex> lock(mutex);
+        inputDeviceId = devid;
+        inputDeviceIndex = index;
+        currentDeviceName = name;
     }
 
-    // Convert float32 to 16-bit PCM
-    int numChannels = channelCount.load();
-    int sampleRate = this->sampleRate.load();
-    int numSamples = recordedAudio.size() / sizeof(float);
+    if (!openStream(latencyFrames.load(), &stream))
+    {
+        return false;
+    }
 
-    std::vector<int16_t> pcmData;
-    pcmData.reserve(numSamples);
+    // Cleared before starting so an error of the new stream is not lost
+    lastCallbackTime = 0;
+    streamLost = false;
 
-    const float *floatData = reinterpret_cast<const float *>(recordedAudio.data());
-    for (int i = 0; i < numSamples; ++i)
+    if (cubeb_stream_start(stream) != CUBEB_OK)
     {
-        // Clamp to [-1.0, 1.0] and convert to 16-bit PCM
-        float sample = std::max(-1.0f, std::min(1.0f, floatData[i]));
-        int16_t pcmSample = static_cast<int16_t>(sample * 32767.0f);
-        pcmData.push_back(pcmSample);
+        streamLost = true;
+        cubeb_stream_destroy(stream);
+        stream = nullptr;
+        return false;
     }
 
-    // Use drwav to write WAV file
-    drwav_data_format format;
-    format.container = drwav_container_riff;
-    format.format = DR_WAVE_FORMAT_PCM;
-    format.channels = numChannels;
-    format.sampleRate = sampleRate;
-    format.bitsPerSample = 16;
+    int64_t outage = steadyNanoseconds(std::chrono::steady_clock::now()) - streamLostTime.load();
+    failovers++;
+    lastFailoverTime = outage;
+    maxFailoverTime = std::max(maxFailoverTime.load(), outage);
+
+    // The audio thread sees the outage as a gap and tags it as a device loss
+    onFallbackDevice = fallback;
+    streamRecovered = true;
+    clockReferenceTime = 0;
+
+    std::cout << "Capture resumed on device: " << name << " after " << outage / 1e6 << " ms" << std::endl;
 
-    drwav wav;
-    if (!drwav_init_file_write(&wav, wavFile.c_str(), &format, NULL))
+    return true;
+}
+
+bool AudioCapture::returnToSelectedDevice()
+{
+    cubeb_devid devid = nullptr;
+    std::string name;
+    int index = -1;
+    if (!findInputDevice(selectedDeviceId, devid, name, index))
     {
-        std::cerr << "Failed to initialize WAV file: " << wavFile << std::endl;
         return false;
     }
 
-    // Write PCM data
-    drwav_uint64 framesWritten = drwav_write_pcm_frames(&wav, pcmData.size() / numChannels, pcmData.data());
-    drwav_uninit(&wav);
+    cubeb_devid fallbackId = nullptr;
+    int fallbackIndex = -1;
+    std::string fallbackName;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        fallbackId = inputDeviceId;
+        fallbackIndex = inputDeviceIndex;
+        fallbackName = currentDeviceName;
+        inputDeviceId = devid;
+        inputDeviceIndex = index;
+        currentDeviceName = name;
+    }
 
-    if (framesWritten == 0)
+    // The fallback keeps running if the selected device cannot be opened, it is tried again later
+    if (!replaceStream(latencyFrames.load(), "Device switch: " + name))
     {
-        std::cerr << "Failed to write audio data" << std::endl;
+        std::lock_guard<std::mutex> lock(mutex);
+        inputDeviceId = fallbackId;
+        inputDeviceIndex = fallbackIndex;
+        currentDeviceName = fallbackName;
         return false;
     }
 
-    std::cout << "WAV audio saved to: " << wavFile << std::endl;
-    std::cout << "Recorded " << framesWritten << " frames (" << pcmData.size() << " samples)" << std::endl;
-    std::cout << "Format: " << numChannels << " channels, "
-              << sampleRate << " Hz, 16 bits PCM" << std::endl;
-
+    onFallbackDevice = false;
+    std::cout << "Capture returned to device: " << name << std::endl;
     return true;
 }
 
-} // namespace AudioCaptureX
+bool AudioCapture::findInputDevice(const std::string &deviceId, cubeb_devid &devid, std::string &name, int &index) const
+{
+    if (deviceId.empty())
+    {
+        return false;
+    }
+
+    cubeb_device_collection collection;
+    if (cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection) != CUBEB_OK)
+    {
+        return false;
+    }
 
+    bool found = false;
+    for (size_t i = 0; i < collection.count && !found; ++i)
+    {
+        const cubeb_device_info &device = collection.device[i];
+        if (device.device_id && deviceId == device.device_id && device.state == CUBEB_DEVICE_STATE_ENABLED)
+        {
+            devid = device.devid;
+            name = device.friendly_name ? device.friendly_name : device.device_id;
+            index = static_cast<int>(i);
+            found = true;
+        }
+    }
+
+    cubeb_device_collection_destroy(context, &collection);
+    return found;
+}
+
+void AudioCapture::reportGaps()
+{
+    GapCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        callback = gapCallback;
+    }
+
+    GapEvent gap;
+    while (gapEvents.read(&gap, 1) == 1)
+    {
+        const char *reason = gap.reason == GapReason::DeviceLost      ? " (device lost)"
+                             : gap.reason == GapReason::StreamRestart ? " (stream restart)"
+                                                                      : " (discontinuity)";
+        std::cerr << "Gap of " << gap.frameCount << " frames at frame " << gap.framePosition << reason << std::endl;
+
+        if (callback)
+        {
+            callback(gap);
+        }
+    }
+}
+
+uint64_t AudioCapture::detectGap(long frameCount, std::chrono::steady_clock::time_point now) noexcept
+{
+    int64_t time = steadyNanoseconds(now);
+    double rate = sampleRate.load(std::memory_order_relaxed) * deviceClockRatio.load(std::memory_order_relaxed);
+
+    if (timelineStart == 0)
+    {
+        timelineStart = time;
+        timelineFrames = 0;
+        timelineBaseline = 0.0;
+    }
+
+    // After a restart the frames missing are the time since the old stream's last callback less the
+    // frames this one brings. The timeline is then moved to the new stream, whose buffer size differs.
+    if (streamRestarted.exchange(false) && restartCallbackTime > 0 && rate > 0)
+    {
+        double lost = (time - restartCallbackTime) * rate / 1e9 - frameCount;
+        uint64_t missing = lost >= 1.0 ? static_cast<uint64_t>(lost + 0.5) : 0;
+        if (missing > 0)
+        {
+            GapEvent gap;
+            gap.reason = GapReason::StreamRestart;
+            gap.framePosition = timelineFrames;
+            gap.frameCount = missing;
+            gapEvents.write(&gap, 1);
+
+            gaps.fetch_add(1, std::memory_order_relaxed);
+            gapFrames.fetch_add(missing, std::memory_order_relaxed);
+        }
+
+        timelineFrames += missing;
+        timelineStart = time - static_cast<int64_t>((timelineFrames + timelineBaseline) * 1e9 / rate);
+        timelineFrames += frameCount;
+        return missing;
+    }
+
+    // Frames the clock says should have arrived before this callback. The
+    // baseline is the lowest deficit seen, i.e. the buffering offset, and may
+    // creep up slowly to follow a device clock within tolerance.
+    double deficit = (time - timelineStart) * rate / 1e9 - static_cast<double>(timelineFrames);
+    timelineBaseline = std::min(timelineBaseline + frameCount * kClockTolerance, deficit);
+
+    double excess = deficit - timelineBaseline;
+    double threshold = static_cast<double>(latencyFrames.load(std::memory_order_relaxed)) + frameCount;
+    uint64_t missing = excess > threshold ? static_cast<uint64_t>(excess) : 0;
+
+    if (missing > 0)
+    {
+        GapEvent gap;
+        gap.reason = streamRecovered.exchange(false) ? GapReason::DeviceLost : GapReason::Discontinuity;
+        gap.framePosition = timelineFrames;
+        gap.frameCount = missing;
+        gapEvents.write(&gap, 1);
+
+        gaps.fetch_add(1, std::memory_order_relaxed);
+        gapFrames.fetch_add(missing, std::memory_order_relaxed);
+    }
+
+    // Unfilled gaps still advance the timeline so they are reported only once
+    timelineFrames += missing + frameCount;
+    return missing;
+}
+
+void AudioCapture::fillGap(const float *nextFrame, uint64_t frameCount) noexcept
+{
+    if (gapFill == GapFill::None)
+    {
+        return;
+    }
+
+    // Long gaps are queued as silence, the writer threads expand them
+    if (gapFill == GapFill::Silence || frameCount > kMaxInterpolatedFrames)
+    {
+        storeSilence(frameCount);
+        return;
+    }
+
+    size_t channels = lastFrame.size();
+    for (uint64_t done = 0; done < frameCount;)
+    {
+        size_t frames = static_cast<size_t>(std::min<uint64_t>(kGapFillChunkFrames, frameCount - done));
+
+        for (size_t i = 0; i < frames; ++i)
+        {
+            float position = static_cast<float>(done + i + 1) / static_cast<float>(frameCount + 1);
+            for (size_t channel = 0; channel < channels; ++channel)
+            {
+                gapFillBuffer[i * channels + channel] = lastFrame[channel] + (nextFrame[channel] - lastFrame[channel]) * position;
+            }
+        }
+
+        storeFrames(gapFillBuffer.data(), static_cast<long>(frames));
+        done += frames;
+    }
+}
+
+void AudioCapture::storeFrames(const float *samples, long frameCount) noexcept
+{
+    if (fileSink)
+    {
+        fileSink->push(samples, frameCount);
+    }
+    else
+    {
+        recordedAudio->append(samples, frameCount);
+    }
+
+    stageRunner->push(samples, frameCount);
+    recordingPosition += static_cast<uint64_t>(frameCount);
+}
+
+void AudioCapture::storeSilence(uint64_t frameCount) noexcept
+{
+    if (fileSink)
+    {
+        fileSink->pushSilence(frameCount);
+    }
+    else
+    {
+        recordedAudio->appendSilence(frameCount);
+    }
+
+    stageRunner->pushSilence(frameCount);
+    recordingPosition += frameCount;
+}
+
+void AudioCapture::publishPosition(std::chrono::steady_clock::time_point callbackStart) noexcept
+{
+    // Sequence lock, readers retry while the sequence is odd or has changed
+    uint32_t sequence = positionSequence.load(std::memory_order_relaxed);
+    positionSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    positionFrames.store(recordingPosition, std::memory_order_relaxed);
+    positionTime.store(steadyNanoseconds(callbackStart), std::memory_order_relaxed);
+    positionSequence.store(sequence + 2, std::memory_order_release);
+}
+
+void AudioCapture::updateDeviceClockRatio()
+{
+    uint64_t position = 0;
+    if (!stream || cubeb_stream_get_position(stream, &position) != CUBEB_OK || position == 0)
+    {
+        return;
+    }
+
+    int64_t time = steadyNanoseconds(std::chrono::steady_clock::now());
+    if (clockReferenceTime == 0)
+    {
+        clockReferencePosition = position;
+        clockReferenceTime = time;
+        return;
+    }
+
+    int64_t elapsed = time - clockReferenceTime;
+    if (elapsed < std::chrono::duration_cast<std::chrono::nanoseconds>(kClockMeasureInterval).count() || position <= clockReferencePosition)
+    {
+        return;
+    }
+
+    // Device frames per monotonic clock frame, implausible values are ignored
+    double ratio = (position - clockReferencePosition) / (elapsed * sampleRate.load() / 1e9);
+    if (ratio > 0.99 && ratio < 1.01)
+    {
+        deviceClockRatio = ratio;
+    }
+}
+
+void AudioCapture::stopCaptureThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(captureThreadMutex);
+        shouldStop = true;
+    }
+
+    cv.notify_all();
+
+    if (captureThreadHandle.joinable())
+    {
+        captureThreadHandle.join();
+    }
+
+    if (context && deviceRecovery && !fallbackDeviceId.empty())
+    {
+        cubeb_register_device_collection_changed(context, CUBEB_DEVICE_TYPE_INPUT, nullptr, nullptr);
+    }
+}
+
+bool AudioCapture::isCapturing() const noexcept
+{
+    return capturing.load();
+}
+
+void AudioCapture::setCallback(AudioDataCallback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    this->callback = std::move(callback);
+}
+
+int AudioCapture::getSampleRate() const noexcept
+{
+    return sampleRate.load();
+}
+
+int AudioCapture::getStreamSampleRate() const noexcept
+{
+    return static_cast<int>(kStreamSampleRate);
+}
+
+int AudioCapture::getChannelCount() const noexcept
+{
+    return channelCount.load();
+}
+
+std::vector<std::string> AudioCapture::getAvailableInputDevices() const
+{
+    std::vector<std::string> devices;
+
+    if (!initialized || !context)
+    {
+        return devices;
+    }
+
+    cubeb_device_collection collection;
+    int r = cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection);
+    if (r != CUBEB_OK)
+    {
+        std::cerr << "Error enumerating devices: " << r << std::endl;
+        return devices;
+    }
+
+    for (size_t i = 0; i < collection.count; ++i)
+    {
+                const char* name = collection.device[i].friendly_name ?
+                          collection.device[i].friendly_name :
+                          collection.device[i].device_id;
+        if (name)
+        {
+            devices.emplace_back(name);
+        }
+    }
+
+    cubeb_device_collection_destroy(context, &collection);
+    return devices;
+}
+
+bool AudioCapture::setInputDevice(int deviceIndex)
+{
+    if (!initialized || !context)
+    {
+        std::cerr << "Audio system not initialized" << std::endl;
+        return false;
+    }
+
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change device while capturing" << std::endl;
+        return false;
+    }
+
+    cubeb_device_collection collection;
+    int r = cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection);
+    if (r != CUBEB_OK)
+    {
+        std::cerr << "Error enumerating devices: " << r << std::endl;
+        return false;
+    }
+
+    if (deviceIndex < 0 || deviceIndex >= static_cast<int>(collection.count))
+    {
+        std::cerr << "Invalid device index: " << deviceIndex << std::endl;
+        cubeb_device_collection_destroy(context, &collection);
+        return false;
+    }
+
+    // Set new device
+    inputDeviceId = collection.device[deviceIndex].devid;
+    inputDeviceIndex = deviceIndex;
+    currentDeviceName = collection.device[deviceIndex].friendly_name ?
+                       collection.device[deviceIndex].friendly_name :
+                       collection.device[deviceIndex].device_id;
+    selectedDeviceId = collection.device[deviceIndex].device_id ? collection.device[deviceIndex].device_id : "";
+
+    cubeb_device_collection_destroy(context, &collection);
+
+    std::cout << "Input device set to: " << currentDeviceName << std::endl;
+    return true;
+}
+
+std::string AudioCapture::getCurrentInputDevice() const
+{
+    // Device recovery may switch devices while capturing
+    std::lock_guard<std::mutex> lock(mutex);
+    return currentDeviceName;
+}
+
+long AudioCapture::dataCallback(cubeb_stream *stream, void *user_ptr, const void *input_buffer, void *output_buffer, long nframes)
+{
+    AudioCapture *capture = static_cast<AudioCapture *>(user_ptr);
+    if (!capture || !input_buffer)
+    {
+        return 0;
+    }
+
+    auto callbackStart = std::chrono::steady_clock::now();
+
+    // Convert input buffer to float vector
+    const float *input_samples = static_cast<const float *>(input_buffer);
+    int sample_count = nframes * capture->channelCount.load();
+
+    // Duplex streams play the input back from the same callback
+    if (output_buffer)
+    {
+        capture->writeMonitorOutput(input_samples, static_cast<float *>(output_buffer), nframes);
+    }
+
+    std::vector<float> audio_data(input_samples, input_samples + sample_count);
+
+    // Clip counters and level histogram of the captured audio, filled gaps excluded
+    capture->levelStats->process(input_samples, nframes);
+
+    // Keep the recording aligned with wall time
+    uint64_t missing = capture->detectGap(nframes, callbackStart);
+    if (missing > 0)
+    {
+        capture->fillGap(input_samples, missing);
+    }
+
+    if (nframes > 0)
+    {
+        std::copy(input_samples + sample_count - capture->lastFrame.size(), input_samples + sample_count, capture->lastFrame.begin());
+    }
+
+    // Store for recording
+    capture->storeFrames(input_samples, nframes);
+
+    // Copy for the tap consumer, only whole callbacks so frames stay in step
+    if (capture->tap)
+    {
+        CaptureTap &tap = *capture->tap;
+        size_t samples = static_cast<size_t>(sample_count);
+        if (tap.channelCount != capture->channelCount.load() || tap.samples.writeAvailable() < samples)
+        {
+            tap.droppedFrames.fetch_add(nframes, std::memory_order_relaxed);
+        }
+        else
+        {
+            tap.samples.write(input_samples, samples);
+        }
+    }
+
+    capture->publishPosition(callbackStart);
+
+    // Call user callback
+    capture->onAudioData(audio_data, nframes);
+
+    capture->updateCallbackTiming(nframes, callbackStart);
+
+    return nframes;
+}
+
+void AudioCapture::stateCallback(cubeb_stream *stream, void *user_ptr, cubeb_state state)
+{
+    AudioCapture *capture = static_cast<AudioCapture *>(user_ptr);
+    if (!capture)
+    {
+        return;
+    }
+
+    switch (state)
+    {
+        case CUBEB_STATE_STARTED:
+            std::cout << "Stream started" << std::endl;
+            break;
+        case CUBEB_STATE_STOPPED:
+            std::cout << "Stream stopped" << std::endl;
+            if (!capture->restartingStream.load())
+            {
+                capture->capturing = false;
+            }
+            break;
+        case CUBEB_STATE_DRAINED:
+            std::cout << "Stream drained" << std::endl;
+            break;
+        case CUBEB_STATE_ERROR:
+            std::cerr << "Stream error" << std::endl;
+            if (capture->deviceRecovery && capture->capturing.load())
+            {
+                // The supervisor thread reopens the stream, the capture stays active
+                capture->streamLostTime = steadyNanoseconds(std::chrono::steady_clock::now());
+                {
+                    std::lock_guard<std::mutex> lock(capture->captureThreadMutex);
+                    capture->streamLost = true;
+                }
+                capture->cv.notify_all();
+            }
+            else
+            {
+                capture->capturing = false;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void AudioCapture::deviceCollectionChanged(cubeb *, void *user_ptr)
+{
+    AudioCapture *capture = static_cast<AudioCapture *>(user_ptr);
+    if (!capture)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(capture->captureThreadMutex);
+        capture->devicesChanged = true;
+    }
+    capture->cv.notify_all();
+}
+
+void AudioCapture::onAudioData(const std::vector<float> &audioData, int frameCount)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if (callback)
+    {
+        callback(audioData, frameCount, sampleRate.load(), channelCount.load());
+    }
+}
+
+void AudioCapture::writeMonitorOutput(const float *input, float *output, long frameCount) noexcept
+{
+    int inputChannels = channelCount.load();
+    size_t outputChannels = monitorRouting.size();
+    float gain = monitorGain.load(std::memory_order_relaxed);
+
+    for (long frame = 0; frame < frameCount; ++frame)
+    {
+        const float *inputFrame = input + frame * inputChannels;
+        float *outputFrame = output + frame * outputChannels;
+
+        for (size_t channel = 0; channel < outputChannels; ++channel)
+        {
+            int source = monitorRouting[channel];
+            outputFrame[channel] = source >= 0 ? inputFrame[source] * gain : 0.0f;
+        }
+    }
+}
+
+void AudioCapture::setOutputFile(const std::string &filename)
+{
+    outputFile = filename;
+}
+
+void AudioCapture::setOutputFormat(WavSampleFormat format)
+{
+    outputFormat = format;
+}
+
+WavSampleFormat AudioCapture::getOutputFormat() const noexcept
+{
+    return outputFormat;
+}
+
+void AudioCapture::setOutputContainer(WavContainer container)
+{
+    outputContainer = container;
+}
+
+WavContainer AudioCapture::getOutputContainer() const noexcept
+{
+    return outputContainer;
+}
+
+bool AudioCapture::setStreamingOutput(bool enabled)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change output mode while capturing" << std::endl;
+        return false;
+    }
+
+    streamingOutput = enabled;
+    return true;
+}
+
+bool AudioCapture::isStreamingOutput() const noexcept
+{
+    return streamingOutput;
+}
+
+void AudioCapture::setRecordingCompression(bool enabled)
+{
+    recordingCompression = enabled;
+}
+
+void AudioCapture::setRecordingMemoryBudget(uint64_t bytes)
+{
+    if (recordedAudio)
+    {
+        recordedAudio->setMemoryBudget(bytes);
+    }
+}
+
+bool AudioCapture::setGapFill(GapFill mode)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change gap fill while capturing" << std::endl;
+        return false;
+    }
+
+    gapFill = mode;
+    return true;
+}
+
+bool AudioCapture::setDeviceRecovery(bool enabled)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change device recovery while capturing" << std::endl;
+        return false;
+    }
+
+    deviceRecovery = enabled;
+    return true;
+}
+
+bool AudioCapture::setFallbackInputDevice(int deviceIndex)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change fallback device while capturing" << std::endl;
+        return false;
+    }
+
+    if (deviceIndex < 0)
+    {
+        fallbackDeviceId.clear();
+        return true;
+    }
+
+    if (!initialized || !context)
+    {
+        std::cerr << "Audio system not initialized" << std::endl;
+        return false;
+    }
+
+    cubeb_device_collection collection;
+    int r = cubeb_enumerate_devices(context, CUBEB_DEVICE_TYPE_INPUT, &collection);
+    if (r != CUBEB_OK)
+    {
+        std::cerr << "Error enumerating devices: " << r << std::endl;
+        return false;
+    }
+
+    if (deviceIndex >= static_cast<int>(collection.count) || !collection.device[deviceIndex].device_id)
+    {
+        std::cerr << "Invalid device index: " << deviceIndex << std::endl;
+        cubeb_device_collection_destroy(context, &collection);
+        return false;
+    }
+
+    // Devices get new handles when they reappear, the identifier is stable
+    fallbackDeviceId = collection.device[deviceIndex].device_id;
+    cubeb_device_collection_destroy(context, &collection);
+    return true;
+}
+
+void AudioCapture::setGapCallback(GapCallback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    gapCallback = std::move(callback);
+}
+
+bool AudioCapture::setAdaptiveLatency(bool enabled)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change latency mode while capturing" << std::endl;
+        return false;
+    }
+
+    adaptiveLatency = enabled;
+    return true;
+}
+
+bool AudioCapture::setMonitoring(bool enabled)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change monitoring while capturing" << std::endl;
+        return false;
+    }
+
+    monitoring = enabled;
+    return true;
+}
+
+bool AudioCapture::isMonitoring() const noexcept
+{
+    return monitoring;
+}
+
+void AudioCapture::setMonitorGain(float gain) noexcept
+{
+    monitorGain = gain;
+}
+
+bool AudioCapture::setMonitorChannelMap(const std::vector<int> &channelMap)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change monitor channel map while capturing" << std::endl;
+        return false;
+    }
+
+    monitorChannelMap = channelMap;
+    return true;
+}
+
+bool AudioCapture::addStage(std::shared_ptr<AudioStage> stage)
+{
+    if (!stage)
+    {
+        return false;
+    }
+
+    if (capturing.load())
+    {
+        std::cerr << "Cannot add processing stage while capturing" << std::endl;
+        return false;
+    }
+
+    stages.push_back(std::move(stage));
+    return true;
+}
+
+bool AudioCapture::clearStages()
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot remove processing stages while capturing" << std::endl;
+        return false;
+    }
+
+    stages.clear();
+    return true;
+}
+
+bool AudioCapture::setTap(std::shared_ptr<CaptureTap> tap)
+{
+    if (capturing.load())
+    {
+        std::cerr << "Cannot change tap while capturing" << std::endl;
+        return false;
+    }
+
+    this->tap = std::move(tap);
+    return true;
+}
+
+void AudioCapture::setCheckpointInterval(std::chrono::milliseconds interval)
+{
+    checkpointInterval = interval;
+}
+
+void AudioCapture::setFileBackend(FileBackendType type)
+{
+    fileBackendType = type;
+}
+
+std::string AudioCapture::getWavFilename() const
+{
+    std::string wavFile = outputFile;
+    if (wavFile.substr(wavFile.find_last_of(".") + 1) != "wav")
+    {
+        wavFile = wavFile.substr(0, wavFile.find_last_of(".")) + ".wav";
+    }
+
+    return wavFile;
+}
+
+WavFormat AudioCapture::getWavFormat() const
+{
+    WavFormat format;
+    format.sampleFormat = outputFormat;
+    format.container = outputContainer;
+    format.channelCount = channelCount.load();
+    format.sampleRate = sampleRate.load();
+    return format;
+}
+
+void AudioCapture::closeFileSink()
+{
+    if (!fileSink || !fileSink->isOpen())
+    {
+        return;
+    }
+
+    fileSink->setInfo(getRecordingInfo());
+    fileSink->setCues(getMarkers());
+
+    if (fileSink->close())
+    {
+        const WavFormat &format = fileSink->getFormat();
+        std::cout << "WAV audio streamed to: " << fileSink->getFilename() << std::endl;
+        std::cout << "Recorded " << fileSink->getFramesWritten() << " frames" << std::endl;
+        std::cout << "Format: " << format.channelCount << " channels, "
+                  << format.sampleRate << " Hz, " << sampleFormatName(format.sampleFormat)
+                  << ", " << containerName(format.container) << std::endl;
+    }
+    else
+    {
+        std::cerr << "Failed to finalize output file: " << fileSink->getFilename() << std::endl;
+    }
+}
+
+CaptureStats AudioCapture::getStats() const
+{
+    CaptureStats stats;
+
+    if (fileSink)
+    {
+        stats.framesWritten = fileSink->getFramesWritten();
+        stats.bytesWritten = fileSink->getBytesWritten();
+        stats.droppedFrames = fileSink->getDroppedFrames();
+        stats.writeThroughput = fileSink->getWriteThroughput();
+    }
+
+    if (recordedAudio)
+    {
+        stats.droppedFrames += recordedAudio->getDroppedFrames();
+        stats.recordedFrames = recordedAudio->getFrameCount();
+        stats.recordingRawBytes = recordedAudio->getRawBytes();
+        stats.recordingResidentBytes = recordedAudio->getResidentBytes();
+        stats.recordingSpilledBytes = recordedAudio->getSpilledBytes();
+    }
+
+    stats.latencyFrames = latencyFrames.load();
+    stats.lowestLatencyFrames = lowestLatencyFrames.load();
+    stats.highestLatencyFrames = highestLatencyFrames.load();
+    stats.latencyChanges = latencyChanges.load();
+    stats.xruns = xruns.load();
+    stats.failovers = failovers.load();
+    stats.lastFailoverMs = lastFailoverTime.load() / 1e6;
+    stats.maxFailoverMs = maxFailoverTime.load() / 1e6;
+    stats.gaps = gaps.load();
+    stats.gapFrames = gapFrames.load();
+
+    if (stageRunner)
+    {
+        stats.stageDroppedFrames = stageRunner->getDroppedFrames();
+    }
+
+    if (levelStats)
+    {
+        stats.channelLevels = levelStats->getChannels();
+        for (const ChannelLevelStats &channel : stats.channelLevels)
+        {
+            stats.clippedSamples += channel.clippedSamples;
+        }
+    }
+
+    return stats;
+}
+
+std::vector<WavInfoEntry> AudioCapture::getRecordingInfo() const
+{
+    std::vector<WavInfoEntry> info;
+    if (stageRunner)
+    {
+        info = stageRunner->getInfo();
+    }
+
+    if (levelStats)
+    {
+        levelStats->describe(info);
+    }
+
+    return info;
+}
+
+bool AudioCapture::addMarker(const std::string &label)
+{
+    int64_t now = steadyNanoseconds(std::chrono::steady_clock::now());
+
+    if (!capturing.load() || !markers)
+    {
+        std::cerr << "Cannot add marker, capture is not running" << std::endl;
+        return false;
+    }
+
+    uint64_t frames = 0;
+    int64_t time = 0;
+    uint32_t sequence = 0;
+    do
+    {
+        sequence = positionSequence.load(std::memory_order_acquire);
+        frames = positionFrames.load(std::memory_order_relaxed);
+        time = positionTime.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((sequence & 1) != 0 || sequence != positionSequence.load(std::memory_order_relaxed));
+
+    // Frames captured since the last callback, at most the buffer it is filling
+    int rate = sampleRate.load(std::memory_order_relaxed);
+    if (time > 0 && now > time && rate > 0)
+    {
+        double ahead = static_cast<double>(now - time) * rate / 1e9;
+        frames += std::min(static_cast<uint64_t>(ahead), static_cast<uint64_t>(latencyFrames.load(std::memory_order_relaxed)));
+    }
+
+    return appendMarker(frames, label);
+}
+
+bool AudioCapture::appendMarker(uint64_t framePosition, const std::string &label)
+{
+    if (!markers)
+    {
+        return false;
+    }
+
+    uint32_t index = markerCount.load(std::memory_order_relaxed);
+    do
+    {
+        if (index >= kMaxMarkers)
+        {
+            std::cerr << "Marker limit of " << kMaxMarkers << " reached, dropping marker: " << label << std::endl;
+            return false;
+        }
+    } while (!markerCount.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+    MarkerSlot &slot = markers[index];
+    slot.cue.framePosition = framePosition;
+    slot.cue.label = label;
+    slot.ready.store(true, std::memory_order_release);
+    return true;
+}
+
+std::vector<WavCue> AudioCapture::getMarkers() const
+{
+    std::vector<WavCue> cues;
+    if (!markers)
+    {
+        return cues;
+    }
+
+    // Slots still being written by addMarker() are not ready yet and skipped
+    uint32_t count = std::min(markerCount.load(std::memory_order_acquire), kMaxMarkers);
+    for (uint32_t index = 0; index < count; ++index)
+    {
+        if (markers[index].ready.load(std::memory_order_acquire))
+        {
+            cues.push_back(markers[index].cue);
+        }
+    }
+
+    std::stable_sort(cues.begin(), cues.end(), [](const WavCue &a, const WavCue &b) {
+        return a.framePosition < b.framePosition;
+    });
+    return cues;
+}
+
+bool AudioCapture::saveRecordedAudio() const
+{
+    if (streamingOutput)
+    {
+        // Audio was already written while capturing
+        if (!fileSink || fileSink->isOpen() || fileSink->getFramesWritten() == 0)
+        {
+            std::cerr << "No audio data to save" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    if (!recordedAudio || recordedAudio->empty())
+    {
+        std::cerr << "No audio data to save" << std::endl;
+        return false;
+    }
+
+    std::string wavFile = getWavFilename();
+    WavFormat format = getWavFormat();
+
+    WavWriter writer;
+    if (!writer.open(wavFile, format, createFileBackend(fileBackendType)))
+    {
+        std::cerr << "Failed to initialize WAV file: " << wavFile << std::endl;
+        return false;
+    }
+
+    writer.setInfo(getRecordingInfo());
+    writer.setCues(getMarkers());
+
+    // Blocks are decoded and converted on every core in chunks while the writer stores finished chunks in
+    // order, and only a few chunks are expanded in memory at a time
+    WavSampleFormat sampleFormat = format.sampleFormat;
+    int channelCount = format.channelCount;
+    size_t frameBytes = static_cast<size_t>(channelCount) * bytesPerSample(sampleFormat);
+    bool written = recordedAudio->readParallel(
+        frameBytes,
+        [sampleFormat, channelCount](const float *samples, uint64_t frameCount, uint8_t *output) {
+            convertSamples(samples, sampleFormat, output, static_cast<size_t>(frameCount) * channelCount);
+        },
+        [&writer](const uint8_t *data, uint64_t frameCount) {
+            return writer.writeConverted(data, frameCount);
+        });
+    uint64_t framesWritten = writer.getFramesWritten();
+
+    if (!writer.finalize() || !written || framesWritten == 0)
+    {
+        std::cerr << "Failed to write audio data" << std::endl;
+        return false;
+    }
+
+    std::cout << "WAV audio saved to: " << wavFile << std::endl;
+    std::cout << "Recorded " << framesWritten << " frames (" << framesWritten * format.channelCount << " samples)" << std::endl;
+    std::cout << "Format: " << format.channelCount << " channels, "
+              << format.sampleRate << " Hz, " << sampleFormatName(format.sampleFormat)
+              << ", " << containerName(writer.getFormat().container) << std::endl;
+
+    return true;
+}
+
+} // namespace AudioCaptureX
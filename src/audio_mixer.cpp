@@ -0,0 +1,373 @@
+#include "audio_mixer.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Inputs a mixer can hold, slots are allocated up front so inputs can be added while mixing
+const size_t kMaxInputs = 32;
+
+// Frames mixed per pass, bounds the per-input buffers
+const size_t kMixChunkFrames = 512;
+
+// Frames a capture tap can hold (seconds of audio)
+const int kTapSeconds = 1;
+
+// Largest deviation of the resampling ratio from unity
+const double kMaxRateCorrection = 0.005;
+
+// Time constant of the buffered level average, smooths the bursts of each capture callback
+const double kFillAverageSeconds = 1.0;
+
+// Time over which the rate correction removes a level error
+const double kCorrectionSeconds = 4.0;
+
+// Excess buffered audio dropped at once rather than resampled away (seconds)
+const double kResyncSeconds = 0.1;
+
+// Add gain * input to output
+void accumulate(float *output, const float *input, float gain, size_t sampleCount) noexcept
+{
+    size_t i = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    const __m128 g = _mm_set1_ps(gain);
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        __m128 a = _mm_add_ps(_mm_loadu_ps(output + i), _mm_mul_ps(_mm_loadu_ps(input + i), g));
+        __m128 b = _mm_add_ps(_mm_loadu_ps(output + i + 4), _mm_mul_ps(_mm_loadu_ps(input + i + 4), g));
+        _mm_storeu_ps(output + i, a);
+        _mm_storeu_ps(output + i + 4, b);
+    }
+#elif defined(AUDIO_CAPTUREX_NEON)
+    const float32x4_t g = vdupq_n_f32(gain);
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        vst1q_f32(output + i, vmlaq_f32(vld1q_f32(output + i), vld1q_f32(input + i), g));
+        vst1q_f32(output + i + 4, vmlaq_f32(vld1q_f32(output + i + 4), vld1q_f32(input + i + 4), g));
+    }
+#endif
+
+    for (; i < sampleCount; ++i)
+    {
+        output[i] += input[i] * gain;
+    }
+}
+
+// Add input to output with the gain moving linearly across the frames
+void accumulateRamp(float *output, const float *input, float startGain, float endGain, size_t frameCount, int channelCount) noexcept
+{
+    float step = (endGain - startGain) / static_cast<float>(frameCount);
+    float gain = startGain;
+
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        gain += step;
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            *output++ += *input++ * gain;
+        }
+    }
+}
+
+} // namespace
+
+AudioMixer::AudioMixer(int sampleRate, int channelCount)
+    : sampleRate(sampleRate)
+    , channelCount(channelCount)
+    , inputs(kMaxInputs)
+    , inputCount(0)
+    , largestBlock(0)
+{
+}
+
+int AudioMixer::addInput(AudioCapture &capture, float gain)
+{
+    size_t index = inputCount.load();
+    if (index == kMaxInputs)
+    {
+        std::cerr << "Mixer is full: " << kMaxInputs << " inputs" << std::endl;
+        return -1;
+    }
+
+    // Drift correction only absorbs small clock differences, not another nominal rate
+    if (capture.getStreamSampleRate() != sampleRate)
+    {
+        std::cerr << "Cannot mix a " << capture.getStreamSampleRate() << " Hz capture into a " << sampleRate
+                  << " Hz mixer" << std::endl;
+        return -1;
+    }
+
+    auto input = std::make_unique<Input>();
+    input->tap = std::make_shared<CaptureTap>(static_cast<size_t>(sampleRate) * kTapSeconds, channelCount);
+    input->gain = gain;
+
+    // Room for one block at the fastest rate plus the interpolation neighbours
+    size_t stagingFrames = static_cast<size_t>(kMixChunkFrames * (1.0 + kMaxRateCorrection)) + 8;
+    input->staging.assign(stagingFrames * channelCount, 0.0f);
+    input->resampled.assign(kMixChunkFrames * channelCount, 0.0f);
+
+    if (!capture.setTap(input->tap))
+    {
+        return -1;
+    }
+
+    // Publish the slot once it is complete
+    inputs[index] = std::move(input);
+    inputCount.store(index + 1, std::memory_order_release);
+    return static_cast<int>(index);
+}
+
+void AudioMixer::setInputGain(int input, float gain) noexcept
+{
+    if (input >= 0 && static_cast<size_t>(input) < inputCount.load())
+    {
+        inputs[input]->gain = gain;
+    }
+}
+
+void AudioMixer::setInputDelay(int input, uint32_t frames) noexcept
+{
+    if (input >= 0 && static_cast<size_t>(input) < inputCount.load())
+    {
+        inputs[input]->delayFrames = frames;
+    }
+}
+
+void AudioMixer::process(float *output, size_t frameCount) noexcept
+{
+    std::fill(output, output + frameCount * channelCount, 0.0f);
+
+    size_t count = inputCount.load(std::memory_order_acquire);
+    largestBlock = std::max(largestBlock, frameCount);
+
+    // Audio is as old as the capture buffer plus what waits here. Every input is
+    // held at the same age, which must leave the input with the largest capture
+    // buffer one full burst plus one mixer block in reserve.
+    uint32_t alignedFrames = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        int64_t latency = inputs[i]->tap->latencyFrames.load(std::memory_order_relaxed);
+        int64_t needed = 2 * latency - inputs[i]->delayFrames.load(std::memory_order_relaxed) + static_cast<int64_t>(largestBlock);
+        alignedFrames = std::max<uint32_t>(alignedFrames, static_cast<uint32_t>(std::max<int64_t>(needed, 0)));
+    }
+
+    for (size_t done = 0; done < frameCount;)
+    {
+        size_t frames = std::min(kMixChunkFrames, frameCount - done);
+        for (size_t i = 0; i < count; ++i)
+        {
+            mixInput(*inputs[i], output + done * channelCount, frames, alignedFrames);
+        }
+
+        done += frames;
+    }
+}
+
+void AudioMixer::mixInput(Input &input, float *output, size_t frameCount, uint32_t alignedFrames) noexcept
+{
+    CaptureTap &tap = *input.tap;
+    uint32_t latency = tap.latencyFrames.load(std::memory_order_relaxed);
+    double fill = fillLevel(input);
+    double target = static_cast<double>(alignedFrames) + input.delayFrames.load(std::memory_order_relaxed) - latency;
+
+    // The level rises by a whole capture buffer with each capture callback, so it
+    // peaks half a buffer above its average
+    double peak = target + latency / 2.0;
+
+    input.bufferedFrames.store(static_cast<uint32_t>(std::max(fill, 0.0)), std::memory_order_relaxed);
+    input.targetFrames.store(static_cast<uint32_t>(target), std::memory_order_relaxed);
+
+    if (!input.primed)
+    {
+        // Wait for the aligned level, then skip the excess so the input starts in step
+        if (fill < target + frameCount)
+        {
+            return;
+        }
+
+        discardFrames(input, static_cast<size_t>(std::max(fill - peak, 0.0)));
+        input.averageFill = target;
+        input.appliedGain = 0.0f; // Fade in
+        input.primed = true;
+    }
+    else
+    {
+        input.averageFill += (fill - input.averageFill) * frameCount / (sampleRate * kFillAverageSeconds);
+    }
+
+    // Jumps such as a restarted capture are cut rather than slowly resampled away
+    if (fill - peak > sampleRate * kResyncSeconds)
+    {
+        discardFrames(input, static_cast<size_t>(fill - peak));
+        input.averageFill = target;
+    }
+
+    double error = input.averageFill - target;
+
+    // Consume slightly faster when audio piles up, slower when it runs low
+    double ratio = 1.0 + std::clamp(error / (sampleRate * kCorrectionSeconds), -kMaxRateCorrection, kMaxRateCorrection);
+    input.rateRatio.store(ratio, std::memory_order_relaxed);
+
+    // Cubic interpolation reads one frame before and two after the position
+    size_t needed = static_cast<size_t>(input.position + (frameCount - 1) * ratio) + 3;
+    if (!fillStaging(input, needed))
+    {
+        // Mute until the aligned level is reached again
+        input.underruns.fetch_add(1, std::memory_order_relaxed);
+        input.primed = false;
+        input.stagedFrames = 0;
+        input.position = 0.0;
+        return;
+    }
+
+    const float *staging = input.staging.data();
+    float *resampled = input.resampled.data();
+    double position = input.position;
+
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        size_t index = static_cast<size_t>(position);
+        float t = static_cast<float>(position - index);
+        const float *p0 = staging + (index - 1) * channelCount;
+        const float *p1 = p0 + channelCount;
+        const float *p2 = p1 + channelCount;
+        const float *p3 = p2 + channelCount;
+
+        // Catmull-Rom spline, exact at whole positions so a unity ratio is transparent
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            float a = p1[channel];
+            float b = 0.5f * (p2[channel] - p0[channel]);
+            float c = p0[channel] - 2.5f * p1[channel] + 2.0f * p2[channel] - 0.5f * p3[channel];
+            float d = 0.5f * (p3[channel] - p0[channel]) + 1.5f * (p1[channel] - p2[channel]);
+            *resampled++ = ((d * t + c) * t + b) * t + a;
+        }
+
+        position += ratio;
+    }
+
+    input.position = position;
+    compactStaging(input);
+
+    float gain = input.gain.load(std::memory_order_relaxed);
+    if (gain == input.appliedGain)
+    {
+        accumulate(output, input.resampled.data(), gain, frameCount * channelCount);
+    }
+    else
+    {
+        accumulateRamp(output, input.resampled.data(), input.appliedGain, gain, frameCount, channelCount);
+        input.appliedGain = gain;
+    }
+}
+
+bool AudioMixer::fillStaging(Input &input, size_t frameCount) noexcept
+{
+    if (input.stagedFrames >= frameCount)
+    {
+        return true;
+    }
+
+    size_t missing = (frameCount - input.stagedFrames) * channelCount;
+    if (input.tap->samples.readAvailable() < missing)
+    {
+        return false;
+    }
+
+    input.tap->samples.read(input.staging.data() + input.stagedFrames * channelCount, missing);
+    input.stagedFrames = frameCount;
+    return true;
+}
+
+void AudioMixer::discardFrames(Input &input, size_t frameCount) noexcept
+{
+    size_t staged = input.stagedFrames - std::min(input.stagedFrames, static_cast<size_t>(input.position));
+    if (frameCount < staged)
+    {
+        // Everything to skip is already staged
+        input.position += frameCount;
+        compactStaging(input);
+        input.discardedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return;
+    }
+
+    size_t skipped = staged;
+    size_t remaining = frameCount - staged;
+
+    // Read through the staging buffer, its content is replaced below anyway
+    size_t chunkFrames = input.staging.size() / channelCount;
+    while (remaining > 0)
+    {
+        size_t frames = std::min(remaining, chunkFrames);
+        size_t read = input.tap->samples.read(input.staging.data(), frames * channelCount) / channelCount;
+        skipped += read;
+        remaining -= read;
+        if (read < frames)
+        {
+            break;
+        }
+    }
+
+    input.discardedFrames.fetch_add(skipped, std::memory_order_relaxed);
+
+    // The first frame read becomes the interpolation history
+    input.stagedFrames = 0;
+    input.position = 1.0;
+}
+
+void AudioMixer::compactStaging(Input &input) noexcept
+{
+    // Keep one frame before the position as history
+    size_t consumed = static_cast<size_t>(input.position) - 1;
+    std::memmove(input.staging.data(), input.staging.data() + consumed * channelCount, (input.stagedFrames - consumed) * channelCount * sizeof(float));
+    input.stagedFrames -= consumed;
+    input.position -= consumed;
+}
+
+double AudioMixer::fillLevel(const Input &input) const noexcept
+{
+    return static_cast<double>(input.tap->samples.readAvailable() / channelCount) + input.stagedFrames - input.position;
+}
+
+int AudioMixer::getInputCount() const noexcept
+{
+    return static_cast<int>(inputCount.load());
+}
+
+int AudioMixer::getSampleRate() const noexcept
+{
+    return sampleRate;
+}
+
+int AudioMixer::getChannelCount() const noexcept
+{
+    return channelCount;
+}
+
+MixerInputStats AudioMixer::getInputStats(int input) const
+{
+    MixerInputStats stats;
+    if (input < 0 || static_cast<size_t>(input) >= inputCount.load())
+    {
+        return stats;
+    }
+
+    const Input &source = *inputs[input];
+    stats.underruns = source.underruns.load();
+    stats.droppedFrames = source.tap->droppedFrames.load();
+    stats.discardedFrames = source.discardedFrames.load();
+    stats.bufferedFrames = source.bufferedFrames.load();
+    stats.targetFrames = source.targetFrames.load();
+    stats.rateRatio = source.rateRatio.load();
+    return stats;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,201 @@
+#include "audio_stage.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Seconds of audio buffered between the capture callback and the stage thread
+const int kRingSeconds = 2;
+
+// Frames handed to the stages per iteration
+const size_t kStageChunkFrames = 4096;
+
+} // namespace
+
+MonoHistory::MonoHistory(int channelCount)
+    : channelCount(channelCount)
+    , offset(0)
+    , start(0)
+{
+}
+
+void MonoHistory::append(const float *input, size_t frameCount)
+{
+    float scale = 1.0f / channelCount;
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        float sum = 0.0f;
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            sum += *input++;
+        }
+
+        samples.push_back(sum * scale);
+    }
+}
+
+void MonoHistory::appendSilence(size_t frameCount)
+{
+    samples.insert(samples.end(), frameCount, 0.0f);
+}
+
+void MonoHistory::discard(uint64_t position)
+{
+    if (position > start)
+    {
+        size_t drop = static_cast<size_t>(std::min<uint64_t>(position - start, samples.size() - offset));
+        offset += drop;
+        start += drop;
+
+        // Move the kept samples down only once the dropped ones outnumber them, so each sample is moved
+        // a bounded number of times however small the discards are
+        if (offset >= samples.size() - offset)
+        {
+            samples.erase(samples.begin(), samples.begin() + offset);
+            offset = 0;
+        }
+    }
+}
+
+const float *MonoHistory::data(uint64_t position) const noexcept
+{
+    return samples.data() + offset + (position - start);
+}
+
+uint64_t MonoHistory::getStart() const noexcept
+{
+    return start;
+}
+
+uint64_t MonoHistory::getEnd() const noexcept
+{
+    return start + (samples.size() - offset);
+}
+
+StageRunner::StageRunner()
+    : running(false)
+    , droppedFrames(0)
+{
+}
+
+StageRunner::~StageRunner()
+{
+    stop();
+}
+
+bool StageRunner::start(const std::vector<std::shared_ptr<AudioStage>> &stages, int sampleRate, int channelCount,
+                        const std::string &recordingFile)
+{
+    stop();
+
+    activeStages.clear();
+    info.clear();
+    for (const auto &stage : stages)
+    {
+        if (stage && stage->prepare(sampleRate, channelCount, recordingFile))
+        {
+            activeStages.push_back(stage);
+        }
+    }
+
+    if (activeStages.empty())
+    {
+        return false;
+    }
+
+    queue.reset(static_cast<size_t>(sampleRate) * kRingSeconds, channelCount);
+    droppedFrames = 0;
+
+    running = true;
+    stageThreadHandle = std::thread(&StageRunner::stageThread, this);
+
+    return true;
+}
+
+bool StageRunner::push(const float *samples, long frameCount) noexcept
+{
+    if (!running.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    if (!queue.push(samples, frameCount))
+    {
+        droppedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+bool StageRunner::pushSilence(uint64_t frameCount) noexcept
+{
+    if (!running.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    if (!queue.pushSilence(frameCount))
+    {
+        droppedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void StageRunner::stop()
+{
+    if (!stageThreadHandle.joinable())
+    {
+        return;
+    }
+
+    running = false;
+    stageThreadHandle.join();
+
+    info.clear();
+    for (const auto &stage : activeStages)
+    {
+        stage->finish();
+        stage->describe(info);
+    }
+
+    activeStages.clear();
+
+    if (droppedFrames.load() > 0)
+    {
+        std::cerr << "Processing stages dropped " << droppedFrames.load() << " frames" << std::endl;
+    }
+}
+
+uint64_t StageRunner::getDroppedFrames() const noexcept
+{
+    return droppedFrames.load();
+}
+
+const std::vector<WavInfoEntry> &StageRunner::getInfo() const noexcept
+{
+    return info;
+}
+
+void StageRunner::stageThread()
+{
+    queue.drain(
+        running, kStageChunkFrames, [this](const float *samples, size_t frameCount, bool) { processBlock(samples, frameCount); },
+        [] {});
+}
+
+void StageRunner::processBlock(const float *samples, size_t frameCount)
+{
+    for (const auto &stage : activeStages)
+    {
+        stage->process(samples, frameCount);
+    }
+}
+
+} // namespace AudioCaptureX
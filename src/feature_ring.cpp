@@ -0,0 +1,118 @@
+#include "feature_ring.hpp"
+#include <algorithm>
+
+namespace AudioCaptureX
+{
+
+FeatureRing::FeatureRing(size_t frameCapacity, size_t featureCount)
+    : frameCapacity(0)
+    , features(0)
+    , published(0)
+    , cleared(0)
+{
+    reset(frameCapacity, featureCount);
+}
+
+void FeatureRing::reset(size_t frameCapacity, size_t featureCount)
+{
+    bool empty = frameCapacity == 0 || featureCount == 0;
+    storage.reset(empty ? nullptr : new float[2 * frameCapacity * featureCount]());
+    this->frameCapacity = empty ? 0 : frameCapacity;
+    features = empty ? 0 : featureCount;
+    published.store(0, std::memory_order_relaxed);
+    cleared.store(0, std::memory_order_relaxed);
+}
+
+void FeatureRing::clear() noexcept
+{
+    cleared.store(published.load(std::memory_order_relaxed), std::memory_order_release);
+}
+
+size_t FeatureRing::capacity() const noexcept
+{
+    return frameCapacity;
+}
+
+size_t FeatureRing::featureCount() const noexcept
+{
+    return features;
+}
+
+float *FeatureRing::beginFrame() noexcept
+{
+    if (!storage)
+    {
+        return nullptr;
+    }
+
+    // Stores to the frame must not become visible before the frame count that
+    // lets consumers detect them
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t slot = static_cast<size_t>(published.load(std::memory_order_relaxed) % frameCapacity);
+    return storage.get() + slot * features;
+}
+
+void FeatureRing::commitFrame() noexcept
+{
+    if (!storage)
+    {
+        return;
+    }
+
+    uint64_t frame = published.load(std::memory_order_relaxed);
+    float *values = storage.get() + static_cast<size_t>(frame % frameCapacity) * features;
+    std::copy(values, values + features, values + frameCapacity * features);
+
+    published.store(frame + 1, std::memory_order_release);
+}
+
+uint64_t FeatureRing::getFrameCount() const noexcept
+{
+    return published.load(std::memory_order_acquire);
+}
+
+uint64_t FeatureRing::getFirstFrame() const noexcept
+{
+    return cleared.load(std::memory_order_acquire);
+}
+
+FeatureView FeatureRing::getFrames(uint64_t firstFrame, size_t frameCount) const noexcept
+{
+    FeatureView view;
+    uint64_t available = published.load(std::memory_order_acquire);
+
+    // The frame being written next replaces frame available - capacity
+    if (!storage || frameCount > frameCapacity || firstFrame + frameCount > available ||
+        firstFrame + frameCapacity <= available || firstFrame < cleared.load(std::memory_order_acquire))
+    {
+        return view;
+    }
+
+    view.data = storage.get() + static_cast<size_t>(firstFrame % frameCapacity) * features;
+    view.firstFrame = firstFrame;
+    view.frameCount = frameCount;
+    view.featureCount = features;
+    return view;
+}
+
+FeatureView FeatureRing::getLatest(size_t frameCount) const noexcept
+{
+    uint64_t available = published.load(std::memory_order_acquire);
+    if (frameCount > available)
+    {
+        return FeatureView();
+    }
+
+    return getFrames(available - frameCount, frameCount);
+}
+
+bool FeatureRing::isValid(const FeatureView &view) const noexcept
+{
+    // Reads of the view must complete before the frame count is checked
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return view.data && view.firstFrame + frameCapacity > published.load(std::memory_order_relaxed) &&
+           view.firstFrame >= cleared.load(std::memory_order_relaxed);
+}
+
+} // namespace AudioCaptureX
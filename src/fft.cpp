@@ -0,0 +1,120 @@
+#include "fft.hpp"
+#include <cmath>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+} // namespace
+
+RealFft::RealFft(size_t size)
+    : n(size)
+{
+    size_t half = n / 2;
+
+    bitReverse.resize(half);
+    size_t bits = 0;
+    while ((static_cast<size_t>(1) << bits) < half)
+    {
+        bits++;
+    }
+
+    for (size_t i = 0; i < half; ++i)
+    {
+        size_t reversed = 0;
+        for (size_t bit = 0; bit < bits; ++bit)
+        {
+            reversed |= ((i >> bit) & 1) << (bits - 1 - bit);
+        }
+
+        bitReverse[i] = reversed;
+    }
+
+    twiddles.resize(half / 2);
+    for (size_t i = 0; i < twiddles.size(); ++i)
+    {
+        double angle = -2.0 * kPi * i / half;
+        twiddles[i] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    unpackFactors.resize(half + 1);
+    for (size_t k = 0; k <= half; ++k)
+    {
+        double angle = -2.0 * kPi * k / n;
+        unpackFactors[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    work.resize(half);
+    spectrum.resize(half + 1);
+}
+
+size_t RealFft::size() const noexcept
+{
+    return n;
+}
+
+void RealFft::forward(const float *input, std::complex<float> *output) noexcept
+{
+    size_t half = n / 2;
+
+    // Even samples become the real parts, odd samples the imaginary parts
+    for (size_t i = 0; i < half; ++i)
+    {
+        work[bitReverse[i]] = std::complex<float>(input[2 * i], input[2 * i + 1]);
+    }
+
+    for (size_t length = 2; length <= half; length <<= 1)
+    {
+        size_t step = half / length;
+        size_t span = length / 2;
+
+        for (size_t start = 0; start < half; start += length)
+        {
+            for (size_t i = 0; i < span; ++i)
+            {
+                std::complex<float> odd = work[start + i + span] * twiddles[i * step];
+                std::complex<float> even = work[start + i];
+                work[start + i] = even + odd;
+                work[start + i + span] = even - odd;
+            }
+        }
+    }
+
+    // Split the packed transform into the spectra of the even and odd samples
+    output[0] = std::complex<float>(work[0].real() + work[0].imag(), 0.0f);
+    output[half] = std::complex<float>(work[0].real() - work[0].imag(), 0.0f);
+
+    for (size_t k = 1; k < half; ++k)
+    {
+        std::complex<float> a = work[k];
+        std::complex<float> b = std::conj(work[half - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = std::complex<float>(0.0f, -0.5f) * (a - b);
+        output[k] = even + unpackFactors[k] * odd;
+    }
+}
+
+void RealFft::power(const float *input, float *power) noexcept
+{
+    forward(input, spectrum.data());
+
+    for (size_t k = 0; k <= n / 2; ++k)
+    {
+        power[k] = std::norm(spectrum[k]);
+    }
+}
+
+void hannWindow(std::vector<float> &window)
+{
+    size_t length = window.size();
+    for (size_t i = 0; i < length; ++i)
+    {
+        window[i] = static_cast<float>(0.5 - 0.5 * std::cos(2.0 * kPi * i / length));
+    }
+}
+
+} // namespace AudioCaptureX
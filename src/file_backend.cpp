@@ -0,0 +1,924 @@
+#include "file_backend.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define AUDIO_CAPTUREX_HAS_IO_URING 1
+#endif
+#endif
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+bool seekFile(FILE *file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+class StdioFileBackend : public FileBackend
+{
+public:
+    ~StdioFileBackend() override
+    {
+        close();
+    }
+
+    bool open(const std::string &path) override
+    {
+        close();
+
+        file = std::fopen(path.c_str(), "wb");
+        position = 0;
+        return file != nullptr;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        if (!file || std::fwrite(data, 1, size, file) != size)
+        {
+            return false;
+        }
+
+        position += size;
+        return true;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) override
+    {
+        if (!file || !seekFile(file, offset))
+        {
+            return false;
+        }
+
+        bool ok = std::fwrite(data, 1, size, file) == size;
+
+        // Restore the append position
+        return seekFile(file, position) && ok;
+    }
+
+    bool sync() override
+    {
+        if (!file || std::fflush(file) != 0)
+        {
+            return false;
+        }
+
+#if defined(_WIN32)
+        return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+        return fsync(fileno(file)) == 0;
+#else
+        return fdatasync(fileno(file)) == 0;
+#endif
+    }
+
+    bool close() override
+    {
+        if (!file)
+        {
+            return true;
+        }
+
+        bool ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    FILE *file = nullptr;
+    uint64_t position = 0;
+};
+
+#ifndef _WIN32
+
+// Write the whole buffer at the given offset, retrying partial writes
+bool writeFully(int fd, uint64_t offset, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+    while (size > 0)
+    {
+        ssize_t written = pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        bytes += written;
+        offset += written;
+        size -= written;
+    }
+
+    return true;
+}
+
+bool syncFile(int fd)
+{
+#ifdef __APPLE__
+    return fsync(fd) == 0;
+#else
+    return fdatasync(fd) == 0;
+#endif
+}
+
+class PwriteFileBackend : public FileBackend
+{
+public:
+    ~PwriteFileBackend() override
+    {
+        close();
+    }
+
+    bool open(const std::string &path) override
+    {
+        close();
+
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        position = 0;
+        return fd >= 0;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        if (fd < 0 || !writeFully(fd, position, data, size))
+        {
+            return false;
+        }
+
+        position += size;
+        return true;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) override
+    {
+        return fd >= 0 && writeFully(fd, offset, data, size);
+    }
+
+    bool sync() override
+    {
+        return fd >= 0 && syncFile(fd);
+    }
+
+    bool close() override
+    {
+        if (fd < 0)
+        {
+            return true;
+        }
+
+        bool ok = ::close(fd) == 0;
+        fd = -1;
+        return ok;
+    }
+
+private:
+    int fd = -1;
+    uint64_t position = 0;
+};
+
+/**
+ * Appends fill one of two aligned buffers while an I/O thread writes the other
+ * one with O_DIRECT, so the page cache is never involved. Every disk write is a
+ * whole buffer at an aligned offset; the unaligned tail is written padded to the
+ * alignment and the file is truncated back to its logical size.
+ */
+class DirectFileBackend : public FileBackend
+{
+public:
+    ~DirectFileBackend() override
+    {
+        close();
+
+        for (uint8_t *buffer : buffers)
+        {
+            std::free(buffer);
+        }
+    }
+
+    bool open(const std::string &path) override
+    {
+        close();
+
+        if (!buffers[0] &&
+            (posix_memalign(reinterpret_cast<void **>(&buffers[0]), kAlignment, kBufferSize) != 0 ||
+             posix_memalign(reinterpret_cast<void **>(&buffers[1]), kAlignment, kBufferSize) != 0))
+        {
+            return false;
+        }
+
+#ifdef O_DIRECT
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+        if (fd < 0 && errno == EINVAL)
+        {
+            // Some filesystems (e.g. tmpfs) do not support O_DIRECT
+            std::cerr << "O_DIRECT is not supported for: " << path << ", using buffered writes" << std::endl;
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        }
+#else
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+#ifdef F_NOCACHE
+        if (fd >= 0)
+        {
+            fcntl(fd, F_NOCACHE, 1);
+        }
+#endif
+#endif
+
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        active = 0;
+        used = 0;
+        bufferOffset = 0;
+        failed = false;
+        stopping = false;
+        requestPending = false;
+        ioThread = std::thread(&DirectFileBackend::ioLoop, this);
+        return true;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        while (size > 0)
+        {
+            size_t count = std::min(size, kBufferSize - used);
+            std::memcpy(buffers[active] + used, bytes, count);
+            used += count;
+            bytes += count;
+            size -= count;
+
+            if (used == kBufferSize)
+            {
+                // Hand the full buffer to the I/O thread and keep filling the other one
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return !requestPending; });
+                requestPending = true;
+                requestBuffer = active;
+                requestOffset = bufferOffset;
+                cv.notify_all();
+
+                active = 1 - active;
+                bufferOffset += kBufferSize;
+                used = 0;
+            }
+        }
+
+        return !failed;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) override
+    {
+        if (fd < 0 || !waitIdle())
+        {
+            return false;
+        }
+
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+        // Part of the region still in the active buffer is patched in memory
+        if (offset + size > bufferOffset)
+        {
+            uint64_t start = std::max(offset, bufferOffset);
+            std::memcpy(buffers[active] + (start - bufferOffset), bytes + (start - offset), offset + size - start);
+            size = static_cast<size_t>(start - offset);
+        }
+
+        // The rest is on disk and needs an aligned read-modify-write
+        if (size > 0)
+        {
+            uint64_t blockStart = offset / kAlignment * kAlignment;
+            size_t blockSize = static_cast<size_t>((offset + size + kAlignment - 1) / kAlignment * kAlignment - blockStart);
+
+            uint8_t *block = nullptr;
+            if (posix_memalign(reinterpret_cast<void **>(&block), kAlignment, blockSize) != 0)
+            {
+                return false;
+            }
+
+            bool ok = pread(fd, block, blockSize, static_cast<off_t>(blockStart)) == static_cast<ssize_t>(blockSize);
+            if (ok)
+            {
+                std::memcpy(block + (offset - blockStart), bytes, size);
+                ok = writeFully(fd, blockStart, block, blockSize);
+            }
+
+            std::free(block);
+            return ok;
+        }
+
+        return true;
+    }
+
+    bool sync() override
+    {
+        return fd >= 0 && writeTail() && syncFile(fd);
+    }
+
+    bool close() override
+    {
+        if (fd < 0)
+        {
+            return true;
+        }
+
+        bool ok = writeTail();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            cv.notify_all();
+        }
+
+        ioThread.join();
+
+        ok = ::close(fd) == 0 && ok;
+        fd = -1;
+        return ok;
+    }
+
+private:
+    static constexpr size_t kAlignment = 4096;
+    static constexpr size_t kBufferSize = 1024 * 1024;
+
+    void ioLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true)
+        {
+            cv.wait(lock, [this] { return requestPending || stopping; });
+            if (!requestPending)
+            {
+                break;
+            }
+
+            int buffer = requestBuffer;
+            uint64_t offset = requestOffset;
+
+            lock.unlock();
+            bool ok = writeFully(fd, offset, buffers[buffer], kBufferSize);
+            lock.lock();
+
+            failed = failed.load() || !ok;
+            requestPending = false;
+            cv.notify_all();
+        }
+    }
+
+    bool waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return !requestPending; });
+        return !failed;
+    }
+
+    // Write the partial active buffer padded to the alignment, then trim the file
+    bool writeTail()
+    {
+        if (!waitIdle())
+        {
+            return false;
+        }
+
+        if (used == 0)
+        {
+            return true;
+        }
+
+        size_t padded = (used + kAlignment - 1) / kAlignment * kAlignment;
+        std::memset(buffers[active] + used, 0, padded - used);
+
+        return writeFully(fd, bufferOffset, buffers[active], padded) &&
+               ftruncate(fd, static_cast<off_t>(bufferOffset + used)) == 0;
+    }
+
+    uint8_t *buffers[2] = {nullptr, nullptr};
+    int active = 0;
+    size_t used = 0;
+    uint64_t bufferOffset = 0;
+
+    std::thread ioThread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool requestPending = false;
+    int requestBuffer = 0;
+    uint64_t requestOffset = 0;
+    bool stopping = false;
+    std::atomic<bool> failed{false};
+
+    int fd = -1;
+};
+
+#endif
+
+#ifdef AUDIO_CAPTUREX_HAS_IO_URING
+
+/**
+ * Appends are copied into a pool of registered buffers; each full buffer is
+ * queued as a fixed-buffer write and queued writes are submitted in batches.
+ * A sync submits the partial tail buffer drained behind every earlier write
+ * and linked to a datasync, then waits for the chain.
+ */
+class IoUringFileBackend : public FileBackend
+{
+public:
+    ~IoUringFileBackend() override
+    {
+        close();
+        destroyRing();
+    }
+
+    // Set up the ring and register the buffer pool, false if io_uring is unavailable
+    bool initialize()
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        ringFd = static_cast<int>(syscall(__NR_io_uring_setup, kQueueDepth, &params));
+        if (ringFd < 0)
+        {
+            return false;
+        }
+
+        size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+        {
+            sqSize = cqSize = std::max(sqSize, cqSize);
+        }
+
+        sqMapSize = sqSize;
+        sqMap = mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqMap == MAP_FAILED)
+        {
+            sqMap = nullptr;
+            return false;
+        }
+
+        if (singleMap)
+        {
+            cqMap = sqMap;
+        }
+        else
+        {
+            cqMapSize = cqSize;
+            cqMap = mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+            if (cqMap == MAP_FAILED)
+            {
+                cqMap = nullptr;
+                return false;
+            }
+        }
+
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = static_cast<io_uring_sqe *>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES));
+        if (sqes == MAP_FAILED)
+        {
+            sqes = nullptr;
+            return false;
+        }
+
+        uint8_t *sq = static_cast<uint8_t *>(sqMap);
+        sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sqEntries = params.sq_entries;
+
+        uint8_t *cq = static_cast<uint8_t *>(cqMap);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+        // Page aligned buffers, registered once so the kernel does not pin them per write
+        std::vector<iovec> iovecs(kBufferCount);
+        buffers.resize(kBufferCount);
+        for (size_t i = 0; i < kBufferCount; ++i)
+        {
+            if (posix_memalign(reinterpret_cast<void **>(&buffers[i].data), 4096, kBufferSize) != 0)
+            {
+                buffers[i].data = nullptr;
+                return false;
+            }
+
+            iovecs[i].iov_base = buffers[i].data;
+            iovecs[i].iov_len = kBufferSize;
+        }
+
+        return syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), kBufferCount) == 0;
+    }
+
+    bool open(const std::string &path) override
+    {
+        close();
+
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        position = 0;
+        current = 0;
+        failed = false;
+        return fd >= 0;
+    }
+
+    bool write(const void *data, size_t size) override
+    {
+        if (fd < 0 || failed)
+        {
+            return false;
+        }
+
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        while (size > 0)
+        {
+            Buffer &buffer = buffers[current];
+            size_t count = std::min(size, kBufferSize - buffer.used);
+            std::memcpy(buffer.data + buffer.used, bytes, count);
+            buffer.used += count;
+            bytes += count;
+            size -= count;
+
+            if (buffer.used < kBufferSize)
+            {
+                continue;
+            }
+
+            queueBuffer(0);
+            if ((pending >= kSubmitBatch && !submit(0)) || !acquireBuffer())
+            {
+                return false;
+            }
+        }
+
+        return !failed;
+    }
+
+    bool writeAt(uint64_t offset, const void *data, size_t size) override
+    {
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+
+        // Part of the region still in the unsubmitted buffer is patched in memory
+        if (offset + size > position)
+        {
+            uint64_t start = std::max(offset, position);
+            std::memcpy(buffers[current].data + (start - position), bytes + (start - offset), offset + size - start);
+            size = static_cast<size_t>(start - offset);
+        }
+
+        // The rest is written synchronously once queued writes of the region have landed
+        return size == 0 || (drain() && writeFully(fd, offset, bytes, size));
+    }
+
+    bool sync() override
+    {
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        if (buffers[current].used > 0)
+        {
+            // The tail write waits for every earlier write and the fsync is linked behind it
+            queueBuffer(IOSQE_IO_DRAIN | IOSQE_IO_LINK);
+            queueFsync(0);
+        }
+        else
+        {
+            queueFsync(IOSQE_IO_DRAIN);
+        }
+
+        return waitAll() && !failed;
+    }
+
+    bool close() override
+    {
+        if (fd < 0)
+        {
+            return true;
+        }
+
+        if (buffers[current].used > 0)
+        {
+            queueBuffer(0);
+        }
+
+        bool ok = waitAll() && !failed;
+        ok = ::close(fd) == 0 && ok;
+        fd = -1;
+        return ok;
+    }
+
+private:
+    static constexpr unsigned kQueueDepth = 32;
+    static constexpr size_t kBufferCount = 8;
+    static constexpr size_t kBufferSize = 256 * 1024;
+    static constexpr size_t kSubmitBatch = 4;
+    static constexpr uint64_t kFsyncTag = ~0ull;
+
+    struct Buffer
+    {
+        uint8_t *data = nullptr;
+        size_t used = 0;
+        bool inFlight = false;
+    };
+
+    io_uring_sqe *nextSqe()
+    {
+        unsigned tail = *sqTail;
+        if (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= sqEntries)
+        {
+            submit(0);
+        }
+
+        unsigned index = tail & sqMask;
+        io_uring_sqe *sqe = &sqes[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+        pending++;
+        return sqe;
+    }
+
+    // Queue the current buffer as a fixed-buffer write at the append position
+    void queueBuffer(uint8_t flags)
+    {
+        Buffer &buffer = buffers[current];
+
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_WRITE_FIXED;
+        sqe->flags = flags;
+        sqe->fd = fd;
+        sqe->off = position;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer.data);
+        sqe->len = static_cast<uint32_t>(buffer.used);
+        sqe->buf_index = static_cast<uint16_t>(current);
+        sqe->user_data = current;
+
+        position += buffer.used;
+        buffer.inFlight = true;
+        inFlight++;
+    }
+
+    void queueFsync(uint8_t flags)
+    {
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->flags = flags;
+        sqe->fd = fd;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->user_data = kFsyncTag;
+        inFlight++;
+    }
+
+    // Find a buffer that is not in flight, reaping completions if needed
+    bool acquireBuffer()
+    {
+        while (true)
+        {
+            for (size_t i = 0; i < buffers.size(); ++i)
+            {
+                if (!buffers[i].inFlight)
+                {
+                    current = i;
+                    buffers[i].used = 0;
+                    return true;
+                }
+            }
+
+            if (!submit(1))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Submit queued entries and wait for at least minComplete completions
+    bool submit(unsigned minComplete)
+    {
+        unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+        while (true)
+        {
+            long r = syscall(__NR_io_uring_enter, ringFd, pending, minComplete, flags, nullptr, 0);
+            if (r >= 0)
+            {
+                pending -= std::min<unsigned>(pending, static_cast<unsigned>(r));
+                break;
+            }
+
+            if (errno != EINTR)
+            {
+                failed = true;
+                return false;
+            }
+        }
+
+        reap();
+        return true;
+    }
+
+    void reap()
+    {
+        unsigned head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+        {
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            if (cqe.user_data == kFsyncTag)
+            {
+                failed = failed || cqe.res < 0;
+            }
+            else
+            {
+                Buffer &buffer = buffers[cqe.user_data];
+                failed = failed || cqe.res != static_cast<int>(buffer.used);
+                buffer.inFlight = false;
+                buffer.used = 0;
+            }
+
+            inFlight--;
+            head++;
+        }
+
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    // Wait for every queued write, keeping the current buffer
+    bool drain()
+    {
+        while (inFlight > 0 || pending > 0)
+        {
+            if (!submit(inFlight > 0 ? 1 : 0))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool waitAll()
+    {
+        return drain() && acquireBuffer();
+    }
+
+    void destroyRing()
+    {
+        for (Buffer &buffer : buffers)
+        {
+            std::free(buffer.data);
+        }
+
+        if (sqes)
+        {
+            munmap(sqes, sqesSize);
+        }
+
+        if (cqMap && cqMap != sqMap)
+        {
+            munmap(cqMap, cqMapSize);
+        }
+
+        if (sqMap)
+        {
+            munmap(sqMap, sqMapSize);
+        }
+
+        if (ringFd >= 0)
+        {
+            ::close(ringFd);
+        }
+    }
+
+    int ringFd = -1;
+    void *sqMap = nullptr;
+    void *cqMap = nullptr;
+    size_t sqMapSize = 0;
+    size_t cqMapSize = 0;
+    size_t sqesSize = 0;
+
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    io_uring_sqe *sqes = nullptr;
+
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe *cqes = nullptr;
+
+    std::vector<Buffer> buffers;
+    size_t current = 0;
+    unsigned pending = 0;
+    unsigned inFlight = 0;
+    bool failed = false;
+
+    int fd = -1;
+    uint64_t position = 0;
+};
+
+#endif
+
+} // namespace
+
+const char *fileBackendName(FileBackendType type) noexcept
+{
+    switch (type)
+    {
+        case FileBackendType::Stdio:
+            return "stdio";
+        case FileBackendType::Pwrite:
+            return "pwrite";
+        case FileBackendType::IoUring:
+            return "io_uring";
+        case FileBackendType::Direct:
+            return "direct";
+    }
+
+    return "unknown";
+}
+
+std::unique_ptr<FileBackend> createStdioFileBackend()
+{
+    return std::make_unique<StdioFileBackend>();
+}
+
+std::unique_ptr<FileBackend> createFileBackend(FileBackendType type)
+{
+#ifdef AUDIO_CAPTUREX_HAS_IO_URING
+    if (type == FileBackendType::IoUring)
+    {
+        auto backend = std::make_unique<IoUringFileBackend>();
+        if (backend->initialize())
+        {
+            return backend;
+        }
+
+        std::cerr << "io_uring is not available, falling back to pwrite" << std::endl;
+        type = FileBackendType::Pwrite;
+    }
+#endif
+
+#ifndef _WIN32
+    if (type == FileBackendType::Direct)
+    {
+        return std::make_unique<DirectFileBackend>();
+    }
+
+    if (type == FileBackendType::Pwrite || type == FileBackendType::IoUring)
+    {
+        return std::make_unique<PwriteFileBackend>();
+    }
+#endif
+
+    return createStdioFileBackend();
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,571 @@
+#include "fingerprint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+#include "dr_wav.h"
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Analysis grid shared by every fingerprint
+const int kAnalysisRate = 8000;
+const size_t kFftSize = 512;
+const size_t kHopSize = 128;
+
+// Lowpass transition below the analysis Nyquist frequency
+const double kFilterCutoff = 3600.0;
+const double kFilterTransition = 1000.0;
+
+// Bins searched for peaks (about 125 Hz to 3.75 kHz)
+const size_t kMinBin = 8;
+const size_t kMaxBin = 240;
+
+// A peak is the maximum of this many frames and bins on each side
+const uint32_t kPeakFrames = 3;
+const size_t kPeakBins = 6;
+
+// A peak must exceed the mean log power of its frame by about 10 dB
+const float kPeakThreshold = 2.3f;
+
+// Strongest peaks kept per frame
+const size_t kMaxPeaksPerFrame = 5;
+
+// Pairs per anchor and the zone in which targets are searched
+const uint16_t kFanout = 5;
+const uint32_t kMaxPairFrames = 63;
+const int kMaxPairBins = 63;
+
+// Hashes this common carry no information (silence, hum)
+const size_t kMaxPostings = 4096;
+
+const char kSidecarMagic[4] = {'A', 'F', 'P', '1'};
+const size_t kSidecarHeaderSize = 12;
+
+const double kPi = 3.14159265358979323846;
+
+void putU32(std::vector<uint8_t> &out, uint32_t value)
+{
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+}
+
+uint32_t getU32(const uint8_t *data)
+{
+    return static_cast<uint32_t>(data[0]) | static_cast<uint32_t>(data[1]) << 8 | static_cast<uint32_t>(data[2]) << 16 |
+           static_cast<uint32_t>(data[3]) << 24;
+}
+
+std::vector<uint8_t> sidecarHeader()
+{
+    std::vector<uint8_t> header(kSidecarMagic, kSidecarMagic + 4);
+    putU32(header, kAnalysisRate);
+    putU32(header, kHopSize);
+    return header;
+}
+
+bool writeLandmarks(FILE *file, const std::vector<Landmark> &landmarks)
+{
+    std::vector<uint8_t> bytes;
+    bytes.reserve(landmarks.size() * 8);
+    for (const Landmark &landmark : landmarks)
+    {
+        putU32(bytes, landmark.hash);
+        putU32(bytes, landmark.frame);
+    }
+
+    return std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
+
+} // namespace
+
+Fingerprinter::Fingerprinter(int sampleRate, int channelCount)
+    : step(static_cast<double>(sampleRate) / kAnalysisRate)
+    , mono(channelCount)
+    , position(0.0)
+    , fft(kFftSize)
+    , window(kFftSize)
+    , windowed(kFftSize)
+    , spectra(2 * kPeakFrames + 1, std::vector<float>(kFftSize / 2 + 2))
+    , frameCount(0)
+{
+    // Blackman windowed sinc, unity gain at DC
+    size_t half = static_cast<size_t>(std::ceil(2.75 * sampleRate / kFilterTransition));
+    double cutoff = std::min(kFilterCutoff / sampleRate, 0.5);
+    filter.resize(2 * half + 1);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < filter.size(); ++i)
+    {
+        double x = static_cast<double>(i) - half;
+        double sinc = x == 0.0 ? 2.0 * cutoff : std::sin(2.0 * kPi * cutoff * x) / (kPi * x);
+        double phase = 2.0 * kPi * i / (filter.size() - 1);
+        filter[i] = static_cast<float>(sinc * (0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase)));
+        sum += filter[i];
+    }
+
+    for (float &tap : filter)
+    {
+        tap = static_cast<float>(tap / sum);
+    }
+
+    // Silence before the first sample keeps the filter centred from the start
+    mono.appendSilence(half);
+    position = static_cast<double>(half);
+
+    hannWindow(window);
+}
+
+void Fingerprinter::process(const float *samples, size_t frameCount, std::vector<Landmark> &landmarks)
+{
+    mono.append(samples, frameCount);
+    resample(landmarks);
+}
+
+double Fingerprinter::frameSeconds() noexcept
+{
+    return static_cast<double>(kHopSize) / kAnalysisRate;
+}
+
+void Fingerprinter::resample(std::vector<Landmark> &landmarks)
+{
+    size_t half = filter.size() / 2;
+
+    // The nearest input sample is close enough at the analysis bandwidth
+    while (true)
+    {
+        size_t centre = static_cast<size_t>(position + 0.5);
+        if (mono.getStart() + centre + half >= mono.getEnd())
+        {
+            break;
+        }
+
+        const float *input = mono.data(mono.getStart() + centre - half);
+        float value = 0.0f;
+        for (size_t i = 0; i < filter.size(); ++i)
+        {
+            value += filter[i] * input[i];
+        }
+
+        analysis.push_back(value);
+        position += step;
+
+        if (analysis.size() == kFftSize)
+        {
+            analyseFrame(landmarks);
+            analysis.erase(analysis.begin(), analysis.begin() + kHopSize);
+        }
+    }
+
+    // Drop input the filter no longer reaches
+    size_t consumed = static_cast<size_t>(position) - half;
+    mono.discard(mono.getStart() + consumed);
+    position -= consumed;
+}
+
+void Fingerprinter::analyseFrame(std::vector<Landmark> &landmarks)
+{
+    for (size_t i = 0; i < kFftSize; ++i)
+    {
+        windowed[i] = analysis[i] * window[i];
+    }
+
+    // The last element holds the mean log power of the searched bins
+    std::vector<float> &spectrum = spectra[frameCount % spectra.size()];
+    fft.power(windowed.data(), spectrum.data());
+
+    float mean = 0.0f;
+    for (size_t bin = 0; bin <= kFftSize / 2; ++bin)
+    {
+        spectrum[bin] = std::log(spectrum[bin] + 1e-10f);
+        if (bin >= kMinBin && bin <= kMaxBin)
+        {
+            mean += spectrum[bin];
+        }
+    }
+
+    spectrum.back() = mean / (kMaxBin - kMinBin + 1);
+    frameCount++;
+
+    // Peaks are picked once the frames after them are known
+    if (frameCount < spectra.size())
+    {
+        return;
+    }
+
+    uint32_t centre = frameCount - 1 - kPeakFrames;
+    const std::vector<float> &candidate = spectra[centre % spectra.size()];
+    float threshold = candidate.back() + kPeakThreshold;
+
+    std::vector<std::pair<float, uint16_t>> found;
+    for (size_t bin = kMinBin; bin <= kMaxBin; ++bin)
+    {
+        float value = candidate[bin];
+        if (value < threshold)
+        {
+            continue;
+        }
+
+        bool peak = true;
+        for (const std::vector<float> &other : spectra)
+        {
+            for (size_t neighbour = bin - kPeakBins; neighbour <= bin + kPeakBins && peak; ++neighbour)
+            {
+                if (other[neighbour] > value || (&other == &candidate && neighbour < bin && other[neighbour] == value))
+                {
+                    peak = false;
+                }
+            }
+        }
+
+        if (peak)
+        {
+            found.emplace_back(value, static_cast<uint16_t>(bin));
+        }
+    }
+
+    if (found.size() > kMaxPeaksPerFrame)
+    {
+        std::partial_sort(found.begin(), found.begin() + kMaxPeaksPerFrame, found.end(), std::greater<>());
+        found.resize(kMaxPeaksPerFrame);
+    }
+
+    for (const auto &peak : found)
+    {
+        addPeak(centre, peak.second, landmarks);
+    }
+}
+
+void Fingerprinter::addPeak(uint32_t frame, uint16_t bin, std::vector<Landmark> &landmarks)
+{
+    // Anchors out of reach of this frame are done
+    size_t expired = 0;
+    while (expired < peaks.size() && peaks[expired].frame + kMaxPairFrames < frame)
+    {
+        expired++;
+    }
+
+    peaks.erase(peaks.begin(), peaks.begin() + expired);
+
+    // Targets arrive in time order, so each anchor pairs with its nearest peaks
+    for (Peak &anchor : peaks)
+    {
+        uint32_t distance = frame - anchor.frame;
+        if (distance == 0 || anchor.pairs >= kFanout || std::abs(static_cast<int>(bin) - anchor.bin) > kMaxPairBins)
+        {
+            continue;
+        }
+
+        Landmark landmark;
+        landmark.hash = static_cast<uint32_t>(anchor.bin) << 14 | static_cast<uint32_t>(bin) << 6 | distance;
+        landmark.frame = anchor.frame;
+        landmarks.push_back(landmark);
+        anchor.pairs++;
+    }
+
+    Peak peak;
+    peak.frame = frame;
+    peak.bin = bin;
+    peaks.push_back(peak);
+}
+
+FingerprintStage::FingerprintStage()
+    : file(nullptr)
+    , landmarkCount(0)
+{
+}
+
+FingerprintStage::~FingerprintStage()
+{
+    finish();
+}
+
+bool FingerprintStage::prepare(int sampleRate, int channelCount, const std::string &recordingFile)
+{
+    finish();
+
+    path = fingerprintSidecarPath(recordingFile);
+    file = std::fopen(path.c_str(), "wb");
+    std::vector<uint8_t> header = sidecarHeader();
+    if (!file || std::fwrite(header.data(), 1, header.size(), file) != header.size())
+    {
+        std::cerr << "Failed to create fingerprint file: " << path << std::endl;
+        finish();
+        return false;
+    }
+
+    fingerprinter = std::make_unique<Fingerprinter>(sampleRate, channelCount);
+    landmarkCount = 0;
+    return true;
+}
+
+void FingerprintStage::process(const float *samples, size_t frameCount)
+{
+    if (!file)
+    {
+        return;
+    }
+
+    pending.clear();
+    fingerprinter->process(samples, frameCount, pending);
+
+    if (!pending.empty() && !writeLandmarks(file, pending))
+    {
+        std::cerr << "Failed to write fingerprint file: " << path << std::endl;
+        finish();
+        return;
+    }
+
+    landmarkCount += pending.size();
+}
+
+void FingerprintStage::finish()
+{
+    if (file)
+    {
+        if (std::fclose(file) != 0)
+        {
+            std::cerr << "Failed to write fingerprint file: " << path << std::endl;
+        }
+
+        file = nullptr;
+    }
+
+    fingerprinter.reset();
+}
+
+uint64_t FingerprintStage::getLandmarkCount() const noexcept
+{
+    return landmarkCount;
+}
+
+void FingerprintIndex::add(uint32_t recording, const std::vector<Landmark> &landmarks)
+{
+    entries.reserve(entries.size() + landmarks.size());
+    for (const Landmark &landmark : landmarks)
+    {
+        entries.push_back({landmark.hash, recording, landmark.frame});
+    }
+}
+
+void FingerprintIndex::build()
+{
+    // Postings of one hash are grouped by recording, so repeats within a recording are counted in one pass
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.recording < b.recording;
+    });
+}
+
+size_t FingerprintIndex::size() const noexcept
+{
+    return entries.size();
+}
+
+std::vector<FingerprintMatch> FingerprintIndex::find(const std::vector<Landmark> &landmarks, double minScore) const
+{
+    struct Vote
+    {
+        double score = 0.0;
+        uint32_t queryStart = UINT32_MAX;
+        uint32_t queryEnd = 0;
+    };
+
+    // Recording and offset, biased to stay positive, in one key
+    auto makeKey = [](uint32_t recording, int64_t offset) {
+        return static_cast<uint64_t>(recording) << 32 | static_cast<uint32_t>(offset + 0x80000000ll);
+    };
+
+    // A hash repeating in the query votes for many offsets at once, each occurrence counts for its share
+    std::vector<uint32_t> queryHashes(landmarks.size());
+    std::transform(landmarks.begin(), landmarks.end(), queryHashes.begin(), [](const Landmark &landmark) {
+        return landmark.hash;
+    });
+    std::sort(queryHashes.begin(), queryHashes.end());
+
+    std::unordered_map<uint64_t, Vote> votes;
+    for (const Landmark &landmark : landmarks)
+    {
+        auto range = std::equal_range(entries.begin(), entries.end(), Entry{landmark.hash, 0, 0}, [](const Entry &a, const Entry &b) {
+            return a.hash < b.hash;
+        });
+
+        if (static_cast<size_t>(range.second - range.first) > kMaxPostings)
+        {
+            continue;
+        }
+
+        auto queryRange = std::equal_range(queryHashes.begin(), queryHashes.end(), landmark.hash);
+        double queryRepeats = static_cast<double>(queryRange.second - queryRange.first);
+
+        // Likewise for repeats within a recording, so periodic audio adds at most one vote per query landmark
+        for (auto run = range.first; run != range.second;)
+        {
+            auto runEnd = std::find_if(run, range.second, [run](const Entry &entry) {
+                return entry.recording != run->recording;
+            });
+            double weight = 1.0 / (queryRepeats * static_cast<double>(runEnd - run));
+
+            for (auto entry = run; entry != runEnd; ++entry)
+            {
+                Vote &vote = votes[makeKey(entry->recording, static_cast<int64_t>(entry->frame) - landmark.frame)];
+                vote.score += weight;
+                vote.queryStart = std::min(vote.queryStart, landmark.frame);
+                vote.queryEnd = std::max(vote.queryEnd, landmark.frame);
+            }
+
+            run = runEnd;
+        }
+    }
+
+    // Peaks jitter by a frame, neighbouring offsets count for the strongest of them
+    std::vector<FingerprintMatch> matches;
+    for (const auto &[key, vote] : votes)
+    {
+        FingerprintMatch match;
+        match.recording = static_cast<uint32_t>(key >> 32);
+        match.offset = static_cast<int64_t>(key & 0xFFFFFFFFull) - 0x80000000ll;
+        match.queryStart = vote.queryStart;
+        match.queryEnd = vote.queryEnd;
+        match.score = vote.score;
+
+        bool strongest = true;
+        for (int64_t delta : {-1, 1})
+        {
+            auto neighbour = votes.find(makeKey(match.recording, match.offset + delta));
+            if (neighbour == votes.end())
+            {
+                continue;
+            }
+
+            const Vote &other = neighbour->second;
+            if (other.score > vote.score || (other.score == vote.score && delta < 0))
+            {
+                strongest = false;
+            }
+
+            match.score += other.score;
+            match.queryStart = std::min(match.queryStart, other.queryStart);
+            match.queryEnd = std::max(match.queryEnd, other.queryEnd);
+        }
+
+        if (strongest && match.score >= minScore)
+        {
+            matches.push_back(match);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const FingerprintMatch &a, const FingerprintMatch &b) {
+        return a.score > b.score;
+    });
+
+    return matches;
+}
+
+std::string fingerprintSidecarPath(const std::string &recordingFile)
+{
+    return std::filesystem::path(recordingFile).replace_extension(".afp").string();
+}
+
+bool readFingerprintFile(const std::string &filename, Fingerprint &fingerprint)
+{
+    FILE *file = std::fopen(filename.c_str(), "rb");
+    if (!file)
+    {
+        std::cerr << "Failed to open fingerprint file: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[65536];
+    size_t read = 0;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    }
+
+    std::fclose(file);
+
+    if (bytes.size() < kSidecarHeaderSize || !std::equal(kSidecarMagic, kSidecarMagic + 4, bytes.begin()))
+    {
+        std::cerr << "Not a fingerprint file: " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t rate = getU32(bytes.data() + 4);
+    uint32_t hop = getU32(bytes.data() + 8);
+    if (rate == 0)
+    {
+        std::cerr << "Invalid fingerprint file: " << filename << std::endl;
+        return false;
+    }
+
+    // A trailing partial record is left over from an interrupted recording
+    size_t count = (bytes.size() - kSidecarHeaderSize) / 8;
+    fingerprint.frameSeconds = static_cast<double>(hop) / rate;
+    fingerprint.landmarks.resize(count);
+
+    const uint8_t *record = bytes.data() + kSidecarHeaderSize;
+    for (Landmark &landmark : fingerprint.landmarks)
+    {
+        landmark.hash = getU32(record);
+        landmark.frame = getU32(record + 4);
+        record += 8;
+    }
+
+    return true;
+}
+
+bool writeFingerprintFile(const std::string &filename, const Fingerprint &fingerprint)
+{
+    FILE *file = std::fopen(filename.c_str(), "wb");
+    if (!file)
+    {
+        std::cerr << "Failed to create fingerprint file: " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> header = sidecarHeader();
+    bool ok = std::fwrite(header.data(), 1, header.size(), file) == header.size() && writeLandmarks(file, fingerprint.landmarks);
+    ok = std::fclose(file) == 0 && ok;
+
+    if (!ok)
+    {
+        std::cerr << "Failed to write fingerprint file: " << filename << std::endl;
+    }
+
+    return ok;
+}
+
+bool fingerprintWavFile(const std::string &filename, Fingerprint &fingerprint)
+{
+    drwav wav;
+    if (!drwav_init_file(&wav, filename.c_str(), nullptr))
+    {
+        std::cerr << "Failed to open WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    Fingerprinter fingerprinter(static_cast<int>(wav.sampleRate), wav.channels);
+    fingerprint.frameSeconds = Fingerprinter::frameSeconds();
+    fingerprint.landmarks.clear();
+
+    const size_t chunkFrames = 16384;
+    std::vector<float> samples(chunkFrames * wav.channels);
+    drwav_uint64 read = 0;
+    while ((read = drwav_read_pcm_frames_f32(&wav, chunkFrames, samples.data())) > 0)
+    {
+        fingerprinter.process(samples.data(), static_cast<size_t>(read), fingerprint.landmarks);
+    }
+
+    drwav_uninit(&wav);
+    return true;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,353 @@
+#include "level_stats.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Bins per octave of level
+const int kBinsPerOctave = 6;
+
+// Mantissas of 2^(k/6) for k = 1..5, the bin edges within an octave
+const uint32_t kStepMantissas[kBinsPerOctave - 1] = {0x0FACD6, 0x214518, 0x3504F3, 0x4B2FF5, 0x6411F0};
+
+// Biased exponent of the octave just below full scale, [0.5, 1)
+const int kTopExponent = 126;
+
+// Level bin of one sample: octave below full scale from the exponent, sixth of the octave from the mantissa
+int levelBin(float sample) noexcept
+{
+    uint32_t bits;
+    std::memcpy(&bits, &sample, sizeof(bits));
+    bits &= 0x7FFFFFFF;
+
+    int exponent = static_cast<int>(bits >> 23);
+    uint32_t mantissa = bits & 0x7FFFFF;
+    int steps = 0;
+    for (uint32_t edge : kStepMantissas)
+    {
+        steps += mantissa >= edge ? 1 : 0;
+    }
+
+    int bin = kBinsPerOctave * (kTopExponent - exponent) + kBinsPerOctave - 1 - steps;
+    return std::clamp(bin, 0, static_cast<int>(LevelStats::kBinCount) - 1);
+}
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+// Level bins of four absolute samples, not yet clamped
+__m128i levelBins(__m128 magnitude) noexcept
+{
+    __m128i bits = _mm_castps_si128(magnitude);
+    __m128i exponent = _mm_srli_epi32(bits, 23);
+    __m128i mantissa = _mm_and_si128(bits, _mm_set1_epi32(0x7FFFFF));
+
+    // Each edge passed subtracts one (compare results are -1)
+    __m128i bin = _mm_sub_epi32(_mm_set1_epi32(kTopExponent), exponent);
+    bin = _mm_add_epi32(_mm_slli_epi32(bin, 2), _mm_slli_epi32(bin, 1));
+    bin = _mm_add_epi32(bin, _mm_set1_epi32(kBinsPerOctave - 1));
+    for (uint32_t edge : kStepMantissas)
+    {
+        bin = _mm_add_epi32(bin, _mm_cmpgt_epi32(mantissa, _mm_set1_epi32(static_cast<int>(edge - 1))));
+    }
+
+    return bin;
+}
+#elif defined(AUDIO_CAPTUREX_NEON)
+// Level bins of four absolute samples, not yet clamped
+int32x4_t levelBins(float32x4_t magnitude) noexcept
+{
+    uint32x4_t bits = vreinterpretq_u32_f32(magnitude);
+    int32x4_t exponent = vreinterpretq_s32_u32(vshrq_n_u32(bits, 23));
+    uint32x4_t mantissa = vandq_u32(bits, vdupq_n_u32(0x7FFFFF));
+
+    // Each edge passed subtracts one (compare results are -1)
+    int32x4_t bin = vmulq_n_s32(vsubq_s32(vdupq_n_s32(kTopExponent), exponent), kBinsPerOctave);
+    bin = vaddq_s32(bin, vdupq_n_s32(kBinsPerOctave - 1));
+    for (uint32_t edge : kStepMantissas)
+    {
+        bin = vaddq_s32(bin, vreinterpretq_s32_u32(vcgeq_u32(mantissa, vdupq_n_u32(edge))));
+    }
+
+    return bin;
+}
+#endif
+
+// Add to a counter that only this thread writes
+void addCounter(std::atomic<uint64_t> &counter, uint64_t value) noexcept
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+LevelStats::LevelStats()
+    : channelCount(0)
+    , activeRuns(0)
+{
+}
+
+void LevelStats::reset(int channelCount)
+{
+    if (channelCount != this->channelCount)
+    {
+        size_t channels = static_cast<size_t>(channelCount);
+        clippedSamples.reset(new std::atomic<uint64_t>[channels]());
+        clipRuns.reset(new std::atomic<uint64_t>[channels]());
+        longestClipRun.reset(new std::atomic<uint64_t>[channels]());
+        histogram.reset(new std::atomic<uint64_t>[channels * kBinCount]());
+        this->channelCount = channelCount;
+    }
+
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        clippedSamples[channel] = 0;
+        clipRuns[channel] = 0;
+        longestClipRun[channel] = 0;
+    }
+
+    for (size_t i = 0; i < static_cast<size_t>(channelCount) * kBinCount; ++i)
+    {
+        histogram[i] = 0;
+    }
+
+    blockHistogram.assign(static_cast<size_t>(channelCount) * kBinCount, 0);
+    blockClipped.assign(channelCount, 0);
+    runLength.assign(channelCount, 0);
+    activeRuns = 0;
+}
+
+void LevelStats::process(const float *samples, long frameCount) noexcept
+{
+    if (channelCount <= 0 || frameCount <= 0)
+    {
+        return;
+    }
+
+    size_t count = static_cast<size_t>(frameCount) * channelCount;
+    uint32_t *bins = blockHistogram.data();
+    int channel = 0;
+    size_t i = 0;
+
+    // Follow runs of clipped samples through the channels of a group of samples
+    auto trackClipping = [this](int channel, size_t sampleCount, uint32_t clippedMask) {
+        for (size_t j = 0; j < sampleCount; ++j)
+        {
+            uint64_t &run = runLength[channel];
+            if ((clippedMask >> j) & 1)
+            {
+                blockClipped[channel]++;
+                activeRuns += run == 0 ? 1 : 0;
+                run++;
+
+                if (run == kMinClipRun)
+                {
+                    addCounter(clipRuns[channel], 1);
+                }
+
+                if (run > longestClipRun[channel].load(std::memory_order_relaxed))
+                {
+                    longestClipRun[channel].store(run, std::memory_order_relaxed);
+                }
+            }
+            else if (run > 0)
+            {
+                run = 0;
+                activeRuns--;
+            }
+
+            if (++channel == channelCount)
+            {
+                channel = 0;
+            }
+        }
+    };
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 clipLevel = _mm_set1_ps(kClipLevel);
+    const __m128i lowestBin = _mm_setzero_si128();
+    const __m128i highestBin = _mm_set1_epi16(static_cast<int16_t>(kBinCount - 1));
+    alignas(16) int16_t groupBins[8];
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128 a = _mm_andnot_ps(signMask, _mm_loadu_ps(samples + i));
+        __m128 b = _mm_andnot_ps(signMask, _mm_loadu_ps(samples + i + 4));
+        uint32_t clipped = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(a, clipLevel)) |
+                                                 (_mm_movemask_ps(_mm_cmpge_ps(b, clipLevel)) << 4));
+
+        // Bins fit 16 bits, so clamp after packing both halves
+        __m128i packed = _mm_packs_epi32(levelBins(a), levelBins(b));
+        packed = _mm_min_epi16(_mm_max_epi16(packed, lowestBin), highestBin);
+        _mm_store_si128(reinterpret_cast<__m128i *>(groupBins), packed);
+
+        if (clipped != 0 || activeRuns != 0)
+        {
+            trackClipping(channel, 8, clipped);
+        }
+
+        for (int j = 0; j < 8; ++j)
+        {
+            bins[channel * kBinCount + groupBins[j]]++;
+            if (++channel == channelCount)
+            {
+                channel = 0;
+            }
+        }
+    }
+#elif defined(AUDIO_CAPTUREX_NEON)
+    const float32x4_t clipLevel = vdupq_n_f32(kClipLevel);
+    const int16x8_t lowestBin = vdupq_n_s16(0);
+    const int16x8_t highestBin = vdupq_n_s16(static_cast<int16_t>(kBinCount - 1));
+    int16_t groupBins[8];
+
+    for (; i + 8 <= count; i += 8)
+    {
+        float32x4_t a = vabsq_f32(vld1q_f32(samples + i));
+        float32x4_t b = vabsq_f32(vld1q_f32(samples + i + 4));
+
+        // One byte per sample, 0xFF where clipped
+        uint16x8_t clippedLanes = vcombine_u16(vmovn_u32(vcgeq_f32(a, clipLevel)), vmovn_u32(vcgeq_f32(b, clipLevel)));
+        uint64_t clippedBytes = vget_lane_u64(vreinterpret_u64_u8(vmovn_u16(clippedLanes)), 0);
+        uint32_t clipped = 0;
+        for (int j = 0; clippedBytes != 0 && j < 8; ++j)
+        {
+            clipped |= static_cast<uint32_t>((clippedBytes >> (8 * j)) & 1) << j;
+        }
+
+        int16x8_t packed = vcombine_s16(vqmovn_s32(levelBins(a)), vqmovn_s32(levelBins(b)));
+        vst1q_s16(groupBins, vminq_s16(vmaxq_s16(packed, lowestBin), highestBin));
+
+        if (clipped != 0 || activeRuns != 0)
+        {
+            trackClipping(channel, 8, clipped);
+        }
+
+        for (int j = 0; j < 8; ++j)
+        {
+            bins[channel * kBinCount + groupBins[j]]++;
+            if (++channel == channelCount)
+            {
+                channel = 0;
+            }
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        trackClipping(channel, 1, std::abs(samples[i]) >= kClipLevel ? 1 : 0);
+        bins[channel * kBinCount + levelBin(samples[i])]++;
+        if (++channel == channelCount)
+        {
+            channel = 0;
+        }
+    }
+
+    publish();
+}
+
+void LevelStats::publish() noexcept
+{
+    for (size_t i = 0; i < blockHistogram.size(); ++i)
+    {
+        if (blockHistogram[i] != 0)
+        {
+            addCounter(histogram[i], blockHistogram[i]);
+            blockHistogram[i] = 0;
+        }
+    }
+
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        if (blockClipped[channel] != 0)
+        {
+            addCounter(clippedSamples[channel], blockClipped[channel]);
+            blockClipped[channel] = 0;
+        }
+    }
+}
+
+std::vector<ChannelLevelStats> LevelStats::getChannels() const
+{
+    std::vector<ChannelLevelStats> channels(channelCount);
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        ChannelLevelStats &stats = channels[channel];
+        stats.clippedSamples = clippedSamples[channel].load(std::memory_order_relaxed);
+        stats.clipRuns = clipRuns[channel].load(std::memory_order_relaxed);
+        stats.longestClipRun = longestClipRun[channel].load(std::memory_order_relaxed);
+        stats.histogram.resize(kBinCount);
+        for (size_t bin = 0; bin < kBinCount; ++bin)
+        {
+            stats.histogram[bin] = histogram[channel * kBinCount + bin].load(std::memory_order_relaxed);
+        }
+    }
+
+    return channels;
+}
+
+void LevelStats::describe(std::vector<WavInfoEntry> &info) const
+{
+    std::vector<ChannelLevelStats> channels = getChannels();
+    if (channels.empty())
+    {
+        return;
+    }
+
+    std::ostringstream clipping;
+    std::ostringstream levels;
+    clipping << "Clipping";
+    levels << "Sample levels in " << kBinsPerOctave << " bins per octave from 0 dBFS";
+
+    for (size_t channel = 0; channel < channels.size(); ++channel)
+    {
+        const ChannelLevelStats &stats = channels[channel];
+        clipping << (channel == 0 ? " " : ", ") << "channel " << channel + 1 << " ";
+        if (stats.clippedSamples == 0)
+        {
+            clipping << "none";
+        }
+        else
+        {
+            clipping << stats.clippedSamples << " samples in " << stats.clipRuns << " runs (longest "
+                     << stats.longestClipRun << ")";
+        }
+
+        // Quiet trailing bins are left out
+        size_t used = kBinCount;
+        while (used > 0 && stats.histogram[used - 1] == 0)
+        {
+            used--;
+        }
+
+        levels << (channel == 0 ? ": " : "; ") << "channel " << channel + 1 << ":";
+        for (size_t bin = 0; bin < used; ++bin)
+        {
+            levels << " " << stats.histogram[bin];
+        }
+    }
+
+    WavInfoEntry summary;
+    summary.id = "ICMT";
+    summary.text = clipping.str();
+    info.push_back(summary);
+
+    WavInfoEntry histogramEntry;
+    histogramEntry.id = "ILVL";
+    histogramEntry.text = levels.str();
+    info.push_back(histogramEntry);
+}
+
+double LevelStats::binDecibels(size_t bin) noexcept
+{
+    return -20.0 * std::log10(2.0) * static_cast<double>(bin) / kBinsPerOctave;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,564 @@
+#include "loudness_meter.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+// Steps of 100 ms in a momentary (400 ms) and short-term (3 s) window
+const size_t kMomentarySteps = 4;
+const size_t kShortTermSteps = 30;
+
+// Gates of BS.1770 and EBU Tech 3342
+const double kAbsoluteGate = -70.0;
+const double kIntegratedRelativeGate = -10.0;
+const double kRangeRelativeGate = -20.0;
+
+// Histogram range and resolution for gating
+const double kHistogramTop = 10.0;
+const double kHistogramStep = 0.01;
+
+// Readings that can wait for the consumer (6.4 s)
+const size_t kReadingCapacity = 64;
+
+// Interpolation filter of BS.1770 Annex 2, taps of the four output phases
+const size_t kPeakTaps = 12;
+const float kPeakFilter[4][kPeakTaps] = {
+    {0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+     0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f},
+    {-0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+     0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f},
+    {-0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+     0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f},
+    {-0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+     0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f},
+};
+
+double energyToLoudness(double energy)
+{
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : -std::numeric_limits<double>::infinity();
+}
+
+float amplitudeToDecibels(float amplitude)
+{
+    return amplitude > 0.0f ? 20.0f * std::log10(amplitude) : -std::numeric_limits<float>::infinity();
+}
+
+size_t histogramBin(double loudness)
+{
+    double bin = std::floor((loudness - kAbsoluteGate) / kHistogramStep);
+    size_t binCount = static_cast<size_t>((kHistogramTop - kAbsoluteGate) / kHistogramStep);
+    return static_cast<size_t>(std::clamp(bin, 0.0, static_cast<double>(binCount - 1)));
+}
+
+// High shelf of the K-weighting curve for the sample rate (b0 b1 b2 a1 a2)
+void shelfCoefficients(double sampleRate, double *c)
+{
+    const double f0 = 1681.974450955533;
+    const double gain = 3.999843853973347;
+    const double q = 0.7071752369554196;
+
+    double k = std::tan(kPi * f0 / sampleRate);
+    double vh = std::pow(10.0, gain / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+
+    c[0] = (vh + vb * k / q + k * k) / a0;
+    c[1] = 2.0 * (k * k - vh) / a0;
+    c[2] = (vh - vb * k / q + k * k) / a0;
+    c[3] = 2.0 * (k * k - 1.0) / a0;
+    c[4] = (1.0 - k / q + k * k) / a0;
+}
+
+// Revised low-frequency B-weighting highpass for the sample rate (b0 b1 b2 a1 a2)
+void highpassCoefficients(double sampleRate, double *c)
+{
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+
+    double k = std::tan(kPi * f0 / sampleRate);
+    double a0 = 1.0 + k / q + k * k;
+
+    c[0] = 1.0;
+    c[1] = -2.0;
+    c[2] = 1.0;
+    c[3] = 2.0 * (k * k - 1.0) / a0;
+    c[4] = (1.0 - k / q + k * k) / a0;
+}
+
+} // namespace
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channelCount)
+    : channelCount(channelCount)
+    , pairCount((static_cast<size_t>(channelCount) + 1) / 2)
+    , stepFrames(std::max<size_t>(1, static_cast<size_t>(sampleRate) / 10))
+    , filterState(pairCount * 8, 0.0)
+    , channelEnergy(pairCount * 2, 0.0)
+    , channelWeights(channelCount, 1.0)
+    , peakHistory(static_cast<size_t>(channelCount) * (kPeakTaps - 1), 0.0f)
+    , stepEnergies(kShortTermSteps, 0.0)
+    , stepFilled(0)
+    , stepCount(0)
+    , frameCount(0)
+    , stepPeak(0.0f)
+    , maxPeak(0.0f)
+    , maxMomentary(0.0)
+    , maxShortTerm(0.0)
+{
+    shelfCoefficients(sampleRate, coefficients);
+    highpassCoefficients(sampleRate, coefficients + 5);
+
+    // Surround channels of 5.0 (L R C Ls Rs) and 5.1 (L R C LFE Ls Rs)
+    if (channelCount == 5)
+    {
+        channelWeights[3] = channelWeights[4] = 1.41;
+    }
+    else if (channelCount == 6)
+    {
+        channelWeights[3] = 0.0;
+        channelWeights[4] = channelWeights[5] = 1.41;
+    }
+
+    size_t binCount = histogramBin(kHistogramTop) + 1;
+    for (Histogram *histogram : {&momentaryBlocks, &shortTermBlocks})
+    {
+        histogram->counts.assign(binCount, 0);
+        histogram->energies.assign(binCount, 0.0);
+    }
+}
+
+void LoudnessMeter::process(const float *samples, size_t frameCount, std::vector<LoudnessReading> &readings)
+{
+    while (frameCount > 0)
+    {
+        size_t frames = std::min(frameCount, stepFrames - stepFilled);
+
+        filterFrames(samples, frames);
+        stepPeak = std::max(stepPeak, measureTruePeak(samples, frames));
+
+        samples += frames * channelCount;
+        frameCount -= frames;
+        stepFilled += frames;
+        this->frameCount += frames;
+
+        if (stepFilled == stepFrames)
+        {
+            finishStep(readings);
+        }
+    }
+}
+
+void LoudnessMeter::filterFrames(const float *samples, size_t frameCount)
+{
+    for (size_t pair = 0; pair < pairCount; ++pair)
+    {
+        size_t channel = pair * 2;
+        bool full = channel + 1 < static_cast<size_t>(channelCount);
+        const float *input = samples + channel;
+        double *state = filterState.data() + pair * 8;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+        __m128d b[2][5];
+        for (int stage = 0; stage < 2; ++stage)
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                b[stage][i] = _mm_set1_pd(coefficients[stage * 5 + i]);
+            }
+        }
+
+        __m128d s1a = _mm_loadu_pd(state);
+        __m128d s2a = _mm_loadu_pd(state + 2);
+        __m128d s1b = _mm_loadu_pd(state + 4);
+        __m128d s2b = _mm_loadu_pd(state + 6);
+        __m128d energy = _mm_setzero_pd();
+
+        for (size_t frame = 0; frame < frameCount; ++frame, input += channelCount)
+        {
+            __m128d x = full ? _mm_cvtps_pd(_mm_castsi128_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(input))))
+                             : _mm_set_pd(0.0, input[0]);
+
+            // Transposed direct form II, shelf then highpass
+            __m128d y = _mm_add_pd(_mm_mul_pd(b[0][0], x), s1a);
+            s1a = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b[0][1], x), _mm_mul_pd(b[0][3], y)), s2a);
+            s2a = _mm_sub_pd(_mm_mul_pd(b[0][2], x), _mm_mul_pd(b[0][4], y));
+
+            __m128d z = _mm_add_pd(_mm_mul_pd(b[1][0], y), s1b);
+            s1b = _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b[1][1], y), _mm_mul_pd(b[1][3], z)), s2b);
+            s2b = _mm_sub_pd(_mm_mul_pd(b[1][2], y), _mm_mul_pd(b[1][4], z));
+
+            energy = _mm_add_pd(energy, _mm_mul_pd(z, z));
+        }
+
+        _mm_storeu_pd(state, s1a);
+        _mm_storeu_pd(state + 2, s2a);
+        _mm_storeu_pd(state + 4, s1b);
+        _mm_storeu_pd(state + 6, s2b);
+
+        double sums[2];
+        _mm_storeu_pd(sums, energy);
+        channelEnergy[channel] += sums[0];
+        channelEnergy[channel + 1] += sums[1];
+#elif defined(AUDIO_CAPTUREX_NEON_AARCH64)
+        float64x2_t b[2][5];
+        for (int stage = 0; stage < 2; ++stage)
+        {
+            for (int i = 0; i < 5; ++i)
+            {
+                b[stage][i] = vdupq_n_f64(coefficients[stage * 5 + i]);
+            }
+        }
+
+        float64x2_t s1a = vld1q_f64(state);
+        float64x2_t s2a = vld1q_f64(state + 2);
+        float64x2_t s1b = vld1q_f64(state + 4);
+        float64x2_t s2b = vld1q_f64(state + 6);
+        float64x2_t energy = vdupq_n_f64(0.0);
+
+        for (size_t frame = 0; frame < frameCount; ++frame, input += channelCount)
+        {
+            float32x2_t pairInput = full ? vld1_f32(input) : vset_lane_f32(input[0], vdup_n_f32(0.0f), 0);
+            float64x2_t x = vcvt_f64_f32(pairInput);
+
+            // Transposed direct form II, shelf then highpass
+            float64x2_t y = vfmaq_f64(s1a, b[0][0], x);
+            s1a = vaddq_f64(vfmsq_f64(vmulq_f64(b[0][1], x), b[0][3], y), s2a);
+            s2a = vfmsq_f64(vmulq_f64(b[0][2], x), b[0][4], y);
+
+            float64x2_t z = vfmaq_f64(s1b, b[1][0], y);
+            s1b = vaddq_f64(vfmsq_f64(vmulq_f64(b[1][1], y), b[1][3], z), s2b);
+            s2b = vfmsq_f64(vmulq_f64(b[1][2], y), b[1][4], z);
+
+            energy = vfmaq_f64(energy, z, z);
+        }
+
+        vst1q_f64(state, s1a);
+        vst1q_f64(state + 2, s2a);
+        vst1q_f64(state + 4, s1b);
+        vst1q_f64(state + 6, s2b);
+
+        channelEnergy[channel] += vgetq_lane_f64(energy, 0);
+        channelEnergy[channel + 1] += vgetq_lane_f64(energy, 1);
+#else
+        const double *c = coefficients;
+        for (size_t lane = 0; lane < (full ? 2u : 1u); ++lane)
+        {
+            const float *laneInput = input + lane;
+            double s1a = state[lane];
+            double s2a = state[2 + lane];
+            double s1b = state[4 + lane];
+            double s2b = state[6 + lane];
+            double energy = 0.0;
+
+            for (size_t frame = 0; frame < frameCount; ++frame, laneInput += channelCount)
+            {
+                double x = *laneInput;
+                double y = c[0] * x + s1a;
+                s1a = c[1] * x - c[3] * y + s2a;
+                s2a = c[2] * x - c[4] * y;
+
+                double z = c[5] * y + s1b;
+                s1b = c[6] * y - c[8] * z + s2b;
+                s2b = c[7] * y - c[9] * z;
+
+                energy += z * z;
+            }
+
+            state[lane] = s1a;
+            state[2 + lane] = s2a;
+            state[4 + lane] = s1b;
+            state[6 + lane] = s2b;
+            channelEnergy[channel + lane] += energy;
+        }
+#endif
+
+        // Let decayed states reach zero rather than linger as denormals
+        for (int i = 0; i < 8; ++i)
+        {
+            if (std::abs(state[i]) < 1e-30)
+            {
+                state[i] = 0.0;
+            }
+        }
+    }
+}
+
+float LoudnessMeter::measureTruePeak(const float *samples, size_t frameCount)
+{
+    const size_t history = kPeakTaps - 1;
+    peakBuffer.resize(history + frameCount);
+    float peak = 0.0f;
+
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        float *previous = peakHistory.data() + channel * history;
+        std::copy(previous, previous + history, peakBuffer.begin());
+        for (size_t frame = 0; frame < frameCount; ++frame)
+        {
+            peakBuffer[history + frame] = samples[frame * channelCount + channel];
+        }
+
+        // Output n of phase p is the sum over k of filter[p][k] * input[n - k],
+        // the input of frame n is at n + history
+        const float *input = peakBuffer.data();
+        size_t frame = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+        __m128 taps[kPeakTaps];
+        for (size_t k = 0; k < kPeakTaps; ++k)
+        {
+            taps[k] = _mm_setr_ps(kPeakFilter[0][k], kPeakFilter[1][k], kPeakFilter[2][k], kPeakFilter[3][k]);
+        }
+
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 highest = _mm_setzero_ps();
+        for (; frame < frameCount; ++frame)
+        {
+            __m128 sum = _mm_mul_ps(taps[0], _mm_set1_ps(input[frame + history]));
+            for (size_t k = 1; k < kPeakTaps; ++k)
+            {
+                sum = _mm_add_ps(sum, _mm_mul_ps(taps[k], _mm_set1_ps(input[frame + history - k])));
+            }
+
+            highest = _mm_max_ps(highest, _mm_andnot_ps(signMask, sum));
+        }
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, highest);
+        peak = std::max({peak, lanes[0], lanes[1], lanes[2], lanes[3]});
+#elif defined(AUDIO_CAPTUREX_NEON_AARCH64)
+        float32x4_t taps[kPeakTaps];
+        for (size_t k = 0; k < kPeakTaps; ++k)
+        {
+            float phases[4] = {kPeakFilter[0][k], kPeakFilter[1][k], kPeakFilter[2][k], kPeakFilter[3][k]};
+            taps[k] = vld1q_f32(phases);
+        }
+
+        float32x4_t highest = vdupq_n_f32(0.0f);
+        for (; frame < frameCount; ++frame)
+        {
+            float32x4_t sum = vmulq_n_f32(taps[0], input[frame + history]);
+            for (size_t k = 1; k < kPeakTaps; ++k)
+            {
+                sum = vfmaq_n_f32(sum, taps[k], input[frame + history - k]);
+            }
+
+            highest = vmaxq_f32(highest, vabsq_f32(sum));
+        }
+
+        peak = std::max(peak, vmaxvq_f32(highest));
+#endif
+
+        for (; frame < frameCount; ++frame)
+        {
+            for (int phase = 0; phase < 4; ++phase)
+            {
+                float sum = 0.0f;
+                for (size_t k = 0; k < kPeakTaps; ++k)
+                {
+                    sum += kPeakFilter[phase][k] * input[frame + history - k];
+                }
+
+                peak = std::max(peak, std::abs(sum));
+            }
+        }
+
+        std::copy(peakBuffer.end() - history, peakBuffer.end(), previous);
+    }
+
+    return peak;
+}
+
+void LoudnessMeter::finishStep(std::vector<LoudnessReading> &readings)
+{
+    double energy = 0.0;
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        energy += channelWeights[channel] * channelEnergy[channel];
+    }
+
+    std::fill(channelEnergy.begin(), channelEnergy.end(), 0.0);
+    stepEnergies[stepCount % kShortTermSteps] = energy / static_cast<double>(stepFrames);
+    stepCount++;
+    stepFilled = 0;
+
+    // Windows cover the steps available until they are full
+    auto windowEnergy = [this](size_t steps) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(steps, stepCount));
+        double sum = 0.0;
+        for (size_t i = 1; i <= count; ++i)
+        {
+            sum += stepEnergies[(stepCount - i) % kShortTermSteps];
+        }
+
+        return sum / static_cast<double>(count);
+    };
+
+    double momentary = windowEnergy(kMomentarySteps);
+    double shortTerm = windowEnergy(kShortTermSteps);
+
+    // Gating blocks of 400 ms overlap by 75%, short-term blocks of 3 s are taken every step
+    if (stepCount >= kMomentarySteps)
+    {
+        addBlock(momentaryBlocks, momentary);
+        maxMomentary = std::max(maxMomentary, momentary);
+    }
+
+    if (stepCount >= kShortTermSteps)
+    {
+        addBlock(shortTermBlocks, shortTerm);
+        maxShortTerm = std::max(maxShortTerm, shortTerm);
+    }
+
+    maxPeak = std::max(maxPeak, stepPeak);
+
+    LoudnessReading reading;
+    reading.framePosition = frameCount;
+    reading.momentary = static_cast<float>(energyToLoudness(momentary));
+    reading.shortTerm = static_cast<float>(energyToLoudness(shortTerm));
+    reading.integrated = getSummary().integrated;
+    reading.truePeak = amplitudeToDecibels(stepPeak);
+    readings.push_back(reading);
+
+    stepPeak = 0.0f;
+}
+
+void LoudnessMeter::addBlock(Histogram &histogram, double energy)
+{
+    double loudness = energyToLoudness(energy);
+    if (loudness < kAbsoluteGate)
+    {
+        return;
+    }
+
+    size_t bin = histogramBin(loudness);
+    histogram.counts[bin]++;
+    histogram.energies[bin] += energy;
+}
+
+double LoudnessMeter::gatedEnergy(const Histogram &histogram, double gate)
+{
+    uint64_t count = 0;
+    double energy = 0.0;
+    for (size_t bin = histogramBin(gate); bin < histogram.counts.size(); ++bin)
+    {
+        count += histogram.counts[bin];
+        energy += histogram.energies[bin];
+    }
+
+    return count > 0 ? energy / static_cast<double>(count) : 0.0;
+}
+
+LoudnessSummary LoudnessMeter::getSummary() const
+{
+    LoudnessSummary summary;
+    summary.frameCount = frameCount;
+    summary.maxMomentary = static_cast<float>(energyToLoudness(maxMomentary));
+    summary.maxShortTerm = static_cast<float>(energyToLoudness(maxShortTerm));
+    summary.maxTruePeak = amplitudeToDecibels(std::max(maxPeak, stepPeak));
+
+    // Integrated: mean of the blocks above the absolute gate and 10 LU below their mean
+    double absolute = gatedEnergy(momentaryBlocks, kAbsoluteGate);
+    summary.integrated = static_cast<float>(energyToLoudness(
+        absolute > 0.0 ? gatedEnergy(momentaryBlocks, energyToLoudness(absolute) + kIntegratedRelativeGate) : 0.0));
+
+    // Range: 10th to 95th percentile of the short-term blocks within 20 LU of their mean
+    double shortTerm = gatedEnergy(shortTermBlocks, kAbsoluteGate);
+    if (shortTerm > 0.0)
+    {
+        size_t first = histogramBin(energyToLoudness(shortTerm) + kRangeRelativeGate);
+        uint64_t total = 0;
+        for (size_t bin = first; bin < shortTermBlocks.counts.size(); ++bin)
+        {
+            total += shortTermBlocks.counts[bin];
+        }
+
+        auto percentile = [&](double fraction) {
+            uint64_t target = static_cast<uint64_t>(fraction * static_cast<double>(total - 1));
+            uint64_t seen = 0;
+            for (size_t bin = first; bin < shortTermBlocks.counts.size(); ++bin)
+            {
+                seen += shortTermBlocks.counts[bin];
+                if (seen > target)
+                {
+                    return kAbsoluteGate + (static_cast<double>(bin) + 0.5) * kHistogramStep;
+                }
+            }
+
+            return kHistogramTop;
+        };
+
+        summary.loudnessRange = static_cast<float>(percentile(0.95) - percentile(0.10));
+    }
+
+    return summary;
+}
+
+LoudnessStage::LoudnessStage()
+    : readings(kReadingCapacity)
+    , droppedReadings(0)
+{
+}
+
+bool LoudnessStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    meter = std::make_unique<LoudnessMeter>(sampleRate, channelCount);
+    summary = LoudnessSummary();
+    return true;
+}
+
+void LoudnessStage::process(const float *samples, size_t frameCount)
+{
+    found.clear();
+    meter->process(samples, frameCount, found);
+
+    size_t written = readings.write(found.data(), found.size());
+    if (written < found.size())
+    {
+        droppedReadings.fetch_add(found.size() - written, std::memory_order_relaxed);
+    }
+}
+
+void LoudnessStage::finish()
+{
+    summary = meter->getSummary();
+}
+
+void LoudnessStage::describe(std::vector<WavInfoEntry> &info) const
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(1) << "Integrated loudness " << summary.integrated << " LUFS, loudness range "
+         << summary.loudnessRange << " LU, true peak " << summary.maxTruePeak << " dBTP, max momentary "
+         << summary.maxMomentary << " LUFS, max short-term " << summary.maxShortTerm << " LUFS";
+
+    WavInfoEntry entry;
+    entry.id = "ICMT";
+    entry.text = text.str();
+    info.push_back(entry);
+}
+
+size_t LoudnessStage::readReadings(LoudnessReading *readings, size_t maxCount) noexcept
+{
+    return this->readings.read(readings, maxCount);
+}
+
+uint64_t LoudnessStage::getDroppedReadings() const noexcept
+{
+    return droppedReadings.load();
+}
+
+LoudnessSummary LoudnessStage::getSummary() const
+{
+    return summary;
+}
+
+} // namespace AudioCaptureX
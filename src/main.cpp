@@ -4,6 +4,7 @@
  */
 
 #include "include/audio_capture.hpp"
+#include "include/loudness_meter.hpp"
 #include <atomic>
 #include <cmath>
 #include <fstream>
@@ -28,6 +29,7 @@ using namespace AudioCaptureX;
 // Global state
 std::atomic<bool> running{true};
 std::unique_ptr<AudioCapture> currentCapture = nullptr;
+std::shared_ptr<LoudnessStage> loudnessStage = nullptr;
 
 // Signal handler
 void signalHandler(int signal)
@@ -84,10 +86,21 @@ void audioCallback(const std::vector<float> &audioData, int frameCount, int samp
 
     float rms = std::sqrt(sum / audioData.size());
 
+    // Keep the latest loudness reading
+    static LoudnessReading loudness;
+    LoudnessReading readings[16];
+    size_t readingCount = loudnessStage ? loudnessStage->readReadings(readings, 16) : 0;
+    if (readingCount > 0)
+    {
+        loudness = readings[readingCount - 1];
+    }
+
     // Log every 500 callbacks (reduced frequency)
     if (callCount % 500 == 0)
     {
-        std::cout << "Audio #" << callCount << " - Peak: " << peak << ", RMS: " << rms << std::endl;
+        std::cout << "Audio #" << callCount << " - Peak: " << peak << ", RMS: " << rms
+                  << ", Momentary: " << loudness.momentary << " LUFS, Short-term: " << loudness.shortTerm
+                  << " LUFS, Integrated: " << loudness.integrated << " LUFS" << std::endl;
     }
 }
 
@@ -143,6 +156,10 @@ void startCapture()
     currentCapture = std::make_unique<AudioCapture>(audioCallback);
     currentCapture->setOutputFile("captured-audio.wav");
 
+    // Loudness is metered while capturing and summarized in the WAV file
+    loudnessStage = std::make_shared<LoudnessStage>();
+    currentCapture->addStage(loudnessStage);
+
     if (currentCapture->startCapture(deviceIndex))
     {
         std::cout << "Audio capture started. Type 'stop' to stop and save." << std::endl;
@@ -159,6 +176,7 @@ void startCapture()
     {
         std::cout << "Failed to start audio capture" << std::endl;
         currentCapture = nullptr;
+        loudnessStage = nullptr;
     }
 }
 
@@ -173,6 +191,10 @@ void stopCapture()
     // Stop the capture
     currentCapture->stopCapture();
 
+    LoudnessSummary loudness = loudnessStage->getSummary();
+    std::cout << "Integrated loudness: " << loudness.integrated << " LUFS, loudness range: " << loudness.loudnessRange
+              << " LU, true peak: " << loudness.maxTruePeak << " dBTP" << std::endl;
+
     // Save recorded audio as WAV file
     if (currentCapture->saveRecordedAudio())
     {
@@ -185,6 +207,7 @@ void stopCapture()
 
     // Clean up
     currentCapture.reset();
+    loudnessStage = nullptr;
     std::cout << "Capture stopped" << std::endl;
 }
 
@@ -215,11 +238,26 @@ void showStatus()
     }
 }
 
+void addMarker(const std::string &label)
+{
+    if (!currentCapture || !currentCapture->isCapturing())
+    {
+        std::cout << "Not capturing" << std::endl;
+        return;
+    }
+
+    if (currentCapture->addMarker(label))
+    {
+        std::cout << "Marked: " << label << std::endl;
+    }
+}
+
 void showHelp()
 {
     std::cout << "\nCommands:" << std::endl;
     std::cout << "  start    - Start audio capture" << std::endl;
     std::cout << "  stop     - Stop capture and save to file" << std::endl;
+    std::cout << "  mark     - Mark the current position in the recording (mark <label>)" << std::endl;
     std::cout << "  devices  - List available audio devices" << std::endl;
     std::cout << "  status   - Show current status" << std::endl;
     std::cout << "  help     - Show this help" << std::endl;
@@ -254,6 +292,10 @@ int main()
         {
             stopCapture();
         }
+        else if (command == "mark" || command.rfind("mark ", 0) == 0)
+        {
+            addMarker(command.size() > 5 ? command.substr(5) : "Marker");
+        }
         else if (command == "devices")
         {
             listDevices();
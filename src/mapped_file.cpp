@@ -0,0 +1,167 @@
+#include "mapped_file.hpp"
+#include <algorithm>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace AudioCaptureX
+{
+
+MappedFile::MappedFile()
+    : mapping(nullptr)
+    , mappingSize(0)
+#ifdef _WIN32
+    , fileHandle(nullptr)
+    , mappingHandle(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        std::cerr << "Cannot map empty file: " << path << std::endl;
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *address = view ? MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!address)
+    {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        if (view)
+        {
+            CloseHandle(view);
+        }
+
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = view;
+    mapping = static_cast<const uint8_t *>(address);
+    mappingSize = static_cast<uint64_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "Failed to open file: " << path << std::endl;
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0 || status.st_size <= 0)
+    {
+        std::cerr << "Cannot map empty file: " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+
+    // The mapping keeps the file referenced, the descriptor is not needed anymore
+    void *address = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+    {
+        std::cerr << "Failed to map file: " << path << std::endl;
+        return false;
+    }
+
+    mapping = static_cast<const uint8_t *>(address);
+    mappingSize = static_cast<uint64_t>(status.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::close() noexcept
+{
+    if (!mapping)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mappingHandle));
+    CloseHandle(static_cast<HANDLE>(fileHandle));
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t *>(mapping), static_cast<size_t>(mappingSize));
+#endif
+
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+bool MappedFile::isOpen() const noexcept
+{
+    return mapping != nullptr;
+}
+
+const uint8_t *MappedFile::data() const noexcept
+{
+    return mapping;
+}
+
+uint64_t MappedFile::size() const noexcept
+{
+    return mappingSize;
+}
+
+void MappedFile::adviseSequential() noexcept
+{
+#ifndef _WIN32
+    if (mapping)
+    {
+        madvise(const_cast<uint8_t *>(mapping), static_cast<size_t>(mappingSize), MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::release(uint64_t offset, uint64_t size) noexcept
+{
+#ifndef _WIN32
+    if (!mapping || offset >= mappingSize)
+    {
+        return;
+    }
+
+    // Rounded out to whole pages, a page shared with the next range is simply loaded again
+    uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    uint64_t start = offset / pageSize * pageSize;
+    uint64_t end = std::min(offset + size, mappingSize);
+    if (end > start)
+    {
+        madvise(const_cast<uint8_t *>(mapping) + start, static_cast<size_t>(end - start), MADV_DONTNEED);
+    }
+#endif
+}
+
+} // namespace AudioCaptureX
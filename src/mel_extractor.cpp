@@ -0,0 +1,205 @@
+#include "mel_extractor.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+float hertzToMel(double frequency)
+{
+    return static_cast<float>(2595.0 * std::log10(1.0 + frequency / 700.0));
+}
+
+double melToHertz(double mel)
+{
+    return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0);
+}
+
+// Power of two FFT size holding the window
+size_t fftSize(size_t windowSize)
+{
+    size_t size = 4;
+    while (size < windowSize)
+    {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+size_t windowFrames(const MelSettings &settings, int sampleRate)
+{
+    return std::max<size_t>(2, static_cast<size_t>(std::lround(settings.windowSeconds * sampleRate)));
+}
+
+// Frames of the stage ring, independent of the sample rate so the ring outlives sessions
+size_t ringFrames(const MelSettings &settings, double ringSeconds)
+{
+    return settings.hopSeconds > 0.0 ? std::max<size_t>(16, static_cast<size_t>(ringSeconds / settings.hopSeconds)) : 0;
+}
+
+} // namespace
+
+MelExtractor::MelExtractor(int sampleRate, int channelCount, const MelSettings &settings)
+    : logFloor(settings.logFloor)
+    , windowSize(windowFrames(settings, sampleRate))
+    , hopSize(std::max<size_t>(1, static_cast<size_t>(std::lround(settings.hopSeconds * sampleRate))))
+    , fft(fftSize(windowSize))
+    , window(windowSize)
+    , windowed(fft.size(), 0.0f)
+    , power(fft.size() / 2 + 1)
+    , mono(channelCount)
+    , nextWindow(0)
+{
+    hannWindow(window);
+
+    // Band edges equally spaced in mel, band b rises from edge b to b + 1 and falls to b + 2
+    double maxFrequency = settings.maxFrequency > 0.0f ? settings.maxFrequency : sampleRate / 2.0;
+    double minMel = hertzToMel(settings.minFrequency);
+    double maxMel = hertzToMel(maxFrequency);
+    std::vector<double> edges(static_cast<size_t>(settings.bandCount) + 2);
+    for (size_t i = 0; i < edges.size(); ++i)
+    {
+        edges[i] = melToHertz(minMel + (maxMel - minMel) * static_cast<double>(i) / (edges.size() - 1));
+    }
+
+    double binWidth = static_cast<double>(sampleRate) / fft.size();
+    bands.resize(static_cast<size_t>(settings.bandCount));
+    for (size_t b = 0; b < bands.size(); ++b)
+    {
+        Band &band = bands[b];
+        band.weightOffset = weights.size();
+        for (size_t bin = 0; bin < power.size(); ++bin)
+        {
+            double frequency = bin * binWidth;
+            double rising = (frequency - edges[b]) / (edges[b + 1] - edges[b]);
+            double falling = (edges[b + 2] - frequency) / (edges[b + 2] - edges[b + 1]);
+            double weight = std::min(rising, falling);
+            if (weight <= 0.0)
+            {
+                continue;
+            }
+
+            if (band.binCount == 0)
+            {
+                band.firstBin = bin;
+            }
+
+            // Triangles are convex, so the bins under one are consecutive
+            weights.push_back(static_cast<float>(weight));
+            band.binCount++;
+        }
+    }
+}
+
+void MelExtractor::process(const float *samples, size_t frameCount, FeatureRing &features)
+{
+    mono.append(samples, frameCount);
+
+    while (mono.getEnd() >= nextWindow + windowSize)
+    {
+        float *frame = features.beginFrame();
+        if (frame)
+        {
+            analyseWindow(mono.data(nextWindow), frame);
+            features.commitFrame();
+        }
+
+        nextWindow += hopSize;
+    }
+
+    mono.discard(nextWindow);
+}
+
+void MelExtractor::analyseWindow(const float *input, float *frame)
+{
+    for (size_t i = 0; i < windowSize; ++i)
+    {
+        windowed[i] = input[i] * window[i];
+    }
+
+    fft.power(windowed.data(), power.data());
+
+    for (size_t b = 0; b < bands.size(); ++b)
+    {
+        const Band &band = bands[b];
+        const float *bandPower = power.data() + band.firstBin;
+        const float *bandWeights = weights.data() + band.weightOffset;
+        float energy = 0.0f;
+        for (size_t i = 0; i < band.binCount; ++i)
+        {
+            energy += bandPower[i] * bandWeights[i];
+        }
+
+        frame[b] = std::log(std::max(energy, logFloor));
+    }
+}
+
+size_t MelExtractor::getBandCount() const noexcept
+{
+    return bands.size();
+}
+
+size_t MelExtractor::getHopFrames() const noexcept
+{
+    return hopSize;
+}
+
+size_t MelExtractor::getWindowFrames() const noexcept
+{
+    return windowSize;
+}
+
+bool MelExtractor::validSettings(const MelSettings &settings, int sampleRate) noexcept
+{
+    float nyquist = sampleRate / 2.0f;
+    float maxFrequency = settings.maxFrequency > 0.0f ? settings.maxFrequency : nyquist;
+    return settings.bandCount > 0 && settings.windowSeconds > 0.0 && settings.hopSeconds > 0.0 &&
+           settings.minFrequency >= 0.0f && maxFrequency > settings.minFrequency && maxFrequency <= nyquist &&
+           settings.logFloor > 0.0f && windowFrames(settings, sampleRate) <= static_cast<size_t>(sampleRate);
+}
+
+MelStage::MelStage(const MelSettings &settings, double ringSeconds)
+    : settings(settings)
+    , features(ringFrames(settings, ringSeconds), static_cast<size_t>(std::max(0, settings.bandCount)))
+    , hopFrames(0)
+{
+}
+
+bool MelStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    if (!MelExtractor::validSettings(settings, sampleRate))
+    {
+        std::cerr << "Invalid mel settings for " << sampleRate << " Hz: " << settings.bandCount << " bands, "
+                  << settings.minFrequency << "-" << settings.maxFrequency << " Hz, window " << settings.windowSeconds
+                  << " s, hop " << settings.hopSeconds << " s" << std::endl;
+        return false;
+    }
+
+    // Consumers may be reading, so the ring is cleared rather than reallocated
+    extractor = std::make_unique<MelExtractor>(sampleRate, channelCount, settings);
+    hopFrames.store(extractor->getHopFrames(), std::memory_order_relaxed);
+    features.clear();
+    return true;
+}
+
+void MelStage::process(const float *samples, size_t frameCount)
+{
+    extractor->process(samples, frameCount, features);
+}
+
+const FeatureRing &MelStage::getFeatures() const noexcept
+{
+    return features;
+}
+
+size_t MelStage::getHopFrames() const noexcept
+{
+    return hopFrames.load(std::memory_order_relaxed);
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,306 @@
+#include "mfcc_extractor.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Log-mel frames buffered between the mel extractor and the DCT
+const size_t kMelRingFrames = 64;
+
+// Input is fed to the mel extractor in slices that fill at most half the ring
+const size_t kMelSliceHops = kMelRingFrames / 2;
+
+const double kPi = 3.14159265358979323846;
+
+// Frames of the stage ring, independent of the sample rate so the ring outlives sessions
+size_t ringFrames(const MfccSettings &settings, double ringSeconds)
+{
+    return settings.mel.hopSeconds > 0.0
+               ? std::max<size_t>(16, static_cast<size_t>(ringSeconds / settings.mel.hopSeconds))
+               : 0;
+}
+
+// Values per frame of the stage ring
+size_t featureCount(const MfccSettings &settings)
+{
+    return static_cast<size_t>(std::max(0, settings.coefficientCount)) * (settings.deltas ? 3 : 1);
+}
+
+// output[c] = sum over i of matrix[i * columns + c] * input[i], columns is a multiple of 4
+void matrixVector(const float *matrix, const float *input, size_t inputCount, size_t columns, float *output) noexcept
+{
+    for (size_t c = 0; c < columns; c += 4)
+    {
+        const float *column = matrix + c;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+        __m128 sum = _mm_setzero_ps();
+        for (size_t i = 0; i < inputCount; ++i)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(column + i * columns), _mm_set1_ps(input[i])));
+        }
+
+        _mm_storeu_ps(output + c, sum);
+#elif defined(AUDIO_CAPTUREX_NEON)
+        float32x4_t sum = vdupq_n_f32(0.0f);
+        for (size_t i = 0; i < inputCount; ++i)
+        {
+            sum = vmlaq_n_f32(sum, vld1q_f32(column + i * columns), input[i]);
+        }
+
+        vst1q_f32(output + c, sum);
+#else
+        float sum[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (size_t i = 0; i < inputCount; ++i)
+        {
+            for (size_t k = 0; k < 4; ++k)
+            {
+                sum[k] += column[i * columns + k] * input[i];
+            }
+        }
+
+        std::copy(sum, sum + 4, output + c);
+#endif
+    }
+}
+
+// accumulator += row * scale, count is a multiple of 4
+void multiplyAdd(float *accumulator, const float *row, float scale, size_t count) noexcept
+{
+    size_t i = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    __m128 factor = _mm_set1_ps(scale);
+    for (; i < count; i += 4)
+    {
+        _mm_storeu_ps(accumulator + i, _mm_add_ps(_mm_loadu_ps(accumulator + i), _mm_mul_ps(_mm_loadu_ps(row + i), factor)));
+    }
+#elif defined(AUDIO_CAPTUREX_NEON)
+    for (; i < count; i += 4)
+    {
+        vst1q_f32(accumulator + i, vmlaq_n_f32(vld1q_f32(accumulator + i), vld1q_f32(row + i), scale));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        accumulator[i] += row[i] * scale;
+    }
+}
+
+} // namespace
+
+MfccExtractor::MfccExtractor(int sampleRate, int channelCount, const MfccSettings &settings)
+    : channelCount(channelCount)
+    , mel(sampleRate, channelCount, settings.mel)
+    , melFrames(kMelRingFrames, mel.getBandCount())
+    , coefficientCount(static_cast<size_t>(settings.coefficientCount))
+    , paddedCount((coefficientCount + 3) / 4 * 4)
+    , deltaWindow(settings.deltas ? settings.deltaWindow : 0)
+    , deltaScale(0.0f)
+    , historyRows(settings.deltas ? 4 * static_cast<size_t>(settings.deltaWindow) + 4 : 1)
+    , melCount(0)
+    , deltaCount(0)
+    , outputCount(0)
+{
+    // Orthonormal DCT-II with the lifter applied to each coefficient
+    size_t bandCount = mel.getBandCount();
+    dct.assign(bandCount * paddedCount, 0.0f);
+    for (size_t k = 0; k < coefficientCount; ++k)
+    {
+        double lifter = settings.lifter > 0.0f ? 1.0 + settings.lifter / 2.0 * std::sin(kPi * k / settings.lifter) : 1.0;
+        double norm = std::sqrt((k == 0 ? 1.0 : 2.0) / bandCount);
+        for (size_t b = 0; b < bandCount; ++b)
+        {
+            dct[b * paddedCount + k] = static_cast<float>(lifter * norm * std::cos(kPi * k * (b + 0.5) / bandCount));
+        }
+    }
+
+    int sum = 0;
+    for (int n = 1; n <= deltaWindow; ++n)
+    {
+        sum += n * n;
+    }
+
+    deltaScale = sum > 0 ? 1.0f / (2.0f * sum) : 0.0f;
+    cepstra.assign(historyRows * paddedCount, 0.0f);
+    deltas.assign(historyRows * paddedCount, 0.0f);
+    deltaDeltas.assign(paddedCount, 0.0f);
+}
+
+void MfccExtractor::process(const float *samples, size_t frameCount, FeatureRing &features)
+{
+    // Slices keep the mel ring from wrapping before its frames are taken
+    size_t sliceFrames = kMelSliceHops * mel.getHopFrames();
+    for (size_t done = 0; done < frameCount;)
+    {
+        size_t frames = std::min(sliceFrames, frameCount - done);
+        mel.process(samples + done * channelCount, frames, melFrames);
+        update(features, false);
+        done += frames;
+    }
+}
+
+void MfccExtractor::finish(FeatureRing &features)
+{
+    update(features, true);
+}
+
+size_t MfccExtractor::getFeatureCount() const noexcept
+{
+    return coefficientCount * (deltaWindow > 0 ? 3 : 1);
+}
+
+size_t MfccExtractor::getHopFrames() const noexcept
+{
+    return mel.getHopFrames();
+}
+
+bool MfccExtractor::validSettings(const MfccSettings &settings, int sampleRate) noexcept
+{
+    return MelExtractor::validSettings(settings.mel, sampleRate) && settings.coefficientCount > 0 &&
+           settings.coefficientCount <= settings.mel.bandCount && settings.lifter >= 0.0f &&
+           (!settings.deltas || settings.deltaWindow > 0);
+}
+
+void MfccExtractor::update(FeatureRing &features, bool flushing)
+{
+    for (; melCount < melFrames.getFrameCount(); ++melCount)
+    {
+        float *row = cepstra.data() + (melCount % historyRows) * paddedCount;
+        matrixVector(dct.data(), melFrames.getFrames(melCount, 1).data, mel.getBandCount(), paddedCount, row);
+
+        if (deltaWindow == 0)
+        {
+            float *frame = features.beginFrame();
+            if (frame)
+            {
+                std::copy(row, row + coefficientCount, frame);
+                features.commitFrame();
+            }
+
+            outputCount++;
+            continue;
+        }
+
+        // Deltas once the cepstra deltaWindow frames ahead exist
+        while (deltaCount + deltaWindow < melCount + 1)
+        {
+            float *row = deltas.data() + (deltaCount % historyRows) * paddedCount;
+            regression(cepstra, static_cast<int64_t>(deltaCount), melCount + 1, row);
+            deltaCount++;
+        }
+
+        // Delta-deltas once the deltas deltaWindow frames ahead exist
+        while (outputCount + deltaWindow < deltaCount)
+        {
+            writeFrame(features);
+        }
+    }
+
+    if (flushing && deltaWindow > 0)
+    {
+        // Past the end the last frame repeats
+        while (deltaCount < melCount)
+        {
+            float *row = deltas.data() + (deltaCount % historyRows) * paddedCount;
+            regression(cepstra, static_cast<int64_t>(deltaCount), melCount, row);
+            deltaCount++;
+        }
+
+        while (outputCount < deltaCount)
+        {
+            writeFrame(features);
+        }
+    }
+}
+
+void MfccExtractor::writeFrame(FeatureRing &features)
+{
+    regression(deltas, static_cast<int64_t>(outputCount), deltaCount, deltaDeltas.data());
+
+    float *frame = features.beginFrame();
+    if (frame)
+    {
+        const float *coefficients = cepstra.data() + (outputCount % historyRows) * paddedCount;
+        const float *delta = deltas.data() + (outputCount % historyRows) * paddedCount;
+        std::copy(coefficients, coefficients + coefficientCount, frame);
+        std::copy(delta, delta + coefficientCount, frame + coefficientCount);
+        std::copy(deltaDeltas.data(), deltaDeltas.data() + coefficientCount, frame + 2 * coefficientCount);
+        features.commitFrame();
+    }
+
+    outputCount++;
+}
+
+const float *MfccExtractor::historyRow(const std::vector<float> &history, int64_t index, uint64_t count) const noexcept
+{
+    uint64_t row = static_cast<uint64_t>(std::clamp<int64_t>(index, 0, static_cast<int64_t>(count) - 1));
+    return history.data() + (row % historyRows) * paddedCount;
+}
+
+void MfccExtractor::regression(const std::vector<float> &history, int64_t index, uint64_t count, float *output) const noexcept
+{
+    std::fill(output, output + paddedCount, 0.0f);
+    for (int n = 1; n <= deltaWindow; ++n)
+    {
+        float weight = n * deltaScale;
+        multiplyAdd(output, historyRow(history, index + n, count), weight, paddedCount);
+        multiplyAdd(output, historyRow(history, index - n, count), -weight, paddedCount);
+    }
+}
+
+MfccStage::MfccStage(const MfccSettings &settings, double ringSeconds)
+    : settings(settings)
+    , features(ringFrames(settings, ringSeconds), featureCount(settings))
+    , hopFrames(0)
+{
+}
+
+bool MfccStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    if (!MfccExtractor::validSettings(settings, sampleRate))
+    {
+        std::cerr << "Invalid MFCC settings for " << sampleRate << " Hz: " << settings.coefficientCount
+                  << " coefficients of " << settings.mel.bandCount << " bands, lifter " << settings.lifter
+                  << ", delta window " << settings.deltaWindow << std::endl;
+        return false;
+    }
+
+    // Consumers may be reading, so the ring is cleared rather than reallocated
+    extractor = std::make_unique<MfccExtractor>(sampleRate, channelCount, settings);
+    hopFrames.store(extractor->getHopFrames(), std::memory_order_relaxed);
+    features.clear();
+    return true;
+}
+
+void MfccStage::process(const float *samples, size_t frameCount)
+{
+    extractor->process(samples, frameCount, features);
+}
+
+void MfccStage::finish()
+{
+    if (extractor)
+    {
+        extractor->finish(features);
+    }
+}
+
+const FeatureRing &MfccStage::getFeatures() const noexcept
+{
+    return features;
+}
+
+size_t MfccStage::getHopFrames() const noexcept
+{
+    return hopFrames.load(std::memory_order_relaxed);
+}
+
+} // namespace AudioCaptureX
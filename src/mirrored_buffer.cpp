@@ -0,0 +1,287 @@
+#include "mirrored_buffer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Another thread may map into the reserved range before both views are placed
+const int kMapAttempts = 4;
+
+size_t mappingGranularity() noexcept
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifndef _WIN32
+// Anonymous shared memory file of the given size, -1 on failure
+int createSharedFile(size_t bytes)
+{
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    int fd = memfd_create("audiocapturex-ring", MFD_CLOEXEC);
+#else
+    // Unlinked right away, the mappings keep the memory alive
+    static std::atomic<unsigned> counter(0);
+    std::string name = "/audiocapturex-" + std::to_string(getpid()) + "-" + std::to_string(counter++);
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+    {
+        shm_unlink(name.c_str());
+    }
+#endif
+
+    if (fd >= 0 && ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+#endif
+
+} // namespace
+
+MirroredBuffer::MirroredBuffer()
+    : mapping(nullptr)
+    , bufferSize(0)
+    , mirrored(false)
+#ifdef _WIN32
+    , sectionHandle(nullptr)
+#endif
+{
+}
+
+MirroredBuffer::~MirroredBuffer()
+{
+    release();
+}
+
+bool MirroredBuffer::allocate(size_t minimumBytes)
+{
+    release();
+    size_t bytes = roundSize(minimumBytes);
+    if (mapMirrored(bytes))
+    {
+        bufferSize = bytes;
+        mirrored = true;
+        return true;
+    }
+
+    heap.reset(new (std::nothrow) uint8_t[2 * bytes]());
+    if (!heap)
+    {
+        return false;
+    }
+
+    mapping = heap.get();
+    bufferSize = bytes;
+    return true;
+}
+
+bool MirroredBuffer::mapMirrored(size_t bytes)
+{
+#ifdef _WIN32
+    HANDLE section = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<uint64_t>(bytes) >> 32),
+                                        static_cast<DWORD>(bytes & 0xFFFFFFFFu), nullptr);
+    if (!section)
+    {
+        return false;
+    }
+
+    // Find a free range of twice the size, then place both views in it
+    for (int attempt = 0; attempt < kMapAttempts; ++attempt)
+    {
+        void *range = VirtualAlloc(nullptr, 2 * bytes, MEM_RESERVE, PAGE_NOACCESS);
+        if (!range)
+        {
+            break;
+        }
+
+        VirtualFree(range, 0, MEM_RELEASE);
+        uint8_t *start = static_cast<uint8_t *>(range);
+        void *first = MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes, start);
+        void *second = first ? MapViewOfFileEx(section, FILE_MAP_ALL_ACCESS, 0, 0, bytes, start + bytes) : nullptr;
+        if (second)
+        {
+            mapping = start;
+            sectionHandle = section;
+            return true;
+        }
+
+        if (first)
+        {
+            UnmapViewOfFile(first);
+        }
+    }
+
+    CloseHandle(section);
+    return false;
+#else
+    int fd = createSharedFile(bytes);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // Reserve twice the size, then map the file over both halves
+    void *range = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    bool mapped = range != MAP_FAILED;
+    uint8_t *start = static_cast<uint8_t *>(range);
+    for (int copy = 0; mapped && copy < 2; ++copy)
+    {
+        void *view = mmap(start + copy * bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        mapped = view == start + copy * bytes;
+    }
+
+    // The mappings keep the file referenced, the descriptor is not needed anymore
+    close(fd);
+    if (!mapped)
+    {
+        if (range != MAP_FAILED)
+        {
+            munmap(range, 2 * bytes);
+        }
+
+        return false;
+    }
+
+    mapping = start;
+    return true;
+#endif
+}
+
+void MirroredBuffer::release() noexcept
+{
+    if (mapping && mirrored)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping + bufferSize);
+        UnmapViewOfFile(mapping);
+        CloseHandle(static_cast<HANDLE>(sectionHandle));
+        sectionHandle = nullptr;
+#else
+        munmap(mapping, 2 * bufferSize);
+#endif
+    }
+
+    heap.reset();
+    mapping = nullptr;
+    bufferSize = 0;
+    mirrored = false;
+}
+
+uint8_t *MirroredBuffer::data() const noexcept
+{
+    return mapping;
+}
+
+size_t MirroredBuffer::size() const noexcept
+{
+    return bufferSize;
+}
+
+bool MirroredBuffer::isMirrored() const noexcept
+{
+    return mirrored;
+}
+
+void MirroredBuffer::write(size_t offset, const void *source, size_t byteCount) noexcept
+{
+    if (!mapping)
+    {
+        return;
+    }
+
+    // With the double mapping one copy through the second half wraps by itself
+    const uint8_t *bytes = static_cast<const uint8_t *>(source);
+    if (mirrored)
+    {
+        std::memcpy(mapping + offset, bytes, byteCount);
+        return;
+    }
+
+    size_t first = std::min(byteCount, bufferSize - offset);
+    std::memcpy(mapping + offset, bytes, first);
+    std::memcpy(mapping + offset + bufferSize, bytes, first);
+    std::memcpy(mapping, bytes + first, byteCount - first);
+    std::memcpy(mapping + bufferSize, bytes + first, byteCount - first);
+}
+
+size_t MirroredBuffer::roundSize(size_t minimumBytes) noexcept
+{
+    size_t granularity = mappingGranularity();
+    return std::max<size_t>(1, (minimumBytes + granularity - 1) / granularity) * granularity;
+}
+
+MirroredBufferPool::MirroredBufferPool(size_t maxIdleBuffers)
+    : maxIdleBuffers(maxIdleBuffers)
+{
+}
+
+std::unique_ptr<MirroredBuffer> MirroredBufferPool::acquire(size_t minimumBytes)
+{
+    size_t bytes = MirroredBuffer::roundSize(minimumBytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto match = std::find_if(idle.begin(), idle.end(),
+                                  [bytes](const std::unique_ptr<MirroredBuffer> &buffer) { return buffer->size() == bytes; });
+        if (match != idle.end())
+        {
+            std::unique_ptr<MirroredBuffer> buffer = std::move(*match);
+            idle.erase(match);
+            return buffer;
+        }
+    }
+
+    auto buffer = std::make_unique<MirroredBuffer>();
+    if (!buffer->allocate(bytes))
+    {
+        return nullptr;
+    }
+
+    return buffer;
+}
+
+void MirroredBufferPool::recycle(std::unique_ptr<MirroredBuffer> buffer)
+{
+    if (!buffer || !buffer->data())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (idle.size() < maxIdleBuffers)
+    {
+        idle.push_back(std::move(buffer));
+    }
+}
+
+size_t MirroredBufferPool::getIdleCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return idle.size();
+}
+
+} // namespace AudioCaptureX
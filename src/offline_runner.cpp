@@ -0,0 +1,310 @@
+#include "offline_runner.hpp"
+#include "wav_reader.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include "dr_wav.h"
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Frames decoded per chunk (about 1.4 s at 48 kHz)
+const uint64_t kChunkFrames = 65536;
+
+// Decoded chunks that may wait for the consumers, per decoder thread
+const size_t kChunksPerDecoder = 2;
+
+// Frames per data callback, the default capture buffer size
+const size_t kDefaultBlockFrames = 4096;
+
+// Chunk buffer shared by the consumers once decoded
+struct ChunkSlot
+{
+    std::vector<float> samples;
+    uint64_t index = 0;
+    size_t frameCount = 0;
+    bool claimed = false; // Being decoded
+    bool ready = false;   // Decoded, waiting for consumers
+    size_t pending = 0;   // Consumers that have not processed the chunk yet
+};
+
+// Chunks moving from the decoder threads to the consumers. Chunk i always
+// uses slot i % slots.size(), so a decoder can only run ahead of the slowest
+// consumer by the number of slots.
+struct ChunkPipeline
+{
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<ChunkSlot> slots;
+    uint64_t chunkCount = 0;
+    uint64_t frameCount = 0;
+    uint64_t nextChunk = 0; // Next chunk to claim for decoding
+    size_t consumers = 0;
+    bool failed = false;
+};
+
+// Decode chunks from the shared mapping if the file could be mapped, otherwise with a dr_wav decoder of its own
+void decodeChunks(ChunkPipeline &pipeline, const WavReader &reader, const std::string &filename, int channelCount)
+{
+    drwav wav;
+    if (!reader.isOpen() && !drwav_init_file(&wav, filename.c_str(), nullptr))
+    {
+        std::cerr << "Failed to open WAV file: " << filename << std::endl;
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        pipeline.failed = true;
+        pipeline.cv.notify_all();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(pipeline.mutex);
+    while (true)
+    {
+        pipeline.cv.wait(lock, [&pipeline] {
+            if (pipeline.failed || pipeline.nextChunk >= pipeline.chunkCount)
+            {
+                return true;
+            }
+
+            const ChunkSlot &slot = pipeline.slots[pipeline.nextChunk % pipeline.slots.size()];
+            return !slot.claimed && !slot.ready;
+        });
+
+        if (pipeline.failed || pipeline.nextChunk >= pipeline.chunkCount)
+        {
+            break;
+        }
+
+        uint64_t index = pipeline.nextChunk++;
+        ChunkSlot &slot = pipeline.slots[index % pipeline.slots.size()];
+        slot.claimed = true;
+        lock.unlock();
+
+        uint64_t firstFrame = index * kChunkFrames;
+        size_t frameCount = static_cast<size_t>(std::min(kChunkFrames, pipeline.frameCount - firstFrame));
+        slot.samples.resize(static_cast<size_t>(kChunkFrames) * channelCount);
+        bool ok = reader.isOpen() ? reader.readFrames(firstFrame, slot.samples.data(), frameCount) == frameCount
+                                  : drwav_seek_to_pcm_frame(&wav, firstFrame) &&
+                                        drwav_read_pcm_frames_f32(&wav, frameCount, slot.samples.data()) == frameCount;
+
+        lock.lock();
+        if (!ok)
+        {
+            std::cerr << "Failed to read frames " << firstFrame << "-" << firstFrame + frameCount << " of " << filename
+                      << std::endl;
+            pipeline.failed = true;
+        }
+
+        slot.index = index;
+        slot.frameCount = frameCount;
+        slot.claimed = false;
+        slot.ready = true;
+        slot.pending = pipeline.consumers;
+        pipeline.cv.notify_all();
+    }
+
+    lock.unlock();
+    if (!reader.isOpen())
+    {
+        drwav_uninit(&wav);
+    }
+}
+
+// Hand every chunk to one consumer in order, false if decoding failed
+bool consumeChunks(ChunkPipeline &pipeline, const std::function<void(const float *, size_t)> &process)
+{
+    for (uint64_t index = 0; index < pipeline.chunkCount; ++index)
+    {
+        ChunkSlot &slot = pipeline.slots[index % pipeline.slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(pipeline.mutex);
+            pipeline.cv.wait(lock, [&pipeline, &slot, index] {
+                return pipeline.failed || (slot.ready && slot.index == index);
+            });
+
+            if (pipeline.failed)
+            {
+                return false;
+            }
+        }
+
+        process(slot.samples.data(), slot.frameCount);
+
+        std::lock_guard<std::mutex> lock(pipeline.mutex);
+        if (--slot.pending == 0)
+        {
+            slot.ready = false;
+            pipeline.cv.notify_all();
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+OfflineRunner::OfflineRunner(AudioDataCallback callback)
+    : callback(std::move(callback))
+    , decoderThreads(0)
+    , blockFrames(kDefaultBlockFrames)
+{
+}
+
+void OfflineRunner::setCallback(AudioDataCallback callback)
+{
+    this->callback = std::move(callback);
+}
+
+void OfflineRunner::addStage(std::shared_ptr<AudioStage> stage)
+{
+    if (stage)
+    {
+        stages.push_back(std::move(stage));
+    }
+}
+
+void OfflineRunner::clearStages()
+{
+    stages.clear();
+}
+
+void OfflineRunner::setDecoderThreads(unsigned count)
+{
+    decoderThreads = count;
+}
+
+void OfflineRunner::setBlockFrames(size_t frames)
+{
+    blockFrames = std::max<size_t>(1, frames);
+}
+
+bool OfflineRunner::run(const std::string &filename, OfflineResult &result)
+{
+    auto start = std::chrono::steady_clock::now();
+    result = OfflineResult();
+
+    drwav wav;
+    if (!drwav_init_file(&wav, filename.c_str(), nullptr))
+    {
+        std::cerr << "Failed to open WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    int sampleRate = static_cast<int>(wav.sampleRate);
+    int channelCount = static_cast<int>(wav.channels);
+    uint64_t frameCount = wav.totalPCMFrameCount;
+
+    // Compressed formats decode from the start to seek, chunks are read sequentially
+    bool seekable = wav.translatedFormatTag == DR_WAVE_FORMAT_PCM || wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT;
+
+    // The formats a capture writes are converted straight from one mapping shared by the decoders
+    bool mappable = (wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && (wav.bitsPerSample == 16 || wav.bitsPerSample == 24)) ||
+                    (wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT && wav.bitsPerSample == 32);
+    drwav_uninit(&wav);
+
+    WavReader reader;
+    if (mappable && reader.open(filename))
+    {
+        frameCount = reader.getFrameCount();
+    }
+
+    if (sampleRate <= 0 || channelCount <= 0)
+    {
+        std::cerr << "Invalid WAV format: " << filename << std::endl;
+        return false;
+    }
+
+    result.frameCount = frameCount;
+    result.sampleRate = sampleRate;
+    result.channelCount = channelCount;
+
+    std::vector<std::shared_ptr<AudioStage>> activeStages;
+    for (const std::shared_ptr<AudioStage> &stage : stages)
+    {
+        if (stage->prepare(sampleRate, channelCount, filename))
+        {
+            activeStages.push_back(stage);
+        }
+    }
+
+    LevelStats levelStats;
+    levelStats.reset(channelCount);
+
+    ChunkPipeline pipeline;
+    pipeline.frameCount = frameCount;
+    pipeline.chunkCount = (frameCount + kChunkFrames - 1) / kChunkFrames;
+    pipeline.consumers = activeStages.size() + 1;
+
+    unsigned decoders = decoderThreads > 0 ? decoderThreads : std::max(1u, std::thread::hardware_concurrency());
+    if (!seekable)
+    {
+        decoders = 1;
+    }
+
+    decoders = static_cast<unsigned>(std::max<uint64_t>(1, std::min<uint64_t>(decoders, pipeline.chunkCount)));
+    pipeline.slots.resize(decoders * kChunksPerDecoder);
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < decoders; ++i)
+    {
+        threads.emplace_back(decodeChunks, std::ref(pipeline), std::cref(reader), std::cref(filename), channelCount);
+    }
+
+    for (const std::shared_ptr<AudioStage> &stage : activeStages)
+    {
+        threads.emplace_back([&pipeline, stage] {
+            consumeChunks(pipeline, [&stage](const float *samples, size_t frames) {
+                stage->process(samples, frames);
+            });
+        });
+    }
+
+    // The data callback gets blocks the size of a capture buffer, like a live session
+    std::vector<float> block;
+    bool ok = consumeChunks(pipeline, [&](const float *samples, size_t frames) {
+        levelStats.process(samples, static_cast<long>(frames));
+
+        if (!callback)
+        {
+            return;
+        }
+
+        for (size_t done = 0; done < frames; done += blockFrames)
+        {
+            size_t count = std::min(blockFrames, frames - done);
+            block.assign(samples + done * channelCount, samples + (done + count) * channelCount);
+            callback(block, static_cast<int>(count), sampleRate, channelCount);
+        }
+    });
+
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const std::shared_ptr<AudioStage> &stage : activeStages)
+    {
+        stage->finish();
+        stage->describe(result.info);
+    }
+
+    levelStats.describe(result.info);
+    result.channelLevels = levelStats.getChannels();
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (result.seconds > 0.0)
+    {
+        result.realtimeFactor = static_cast<double>(frameCount) / sampleRate / result.seconds;
+    }
+
+    return ok && !pipeline.failed;
+}
+
+} // namespace AudioCaptureX
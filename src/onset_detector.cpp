@@ -0,0 +1,229 @@
+#include "onset_detector.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Compression of the magnitude spectrum before differencing
+const float kCompression = 100.0f;
+
+// Flux a peak needs even after silence, per frequency bin
+const float kFluxFloor = 0.05f;
+
+// Time over which the mean flux is taken for the threshold
+const double kThresholdSeconds = 0.1;
+
+// Energy rise is measured over this many samples when placing an onset
+const size_t kRiseSamples = 32;
+
+// Share of the largest energy rise that marks the attack when placing an onset
+const float kRiseShare = 0.5f;
+
+// Onsets that can wait for the consumer
+const size_t kEventCapacity = 256;
+
+// Analysis size for the sample rate, 512 points at 44.1 and 48 kHz
+size_t analysisSize(int sampleRate)
+{
+    size_t size = 256;
+    while (size * 48000 < static_cast<size_t>(sampleRate) * 512)
+    {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+} // namespace
+
+OnsetDetector::OnsetDetector(int sampleRate, int channelCount, float threshold, double minIntervalSeconds)
+    : threshold(threshold)
+    , minInterval(static_cast<uint64_t>(minIntervalSeconds * sampleRate))
+    , hopSize(analysisSize(sampleRate) / 2)
+    , fft(analysisSize(sampleRate))
+    , window(fft.size())
+    , windowed(fft.size())
+    , power(fft.size() / 2 + 1)
+    , previousMagnitude(fft.size() / 2 + 1, 0.0f)
+    , fluxHistory(std::max<size_t>(2, static_cast<size_t>(kThresholdSeconds * sampleRate / hopSize)), 0.0f)
+    , mono(channelCount)
+    , frameIndex(0)
+    , nextOnset(0)
+    , previousFlux(0.0f)
+{
+    hannWindow(window);
+}
+
+void OnsetDetector::process(const float *samples, size_t frameCount, std::vector<OnsetEvent> &onsets)
+{
+    mono.append(samples, frameCount);
+
+    // Analysis frame k covers [k * hop, k * hop + size)
+    while (mono.getEnd() >= frameIndex * hopSize + fft.size())
+    {
+        analyseFrame(onsets);
+    }
+}
+
+void OnsetDetector::analyseFrame(std::vector<OnsetEvent> &onsets)
+{
+    const float *input = mono.data(frameIndex * hopSize);
+    for (size_t i = 0; i < fft.size(); ++i)
+    {
+        windowed[i] = input[i] * window[i];
+    }
+
+    fft.power(windowed.data(), power.data());
+
+    // Sum of magnitude increases, normalized by the number of bins
+    float flux = 0.0f;
+    for (size_t bin = 0; bin < power.size(); ++bin)
+    {
+        float magnitude = std::log1p(kCompression * std::sqrt(power[bin]));
+        flux += std::max(magnitude - previousMagnitude[bin], 0.0f);
+        previousMagnitude[bin] = magnitude;
+    }
+
+    flux /= static_cast<float>(power.size());
+
+    // The previous frame is an onset if it is a local flux maximum above the
+    // threshold of the frames before it. The first frames only fill the history,
+    // the audio appearing from nothing is not an onset.
+    if (frameIndex >= 2)
+    {
+        uint64_t candidate = frameIndex - 1;
+        bool trained = candidate > fluxHistory.size();
+        float mean = 0.0f;
+        for (float value : fluxHistory)
+        {
+            mean += value;
+        }
+
+        mean /= static_cast<float>(fluxHistory.size());
+        float limit = threshold * mean + kFluxFloor;
+        float before = fluxHistory[(candidate - 1) % fluxHistory.size()];
+
+        if (trained && previousFlux > before && previousFlux >= flux && previousFlux > limit)
+        {
+            // The rise can start anywhere after the window before the candidate began, a
+            // burst reaching that window's centre already raises its flux but not to the peak
+            uint64_t position = locateOnset((candidate - 1) * hopSize, frameIndex * hopSize + fft.size());
+            if (position >= nextOnset)
+            {
+                OnsetEvent event;
+                event.framePosition = position;
+                event.strength = previousFlux / limit;
+                onsets.push_back(event);
+                nextOnset = position + minInterval;
+            }
+        }
+
+        fluxHistory[candidate % fluxHistory.size()] = previousFlux;
+    }
+
+    previousFlux = flux;
+    frameIndex++;
+
+    // Keep the windows of the two previous frames for locating onsets
+    if (frameIndex >= 2)
+    {
+        mono.discard((frameIndex - 2) * hopSize);
+    }
+}
+
+uint64_t OnsetDetector::locateOnset(uint64_t start, uint64_t end)
+{
+    const float *samples = mono.data(start);
+    size_t count = static_cast<size_t>(end - start);
+    if (count <= 2 * kRiseSamples)
+    {
+        return start;
+    }
+
+    // Energy of the kRiseSamples after each position minus the kRiseSamples before it
+    rise.resize(count - 2 * kRiseSamples + 1);
+    float before = 0.0f;
+    float after = 0.0f;
+    for (size_t i = 0; i < kRiseSamples; ++i)
+    {
+        before += samples[i] * samples[i];
+        after += samples[i + kRiseSamples] * samples[i + kRiseSamples];
+    }
+
+    rise[0] = after - before;
+    float bestRise = rise[0];
+
+    for (size_t i = kRiseSamples + 1; i + kRiseSamples <= count; ++i)
+    {
+        float leaving = samples[i - kRiseSamples - 1];
+        float moving = samples[i - 1];
+        float entering = samples[i + kRiseSamples - 1];
+        before += moving * moving - leaving * leaving;
+        after += entering * entering - moving * moving;
+
+        rise[i - kRiseSamples] = after - before;
+        bestRise = std::max(bestRise, after - before);
+    }
+
+    // Inside a loud burst the rise between two windows is mostly chance and can
+    // beat the attack itself, so take the peak of the first rise that comes
+    // close to the largest one
+    size_t first = 0;
+    while (rise[first] < kRiseShare * bestRise)
+    {
+        first++;
+    }
+
+    size_t best = first;
+    for (size_t i = first; i < rise.size() && i <= first + kRiseSamples; ++i)
+    {
+        if (rise[i] > rise[best])
+        {
+            best = i;
+        }
+    }
+
+    return start + kRiseSamples + best;
+}
+
+OnsetStage::OnsetStage(float threshold, double minIntervalSeconds)
+    : threshold(threshold)
+    , minIntervalSeconds(minIntervalSeconds)
+    , events(kEventCapacity)
+    , droppedEvents(0)
+{
+}
+
+bool OnsetStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    detector = std::make_unique<OnsetDetector>(sampleRate, channelCount, threshold, minIntervalSeconds);
+    return true;
+}
+
+void OnsetStage::process(const float *samples, size_t frameCount)
+{
+    found.clear();
+    detector->process(samples, frameCount, found);
+
+    size_t written = events.write(found.data(), found.size());
+    if (written < found.size())
+    {
+        droppedEvents.fetch_add(found.size() - written, std::memory_order_relaxed);
+    }
+}
+
+size_t OnsetStage::readEvents(OnsetEvent *events, size_t maxCount) noexcept
+{
+    return this->events.read(events, maxCount);
+}
+
+uint64_t OnsetStage::getDroppedEvents() const noexcept
+{
+    return droppedEvents.load();
+}
+
+} // namespace AudioCaptureX
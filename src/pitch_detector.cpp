@@ -0,0 +1,213 @@
+#include "pitch_detector.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Estimates that can wait for the consumer (seconds of hops)
+const double kQueueSeconds = 2.0;
+
+// Sum of (x[j] - x[j + lag])^2 over count samples for four consecutive lags,
+// sharing the loads of x between them
+void squaredDifference4(const float *x, size_t lag, size_t count, float *sums) noexcept
+{
+    const float *y = x + lag;
+    size_t j = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    __m128 a0 = _mm_setzero_ps();
+    __m128 a1 = _mm_setzero_ps();
+    __m128 a2 = _mm_setzero_ps();
+    __m128 a3 = _mm_setzero_ps();
+    for (; j + 4 <= count; j += 4)
+    {
+        __m128 v = _mm_loadu_ps(x + j);
+        __m128 d0 = _mm_sub_ps(v, _mm_loadu_ps(y + j));
+        __m128 d1 = _mm_sub_ps(v, _mm_loadu_ps(y + j + 1));
+        __m128 d2 = _mm_sub_ps(v, _mm_loadu_ps(y + j + 2));
+        __m128 d3 = _mm_sub_ps(v, _mm_loadu_ps(y + j + 3));
+        a0 = _mm_add_ps(a0, _mm_mul_ps(d0, d0));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(d1, d1));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(d2, d2));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(d3, d3));
+    }
+
+    // Transpose so each lane holds the total of one lag
+    _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+    _mm_storeu_ps(sums, _mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3)));
+#elif defined(AUDIO_CAPTUREX_NEON)
+    float32x4_t a0 = vdupq_n_f32(0.0f);
+    float32x4_t a1 = vdupq_n_f32(0.0f);
+    float32x4_t a2 = vdupq_n_f32(0.0f);
+    float32x4_t a3 = vdupq_n_f32(0.0f);
+    for (; j + 4 <= count; j += 4)
+    {
+        float32x4_t v = vld1q_f32(x + j);
+        float32x4_t d0 = vsubq_f32(v, vld1q_f32(y + j));
+        float32x4_t d1 = vsubq_f32(v, vld1q_f32(y + j + 1));
+        float32x4_t d2 = vsubq_f32(v, vld1q_f32(y + j + 2));
+        float32x4_t d3 = vsubq_f32(v, vld1q_f32(y + j + 3));
+        a0 = vmlaq_f32(a0, d0, d0);
+        a1 = vmlaq_f32(a1, d1, d1);
+        a2 = vmlaq_f32(a2, d2, d2);
+        a3 = vmlaq_f32(a3, d3, d3);
+    }
+
+    float32x4_t accumulators[4] = {a0, a1, a2, a3};
+    for (int k = 0; k < 4; ++k)
+    {
+        float32x4_t total = accumulators[k];
+        sums[k] = (vgetq_lane_f32(total, 0) + vgetq_lane_f32(total, 1)) + (vgetq_lane_f32(total, 2) + vgetq_lane_f32(total, 3));
+    }
+#else
+    sums[0] = sums[1] = sums[2] = sums[3] = 0.0f;
+#endif
+
+    for (; j < count; ++j)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            float d = x[j] - y[j + k];
+            sums[k] += d * d;
+        }
+    }
+}
+
+bool validSettings(const PitchSettings &settings, int sampleRate)
+{
+    return settings.minFrequency > 0.0f && settings.maxFrequency > settings.minFrequency &&
+           settings.maxFrequency * 2.0f <= static_cast<float>(sampleRate) && settings.hopSeconds > 0.0 &&
+           settings.threshold > 0.0f && settings.threshold < 1.0f;
+}
+
+} // namespace
+
+PitchDetector::PitchDetector(int sampleRate, int channelCount, const PitchSettings &settings)
+    : sampleRate(static_cast<float>(sampleRate))
+    , threshold(settings.threshold)
+    , minLag(std::max<size_t>(2, static_cast<size_t>(sampleRate / settings.maxFrequency)))
+    , maxLag(std::max(minLag + 1, static_cast<size_t>(std::ceil(sampleRate / settings.minFrequency))))
+    , windowSize(maxLag)
+    , hopSize(std::max<size_t>(1, static_cast<size_t>(std::lround(settings.hopSeconds * sampleRate))))
+    , difference(maxLag + 2, 0.0f)
+    , mono(channelCount)
+    , nextWindow(0)
+{
+}
+
+void PitchDetector::process(const float *samples, size_t frameCount, std::vector<PitchEstimate> &estimates)
+{
+    mono.append(samples, frameCount);
+
+    // An analysis window needs windowSize samples plus the largest lag compared
+    // against them, rounded up to the four lags computed at once
+    size_t span = windowSize + (difference.size() + 2) / 4 * 4 + 1;
+    while (mono.getEnd() >= nextWindow + span)
+    {
+        PitchEstimate estimate = analyseWindow(mono.data(nextWindow));
+        estimate.framePosition = nextWindow + span / 2;
+        estimates.push_back(estimate);
+        nextWindow += hopSize;
+    }
+
+    mono.discard(nextWindow);
+}
+
+PitchEstimate PitchDetector::analyseWindow(const float *window)
+{
+    // Difference function normalized by its cumulative mean, 1 where the signal is silent
+    difference[0] = 1.0f;
+    float cumulative = 0.0f;
+    float sums[4];
+    for (size_t lag = 1; lag < difference.size(); lag += 4)
+    {
+        squaredDifference4(window, lag, windowSize, sums);
+        for (size_t k = 0; k < 4 && lag + k < difference.size(); ++k)
+        {
+            cumulative += sums[k];
+            difference[lag + k] = cumulative > 0.0f ? sums[k] * static_cast<float>(lag + k) / cumulative : 1.0f;
+        }
+    }
+
+    // First dip below the threshold, followed down to its minimum
+    size_t lag = minLag;
+    while (lag <= maxLag && difference[lag] >= threshold)
+    {
+        lag++;
+    }
+
+    PitchEstimate estimate;
+    if (lag > maxLag)
+    {
+        // No period, report how close the best one came
+        float best = *std::min_element(difference.begin() + minLag, difference.begin() + maxLag + 1);
+        estimate.confidence = std::clamp(1.0f - best, 0.0f, 1.0f);
+        return estimate;
+    }
+
+    while (lag < maxLag && difference[lag + 1] < difference[lag])
+    {
+        lag++;
+    }
+
+    // Parabolic interpolation between the neighbouring lags
+    float previous = difference[lag - 1];
+    float current = difference[lag];
+    float next = difference[lag + 1];
+    float curvature = previous - 2.0f * current + next;
+    float shift = curvature > 0.0f ? std::clamp(0.5f * (previous - next) / curvature, -0.5f, 0.5f) : 0.0f;
+
+    estimate.frequency = sampleRate / (static_cast<float>(lag) + shift);
+    estimate.confidence = std::clamp(1.0f - current, 0.0f, 1.0f);
+    return estimate;
+}
+
+PitchStage::PitchStage(const PitchSettings &settings)
+    : settings(settings)
+    , estimates(std::max<size_t>(16, static_cast<size_t>(kQueueSeconds / std::max(settings.hopSeconds, 1e-3))))
+    , droppedEstimates(0)
+{
+}
+
+bool PitchStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    if (!validSettings(settings, sampleRate))
+    {
+        std::cerr << "Invalid pitch settings for " << sampleRate << " Hz: " << settings.minFrequency << "-"
+                  << settings.maxFrequency << " Hz, hop " << settings.hopSeconds << " s" << std::endl;
+        return false;
+    }
+
+    detector = std::make_unique<PitchDetector>(sampleRate, channelCount, settings);
+    return true;
+}
+
+void PitchStage::process(const float *samples, size_t frameCount)
+{
+    found.clear();
+    detector->process(samples, frameCount, found);
+
+    size_t written = estimates.write(found.data(), found.size());
+    if (written < found.size())
+    {
+        droppedEstimates.fetch_add(found.size() - written, std::memory_order_relaxed);
+    }
+}
+
+size_t PitchStage::readEstimates(PitchEstimate *estimates, size_t maxCount) noexcept
+{
+    return this->estimates.read(estimates, maxCount);
+}
+
+uint64_t PitchStage::getDroppedEstimates() const noexcept
+{
+    return droppedEstimates.load();
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,697 @@
+#include "recording_store.hpp"
+#include "sample_codec.hpp"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Frames per storage block, the unit of compression
+const uint32_t kBlockFrames = 4096;
+
+// Empty blocks kept ready for the capture callback (about 1.4 s at 48 kHz)
+const size_t kPoolBlocks = 16;
+
+// Full blocks that can wait for the worker
+const size_t kPendingBlocks = kPoolBlocks * 4;
+
+// Frames converted at once by a parallel read, about 256 KB of 16-bit stereo output
+const uint64_t kReadChunkFrames = 65536;
+
+// Converted chunks per parallel read thread, waiting for the reader or in progress
+const size_t kReadChunksPerThread = 2;
+
+bool seekFile(FILE *file, uint64_t offset)
+{
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+} // namespace
+
+RecordingStore::RecordingStore()
+    : channelCount(0)
+    , compress(false)
+    , currentBlock(nullptr)
+    , currentFrames(0)
+    , pending(kPendingBlocks)
+    , pool(kPoolBlocks)
+    , spillFile(nullptr)
+    , firstResidentBlock(0)
+    , spillFailed(false)
+    , running(false)
+    , frameCount(0)
+    , residentBytes(0)
+    , spilledBytes(0)
+    , memoryBudget(0)
+    , droppedFrames(0)
+{
+}
+
+RecordingStore::~RecordingStore()
+{
+    stopWorker();
+    release();
+}
+
+void RecordingStore::setMemoryBudget(uint64_t bytes) noexcept
+{
+    memoryBudget = bytes;
+}
+
+void RecordingStore::start(int channelCount, bool compress)
+{
+    stopWorker();
+    release();
+
+    this->channelCount = channelCount;
+    this->compress = compress;
+    frameCount = 0;
+    droppedFrames = 0;
+
+    refillPool();
+    pool.read(&currentBlock, 1);
+    currentFrames = 0;
+
+    running = true;
+    workerThreadHandle = std::thread(&RecordingStore::workerThread, this);
+}
+
+void RecordingStore::append(const float *samples, long frameCount) noexcept
+{
+    size_t remaining = static_cast<size_t>(frameCount);
+
+    while (remaining > 0)
+    {
+        if (!currentBlock && pool.read(&currentBlock, 1) == 0)
+        {
+            // The worker fell behind, losing audio beats blocking the callback
+            droppedFrames.fetch_add(remaining, std::memory_order_relaxed);
+            return;
+        }
+
+        size_t frames = std::min<size_t>(remaining, kBlockFrames - currentFrames);
+        std::memcpy(currentBlock + static_cast<size_t>(currentFrames) * channelCount, samples, frames * channelCount * sizeof(float));
+
+        samples += frames * channelCount;
+        remaining -= frames;
+        currentFrames += static_cast<uint32_t>(frames);
+        this->frameCount.fetch_add(frames, std::memory_order_relaxed);
+
+        if (currentFrames == kBlockFrames && !queueCurrentBlock())
+        {
+            // Reuse the block, its frames are lost
+            droppedFrames.fetch_add(currentFrames, std::memory_order_relaxed);
+            this->frameCount.fetch_sub(currentFrames, std::memory_order_relaxed);
+            currentFrames = 0;
+        }
+    }
+}
+
+void RecordingStore::appendSilence(uint64_t frameCount) noexcept
+{
+    // Samples before the silence go out first to keep the order
+    PendingBlock silence;
+    silence.frameCount = frameCount;
+
+    if ((currentFrames > 0 && !queueCurrentBlock()) || pending.write(&silence, 1) == 0)
+    {
+        droppedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return;
+    }
+
+    this->frameCount.fetch_add(frameCount, std::memory_order_relaxed);
+}
+
+bool RecordingStore::queueCurrentBlock() noexcept
+{
+    PendingBlock block;
+    block.samples = currentBlock;
+    block.frameCount = currentFrames;
+
+    if (pending.write(&block, 1) == 0)
+    {
+        return false;
+    }
+
+    currentBlock = nullptr;
+    currentFrames = 0;
+    return true;
+}
+
+void RecordingStore::finish()
+{
+    if (currentBlock && currentFrames > 0)
+    {
+        queueCurrentBlock();
+    }
+
+    stopWorker();
+
+    // Store whatever the worker did not pick up and drop the spare blocks
+    storePending();
+
+    freeBlock(currentBlock);
+    currentBlock = nullptr;
+    currentFrames = 0;
+
+    float *spare = nullptr;
+    while (pool.read(&spare, 1) == 1)
+    {
+        freeBlock(spare);
+    }
+
+    spillBlocks();
+
+    if (droppedFrames.load() > 0)
+    {
+        std::cerr << "Recording store dropped " << droppedFrames.load() << " frames" << std::endl;
+    }
+}
+
+bool RecordingStore::empty() const noexcept
+{
+    return frameCount.load() == 0;
+}
+
+uint64_t RecordingStore::getFrameCount() const noexcept
+{
+    return frameCount.load();
+}
+
+uint64_t RecordingStore::getDroppedFrames() const noexcept
+{
+    return droppedFrames.load();
+}
+
+uint64_t RecordingStore::getResidentBytes() const noexcept
+{
+    return residentBytes.load();
+}
+
+uint64_t RecordingStore::getSpilledBytes() const noexcept
+{
+    return spilledBytes.load();
+}
+
+uint64_t RecordingStore::getRawBytes() const noexcept
+{
+    return frameCount.load() * channelCount * sizeof(float);
+}
+
+bool RecordingStore::read(const BlockReader &reader) const
+{
+    std::lock_guard<std::mutex> lock(blocksMutex);
+    std::vector<float> decoded(static_cast<size_t>(kBlockFrames) * channelCount);
+    std::vector<uint8_t> spilled;
+
+    for (const Block &block : blocks)
+    {
+        if (block.silent)
+        {
+            // Hand out silence in block-sized pieces
+            std::fill(decoded.begin(), decoded.end(), 0.0f);
+            for (uint64_t done = 0; done < block.frameCount;)
+            {
+                uint64_t frames = std::min<uint64_t>(kBlockFrames, block.frameCount - done);
+                if (!reader(decoded.data(), frames))
+                {
+                    return false;
+                }
+
+                done += frames;
+            }
+
+            continue;
+        }
+
+        const float *samples = loadBlock(block, decoded.data(), spilled);
+        if (!samples || !reader(samples, block.frameCount))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool RecordingStore::readParallel(size_t frameBytes, const BlockTransform &transform, const ChunkReader &reader,
+                                  unsigned threadCount) const
+{
+    std::lock_guard<std::mutex> blocksLock(blocksMutex);
+
+    // Chunks of whole blocks, long runs of silence are split on their own
+    struct ReadChunk
+    {
+        size_t firstBlock = 0;
+        size_t endBlock = 0;
+        uint64_t silenceOffset = 0; // Frames of the first block already in the previous chunk
+        uint64_t frameCount = 0;
+    };
+
+    std::vector<ReadChunk> chunks;
+    ReadChunk current;
+    for (size_t index = 0; index < blocks.size(); ++index)
+    {
+        const Block &block = blocks[index];
+        if (block.silent && block.frameCount > kReadChunkFrames)
+        {
+            if (current.frameCount > 0)
+            {
+                chunks.push_back(current);
+            }
+
+            for (uint64_t done = 0; done < block.frameCount; done += kReadChunkFrames)
+            {
+                chunks.push_back({index, index + 1, done, std::min(kReadChunkFrames, block.frameCount - done)});
+            }
+
+            current = {index + 1, index + 1, 0, 0};
+            continue;
+        }
+
+        if (current.frameCount + block.frameCount > kReadChunkFrames && current.frameCount > 0)
+        {
+            chunks.push_back(current);
+            current = {index, index, 0, 0};
+        }
+
+        current.endBlock = index + 1;
+        current.frameCount += block.frameCount;
+    }
+
+    if (current.frameCount > 0)
+    {
+        chunks.push_back(current);
+    }
+
+    if (chunks.empty())
+    {
+        return true;
+    }
+
+    // Chunk i is converted into slot i % slots.size(), so workers run ahead of the reader by the slot count at most
+    struct ReadSlot
+    {
+        std::vector<uint8_t> data;
+        uint64_t index = 0;
+        bool claimed = false;
+        bool ready = false;
+    };
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    threadCount = static_cast<unsigned>(std::min<size_t>(threadCount, chunks.size()));
+    std::vector<ReadSlot> slots(threadCount * kReadChunksPerThread);
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t nextChunk = 0;
+    bool stopped = false;
+
+    auto convertChunks = [&]() {
+        std::vector<float> decoded(static_cast<size_t>(kBlockFrames) * channelCount);
+        std::vector<uint8_t> spilled;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            cv.wait(lock, [&] {
+                return stopped || nextChunk >= chunks.size() ||
+                       (!slots[nextChunk % slots.size()].claimed && !slots[nextChunk % slots.size()].ready);
+            });
+
+            if (stopped || nextChunk >= chunks.size())
+            {
+                break;
+            }
+
+            size_t index = nextChunk++;
+            ReadSlot &slot = slots[index % slots.size()];
+            slot.claimed = true;
+            lock.unlock();
+
+            const ReadChunk &chunk = chunks[index];
+            slot.data.resize(static_cast<size_t>(kReadChunkFrames) * frameBytes);
+            uint8_t *output = slot.data.data();
+            bool ok = true;
+
+            for (size_t blockIndex = chunk.firstBlock; blockIndex < chunk.endBlock && ok; ++blockIndex)
+            {
+                const Block &block = blocks[blockIndex];
+                if (block.silent)
+                {
+                    uint64_t frameCount = std::min(block.frameCount - chunk.silenceOffset, chunk.frameCount);
+                    std::fill(decoded.begin(), decoded.end(), 0.0f);
+                    for (uint64_t done = 0; done < frameCount;)
+                    {
+                        uint64_t frames = std::min<uint64_t>(kBlockFrames, frameCount - done);
+                        transform(decoded.data(), frames, output);
+                        output += frames * frameBytes;
+                        done += frames;
+                    }
+
+                    continue;
+                }
+
+                const float *samples = loadBlock(block, decoded.data(), spilled);
+                if (!samples)
+                {
+                    ok = false;
+                    break;
+                }
+
+                transform(samples, block.frameCount, output);
+                output += block.frameCount * frameBytes;
+            }
+
+            lock.lock();
+            slot.index = index;
+            slot.claimed = false;
+            slot.ready = ok;
+            stopped = stopped || !ok;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back(convertChunks);
+    }
+
+    // Converted chunks are handed out in order while later ones are still converting
+    bool ok = true;
+    for (size_t index = 0; index < chunks.size() && ok; ++index)
+    {
+        ReadSlot &slot = slots[index % slots.size()];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return stopped || (slot.ready && slot.index == index); });
+            if (stopped)
+            {
+                ok = false;
+                break;
+            }
+        }
+
+        ok = reader(slot.data.data(), chunks[index].frameCount);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        slot.ready = false;
+        cv.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+        cv.notify_all();
+    }
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    return ok;
+}
+
+const float *RecordingStore::loadBlock(const Block &block, float *decoded, std::vector<uint8_t> &spilled) const
+{
+    const float *samples = block.samples.get();
+    const uint8_t *encoded = block.encoded.data();
+    size_t encodedSize = block.encoded.size();
+
+    if (block.spillSize > 0)
+    {
+        // Stitch the block back in from the spill file
+        spilled.resize(block.spillSize);
+        std::lock_guard<std::mutex> lock(spillReadMutex);
+        if (!seekFile(spillFile, block.spillOffset) || std::fread(spilled.data(), 1, spilled.size(), spillFile) != spilled.size())
+        {
+            std::cerr << "Failed to read spilled recording block" << std::endl;
+            return nullptr;
+        }
+
+        if (block.spilledRaw)
+        {
+            samples = reinterpret_cast<const float *>(spilled.data());
+        }
+
+        encoded = spilled.data();
+        encodedSize = spilled.size();
+    }
+
+    if (!samples)
+    {
+        if (!decodeSampleBlock(encoded, encodedSize, block.frameCount, channelCount, decoded))
+        {
+            std::cerr << "Corrupt recording block" << std::endl;
+            return nullptr;
+        }
+
+        samples = decoded;
+    }
+
+    return samples;
+}
+
+void RecordingStore::workerThread()
+{
+    while (true)
+    {
+        // Check the stop flag before draining so every queued block is stored
+        bool stopping = !running.load();
+        bool stored = storePending();
+        refillPool();
+        spillBlocks();
+
+        if (!stored)
+        {
+            if (stopping)
+            {
+                break;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+bool RecordingStore::storePending()
+{
+    PendingBlock item;
+    bool stored = false;
+
+    while (pending.read(&item, 1) == 1)
+    {
+        Block block;
+        block.frameCount = item.frameCount;
+
+        if (!item.samples)
+        {
+            block.silent = true;
+        }
+        else if (compress)
+        {
+            encodeSampleBlock(item.samples, item.frameCount, channelCount, encodeBuffer);
+            block.encoded.assign(encodeBuffer.begin(), encodeBuffer.end());
+            residentBytes += block.encoded.size();
+
+            // Hand the block back to the capture callback
+            if (pool.write(&item.samples, 1) == 0)
+            {
+                freeBlock(item.samples);
+            }
+        }
+        else
+        {
+            block.samples.reset(item.samples);
+        }
+
+        std::lock_guard<std::mutex> lock(blocksMutex);
+        blocks.push_back(std::move(block));
+        stored = true;
+    }
+
+    return stored;
+}
+
+void RecordingStore::refillPool()
+{
+    while (pool.writeAvailable() > 0)
+    {
+        float *block = allocateBlock();
+        pool.write(&block, 1);
+    }
+}
+
+void RecordingStore::spillBlocks()
+{
+    uint64_t budget = memoryBudget.load();
+    if (budget == 0 || spillFailed || residentBytes.load() <= budget)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(blocksMutex);
+
+    while (residentBytes.load() > budget && firstResidentBlock < blocks.size())
+    {
+        if (!spillFile && !openSpillFile())
+        {
+            spillFailed = true;
+            return;
+        }
+
+        Block &block = blocks[firstResidentBlock];
+        if (block.silent)
+        {
+            firstResidentBlock++;
+            continue;
+        }
+
+        bool raw = block.samples != nullptr;
+        const void *data = raw ? static_cast<const void *>(block.samples.get()) : block.encoded.data();
+        size_t size = raw ? static_cast<size_t>(block.frameCount) * channelCount * sizeof(float) : block.encoded.size();
+        uint64_t offset = spilledBytes.load();
+
+        if (!seekFile(spillFile, offset) || std::fwrite(data, 1, size, spillFile) != size)
+        {
+            // Keep the audio in memory rather than lose it
+            std::cerr << "Failed to spill recording to disk, memory budget is no longer enforced" << std::endl;
+            spillFailed = true;
+            return;
+        }
+
+        block.spillOffset = offset;
+        block.spillSize = size;
+        block.spilledRaw = raw;
+
+        if (raw)
+        {
+            block.samples.reset();
+            residentBytes -= blockBytes();
+        }
+        else
+        {
+            residentBytes -= block.encoded.size();
+            std::vector<uint8_t>().swap(block.encoded);
+        }
+
+        spilledBytes += size;
+        firstResidentBlock++;
+    }
+}
+
+bool RecordingStore::openSpillFile()
+{
+    std::error_code error;
+    std::filesystem::path directory = std::filesystem::temp_directory_path(error);
+    if (error)
+    {
+        std::cerr << "No temporary directory for recording spill file: " << error.message() << std::endl;
+        return false;
+    }
+
+    // Unique per store and start time
+    std::filesystem::path path = directory / ("audio-capturex-" + std::to_string(reinterpret_cast<uintptr_t>(this)) + "-" +
+                                              std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".spill");
+
+    spillFile = std::fopen(path.string().c_str(), "w+b");
+    if (!spillFile)
+    {
+        std::cerr << "Failed to create recording spill file: " << path.string() << std::endl;
+        return false;
+    }
+
+#ifndef _WIN32
+    // The open handle keeps the data, nothing is left behind if the process dies
+    std::remove(path.string().c_str());
+#else
+    spillPath = path.string();
+#endif
+
+    return true;
+}
+
+void RecordingStore::stopWorker()
+{
+    if (workerThreadHandle.joinable())
+    {
+        running = false;
+        workerThreadHandle.join();
+    }
+}
+
+void RecordingStore::release()
+{
+    freeBlock(currentBlock);
+    currentBlock = nullptr;
+    currentFrames = 0;
+
+    float *block = nullptr;
+    while (pool.read(&block, 1) == 1)
+    {
+        freeBlock(block);
+    }
+
+    PendingBlock item;
+    while (pending.read(&item, 1) == 1)
+    {
+        freeBlock(item.samples);
+    }
+
+    std::lock_guard<std::mutex> lock(blocksMutex);
+    blocks.clear();
+    residentBytes = 0;
+
+    if (spillFile)
+    {
+        std::fclose(spillFile);
+        spillFile = nullptr;
+#ifdef _WIN32
+        std::remove(spillPath.c_str());
+        spillPath.clear();
+#endif
+    }
+
+    firstResidentBlock = 0;
+    spilledBytes = 0;
+    spillFailed = false;
+}
+
+float *RecordingStore::allocateBlock()
+{
+    residentBytes += blockBytes();
+    return new float[static_cast<size_t>(kBlockFrames) * channelCount];
+}
+
+void RecordingStore::freeBlock(float *block)
+{
+    if (block)
+    {
+        residentBytes -= blockBytes();
+        delete[] block;
+    }
+}
+
+uint64_t RecordingStore::blockBytes() const noexcept
+{
+    return static_cast<uint64_t>(kBlockFrames) * channelCount * sizeof(float);
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,293 @@
+#include "resampler.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Filter phases kept at most, finer ratios use the nearest phase
+const uint64_t kMaxPhases = 1024;
+
+// Taps per phase when the output rate is not lower, scaled up with the decimation
+const double kBaseTaps = 96.0;
+
+// Cutoff relative to the lower Nyquist frequency
+const double kCutoff = 0.93;
+
+// Kaiser window shape, about 90 dB stopband rejection
+const double kKaiserBeta = 9.0;
+
+// Input frames added to the history at once
+const size_t kBlockFrames = 4096;
+
+const double kPi = 3.14159265358979323846;
+
+// Modified Bessel function of the first kind, order zero
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > sum * 1e-16; ++k)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+// Dot product of count floats, count is a multiple of 4
+float dotProduct(const float *a, const float *b, size_t count) noexcept
+{
+    size_t i = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    for (; i + 8 <= count; i += 8)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+
+    for (; i < count; i += 4)
+    {
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    __m128 sum = _mm_add_ps(sum0, sum1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+#elif defined(AUDIO_CAPTUREX_NEON)
+    float32x4_t sum0 = vdupq_n_f32(0.0f);
+    float32x4_t sum1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= count; i += 8)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+        sum1 = vmlaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+
+    for (; i < count; i += 4)
+    {
+        sum0 = vmlaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    }
+
+    float32x4_t sum = vaddq_f32(sum0, sum1);
+    float32x2_t pair = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(pair, pair), 0);
+#else
+    float sum = 0.0f;
+    for (; i < count; ++i)
+    {
+        sum += a[i] * b[i];
+    }
+
+    return sum;
+#endif
+}
+
+} // namespace
+
+Resampler::Resampler(int inputRate, int outputRate, int channelCount)
+    : channelCount(channelCount)
+    , upFactor(1)
+    , downFactor(1)
+    , phaseCount(1)
+    , tapCount(4)
+    , historyCapacity(0)
+    , historyFrames(0)
+    , phase(0)
+    , inputFrames(0)
+    , outputFrames(0)
+{
+    if (inputRate > 0 && outputRate > 0)
+    {
+        uint64_t divisor = static_cast<uint64_t>(std::gcd(inputRate, outputRate));
+        upFactor = static_cast<uint64_t>(outputRate) / divisor;
+        downFactor = static_cast<uint64_t>(inputRate) / divisor;
+    }
+
+    // Equal rates are passed through unfiltered
+    if (upFactor == downFactor)
+    {
+        upFactor = downFactor = 1;
+        return;
+    }
+
+    // Lower output rates need a lower cutoff and, for the same transition band, more taps
+    double ratio = std::min(1.0, static_cast<double>(upFactor) / static_cast<double>(downFactor));
+    double cutoff = 0.5 * ratio * kCutoff; // Cycles per input frame
+    phaseCount = static_cast<size_t>(std::min(upFactor, kMaxPhases));
+    tapCount = (static_cast<size_t>(std::ceil(kBaseTaps / ratio)) + 3) / 4 * 4;
+
+    // Phase p interpolates at p / phaseCount after the centre tap tapCount / 2 - 1
+    double halfLength = tapCount / 2.0;
+    double windowScale = 1.0 / besselI0(kKaiserBeta);
+    coefficients.resize(phaseCount * tapCount);
+    std::vector<double> values(tapCount);
+    for (size_t p = 0; p < phaseCount; ++p)
+    {
+        double offset = static_cast<double>(p) / phaseCount;
+        float *taps = coefficients.data() + p * tapCount;
+        double sum = 0.0;
+        for (size_t i = 0; i < tapCount; ++i)
+        {
+            double distance = static_cast<double>(i) - (halfLength - 1.0) - offset;
+            double x = distance / halfLength;
+            double window = besselI0(kKaiserBeta * std::sqrt(std::max(0.0, 1.0 - x * x))) * windowScale;
+            double sinc = distance == 0.0 ? 2.0 * cutoff : std::sin(2.0 * kPi * cutoff * distance) / (kPi * distance);
+            values[i] = sinc * window;
+            sum += values[i];
+        }
+
+        // Unity gain at DC for every phase
+        for (size_t i = 0; i < tapCount; ++i)
+        {
+            taps[i] = static_cast<float>(values[i] / sum);
+        }
+    }
+
+    historyCapacity = 2 * tapCount + kBlockFrames;
+    reset();
+}
+
+void Resampler::process(const float *samples, size_t frameCount, std::vector<float> &output)
+{
+    inputFrames += frameCount;
+
+    if (upFactor == downFactor)
+    {
+        output.insert(output.end(), samples, samples + frameCount * channelCount);
+        outputFrames += frameCount;
+        return;
+    }
+
+    while (frameCount > 0)
+    {
+        size_t frames = std::min(frameCount, historyCapacity - historyFrames);
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            float *channelHistory = history.data() + channel * historyCapacity + historyFrames;
+            for (size_t frame = 0; frame < frames; ++frame)
+            {
+                channelHistory[frame] = samples[frame * channelCount + channel];
+            }
+        }
+
+        historyFrames += frames;
+        samples += frames * channelCount;
+        frameCount -= frames;
+
+        produce(output, UINT64_MAX);
+    }
+}
+
+void Resampler::flush(std::vector<float> &output)
+{
+    if (upFactor == downFactor)
+    {
+        return;
+    }
+
+    // Silence after the end completes the windows of the last output frames
+    uint64_t expected = (inputFrames * upFactor + downFactor - 1) / downFactor;
+    while (outputFrames < expected)
+    {
+        size_t frames = historyCapacity - historyFrames;
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            std::fill_n(history.data() + channel * historyCapacity + historyFrames, frames, 0.0f);
+        }
+
+        historyFrames += frames;
+        produce(output, expected - outputFrames);
+    }
+}
+
+void Resampler::reset()
+{
+    history.assign(static_cast<size_t>(channelCount) * historyCapacity, 0.0f);
+
+    // Leading silence puts the first input frame at the centre of the first window
+    historyFrames = upFactor == downFactor ? 0 : tapCount / 2 - 1;
+    phase = 0;
+    inputFrames = 0;
+    outputFrames = 0;
+}
+
+void Resampler::produce(std::vector<float> &output, uint64_t maxFrames)
+{
+    // Window start and filter phase of an output position
+    auto locate = [this](size_t start, uint64_t position, size_t &windowStart, const float *&taps) {
+        uint64_t index = phaseCount == upFactor ? position : (position * phaseCount + upFactor / 2) / upFactor;
+        windowStart = start + static_cast<size_t>(index / phaseCount);
+        taps = coefficients.data() + (index % phaseCount) * tapCount;
+    };
+
+    // Count the frames the history covers
+    size_t start = 0;
+    uint64_t position = phase;
+    uint64_t count = 0;
+    while (count < maxFrames)
+    {
+        size_t windowStart = 0;
+        const float *taps = nullptr;
+        locate(start, position, windowStart, taps);
+        if (windowStart + tapCount > historyFrames)
+        {
+            break;
+        }
+
+        count++;
+        position += downFactor;
+        start += static_cast<size_t>(position / upFactor);
+        position %= upFactor;
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    size_t base = output.size();
+    output.resize(base + static_cast<size_t>(count) * channelCount);
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        const float *channelHistory = history.data() + channel * historyCapacity;
+        float *out = output.data() + base + channel;
+        size_t channelStart = 0;
+        uint64_t channelPosition = phase;
+        for (uint64_t frame = 0; frame < count; ++frame)
+        {
+            size_t windowStart = 0;
+            const float *taps = nullptr;
+            locate(channelStart, channelPosition, windowStart, taps);
+            *out = dotProduct(channelHistory + windowStart, taps, tapCount);
+            out += channelCount;
+
+            channelPosition += downFactor;
+            channelStart += static_cast<size_t>(channelPosition / upFactor);
+            channelPosition %= upFactor;
+        }
+    }
+
+    // Drop the frames no later window reads
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        float *channelHistory = history.data() + channel * historyCapacity;
+        std::memmove(channelHistory, channelHistory + start, (historyFrames - start) * sizeof(float));
+    }
+
+    historyFrames -= start;
+    phase = position;
+    outputFrames += count;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,345 @@
+#include "sample_codec.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+enum BlockMode : uint8_t
+{
+    kModeRaw = 0,
+    kModeInteger = 1,
+};
+
+// Unary quotients this long switch to a verbatim 64-bit value
+const uint32_t kEscapeQuotient = 32;
+
+class BitWriter
+{
+public:
+    explicit BitWriter(std::vector<uint8_t> &output)
+        : output(output)
+    {
+    }
+
+    // Append the low bits of value, most significant first (bits <= 32)
+    void write(uint64_t value, int bits)
+    {
+        accumulator = (accumulator << bits) | (value & ((1ull << bits) - 1));
+        count += bits;
+
+        while (count >= 8)
+        {
+            count -= 8;
+            output.push_back(static_cast<uint8_t>(accumulator >> count));
+        }
+    }
+
+    void writeOnes(uint32_t n)
+    {
+        while (n >= 32)
+        {
+            write(0xFFFFFFFFu, 32);
+            n -= 32;
+        }
+
+        write((1ull << n) - 1, static_cast<int>(n));
+    }
+
+    void flush()
+    {
+        if (count > 0)
+        {
+            output.push_back(static_cast<uint8_t>(accumulator << (8 - count)));
+            accumulator = 0;
+            count = 0;
+        }
+    }
+
+private:
+    std::vector<uint8_t> &output;
+    uint64_t accumulator = 0;
+    int count = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const uint8_t *data, size_t size)
+        : data(data)
+        , size(size)
+    {
+    }
+
+    // Read bits most significant first (bits <= 32)
+    bool read(int bits, uint64_t &value)
+    {
+        if (!fill(bits))
+        {
+            return false;
+        }
+
+        count -= bits;
+        value = (accumulator >> count) & ((1ull << bits) - 1);
+        return true;
+    }
+
+    // Count ones up to the terminating zero or limit
+    bool readUnary(uint32_t limit, uint32_t &ones)
+    {
+        ones = 0;
+        while (ones < limit)
+        {
+            if (!fill(1))
+            {
+                return false;
+            }
+
+            count--;
+            if (((accumulator >> count) & 1) == 0)
+            {
+                return true;
+            }
+
+            ones++;
+        }
+
+        return true;
+    }
+
+    size_t bytesConsumed() const
+    {
+        return position;
+    }
+
+private:
+    bool fill(int bits)
+    {
+        while (count < bits)
+        {
+            if (position >= size)
+            {
+                return false;
+            }
+
+            accumulator = (accumulator << 8) | data[position++];
+            count += 8;
+        }
+
+        return true;
+    }
+
+    const uint8_t *data;
+    size_t size;
+    size_t position = 0;
+    uint64_t accumulator = 0;
+    int count = 0;
+};
+
+uint64_t zigzag(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Second order fixed prediction, lower orders for the first samples
+int64_t predict(const int32_t *values, size_t index, int channelCount)
+{
+    if (index == 0)
+    {
+        return 0;
+    }
+
+    int64_t previous = values[(index - 1) * channelCount];
+    if (index == 1)
+    {
+        return previous;
+    }
+
+    return 2 * previous - values[(index - 2) * channelCount];
+}
+
+// Find a power of two scale that turns every sample into an exact integer
+bool findIntegerScale(const float *samples, size_t count, int &scaleBits)
+{
+    for (int bits : {15, 23})
+    {
+        float scale = std::ldexp(1.0f, bits);
+        bool exact = true;
+
+        for (size_t i = 0; i < count && exact; ++i)
+        {
+            float value = samples[i] * scale;
+            exact = std::isfinite(value) && std::fabs(value) < 1073741824.0f && value == std::nearbyint(value) &&
+                    !(samples[i] == 0.0f && std::signbit(samples[i]));
+        }
+
+        if (exact)
+        {
+            scaleBits = bits;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace
+
+void encodeSampleBlock(const float *samples, size_t frameCount, int channelCount, std::vector<uint8_t> &output)
+{
+    size_t count = frameCount * channelCount;
+    output.clear();
+
+    int scaleBits = 0;
+    if (!findIntegerScale(samples, count, scaleBits))
+    {
+        output.push_back(kModeRaw);
+        output.insert(output.end(), reinterpret_cast<const uint8_t *>(samples), reinterpret_cast<const uint8_t *>(samples + count));
+        return;
+    }
+
+    output.push_back(kModeInteger);
+    output.push_back(static_cast<uint8_t>(scaleBits));
+
+    float scale = std::ldexp(1.0f, scaleBits);
+    std::vector<int32_t> values(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i] = static_cast<int32_t>(samples[i] * scale);
+    }
+
+    std::vector<uint64_t> residuals(frameCount);
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        const int32_t *channelValues = values.data() + channel;
+
+        uint64_t sum = 0;
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            residuals[i] = zigzag(channelValues[i * channelCount] - predict(channelValues, i, channelCount));
+            sum += residuals[i];
+        }
+
+        // Rice parameter close to log2 of the mean residual
+        int k = 0;
+        while (k < 31 && (static_cast<uint64_t>(frameCount) << (k + 1)) < sum)
+        {
+            k++;
+        }
+
+        output.push_back(static_cast<uint8_t>(k));
+
+        BitWriter writer(output);
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            uint64_t quotient = residuals[i] >> k;
+            if (quotient >= kEscapeQuotient)
+            {
+                writer.writeOnes(kEscapeQuotient);
+                writer.write(residuals[i] >> 32, 32);
+                writer.write(residuals[i] & 0xFFFFFFFFu, 32);
+                continue;
+            }
+
+            writer.writeOnes(static_cast<uint32_t>(quotient));
+            writer.write(0, 1);
+            writer.write(residuals[i] & ((1ull << k) - 1), k);
+        }
+
+        writer.flush();
+    }
+}
+
+bool decodeSampleBlock(const uint8_t *data, size_t size, size_t frameCount, int channelCount, float *samples)
+{
+    size_t count = frameCount * channelCount;
+    if (size < 1)
+    {
+        return false;
+    }
+
+    if (data[0] == kModeRaw)
+    {
+        if (size != 1 + count * sizeof(float))
+        {
+            return false;
+        }
+
+        std::memcpy(samples, data + 1, count * sizeof(float));
+        return true;
+    }
+
+    if (data[0] != kModeInteger || size < 2)
+    {
+        return false;
+    }
+
+    float inverseScale = std::ldexp(1.0f, -data[1]);
+    std::vector<int32_t> values(count);
+    size_t position = 2;
+
+    for (int channel = 0; channel < channelCount; ++channel)
+    {
+        if (position >= size)
+        {
+            return false;
+        }
+
+        int k = data[position++];
+        int32_t *channelValues = values.data() + channel;
+        BitReader reader(data + position, size - position);
+
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            uint32_t quotient = 0;
+            uint64_t residual = 0;
+            if (!reader.readUnary(kEscapeQuotient, quotient))
+            {
+                return false;
+            }
+
+            if (quotient == kEscapeQuotient)
+            {
+                uint64_t high = 0;
+                uint64_t low = 0;
+                if (!reader.read(32, high) || !reader.read(32, low))
+                {
+                    return false;
+                }
+
+                residual = (high << 32) | low;
+            }
+            else
+            {
+                uint64_t remainder = 0;
+                if (!reader.read(k, remainder))
+                {
+                    return false;
+                }
+
+                residual = (static_cast<uint64_t>(quotient) << k) | remainder;
+            }
+
+            channelValues[i * channelCount] = static_cast<int32_t>(predict(channelValues, i, channelCount) + unzigzag(residual));
+        }
+
+        position += reader.bytesConsumed();
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        samples[i] = static_cast<float>(values[i]) * inverseScale;
+    }
+
+    return true;
+}
+
+} // namespace AudioCaptureX
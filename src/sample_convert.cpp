@@ -0,0 +1,210 @@
+#include "sample_convert.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Scale of PCM samples read as float, full scale negative maps to -1.0
+const float kPcm16ToFloat = 1.0f / 32768.0f;
+const float kPcm24ToFloat = 1.0f / 8388608.0f;
+
+} // namespace
+
+int bytesPerSample(WavSampleFormat format) noexcept
+{
+    switch (format)
+    {
+        case WavSampleFormat::Pcm16:
+            return 2;
+        case WavSampleFormat::Pcm24:
+            return 3;
+        case WavSampleFormat::Float32:
+            return 4;
+    }
+
+    return 0;
+}
+
+const char *sampleFormatName(WavSampleFormat format) noexcept
+{
+    switch (format)
+    {
+        case WavSampleFormat::Pcm16:
+            return "16 bits PCM";
+        case WavSampleFormat::Pcm24:
+            return "24 bits PCM";
+        case WavSampleFormat::Float32:
+            return "32 bits IEEE float";
+    }
+
+    return "unknown";
+}
+
+void convertFloatToPcm16(const float *input, int16_t *output, size_t sampleCount) noexcept
+{
+    size_t i = 0;
+
+    // Same clamp and truncation as the scalar loop, NaN becomes full scale in both
+#if defined(AUDIO_CAPTUREX_SSE2)
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 scale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        __m128 a = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(input + i), one), minusOne);
+        __m128 b = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(input + i + 4), one), minusOne);
+        __m128i packed = _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, scale)), _mm_cvttps_epi32(_mm_mul_ps(b, scale)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), packed);
+    }
+#elif defined(AUDIO_CAPTUREX_NEON_AARCH64)
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t minusOne = vdupq_n_f32(-1.0f);
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        float32x4_t a = vmaxnmq_f32(vminnmq_f32(vld1q_f32(input + i), one), minusOne);
+        float32x4_t b = vmaxnmq_f32(vminnmq_f32(vld1q_f32(input + i + 4), one), minusOne);
+        int16x4_t low = vmovn_s32(vcvtq_s32_f32(vmulq_n_f32(a, 32767.0f)));
+        int16x4_t high = vmovn_s32(vcvtq_s32_f32(vmulq_n_f32(b, 32767.0f)));
+        vst1q_s16(output + i, vcombine_s16(low, high));
+    }
+#endif
+
+    for (; i < sampleCount; ++i)
+    {
+        // Clamp to [-1.0, 1.0] and convert to 16-bit PCM
+        float sample = std::max(-1.0f, std::min(1.0f, input[i]));
+        output[i] = static_cast<int16_t>(sample * 32767.0f);
+    }
+}
+
+void convertFloatToPcm24(const float *input, uint8_t *output, size_t sampleCount) noexcept
+{
+    size_t i = 0;
+
+    // Vector conversion, the packing into three bytes stays scalar
+#if defined(AUDIO_CAPTUREX_SSE2) || defined(AUDIO_CAPTUREX_NEON_AARCH64)
+    int32_t values[4];
+    for (; i + 4 <= sampleCount; i += 4)
+    {
+#if defined(AUDIO_CAPTUREX_SSE2)
+        __m128 sample = _mm_max_ps(_mm_min_ps(_mm_loadu_ps(input + i), _mm_set1_ps(1.0f)), _mm_set1_ps(-1.0f));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(values), _mm_cvttps_epi32(_mm_mul_ps(sample, _mm_set1_ps(8388607.0f))));
+#else
+        float32x4_t sample = vmaxnmq_f32(vminnmq_f32(vld1q_f32(input + i), vdupq_n_f32(1.0f)), vdupq_n_f32(-1.0f));
+        vst1q_s32(values, vcvtq_s32_f32(vmulq_n_f32(sample, 8388607.0f)));
+#endif
+
+        for (int k = 0; k < 4; ++k)
+        {
+            output[(i + k) * 3 + 0] = static_cast<uint8_t>(values[k] & 0xFF);
+            output[(i + k) * 3 + 1] = static_cast<uint8_t>((values[k] >> 8) & 0xFF);
+            output[(i + k) * 3 + 2] = static_cast<uint8_t>((values[k] >> 16) & 0xFF);
+        }
+    }
+#endif
+
+    for (; i < sampleCount; ++i)
+    {
+        // Clamp to [-1.0, 1.0] and convert to 24-bit PCM, stored little-endian
+        float sample = std::max(-1.0f, std::min(1.0f, input[i]));
+        int32_t value = static_cast<int32_t>(sample * 8388607.0f);
+
+        output[i * 3 + 0] = static_cast<uint8_t>(value & 0xFF);
+        output[i * 3 + 1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        output[i * 3 + 2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+    }
+}
+
+void convertSamples(const float *input, WavSampleFormat format, void *output, size_t sampleCount) noexcept
+{
+    switch (format)
+    {
+        case WavSampleFormat::Pcm16:
+            convertFloatToPcm16(input, static_cast<int16_t *>(output), sampleCount);
+            break;
+        case WavSampleFormat::Pcm24:
+            convertFloatToPcm24(input, static_cast<uint8_t *>(output), sampleCount);
+            break;
+        case WavSampleFormat::Float32:
+            std::memcpy(output, input, sampleCount * sizeof(float));
+            break;
+    }
+}
+
+void convertPcm16ToFloat(const int16_t *input, float *output, size_t sampleCount) noexcept
+{
+    size_t i = 0;
+
+#if defined(AUDIO_CAPTUREX_SSE2)
+    const __m128 scale = _mm_set1_ps(kPcm16ToFloat);
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        // Sign extend by placing each sample in the high half and shifting back
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+    }
+#elif defined(AUDIO_CAPTUREX_NEON_AARCH64)
+    for (; i + 8 <= sampleCount; i += 8)
+    {
+        int16x8_t samples = vld1q_s16(input + i);
+        vst1q_f32(output + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples))), kPcm16ToFloat));
+        vst1q_f32(output + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples))), kPcm16ToFloat));
+    }
+#endif
+
+    for (; i < sampleCount; ++i)
+    {
+        output[i] = input[i] * kPcm16ToFloat;
+    }
+}
+
+void convertPcm24ToFloat(const uint8_t *input, float *output, size_t sampleCount) noexcept
+{
+    for (size_t i = 0; i < sampleCount; ++i)
+    {
+        // Assemble in the top bytes so the shift sign extends
+        uint32_t bits = (static_cast<uint32_t>(input[i * 3]) << 8) | (static_cast<uint32_t>(input[i * 3 + 1]) << 16) |
+                        (static_cast<uint32_t>(input[i * 3 + 2]) << 24);
+        output[i] = static_cast<float>(static_cast<int32_t>(bits) >> 8) * kPcm24ToFloat;
+    }
+}
+
+void convertToFloat(const void *input, WavSampleFormat format, float *output, size_t sampleCount) noexcept
+{
+    switch (format)
+    {
+        case WavSampleFormat::Pcm16:
+            convertPcm16ToFloat(static_cast<const int16_t *>(input), output, sampleCount);
+            break;
+        case WavSampleFormat::Pcm24:
+            convertPcm24ToFloat(static_cast<const uint8_t *>(input), output, sampleCount);
+            break;
+        case WavSampleFormat::Float32:
+            std::memcpy(output, input, sampleCount * sizeof(float));
+            break;
+    }
+}
+
+void selectChannels(const float *input, int inputChannels, const int *channels, int outputChannels, float *output,
+                    size_t frameCount) noexcept
+{
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        for (int channel = 0; channel < outputChannels; ++channel)
+        {
+            *output++ = input[channels[channel]];
+        }
+
+        input += inputChannels;
+    }
+}
+
+} // namespace AudioCaptureX
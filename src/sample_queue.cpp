@@ -0,0 +1,53 @@
+#include "sample_queue.hpp"
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Runs of silence that can be queued at once
+const size_t kSilenceMarkerCapacity = 64;
+
+} // namespace
+
+SampleQueue::SampleQueue()
+    : silenceMarkers(kSilenceMarkerCapacity)
+    , samplesPushed(0)
+    , channelCount(1)
+{
+}
+
+void SampleQueue::reset(size_t frameCapacity, int channelCount)
+{
+    this->channelCount = channelCount;
+    ring.reset(frameCapacity * channelCount);
+    silenceMarkers.reset(kSilenceMarkerCapacity);
+    samplesPushed = 0;
+}
+
+bool SampleQueue::push(const float *samples, long frameCount) noexcept
+{
+    // Only queue whole blocks so the consumer always reads complete frames
+    size_t sampleCount = static_cast<size_t>(frameCount) * channelCount;
+    if (ring.writeAvailable() < sampleCount)
+    {
+        return false;
+    }
+
+    ring.write(samples, sampleCount);
+    samplesPushed += sampleCount;
+    return true;
+}
+
+bool SampleQueue::pushSilence(uint64_t frameCount) noexcept
+{
+    // The consumer inserts the silence once it has read up to this position
+    SilenceMarker marker;
+    marker.samplePosition = samplesPushed;
+    marker.frameCount = frameCount;
+
+    return silenceMarkers.write(&marker, 1) == 1;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,15 @@
+#pragma once
+
+// Instruction sets the SIMD kernels of the library are compiled for, detected
+// once for every translation unit. Each kernel keeps a scalar path for the
+// samples left over and for targets without either set.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_CAPTUREX_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AUDIO_CAPTUREX_NEON
+#if defined(__aarch64__)
+#define AUDIO_CAPTUREX_NEON_AARCH64 // Intrinsics only AArch64 has, such as vdivq_f32
+#endif
+#endif
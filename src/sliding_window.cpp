@@ -0,0 +1,340 @@
+#include "sliding_window.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Samples written per reservation, the longest view leaves this much of the ring free
+const size_t kWriteChunkSamples = 1024;
+
+size_t secondsToFrames(double seconds, int sampleRate)
+{
+    return static_cast<size_t>(std::max(0L, std::lround(seconds * sampleRate)));
+}
+
+// Layout fields are copied atomically, so a copy racing with a reset is well defined
+template <typename T>
+T loadField(const T &field) noexcept
+{
+    return std::atomic_ref<T>(const_cast<T &>(field)).load(std::memory_order_relaxed);
+}
+
+template <typename T>
+void storeField(T &field, T value) noexcept
+{
+    std::atomic_ref<T>(field).store(value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+SlidingWindow::SlidingWindow(std::shared_ptr<MirroredBufferPool> pool)
+    : pool(std::move(pool))
+    , generation(0)
+    , written(0)
+    , reserved(0)
+{
+}
+
+SlidingWindow::~SlidingWindow()
+{
+    if (pool)
+    {
+        pool->recycle(std::move(buffer));
+        for (std::unique_ptr<MirroredBuffer> &storage : retired)
+        {
+            pool->recycle(std::move(storage));
+        }
+    }
+}
+
+bool SlidingWindow::reset(int sampleRate, int channelCount, const WindowSettings &settings)
+{
+    // Positions keep counting, so views of the previous session are still caught by the reservation
+    Layout next;
+    next.start = written.load(std::memory_order_relaxed);
+
+    if (sampleRate <= 0 || channelCount <= 0 || settings.windowSeconds <= 0.0 || settings.strideSeconds <= 0.0 ||
+        settings.historySeconds < 0.0)
+    {
+        std::cerr << "Invalid window settings for " << sampleRate << " Hz, " << channelCount << " channels: window "
+                  << settings.windowSeconds << " s, stride " << settings.strideSeconds << " s, history "
+                  << settings.historySeconds << " s" << std::endl;
+        publishLayout(next);
+        return false;
+    }
+
+    next.inputChannels = channelCount;
+    next.outputChannels = settings.mixToMono ? 1 : channelCount;
+    next.windowFrames = std::max<size_t>(1, secondsToFrames(settings.windowSeconds, sampleRate));
+    next.strideFrames = std::max<size_t>(1, secondsToFrames(settings.strideSeconds, sampleRate));
+
+    size_t viewSamples =
+        (next.windowFrames + secondsToFrames(settings.historySeconds, sampleRate)) * next.outputChannels;
+    size_t bytes = (viewSamples + kWriteChunkSamples) * sizeof(float);
+
+    // Consumers may still read the current storage, so it is only replaced if the size changes
+    size_t size = MirroredBuffer::roundSize(bytes);
+    if (!buffer || buffer->size() != size)
+    {
+        auto match = std::find_if(retired.begin(), retired.end(),
+                                  [size](const std::unique_ptr<MirroredBuffer> &storage) { return storage->size() == size; });
+        std::unique_ptr<MirroredBuffer> storage;
+        if (match != retired.end())
+        {
+            storage = std::move(*match);
+            retired.erase(match);
+        }
+        else
+        {
+            storage = pool ? pool->acquire(bytes) : std::make_unique<MirroredBuffer>();
+            if (!storage || (!pool && !storage->allocate(bytes)))
+            {
+                std::cerr << "Failed to allocate a window ring of " << bytes << " bytes" << std::endl;
+                Layout empty;
+                empty.start = next.start;
+                publishLayout(empty);
+                return false;
+            }
+        }
+
+        if (buffer)
+        {
+            retired.push_back(std::move(buffer));
+        }
+
+        buffer = std::move(storage);
+    }
+
+    next.ring = reinterpret_cast<float *>(buffer->data());
+    next.ringSamples = buffer->size() / sizeof(float);
+    next.maxViewSamples = next.ringSamples - kWriteChunkSamples;
+    publishLayout(next);
+    return true;
+}
+
+void SlidingWindow::publishLayout(const Layout &next) noexcept
+{
+    generation.fetch_add(1, std::memory_order_relaxed);
+
+    // Consumers must see the odd generation before any change to the layout
+    std::atomic_thread_fence(std::memory_order_release);
+
+    storeField(layout.ring, next.ring);
+    storeField(layout.ringSamples, next.ringSamples);
+    storeField(layout.maxViewSamples, next.maxViewSamples);
+    storeField(layout.inputChannels, next.inputChannels);
+    storeField(layout.outputChannels, next.outputChannels);
+    storeField(layout.windowFrames, next.windowFrames);
+    storeField(layout.strideFrames, next.strideFrames);
+    storeField(layout.start, next.start);
+    generation.fetch_add(1, std::memory_order_release);
+}
+
+uint64_t SlidingWindow::readLayout(Layout &copy) const noexcept
+{
+    for (;;)
+    {
+        uint64_t session = generation.load(std::memory_order_acquire);
+        copy.ring = loadField(layout.ring);
+        copy.ringSamples = loadField(layout.ringSamples);
+        copy.maxViewSamples = loadField(layout.maxViewSamples);
+        copy.inputChannels = loadField(layout.inputChannels);
+        copy.outputChannels = loadField(layout.outputChannels);
+        copy.windowFrames = loadField(layout.windowFrames);
+        copy.strideFrames = loadField(layout.strideFrames);
+        copy.start = loadField(layout.start);
+
+        // The copy must complete before the generation is checked again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (session % 2 == 0 && generation.load(std::memory_order_relaxed) == session)
+        {
+            return session;
+        }
+
+        std::this_thread::yield();
+    }
+}
+
+void SlidingWindow::write(const float *samples, size_t frameCount) noexcept
+{
+    if (!layout.ring)
+    {
+        return;
+    }
+
+    int inputChannels = layout.inputChannels;
+    if (layout.outputChannels == inputChannels)
+    {
+        for (size_t done = 0; done < frameCount * inputChannels; done += kWriteChunkSamples)
+        {
+            append(samples + done, std::min(kWriteChunkSamples, frameCount * inputChannels - done));
+        }
+
+        return;
+    }
+
+    float mono[kWriteChunkSamples];
+    float scale = 1.0f / inputChannels;
+    for (size_t done = 0; done < frameCount; done += kWriteChunkSamples)
+    {
+        size_t frames = std::min(kWriteChunkSamples, frameCount - done);
+        const float *input = samples + done * inputChannels;
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            float sum = 0.0f;
+            for (int channel = 0; channel < inputChannels; ++channel)
+            {
+                sum += *input++;
+            }
+
+            mono[frame] = sum * scale;
+        }
+
+        append(mono, frames);
+    }
+}
+
+void SlidingWindow::append(const float *samples, size_t sampleCount) noexcept
+{
+    uint64_t position = written.load(std::memory_order_relaxed);
+    reserved.store(position + sampleCount, std::memory_order_relaxed);
+
+    // Stores to the ring must not become visible before the reservation that
+    // lets consumers detect them
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = static_cast<size_t>(position % layout.ringSamples);
+    buffer->write(offset * sizeof(float), samples, sampleCount * sizeof(float));
+
+    written.store(position + sampleCount, std::memory_order_release);
+}
+
+uint64_t SlidingWindow::getFrameCount() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    uint64_t samples = written.load(std::memory_order_acquire) - current.start;
+    return current.outputChannels > 0 ? samples / current.outputChannels : 0;
+}
+
+uint64_t SlidingWindow::getWindowCount() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    uint64_t samples = written.load(std::memory_order_acquire) - current.start;
+    uint64_t frames = current.outputChannels > 0 ? samples / current.outputChannels : 0;
+    return frames >= current.windowFrames && current.strideFrames > 0
+               ? (frames - current.windowFrames) / current.strideFrames + 1
+               : 0;
+}
+
+SampleWindow SlidingWindow::getWindow(uint64_t index) const noexcept
+{
+    Layout current;
+    readLayout(current);
+    return getFrames(index * current.strideFrames, current.windowFrames);
+}
+
+SampleWindow SlidingWindow::getFrames(uint64_t firstFrame, size_t frameCount) const noexcept
+{
+    SampleWindow view;
+    Layout current;
+    uint64_t session = readLayout(current);
+    uint64_t first = current.start + firstFrame * current.outputChannels;
+    size_t count = frameCount * current.outputChannels;
+    uint64_t available = written.load(std::memory_order_acquire);
+
+    // Samples from reserved - ringSamples on are intact
+    if (!current.ring || count > current.maxViewSamples || first + count > available ||
+        first + current.ringSamples < reserved.load(std::memory_order_relaxed))
+    {
+        return view;
+    }
+
+    view.data = current.ring + static_cast<size_t>(first % current.ringSamples);
+    view.firstFrame = firstFrame;
+    view.frameCount = frameCount;
+    view.channelCount = current.outputChannels;
+    view.generation = session;
+    return view;
+}
+
+SampleWindow SlidingWindow::getLatest(size_t frameCount) const noexcept
+{
+    uint64_t frames = getFrameCount();
+    if (frameCount > frames)
+    {
+        return SampleWindow();
+    }
+
+    return getFrames(frames - frameCount, frameCount);
+}
+
+bool SlidingWindow::isValid(const SampleWindow &view) const noexcept
+{
+    // Reads of the view must complete before the reservation is checked
+    std::atomic_thread_fence(std::memory_order_acquire);
+    uint64_t limit = reserved.load(std::memory_order_relaxed);
+
+    Layout current;
+    uint64_t session = readLayout(current);
+    return view.data && view.generation == session &&
+           current.start + view.firstFrame * current.outputChannels + current.ringSamples >= limit;
+}
+
+size_t SlidingWindow::getWindowFrames() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    return current.windowFrames;
+}
+
+size_t SlidingWindow::getStrideFrames() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    return current.strideFrames;
+}
+
+size_t SlidingWindow::getCapacityFrames() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    return current.outputChannels > 0 ? current.maxViewSamples / current.outputChannels : 0;
+}
+
+int SlidingWindow::getChannelCount() const noexcept
+{
+    Layout current;
+    readLayout(current);
+    return current.outputChannels;
+}
+
+WindowStage::WindowStage(const WindowSettings &settings, std::shared_ptr<MirroredBufferPool> pool)
+    : settings(settings)
+    , windows(std::move(pool))
+{
+}
+
+bool WindowStage::prepare(int sampleRate, int channelCount, const std::string &)
+{
+    return windows.reset(sampleRate, channelCount, settings);
+}
+
+void WindowStage::process(const float *samples, size_t frameCount)
+{
+    windows.write(samples, frameCount);
+}
+
+const SlidingWindow &WindowStage::getWindows() const noexcept
+{
+    return windows;
+}
+
+} // namespace AudioCaptureX
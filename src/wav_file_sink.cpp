@@ -0,0 +1,220 @@
+#include "wav_file_sink.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Seconds of audio buffered between the capture callback and the writer thread
+const int kRingSeconds = 2;
+
+// Frames handed to the writer per iteration
+const size_t kWriteChunkFrames = 8192;
+
+} // namespace
+
+WavFileSink::WavFileSink()
+    : channelCount(0)
+    , checkpointInterval(0)
+    , running(false)
+    , writeFailed(false)
+    , framesWritten(0)
+    , droppedFrames(0)
+    , bytesWritten(0)
+    , writeNanoseconds(0)
+{
+}
+
+WavFileSink::~WavFileSink()
+{
+    close();
+}
+
+void WavFileSink::setCheckpointInterval(std::chrono::milliseconds interval)
+{
+    checkpointInterval = interval;
+}
+
+bool WavFileSink::open(const std::string &filename, const WavFormat &format, std::unique_ptr<FileBackend> backend)
+{
+    close();
+
+    if (!writer.open(filename, format, std::move(backend)))
+    {
+        return false;
+    }
+
+    this->filename = filename;
+    channelCount = format.channelCount;
+    info.clear();
+    cues.clear();
+    queue.reset(static_cast<size_t>(format.sampleRate) * kRingSeconds, format.channelCount);
+    writeFailed = false;
+    framesWritten = 0;
+    droppedFrames = 0;
+    bytesWritten = 0;
+    writeNanoseconds = 0;
+
+    running = true;
+    writerThreadHandle = std::thread(&WavFileSink::writerThread, this);
+
+    return true;
+}
+
+bool WavFileSink::push(const float *samples, long frameCount) noexcept
+{
+    if (!running.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    if (!queue.push(samples, frameCount))
+    {
+        droppedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+bool WavFileSink::pushSilence(uint64_t frameCount) noexcept
+{
+    if (!running.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    if (!queue.pushSilence(frameCount))
+    {
+        droppedFrames.fetch_add(frameCount, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void WavFileSink::setInfo(const std::vector<WavInfoEntry> &info)
+{
+    this->info = info;
+}
+
+void WavFileSink::setCues(const std::vector<WavCue> &cues)
+{
+    this->cues = cues;
+}
+
+bool WavFileSink::close()
+{
+    if (!writerThreadHandle.joinable())
+    {
+        return false;
+    }
+
+    running = false;
+    writerThreadHandle.join();
+
+    writer.setInfo(info);
+    writer.setCues(cues);
+    bool ok = writer.finalize() && !writeFailed.load();
+
+    if (droppedFrames.load() > 0)
+    {
+        std::cerr << "File sink dropped " << droppedFrames.load() << " frames" << std::endl;
+    }
+
+    std::cout << "Sustained write throughput: " << getWriteThroughput() << " MB/s" << std::endl;
+
+    return ok;
+}
+
+bool WavFileSink::isOpen() const noexcept
+{
+    return running.load();
+}
+
+const std::string &WavFileSink::getFilename() const noexcept
+{
+    return filename;
+}
+
+const WavFormat &WavFileSink::getFormat() const noexcept
+{
+    return writer.getFormat();
+}
+
+uint64_t WavFileSink::getFramesWritten() const noexcept
+{
+    return framesWritten.load();
+}
+
+uint64_t WavFileSink::getDroppedFrames() const noexcept
+{
+    return droppedFrames.load();
+}
+
+uint64_t WavFileSink::getBytesWritten() const noexcept
+{
+    return bytesWritten.load();
+}
+
+double WavFileSink::getWriteThroughput() const noexcept
+{
+    int64_t nanoseconds = writeNanoseconds.load();
+    if (nanoseconds <= 0)
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(bytesWritten.load()) / (1024.0 * 1024.0) / (nanoseconds / 1e9);
+}
+
+void WavFileSink::writerThread()
+{
+    uint64_t frameBytes = static_cast<uint64_t>(channelCount) * bytesPerSample(writer.getFormat().sampleFormat);
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    auto checkpoint = [&] {
+        if (checkpointInterval.count() > 0 && !writeFailed.load() &&
+            std::chrono::steady_clock::now() - lastCheckpoint >= checkpointInterval)
+        {
+            // Sync and rewrite the header here so the audio thread never waits on the disk
+            auto start = std::chrono::steady_clock::now();
+            if (!writer.checkpoint())
+            {
+                std::cerr << "Failed to checkpoint output file: " << filename << std::endl;
+            }
+
+            lastCheckpoint = std::chrono::steady_clock::now();
+            writeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(lastCheckpoint - start).count();
+        }
+    };
+
+    auto write = [&](const float *samples, size_t frameCount, bool) {
+        if (writeFailed.load())
+        {
+            // Keep draining so the capture side does not report drops
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (!writer.writeFrames(samples, frameCount))
+        {
+            std::cerr << "Failed to write audio data to: " << filename << std::endl;
+            writeFailed = true;
+            return;
+        }
+
+        writeNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        framesWritten += frameCount;
+        bytesWritten += frameCount * frameBytes;
+    };
+
+    queue.drain(running, kWriteChunkFrames, write, checkpoint);
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,213 @@
+#include "wav_reader.hpp"
+#include <algorithm>
+#include <iostream>
+
+#include "dr_wav.h"
+
+namespace AudioCaptureX
+{
+
+WavReader::WavReader()
+    : dataOffset(0)
+    , frameCount(0)
+    , frameBytes(0)
+    , position(0)
+{
+}
+
+bool WavReader::open(const std::string &filename)
+{
+    close();
+
+    if (!file.open(filename))
+    {
+        return false;
+    }
+
+    // dr_wav only parses the header, samples are read from the mapping
+    drwav wav;
+    if (!drwav_init_memory(&wav, file.data(), static_cast<size_t>(file.size()), nullptr))
+    {
+        std::cerr << "Failed to parse WAV header: " << filename << std::endl;
+        file.close();
+        return false;
+    }
+
+    WavFormat parsed;
+    parsed.channelCount = static_cast<int>(wav.channels);
+    parsed.sampleRate = static_cast<int>(wav.sampleRate);
+
+    bool supported = parsed.channelCount > 0 && parsed.sampleRate > 0;
+    if (wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && wav.bitsPerSample == 16)
+    {
+        parsed.sampleFormat = WavSampleFormat::Pcm16;
+    }
+    else if (wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && wav.bitsPerSample == 24)
+    {
+        parsed.sampleFormat = WavSampleFormat::Pcm24;
+    }
+    else if (wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT && wav.bitsPerSample == 32)
+    {
+        parsed.sampleFormat = WavSampleFormat::Float32;
+    }
+    else
+    {
+        supported = false;
+    }
+
+    // Big-endian containers and padded samples cannot be used in place
+    if (wav.container == drwav_container_riff)
+    {
+        parsed.container = WavContainer::Riff;
+    }
+    else if (wav.container == drwav_container_rf64)
+    {
+        parsed.container = WavContainer::Rf64;
+    }
+    else if (wav.container == drwav_container_w64)
+    {
+        parsed.container = WavContainer::W64;
+    }
+    else
+    {
+        supported = false;
+    }
+
+    uint64_t parsedFrameBytes = static_cast<uint64_t>(parsed.channelCount) * bytesPerSample(parsed.sampleFormat);
+    supported = supported && wav.fmt.blockAlign == parsedFrameBytes;
+
+    uint64_t parsedOffset = wav.dataChunkDataPos;
+    uint64_t parsedFrames = wav.totalPCMFrameCount;
+    drwav_uninit(&wav);
+
+    if (!supported)
+    {
+        std::cerr << "Unsupported WAV sample format for mapped reading (16/24-bit PCM or 32-bit float): " << filename
+                  << std::endl;
+        file.close();
+        return false;
+    }
+
+    format = parsed;
+    dataOffset = std::min(parsedOffset, file.size());
+    frameBytes = parsedFrameBytes;
+    frameCount = std::min(parsedFrames, (file.size() - dataOffset) / frameBytes);
+    position = 0;
+    return true;
+}
+
+void WavReader::close() noexcept
+{
+    file.close();
+    format = WavFormat();
+    dataOffset = 0;
+    frameCount = 0;
+    frameBytes = 0;
+    position = 0;
+}
+
+bool WavReader::isOpen() const noexcept
+{
+    return file.isOpen();
+}
+
+const WavFormat &WavReader::getFormat() const noexcept
+{
+    return format;
+}
+
+uint64_t WavReader::getFrameCount() const noexcept
+{
+    return frameCount;
+}
+
+uint64_t WavReader::clampFrames(uint64_t firstFrame, uint64_t frameCount) const noexcept
+{
+    if (firstFrame >= this->frameCount)
+    {
+        return 0;
+    }
+
+    return std::min(frameCount, this->frameCount - firstFrame);
+}
+
+std::span<const uint8_t> WavReader::getBytes(uint64_t firstFrame, uint64_t frameCount) const noexcept
+{
+    uint64_t frames = clampFrames(firstFrame, frameCount);
+    if (frames == 0)
+    {
+        return {};
+    }
+
+    return {file.data() + dataOffset + firstFrame * frameBytes, static_cast<size_t>(frames * frameBytes)};
+}
+
+std::span<const int16_t> WavReader::getPcm16(uint64_t firstFrame, uint64_t frameCount) const noexcept
+{
+    std::span<const uint8_t> bytes = getBytes(firstFrame, frameCount);
+    if (format.sampleFormat != WavSampleFormat::Pcm16 || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(int16_t) != 0)
+    {
+        return {};
+    }
+
+    return {reinterpret_cast<const int16_t *>(bytes.data()), bytes.size() / sizeof(int16_t)};
+}
+
+std::span<const float> WavReader::getFloat(uint64_t firstFrame, uint64_t frameCount) const noexcept
+{
+    std::span<const uint8_t> bytes = getBytes(firstFrame, frameCount);
+    if (format.sampleFormat != WavSampleFormat::Float32 || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(float) != 0)
+    {
+        return {};
+    }
+
+    return {reinterpret_cast<const float *>(bytes.data()), bytes.size() / sizeof(float)};
+}
+
+uint64_t WavReader::readFrames(uint64_t firstFrame, float *output, uint64_t frameCount) const noexcept
+{
+    std::span<const uint8_t> bytes = getBytes(firstFrame, frameCount);
+    if (bytes.empty())
+    {
+        return 0;
+    }
+
+    convertToFloat(bytes.data(), format.sampleFormat, output, bytes.size() / bytesPerSample(format.sampleFormat));
+    return bytes.size() / frameBytes;
+}
+
+bool WavReader::seek(uint64_t frame) noexcept
+{
+    if (frame > frameCount)
+    {
+        return false;
+    }
+
+    position = frame;
+    return true;
+}
+
+uint64_t WavReader::tell() const noexcept
+{
+    return position;
+}
+
+uint64_t WavReader::readFrames(float *output, uint64_t frameCount) noexcept
+{
+    uint64_t frames = readFrames(position, output, frameCount);
+    position += frames;
+    return frames;
+}
+
+void WavReader::adviseSequential() noexcept
+{
+    file.adviseSequential();
+}
+
+void WavReader::release(uint64_t firstFrame, uint64_t frameCount) noexcept
+{
+    uint64_t frames = clampFrames(firstFrame, frameCount);
+    file.release(dataOffset + firstFrame * frameBytes, frames * frameBytes);
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,355 @@
+#include "wav_recovery.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+const uint64_t kRiffMaxSize = 0xFFFFFFFFull;
+
+const uint8_t kW64GuidRiff[16] = {0x72, 0x69, 0x66, 0x66, 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+const uint8_t kW64GuidFmt[16] = {0x66, 0x6D, 0x74, 0x20, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kW64GuidFact[16] = {0x66, 0x61, 0x63, 0x74, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kW64GuidData[16] = {0x64, 0x61, 0x74, 0x61, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+
+class File
+{
+public:
+    explicit File(const std::string &filename)
+        : file(std::fopen(filename.c_str(), "r+b"))
+    {
+    }
+
+    ~File()
+    {
+        if (file)
+        {
+            std::fclose(file);
+        }
+    }
+
+    bool isOpen() const
+    {
+        return file != nullptr;
+    }
+
+    bool read(uint64_t offset, void *data, size_t size)
+    {
+        return seek(offset) && std::fread(data, 1, size, file) == size;
+    }
+
+    bool write(uint64_t offset, const void *data, size_t size)
+    {
+        return seek(offset) && std::fwrite(data, 1, size, file) == size;
+    }
+
+    bool close()
+    {
+        bool ok = std::fclose(file) == 0;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    bool seek(uint64_t offset)
+    {
+#ifdef _WIN32
+        return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+
+    FILE *file;
+};
+
+uint32_t getU32(const uint8_t *data)
+{
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+uint64_t getU64(const uint8_t *data)
+{
+    return getU32(data) | (static_cast<uint64_t>(getU32(data + 4)) << 32);
+}
+
+void setU32(uint8_t *data, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+void setU64(uint8_t *data, uint64_t value)
+{
+    setU32(data, static_cast<uint32_t>(value));
+    setU32(data + 4, static_cast<uint32_t>(value >> 32));
+}
+
+// Location of the chunks that need repairing
+struct Layout
+{
+    uint64_t ds64Offset = 0; // ds64 or reserved JUNK chunk (RIFF/RF64 only)
+    uint64_t factOffset = 0; // Frame count of float files, 0 if there is no fact chunk
+    uint64_t dataOffset = 0; // Start of the data chunk header
+    uint64_t dataStart = 0;  // Start of the sample data
+    uint16_t blockAlign = 0;
+};
+
+bool scanRiff(File &file, uint64_t fileSize, Layout &layout)
+{
+    uint64_t position = 12;
+
+    while (position + 8 <= fileSize)
+    {
+        uint8_t chunk[8];
+        if (!file.read(position, chunk, sizeof(chunk)))
+        {
+            return false;
+        }
+
+        uint64_t size = getU32(chunk + 4);
+
+        if (std::memcmp(chunk, "data", 4) == 0)
+        {
+            layout.dataOffset = position;
+            layout.dataStart = position + 8;
+            return layout.blockAlign > 0;
+        }
+
+        if ((std::memcmp(chunk, "ds64", 4) == 0 || std::memcmp(chunk, "JUNK", 4) == 0) && position == 12 && size >= 28)
+        {
+            layout.ds64Offset = position;
+        }
+        else if (std::memcmp(chunk, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[16];
+            if (size < sizeof(fmt) || !file.read(position + 8, fmt, sizeof(fmt)))
+            {
+                return false;
+            }
+
+            layout.blockAlign = static_cast<uint16_t>(fmt[12] | (fmt[13] << 8));
+        }
+        else if (std::memcmp(chunk, "fact", 4) == 0 && size >= 4)
+        {
+            layout.factOffset = position + 8;
+        }
+
+        position += 8 + size + (size & 1);
+    }
+
+    return false;
+}
+
+bool scanW64(File &file, uint64_t fileSize, Layout &layout)
+{
+    uint64_t position = 40;
+
+    while (position + 24 <= fileSize)
+    {
+        uint8_t chunk[24];
+        if (!file.read(position, chunk, sizeof(chunk)))
+        {
+            return false;
+        }
+
+        uint64_t size = getU64(chunk + 16);
+
+        if (std::memcmp(chunk, kW64GuidData, 16) == 0)
+        {
+            layout.dataOffset = position;
+            layout.dataStart = position + 24;
+            return layout.blockAlign > 0;
+        }
+
+        if (std::memcmp(chunk, kW64GuidFmt, 16) == 0)
+        {
+            uint8_t fmt[16];
+            if (size < 24 + sizeof(fmt) || !file.read(position + 24, fmt, sizeof(fmt)))
+            {
+                return false;
+            }
+
+            layout.blockAlign = static_cast<uint16_t>(fmt[12] | (fmt[13] << 8));
+        }
+        else if (std::memcmp(chunk, kW64GuidFact, 16) == 0 && size >= 24 + 8)
+        {
+            layout.factOffset = position + 24;
+        }
+
+        if (size < 24)
+        {
+            return false;
+        }
+
+        position += (size + 7) & ~7ull;
+    }
+
+    return false;
+}
+
+} // namespace
+
+bool recoverWavFile(const std::string &filename)
+{
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(filename, error);
+    if (error)
+    {
+        std::cerr << "Failed to open WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    File file(filename);
+    uint8_t header[40];
+    if (!file.isOpen() || fileSize < sizeof(header) || !file.read(0, header, sizeof(header)))
+    {
+        std::cerr << "Failed to read WAV header: " << filename << std::endl;
+        return false;
+    }
+
+    bool w64 = std::memcmp(header, kW64GuidRiff, 16) == 0;
+    bool rf64 = std::memcmp(header, "RF64", 4) == 0;
+    bool riff = std::memcmp(header, "RIFF", 4) == 0;
+
+    Layout layout;
+    bool found = false;
+    if (w64)
+    {
+        found = scanW64(file, fileSize, layout);
+    }
+    else if ((riff || rf64) && std::memcmp(header + 8, "WAVE", 4) == 0)
+    {
+        found = scanRiff(file, fileSize, layout);
+    }
+
+    if (!found || (rf64 && layout.ds64Offset == 0))
+    {
+        std::cerr << "Not a recoverable WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    // A header that already accounts for the whole file needs no repair
+    uint64_t declaredSize = 0;
+    if (w64)
+    {
+        declaredSize = getU64(header + 16);
+    }
+    else if (rf64)
+    {
+        uint8_t ds64[8] = {};
+        file.read(layout.ds64Offset + 8, ds64, sizeof(ds64));
+        declaredSize = getU64(ds64) + 8;
+    }
+    else
+    {
+        declaredSize = static_cast<uint64_t>(getU32(header + 4)) + 8;
+    }
+
+    // Keep complete frames only
+    uint64_t dataBytes = (fileSize - layout.dataStart) / layout.blockAlign * layout.blockAlign;
+    uint64_t frames = dataBytes / layout.blockAlign;
+
+    if (declaredSize == fileSize)
+    {
+        std::cout << "WAV file is intact: " << filename << std::endl;
+        return true;
+    }
+
+    uint64_t alignment = w64 ? 8 : 2;
+    uint64_t padding = (alignment - dataBytes % alignment) % alignment;
+    uint64_t newSize = layout.dataStart + dataBytes + padding;
+
+    if (riff && newSize - 8 > kRiffMaxSize)
+    {
+        if (layout.ds64Offset == 0)
+        {
+            std::cerr << "Recovered data exceeds 4 GB and there is no room for an RF64 header: " << filename << std::endl;
+            return false;
+        }
+
+        std::cout << "Recovered data exceeds 4 GB, promoting WAV file to RF64" << std::endl;
+        riff = false;
+        rf64 = true;
+    }
+
+    bool ok = true;
+    if (w64)
+    {
+        uint8_t size[8];
+        setU64(size, newSize);
+        ok = ok && file.write(16, size, sizeof(size));
+        setU64(size, 24 + dataBytes);
+        ok = ok && file.write(layout.dataOffset + 16, size, sizeof(size));
+        if (layout.factOffset > 0)
+        {
+            setU64(size, frames);
+            ok = ok && file.write(layout.factOffset, size, sizeof(size));
+        }
+    }
+    else if (rf64)
+    {
+        uint8_t chunk[8 + 28] = {};
+        std::memcpy(chunk, "ds64", 4);
+        setU32(chunk + 4, 28);
+        setU64(chunk + 8, newSize - 8);
+        setU64(chunk + 16, dataBytes);
+        setU64(chunk + 24, frames);
+
+        uint8_t marker[4];
+        setU32(marker, 0xFFFFFFFF);
+        ok = ok && file.write(0, "RF64", 4) && file.write(4, marker, 4);
+        ok = ok && file.write(layout.ds64Offset, chunk, sizeof(chunk));
+        ok = ok && file.write(layout.dataOffset + 4, marker, 4);
+    }
+    else
+    {
+        uint8_t size[4];
+        setU32(size, static_cast<uint32_t>(newSize - 8));
+        ok = ok && file.write(4, size, sizeof(size));
+        setU32(size, static_cast<uint32_t>(dataBytes));
+        ok = ok && file.write(layout.dataOffset + 4, size, sizeof(size));
+    }
+
+    // The RIFF fact count is 32-bit, RF64 readers take the one in ds64 once it overflows
+    if (!w64 && layout.factOffset > 0)
+    {
+        uint8_t count[4];
+        setU32(count, static_cast<uint32_t>(std::min<uint64_t>(frames, 0xFFFFFFFFull)));
+        ok = ok && file.write(layout.factOffset, count, sizeof(count));
+    }
+
+    if (padding > 0 && ok)
+    {
+        const uint8_t zeros[8] = {};
+        ok = file.write(layout.dataStart + dataBytes, zeros, padding);
+    }
+
+    ok = file.close() && ok;
+
+    // Drop any partial frame left after the last complete one
+    if (ok && newSize < fileSize)
+    {
+        std::filesystem::resize_file(filename, newSize, error);
+        ok = !error;
+    }
+
+    if (!ok)
+    {
+        std::cerr << "Failed to repair WAV file: " << filename << std::endl;
+        return false;
+    }
+
+    std::cout << "Recovered " << frames << " frames in: " << filename << std::endl;
+    return true;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,465 @@
+#include "wav_writer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "dr_wav.h"
+
+namespace AudioCaptureX
+{
+
+namespace
+{
+
+// Frames converted per backend write
+const uint64_t kConvertChunkFrames = 16384;
+
+// RIFF sizes are 32-bit and count everything after the first 8 bytes
+const uint64_t kRiffMaxSize = 0xFFFFFFFFull;
+
+// Size of the ds64 chunk body, reserved as JUNK in RIFF files
+const uint32_t kDs64Size = 28;
+
+const uint8_t kW64GuidRiff[16] = {0x72, 0x69, 0x66, 0x66, 0x2E, 0x91, 0xCF, 0x11, 0xA5, 0xD6, 0x28, 0xDB, 0x04, 0xC1, 0x00, 0x00};
+const uint8_t kW64GuidWave[16] = {0x77, 0x61, 0x76, 0x65, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kW64GuidFmt[16] = {0x66, 0x6D, 0x74, 0x20, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kW64GuidFact[16] = {0x66, 0x61, 0x63, 0x74, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kW64GuidData[16] = {0x64, 0x61, 0x74, 0x61, 0xF3, 0xAC, 0xD3, 0x11, 0x8C, 0xD1, 0x00, 0xC0, 0x4F, 0x8E, 0xDB, 0x8A};
+const uint8_t kSubFormatIeeeFloat[16] = {0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+
+void putBytes(std::vector<uint8_t> &out, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+void putU16(std::vector<uint8_t> &out, uint16_t value)
+{
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void putU32(std::vector<uint8_t> &out, uint32_t value)
+{
+    putU16(out, static_cast<uint16_t>(value));
+    putU16(out, static_cast<uint16_t>(value >> 16));
+}
+
+void putU64(std::vector<uint8_t> &out, uint64_t value)
+{
+    putU32(out, static_cast<uint32_t>(value));
+    putU32(out, static_cast<uint32_t>(value >> 32));
+}
+
+} // namespace
+
+const char *containerName(WavContainer container) noexcept
+{
+    switch (container)
+    {
+        case WavContainer::Riff:
+            return "RIFF";
+        case WavContainer::Rf64:
+            return "RF64";
+        case WavContainer::W64:
+            return "Wave64";
+    }
+
+    return "unknown";
+}
+
+WavWriter::WavWriter()
+    : framesWritten(0)
+    , dataBytes(0)
+    , trailerBytes(0)
+{
+}
+
+WavWriter::~WavWriter()
+{
+    finalize();
+}
+
+bool WavWriter::open(const std::string &filename, const WavFormat &format, std::unique_ptr<FileBackend> backend)
+{
+    finalize();
+
+    if (format.channelCount <= 0 || format.sampleRate <= 0)
+    {
+        std::cerr << "Invalid WAV format: " << format.channelCount << " channels, " << format.sampleRate << " Hz" << std::endl;
+        return false;
+    }
+
+    this->backend = backend ? std::move(backend) : createStdioFileBackend();
+    this->format = format;
+    framesWritten = 0;
+    dataBytes = 0;
+    trailerBytes = 0;
+    info.clear();
+    cues.clear();
+
+    std::vector<uint8_t> header = buildHeader();
+    if (!this->backend->open(filename) || !this->backend->write(header.data(), header.size()))
+    {
+        std::cerr << "Failed to create WAV file: " << filename << std::endl;
+        this->backend.reset();
+        return false;
+    }
+
+    return true;
+}
+
+bool WavWriter::writeFrames(const float *samples, uint64_t frameCount)
+{
+    if (!backend)
+    {
+        return false;
+    }
+
+    size_t channels = format.channelCount;
+    size_t frameBytes = channels * bytesPerSample(format.sampleFormat);
+
+    if (format.sampleFormat == WavSampleFormat::Float32)
+    {
+        // Samples are already in the output format
+        return writeConverted(samples, frameCount);
+    }
+
+    convertBuffer.resize(kConvertChunkFrames * frameBytes);
+
+    for (uint64_t done = 0; done < frameCount;)
+    {
+        uint64_t frames = std::min(kConvertChunkFrames, frameCount - done);
+        convertSamples(samples + done * channels, format.sampleFormat, convertBuffer.data(), frames * channels);
+
+        if (!backend->write(convertBuffer.data(), frames * frameBytes))
+        {
+            return false;
+        }
+
+        done += frames;
+        framesWritten += frames;
+        dataBytes += frames * frameBytes;
+    }
+
+    return true;
+}
+
+bool WavWriter::writeConverted(const void *data, uint64_t frameCount)
+{
+    if (!backend)
+    {
+        return false;
+    }
+
+    uint64_t frameBytes = static_cast<uint64_t>(format.channelCount) * bytesPerSample(format.sampleFormat);
+    if (!backend->write(data, frameCount * frameBytes))
+    {
+        return false;
+    }
+
+    framesWritten += frameCount;
+    dataBytes += frameCount * frameBytes;
+    return true;
+}
+
+void WavWriter::setInfo(const std::vector<WavInfoEntry> &info)
+{
+    this->info.clear();
+    for (const WavInfoEntry &entry : info)
+    {
+        auto existing = std::find_if(this->info.begin(), this->info.end(), [&entry](const WavInfoEntry &other) {
+            return other.id == entry.id;
+        });
+
+        if (existing == this->info.end())
+        {
+            this->info.push_back(entry);
+        }
+        else
+        {
+            existing->text += "; " + entry.text;
+        }
+    }
+}
+
+void WavWriter::setCues(const std::vector<WavCue> &cues)
+{
+    this->cues = cues;
+    std::stable_sort(this->cues.begin(), this->cues.end(), [](const WavCue &a, const WavCue &b) {
+        return a.framePosition < b.framePosition;
+    });
+}
+
+bool WavWriter::checkpoint()
+{
+    if (!backend)
+    {
+        return false;
+    }
+
+    // Make the samples durable before the header claims them
+    if (!backend->sync())
+    {
+        return false;
+    }
+
+    uint64_t alignment = format.container == WavContainer::W64 ? 8 : 2;
+    promoteContainer((alignment - dataBytes % alignment) % alignment);
+
+    std::vector<uint8_t> header = buildHeader();
+    return backend->writeAt(0, header.data(), header.size()) && backend->sync();
+}
+
+bool WavWriter::finalize()
+{
+    if (!backend)
+    {
+        return false;
+    }
+
+    bool ok = true;
+
+    // Chunks are word aligned in RIFF and 8-byte aligned in Wave64
+    uint64_t alignment = format.container == WavContainer::W64 ? 8 : 2;
+    uint64_t padding = (alignment - dataBytes % alignment) % alignment;
+    if (padding > 0)
+    {
+        const uint8_t zeros[8] = {};
+        ok = backend->write(zeros, padding);
+    }
+
+    std::vector<uint8_t> trailer = buildTrailer();
+    if (!trailer.empty())
+    {
+        ok = backend->write(trailer.data(), trailer.size()) && ok;
+        trailerBytes = trailer.size();
+    }
+
+    promoteContainer(padding + trailerBytes);
+
+    std::vector<uint8_t> header = buildHeader();
+    ok = backend->writeAt(0, header.data(), header.size()) && ok;
+    ok = backend->close() && ok;
+    backend.reset();
+
+    return ok;
+}
+
+bool WavWriter::isOpen() const noexcept
+{
+    return backend != nullptr;
+}
+
+uint64_t WavWriter::getFramesWritten() const noexcept
+{
+    return framesWritten;
+}
+
+const WavFormat &WavWriter::getFormat() const noexcept
+{
+    return format;
+}
+
+uint64_t WavWriter::headerSize() const noexcept
+{
+    // RIFF/RF64: RIFF + ds64 (or JUNK) + fmt + data headers
+    // Wave64: riff + fmt + data chunks with 16-byte GUIDs and 64-bit sizes
+    // Float has the 40-byte extensible fmt and a fact chunk, which keeps the samples 4-byte aligned
+    bool floatFormat = format.sampleFormat == WavSampleFormat::Float32;
+    if (format.container == WavContainer::W64)
+    {
+        return floatFormat ? 160 : 104;
+    }
+
+    return floatFormat ? 116 : 80;
+}
+
+void WavWriter::promoteContainer(uint64_t padding)
+{
+    if (format.container == WavContainer::Riff && headerSize() + dataBytes + padding - 8 > kRiffMaxSize)
+    {
+        std::cout << "Recording exceeds 4 GB, promoting WAV file to RF64" << std::endl;
+        format.container = WavContainer::Rf64;
+    }
+}
+
+std::vector<uint8_t> WavWriter::buildTrailer() const
+{
+    std::vector<uint8_t> trailer;
+    if (format.container == WavContainer::W64)
+    {
+        return trailer;
+    }
+
+    // Cue points with sample offsets into the data chunk, labels refer to them by id
+    std::vector<uint8_t> points;
+    std::vector<uint8_t> labels;
+    uint32_t cueCount = 0;
+    for (const WavCue &cue : cues)
+    {
+        if (framesWritten == 0)
+        {
+            std::cerr << "Skipping cue in a recording without audio: " << cue.label << std::endl;
+            continue;
+        }
+
+        // A marker stamped ahead of the audio that reached the file points at its last frame
+        uint64_t framePosition = std::min(cue.framePosition, framesWritten - 1);
+        if (framePosition > 0xFFFFFFFFull)
+        {
+            std::cerr << "Skipping cue beyond 32-bit frame positions: " << cue.label << std::endl;
+            continue;
+        }
+
+        uint32_t id = ++cueCount;
+        uint32_t position = static_cast<uint32_t>(framePosition);
+        putU32(points, id);
+        putU32(points, position);
+        putBytes(points, "data", 4);
+        putU32(points, 0); // Chunk start
+        putU32(points, 0); // Block start
+        putU32(points, position);
+
+        uint32_t size = static_cast<uint32_t>(4 + cue.label.size() + 1);
+        putBytes(labels, "labl", 4);
+        putU32(labels, size);
+        putU32(labels, id);
+        putBytes(labels, cue.label.c_str(), cue.label.size() + 1);
+        if (size % 2 != 0)
+        {
+            labels.push_back(0);
+        }
+    }
+
+    if (cueCount > 0)
+    {
+        putBytes(trailer, "cue ", 4);
+        putU32(trailer, static_cast<uint32_t>(4 + points.size()));
+        putU32(trailer, cueCount);
+        putBytes(trailer, points.data(), points.size());
+
+        putBytes(trailer, "LIST", 4);
+        putU32(trailer, static_cast<uint32_t>(4 + labels.size()));
+        putBytes(trailer, "adtl", 4);
+        putBytes(trailer, labels.data(), labels.size());
+    }
+
+    if (info.empty())
+    {
+        return trailer;
+    }
+
+    std::vector<uint8_t> list;
+    putBytes(list, "INFO", 4);
+
+    for (const WavInfoEntry &entry : info)
+    {
+        if (entry.id.size() != 4)
+        {
+            std::cerr << "Skipping INFO entry with invalid id: " << entry.id << std::endl;
+            continue;
+        }
+
+        // Text is NUL terminated and word aligned
+        uint32_t size = static_cast<uint32_t>(entry.text.size() + 1);
+        putBytes(list, entry.id.data(), 4);
+        putU32(list, size);
+        putBytes(list, entry.text.c_str(), size);
+        if (size % 2 != 0)
+        {
+            list.push_back(0);
+        }
+    }
+
+    putBytes(trailer, "LIST", 4);
+    putU32(trailer, static_cast<uint32_t>(list.size()));
+    putBytes(trailer, list.data(), list.size());
+    return trailer;
+}
+
+std::vector<uint8_t> WavWriter::buildHeader() const
+{
+    // Float is written as WAVE_FORMAT_EXTENSIBLE with a fact chunk holding the frame count
+    bool floatFormat = format.sampleFormat == WavSampleFormat::Float32;
+    uint16_t formatTag = floatFormat ? DR_WAVE_FORMAT_EXTENSIBLE : DR_WAVE_FORMAT_PCM;
+    uint32_t fmtSize = floatFormat ? 40 : 16;
+    uint16_t blockAlign = static_cast<uint16_t>(format.channelCount * bytesPerSample(format.sampleFormat));
+    uint64_t alignment = format.container == WavContainer::W64 ? 8 : 2;
+    uint64_t fileSize = headerSize() + dataBytes + (alignment - dataBytes % alignment) % alignment + trailerBytes;
+
+    std::vector<uint8_t> header;
+    header.reserve(headerSize());
+
+    if (format.container == WavContainer::W64)
+    {
+        putBytes(header, kW64GuidRiff, 16);
+        putU64(header, fileSize);
+        putBytes(header, kW64GuidWave, 16);
+        putBytes(header, kW64GuidFmt, 16);
+        putU64(header, 24 + fmtSize);
+    }
+    else
+    {
+        bool rf64 = format.container == WavContainer::Rf64;
+
+        putBytes(header, rf64 ? "RF64" : "RIFF", 4);
+        putU32(header, rf64 ? 0xFFFFFFFF : static_cast<uint32_t>(fileSize - 8));
+        putBytes(header, "WAVE", 4);
+
+        // The ds64 chunk is reserved as JUNK in plain RIFF files
+        putBytes(header, rf64 ? "ds64" : "JUNK", 4);
+        putU32(header, kDs64Size);
+        putU64(header, rf64 ? fileSize - 8 : 0);
+        putU64(header, rf64 ? dataBytes : 0);
+        putU64(header, rf64 ? framesWritten : 0);
+        putU32(header, 0);
+
+        putBytes(header, "fmt ", 4);
+        putU32(header, fmtSize);
+    }
+
+    putU16(header, formatTag);
+    putU16(header, static_cast<uint16_t>(format.channelCount));
+    putU32(header, static_cast<uint32_t>(format.sampleRate));
+    putU32(header, static_cast<uint32_t>(format.sampleRate) * blockAlign);
+    putU16(header, blockAlign);
+    putU16(header, static_cast<uint16_t>(bytesPerSample(format.sampleFormat) * 8));
+
+    if (floatFormat)
+    {
+        putU16(header, 22); // cbSize
+        putU16(header, 32); // Valid bits per sample
+        putU32(header, 0);  // No speaker assignment
+        putBytes(header, kSubFormatIeeeFloat, 16);
+
+        // The RIFF fact count is 32-bit, RF64 readers take the one in ds64 once it overflows
+        if (format.container == WavContainer::W64)
+        {
+            putBytes(header, kW64GuidFact, 16);
+            putU64(header, 24 + 8);
+            putU64(header, framesWritten);
+        }
+        else
+        {
+            putBytes(header, "fact", 4);
+            putU32(header, 4);
+            putU32(header, static_cast<uint32_t>(std::min<uint64_t>(framesWritten, 0xFFFFFFFFull)));
+        }
+    }
+
+    if (format.container == WavContainer::W64)
+    {
+        putBytes(header, kW64GuidData, 16);
+        putU64(header, 24 + dataBytes);
+    }
+    else
+    {
+        putBytes(header, "data", 4);
+        putU32(header, format.container == WavContainer::Rf64 ? 0xFFFFFFFF : static_cast<uint32_t>(dataBytes));
+    }
+
+    return header;
+}
+
+} // namespace AudioCaptureX
@@ -0,0 +1,219 @@
+/**
+ * AudioCaptureX Feature Ring Test
+ * Checks views across the wrap of the ring, the frames a view may no longer
+ * see, clear() and readers on other threads that must never accept a view the
+ * producer has overwritten
+ */
+
+#include "include/feature_ring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const size_t kCapacity = 8;
+const size_t kFeatureCount = 3;
+
+// The producer publishes at least kConcurrentFrames, and goes on until every reader accepted kMinAccepted views
+const uint64_t kConcurrentFrames = 200000;
+const uint64_t kMinAccepted = 10000;
+const int kReaderCount = 3;
+
+// Value of a feature, distinct per frame and feature
+float featureValue(uint64_t frame, size_t feature)
+{
+    return static_cast<float>(frame * 10 + feature);
+}
+
+void publish(FeatureRing &ring, uint64_t frame)
+{
+    float *values = ring.beginFrame();
+    for (size_t feature = 0; feature < ring.featureCount(); ++feature)
+    {
+        values[feature] = featureValue(frame, feature);
+    }
+
+    ring.commitFrame();
+}
+
+// Check that a view holds its frames in order and in one piece
+bool holdsFrames(const FeatureView &view)
+{
+    for (size_t row = 0; row < view.frameCount; ++row)
+    {
+        for (size_t feature = 0; feature < view.featureCount; ++feature)
+        {
+            if (view.data[row * view.featureCount + feature] != featureValue(view.firstFrame + row, feature))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool check(const std::string &name, bool passed)
+{
+    if (!passed)
+    {
+        std::cerr << name << ": FAILED" << std::endl;
+    }
+
+    return passed;
+}
+
+bool checkSequential()
+{
+    FeatureRing ring(kCapacity, kFeatureCount);
+    bool passed = check("capacity", ring.capacity() == kCapacity && ring.featureCount() == kFeatureCount);
+    passed = check("empty ring has no frames", !ring.getLatest(1).data && ring.getLatest(0).frameCount == 0) && passed;
+
+    // Every run of frames is contiguous, including the ones across the end of the storage
+    for (uint64_t frame = 0; frame < 3 * kCapacity + 5; ++frame)
+    {
+        publish(ring, frame);
+        for (size_t count = 1; count < kCapacity && count <= frame + 1; ++count)
+        {
+            FeatureView view = ring.getLatest(count);
+            passed = check("latest " + std::to_string(count) + " at frame " + std::to_string(frame),
+                           view.data && view.firstFrame == frame + 1 - count && view.frameCount == count &&
+                               view.featureCount == kFeatureCount && holdsFrames(view) && ring.isValid(view)) &&
+                     passed;
+        }
+    }
+
+    // Frames not published yet, already overwritten or as many as the ring holds are not viewable
+    uint64_t published = ring.getFrameCount();
+    passed = check("frame count", published == 3 * kCapacity + 5) && passed;
+    passed = check("future frames", !ring.getFrames(published - 1, 2).data) && passed;
+    passed = check("overwritten frames", !ring.getFrames(published - kCapacity, 1).data) && passed;
+    passed = check("whole capacity", !ring.getLatest(kCapacity).data) && passed;
+    passed = check("oldest frame", ring.getFrames(published - kCapacity + 1, kCapacity - 1).data != nullptr) && passed;
+
+    // A view is valid until the producer may start writing over its first frame
+    FeatureView view = ring.getFrames(published - 2, 2);
+    for (size_t i = 0; i + 3 < kCapacity; ++i)
+    {
+        publish(ring, published++);
+    }
+
+    passed = check("view before its first frame is reused", ring.isValid(view) && holdsFrames(view)) && passed;
+    publish(ring, published++);
+    passed = check("view once its first frame is reused", !ring.isValid(view)) && passed;
+
+    // clear() drops the frames so far while the indices keep counting
+    view = ring.getLatest(3);
+    ring.clear();
+    passed = check("cleared view", !ring.isValid(view) && !ring.getLatest(1).data) && passed;
+    passed = check("first frame after clear", ring.getFirstFrame() == published && ring.getFrameCount() == published) && passed;
+
+    publish(ring, published++);
+    publish(ring, published++);
+    view = ring.getLatest(2);
+    passed = check("frames after clear", view.data && view.firstFrame == published - 2 && holdsFrames(view)) && passed;
+    passed = check("frames before clear", !ring.getLatest(3).data) && passed;
+
+    // reset() starts counting again
+    ring.reset(kCapacity * 2, kFeatureCount + 1);
+    publish(ring, 0);
+    view = ring.getLatest(1);
+    passed = check("reset", ring.getFrameCount() == 1 && ring.getFirstFrame() == 0 && view.data &&
+                                view.featureCount == kFeatureCount + 1 && holdsFrames(view)) &&
+             passed;
+
+    // A ring without storage takes no frames
+    FeatureRing none;
+    passed = check("no storage", !none.beginFrame() && !none.getLatest(0).data && none.capacity() == 0) && passed;
+    return passed;
+}
+
+// Readers accept a view only if isValid() says the producer has not touched it since it was taken
+bool checkConcurrent()
+{
+    FeatureRing ring(kCapacity, kFeatureCount);
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> accepted[kReaderCount] = {};
+    std::vector<uint64_t> torn(kReaderCount, 0);
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < kReaderCount; ++reader)
+    {
+        readers.emplace_back([&, reader] {
+            std::vector<float> copy(kCapacity * kFeatureCount);
+            while (!done.load(std::memory_order_acquire))
+            {
+                FeatureView view = ring.getLatest(1 + reader * 2);
+                if (!view.data)
+                {
+                    continue;
+                }
+
+                // Copy first, as a consumer feeding a model would read the frames
+                std::copy(view.data, view.data + view.frameCount * view.featureCount, copy.begin());
+                if (!ring.isValid(view))
+                {
+                    continue;
+                }
+
+                FeatureView copied = view;
+                copied.data = copy.data();
+                accepted[reader]++;
+                torn[reader] += holdsFrames(copied) ? 0 : 1;
+            }
+        });
+    }
+
+    uint64_t frame = 0;
+    auto readersBehind = [&accepted] {
+        for (const std::atomic<uint64_t> &count : accepted)
+        {
+            if (count.load(std::memory_order_relaxed) < kMinAccepted)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    while (frame < kConcurrentFrames || readersBehind())
+    {
+        publish(ring, frame++);
+    }
+
+    done.store(true, std::memory_order_release);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    bool passed = true;
+    for (int reader = 0; reader < kReaderCount; ++reader)
+    {
+        std::cout << "reader of " << 1 + reader * 2 << " frames accepted " << accepted[reader].load() << " views, "
+                  << torn[reader] << " torn" << std::endl;
+        passed = torn[reader] == 0 && passed;
+    }
+
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = checkSequential();
+    passed = checkConcurrent() && passed;
+
+    std::cout << (passed ? "Feature ring views hold the frames they name" : "Feature ring views differ from the frames written")
+              << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/**
+ * AudioCaptureX File Backend Test
+ * Finalizes WAV files through every file backend and checks the header
+ * against the frames written
+ */
+
+#include "include/wav_reader.hpp"
+#include "include/wav_writer.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+const uint64_t kBlockFrames = 480;
+
+// Value of a sample, distinct per frame and channel so misplaced blocks are caught
+float sampleValue(uint64_t frame, int channel)
+{
+    return static_cast<float>(frame % 1000) / 1000.0f + 0.0001f * channel;
+}
+
+bool checkBackend(const std::string &filename, FileBackendType type, uint64_t frameCount)
+{
+    WavFormat format;
+    format.sampleFormat = WavSampleFormat::Float32;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavWriter writer;
+    if (!writer.open(filename, format, createFileBackend(type)))
+    {
+        std::cerr << "Failed to open " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<float> block(kBlockFrames * kChannelCount);
+    bool ok = true;
+    for (uint64_t frame = 0; frame < frameCount; frame += kBlockFrames)
+    {
+        uint64_t count = std::min(kBlockFrames, frameCount - frame);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            for (int channel = 0; channel < kChannelCount; ++channel)
+            {
+                block[i * kChannelCount + channel] = sampleValue(frame + i, channel);
+            }
+        }
+
+        ok = writer.writeFrames(block.data(), count) && ok;
+    }
+
+    ok = writer.finalize() && ok;
+
+    WavReader reader;
+    if (!ok || !reader.open(filename))
+    {
+        std::cerr << fileBackendName(type) << ": failed to write or reopen " << frameCount << " frames" << std::endl;
+        return false;
+    }
+
+    // The header gives the frame count, the file size is checked against it
+    uint64_t dataBytes = reader.getBytes(0, reader.getFrameCount()).size();
+    if (reader.getFrameCount() != frameCount || dataBytes != frameCount * kChannelCount * sizeof(float))
+    {
+        std::cerr << fileBackendName(type) << ": wrote " << frameCount << " frames, header reports "
+                  << reader.getFrameCount() << " frames of " << dataBytes << " bytes" << std::endl;
+        return false;
+    }
+
+    std::vector<float> samples(kChannelCount);
+    for (uint64_t frame : {uint64_t(0), frameCount / 2, frameCount - 1})
+    {
+        if (frame >= frameCount || reader.readFrames(frame, samples.data(), 1) != 1)
+        {
+            continue;
+        }
+
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            if (samples[channel] != sampleValue(frame, channel))
+            {
+                std::cerr << fileBackendName(type) << ": frame " << frame << " does not match" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::string directory = argc > 1 ? argv[1] : std::filesystem::temp_directory_path().string();
+    std::string filename = directory + "/audio-capturex-backend-test.wav";
+
+    // Sizes inside the first buffer, across several buffers and across many submissions
+    bool passed = true;
+    for (FileBackendType type : {FileBackendType::Stdio, FileBackendType::Pwrite, FileBackendType::IoUring, FileBackendType::Direct})
+    {
+        for (uint64_t frameCount : {uint64_t(0), uint64_t(1000), uint64_t(100000), uint64_t(3000000)})
+        {
+            passed = checkBackend(filename, type, frameCount) && passed;
+        }
+    }
+
+    std::filesystem::remove(filename);
+    std::cout << (passed ? "All backends passed" : "Some backends failed") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+/**
+ * AudioCaptureX Level Stats Test
+ * Feeds known samples through the level statistics in odd block sizes and checks
+ * every histogram bin against logarithm-based binning and the clip counters
+ * against a plain scalar pass
+ */
+
+#include "include/level_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+// Three channels so groups of eight samples start on every channel in turn
+const int kChannelCount = 3;
+const size_t kFrameCount = 20000;
+
+// Block sizes cycled through, from single frames to ones that leave SIMD tails
+const long kBlockFrames[] = {1, 7, 480, 3, 1024, 11, 64};
+
+// Bin of a sample from its level: bin k holds 2^(-(k + 1) / 6) <= |x| < 2^(-k / 6)
+size_t referenceBin(float sample)
+{
+    double magnitude = std::abs(static_cast<double>(sample));
+    if (magnitude == 0.0)
+    {
+        return LevelStats::kBinCount - 1;
+    }
+
+    double bin = std::ceil(-6.0 * std::log2(magnitude)) - 1.0;
+    return static_cast<size_t>(std::clamp(bin, 0.0, static_cast<double>(LevelStats::kBinCount - 1)));
+}
+
+// Distance of a sample from the nearest bin edge, in bins
+double edgeDistance(float sample)
+{
+    double position = -6.0 * std::log2(std::abs(static_cast<double>(sample)));
+    return std::abs(position - std::round(position));
+}
+
+} // namespace
+
+int main()
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> decibels(-130.0, 0.0);
+    std::uniform_int_distribution<int> sign(0, 1);
+
+    // Levels spread over every bin, louder on the first channel than on the others
+    std::vector<float> samples(kFrameCount * kChannelCount);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        float sample;
+        do
+        {
+            double level = decibels(random) - 20.0 * static_cast<double>(i % kChannelCount);
+            sample = static_cast<float>(std::pow(10.0, level / 20.0));
+        } while (edgeDistance(sample) < 1e-4);
+
+        samples[i] = sign(random) ? -sample : sample;
+    }
+
+    // Exact bin edges, silence, denormals and values beyond full scale
+    std::vector<float> specials = {0.5f, 0.25f, -0.125f, std::ldexp(1.0f, -19), 0.0f, -0.0f,
+                                   std::numeric_limits<float>::denorm_min(), 1.0f, -1.5f, 0.9989f};
+    for (size_t i = 0; i < specials.size(); ++i)
+    {
+        samples[1000 + 5 * i] = specials[i];
+    }
+
+    // Clip runs of several lengths, some across block boundaries
+    struct Run
+    {
+        int channel;
+        size_t frame;
+        size_t length;
+    };
+
+    const Run runs[] = {{0, 3000, 1}, {0, 3100, 2}, {0, 3200, 3}, {1, 3300, 5}, {2, 3400, 40}, {0, 5000, 1200}, {1, 9000, 4}};
+    for (const Run &run : runs)
+    {
+        for (size_t i = 0; i < run.length; ++i)
+        {
+            samples[(run.frame + i) * kChannelCount + run.channel] = (i % 2) ? -1.0f : LevelStats::kClipLevel;
+        }
+    }
+
+    // Reference counters from one scalar pass over each channel
+    std::vector<std::vector<uint64_t>> expected(kChannelCount, std::vector<uint64_t>(LevelStats::kBinCount, 0));
+    std::vector<uint64_t> clipped(kChannelCount, 0);
+    std::vector<uint64_t> clipRuns(kChannelCount, 0);
+    std::vector<uint64_t> longest(kChannelCount, 0);
+    std::vector<uint64_t> runLength(kChannelCount, 0);
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        size_t channel = i % kChannelCount;
+        expected[channel][referenceBin(samples[i])]++;
+
+        if (std::abs(samples[i]) >= LevelStats::kClipLevel)
+        {
+            clipped[channel]++;
+            runLength[channel]++;
+            clipRuns[channel] += runLength[channel] == LevelStats::kMinClipRun ? 1 : 0;
+            longest[channel] = std::max(longest[channel], runLength[channel]);
+        }
+        else
+        {
+            runLength[channel] = 0;
+        }
+    }
+
+    // Stale statistics of an earlier session have to be cleared by reset()
+    LevelStats stats;
+    stats.reset(kChannelCount);
+    stats.process(samples.data(), 100);
+    stats.reset(kChannelCount);
+
+    size_t block = 0;
+    for (size_t frame = 0; frame < kFrameCount; block++)
+    {
+        long count = std::min<long>(kBlockFrames[block % std::size(kBlockFrames)], static_cast<long>(kFrameCount - frame));
+        stats.process(samples.data() + frame * kChannelCount, count);
+        frame += count;
+    }
+
+    bool passed = true;
+    std::vector<ChannelLevelStats> channels = stats.getChannels();
+    if (channels.size() != static_cast<size_t>(kChannelCount))
+    {
+        std::cerr << "Statistics for " << channels.size() << " channels, expected " << kChannelCount << std::endl;
+        return 1;
+    }
+
+    for (int channel = 0; channel < kChannelCount; ++channel)
+    {
+        const ChannelLevelStats &result = channels[channel];
+        for (size_t bin = 0; bin < LevelStats::kBinCount; ++bin)
+        {
+            if (result.histogram[bin] != expected[channel][bin])
+            {
+                std::cerr << "Channel " << channel << " bin " << bin << " (" << LevelStats::binDecibels(bin)
+                          << " dBFS) holds " << result.histogram[bin] << " samples, expected " << expected[channel][bin]
+                          << std::endl;
+                passed = false;
+            }
+        }
+
+        if (result.clippedSamples != clipped[channel] || result.clipRuns != clipRuns[channel] ||
+            result.longestClipRun != longest[channel])
+        {
+            std::cerr << "Channel " << channel << " clipped " << result.clippedSamples << " samples in " << result.clipRuns
+                      << " runs (longest " << result.longestClipRun << "), expected " << clipped[channel] << " in "
+                      << clipRuns[channel] << " (longest " << longest[channel] << ")" << std::endl;
+            passed = false;
+        }
+    }
+
+    std::vector<WavInfoEntry> info;
+    stats.describe(info);
+    std::string channel3 = "channel 3 " + std::to_string(clipped[2]) + " samples in " + std::to_string(clipRuns[2]) +
+                           " runs (longest " + std::to_string(longest[2]) + ")";
+    if (info.size() != 2 || info[0].id != "ICMT" || info[1].id != "ILVL" || info[0].text.find(channel3) == std::string::npos)
+    {
+        std::cerr << "Unexpected INFO entries:";
+        for (const WavInfoEntry &entry : info)
+        {
+            std::cerr << " " << entry.id << " \"" << entry.text.substr(0, 100) << "\"";
+        }
+
+        std::cerr << std::endl;
+        passed = false;
+    }
+
+    std::cout << (passed ? "Level statistics match the reference" : "Level statistics differ from the reference") << std::endl;
+    return passed ? 0 : 1;
+}
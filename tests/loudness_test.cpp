@@ -0,0 +1,124 @@
+/**
+ * AudioCaptureX Loudness Test
+ * Meters tone sequences from the EBU Tech 3341 and 3342 test cases and checks
+ * integrated, momentary and short-term loudness, loudness range and true peak
+ */
+
+#include "include/loudness_meter.hpp"
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+// Block sizes cycled through while metering, including ones that straddle 100 ms steps
+const size_t kBlockFrames[] = {480, 1, 4096, 37, 4800, 999};
+
+// Tolerances of EBU Tech 3341 (loudness) and 3342 (loudness range)
+const double kLoudnessTolerance = 0.1;
+const double kRangeTolerance = 1.0;
+const double kTruePeakBelow = 0.4;
+const double kTruePeakAbove = 0.2;
+
+// Stretch of a sine in every channel at a level in dBFS
+struct Tone
+{
+    double seconds = 0.0;
+    double level = 0.0;
+    double frequency = 1000.0;
+    double phase = 0.0;
+};
+
+LoudnessSummary measure(int sampleRate, int channelCount, const std::vector<Tone> &tones)
+{
+    std::vector<float> samples;
+    for (const Tone &tone : tones)
+    {
+        double amplitude = std::pow(10.0, tone.level / 20.0);
+        size_t frames = static_cast<size_t>(tone.seconds * sampleRate);
+        for (size_t frame = 0; frame < frames; ++frame)
+        {
+            float value = static_cast<float>(amplitude * std::sin(2.0 * kPi * tone.frequency * frame / sampleRate + tone.phase));
+            samples.insert(samples.end(), channelCount, value);
+        }
+    }
+
+    LoudnessMeter meter(sampleRate, channelCount);
+    std::vector<LoudnessReading> readings;
+    size_t frames = samples.size() / channelCount;
+    size_t block = 0;
+    for (size_t frame = 0; frame < frames; block++)
+    {
+        size_t count = std::min(kBlockFrames[block % std::size(kBlockFrames)], frames - frame);
+        meter.process(samples.data() + frame * channelCount, count, readings);
+        frame += count;
+    }
+
+    return meter.getSummary();
+}
+
+bool check(const std::string &name, double value, double expected, double below, double above)
+{
+    bool passed = value >= expected - below && value <= expected + above;
+    std::cout << name << ": " << value << ", expected " << expected << (passed ? "" : "  FAILED") << std::endl;
+    return passed;
+}
+
+bool check(const std::string &name, double value, double expected, double tolerance)
+{
+    return check(name, value, expected, tolerance, tolerance);
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = true;
+
+    // Tech 3341 case 1 and 2: stereo 1 kHz sine at -23 and -33 dBFS
+    for (int sampleRate : {48000, 44100})
+    {
+        std::string rate = std::to_string(sampleRate) + " Hz";
+        LoudnessSummary summary = measure(sampleRate, 2, {{20.0, -23.0}});
+        passed = check("-23 dBFS sine integrated, " + rate, summary.integrated, -23.0, kLoudnessTolerance) && passed;
+        passed = check("-23 dBFS sine max momentary, " + rate, summary.maxMomentary, -23.0, kLoudnessTolerance) && passed;
+        passed = check("-23 dBFS sine max short-term, " + rate, summary.maxShortTerm, -23.0, kLoudnessTolerance) && passed;
+
+        summary = measure(sampleRate, 2, {{20.0, -33.0}});
+        passed = check("-33 dBFS sine integrated, " + rate, summary.integrated, -33.0, kLoudnessTolerance) && passed;
+    }
+
+    // Tech 3341 case 3 and 4: the relative gate removes the quiet parts, the absolute gate the silence
+    LoudnessSummary summary = measure(48000, 2, {{10.0, -36.0}, {60.0, -23.0}, {10.0, -36.0}});
+    passed = check("relative gate", summary.integrated, -23.0, kLoudnessTolerance) && passed;
+
+    summary = measure(48000, 2, {{10.0, -72.0}, {10.0, -36.0}, {60.0, -23.0}, {10.0, -36.0}, {10.0, -72.0}});
+    passed = check("absolute gate", summary.integrated, -23.0, kLoudnessTolerance) && passed;
+
+    // Tech 3341 case 5: both sides of the relative gate
+    summary = measure(48000, 2, {{20.0, -26.0}, {20.1, -20.0}, {20.0, -26.0}});
+    passed = check("level steps", summary.integrated, -23.0, kLoudnessTolerance) && passed;
+
+    // Tech 3342 case 1 and 2: loudness range of two levels 10 and 5 LU apart
+    summary = measure(48000, 2, {{20.0, -20.0}, {20.0, -30.0}});
+    passed = check("loudness range 10 LU", summary.loudnessRange, 10.0, kRangeTolerance) && passed;
+
+    summary = measure(48000, 2, {{20.0, -20.0}, {20.0, -15.0}});
+    passed = check("loudness range 5 LU", summary.loudnessRange, 5.0, kRangeTolerance) && passed;
+
+    // Tech 3341 true peak: a quarter-rate sine sampled 45 degrees off its peaks reads 3 dB low on sample peak
+    summary = measure(48000, 2, {{2.0, -6.0, 12000.0, kPi / 4.0}});
+    passed = check("true peak between samples", summary.maxTruePeak, -6.0, kTruePeakBelow, kTruePeakAbove) && passed;
+
+    summary = measure(48000, 2, {{2.0, 0.0, 1000.0}});
+    passed = check("true peak of a full scale sine", summary.maxTruePeak, 0.0, kTruePeakBelow, kTruePeakAbove) && passed;
+
+    std::cout << (passed ? "Loudness matches the test cases" : "Loudness differs from the test cases") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+/**
+ * AudioCaptureX Marker Test
+ * Writes recordings with cue points through the writer and the file sink and
+ * reads the cue and label chunks back with dr_wav
+ */
+
+#include "include/wav_file_sink.hpp"
+#include "include/wav_writer.hpp"
+#include "dr_wav.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+const uint64_t kFrameCount = 10000;
+
+// Cues and INFO text as dr_wav reads them back
+struct Metadata
+{
+    bool opened = false;
+    uint64_t frameCount = 0;
+    std::vector<WavCue> cues;
+    std::string comment;
+};
+
+Metadata readMetadata(const std::string &filename)
+{
+    Metadata metadata;
+    drwav wav;
+    if (!drwav_init_file_with_metadata(&wav, filename.c_str(), 0, nullptr))
+    {
+        return metadata;
+    }
+
+    metadata.opened = true;
+    metadata.frameCount = wav.totalPCMFrameCount;
+
+    std::map<uint32_t, uint64_t> positions;
+    std::map<uint32_t, std::string> labels;
+    for (drwav_uint32 i = 0; i < wav.metadataCount; ++i)
+    {
+        const drwav_metadata &entry = wav.pMetadata[i];
+        if (entry.type == drwav_metadata_type_cue)
+        {
+            for (drwav_uint32 j = 0; j < entry.data.cue.cuePointCount; ++j)
+            {
+                const drwav_cue_point &point = entry.data.cue.pCuePoints[j];
+                positions[point.id] = point.sampleByteOffset;
+            }
+        }
+        else if (entry.type == drwav_metadata_type_list_label)
+        {
+            labels[entry.data.labelOrNote.cuePointId] =
+                std::string(entry.data.labelOrNote.pString, entry.data.labelOrNote.stringLength);
+        }
+        else if (entry.type == drwav_metadata_type_list_info_comment)
+        {
+            metadata.comment = std::string(entry.data.infoText.pString, entry.data.infoText.stringLength);
+        }
+    }
+
+    for (const auto &[id, position] : positions)
+    {
+        WavCue cue;
+        cue.framePosition = position;
+        cue.label = labels.count(id) ? labels[id] : "(no label)";
+        metadata.cues.push_back(cue);
+    }
+
+    drwav_uninit(&wav);
+    return metadata;
+}
+
+bool checkCues(const std::string &name, const Metadata &metadata, uint64_t frameCount, const std::vector<WavCue> &expected)
+{
+    bool passed = metadata.opened && metadata.frameCount == frameCount && metadata.cues.size() == expected.size();
+    for (size_t i = 0; passed && i < expected.size(); ++i)
+    {
+        passed = metadata.cues[i].framePosition == expected[i].framePosition && metadata.cues[i].label == expected[i].label;
+    }
+
+    if (!passed)
+    {
+        std::cerr << name << ": read " << metadata.frameCount << " frames and cues";
+        for (const WavCue &cue : metadata.cues)
+        {
+            std::cerr << " " << cue.framePosition << " \"" << cue.label << "\"";
+        }
+
+        std::cerr << ", expected " << frameCount << " frames and cues";
+        for (const WavCue &cue : expected)
+        {
+            std::cerr << " " << cue.framePosition << " \"" << cue.label << "\"";
+        }
+
+        std::cerr << std::endl;
+    }
+
+    std::cout << name << ": " << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+bool writeFile(const std::string &filename, WavContainer container, WavSampleFormat sampleFormat, uint64_t frameCount,
+               const std::vector<WavCue> &cues, const std::vector<WavInfoEntry> &info)
+{
+    WavFormat format;
+    format.sampleFormat = sampleFormat;
+    format.container = container;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavWriter writer;
+    if (!writer.open(filename, format))
+    {
+        return false;
+    }
+
+    std::vector<float> samples(frameCount * kChannelCount, 0.25f);
+    bool ok = frameCount == 0 || writer.writeFrames(samples.data(), frameCount);
+    writer.setCues(cues);
+    writer.setInfo(info);
+    return writer.finalize() && ok;
+}
+
+WavCue makeCue(uint64_t framePosition, const std::string &label)
+{
+    WavCue cue;
+    cue.framePosition = framePosition;
+    cue.label = label;
+    return cue;
+}
+
+} // namespace
+
+int main()
+{
+    const std::string filename = "marker-test.wav";
+    bool passed = true;
+
+    // Out of order, with odd and even label lengths, an empty label and two past the last frame
+    std::vector<WavCue> cues = {makeCue(7000, "Odd"), makeCue(0, "Start"), makeCue(12345, "Past the end"),
+                                makeCue(4000, ""), makeCue(kFrameCount, "At the end"), makeCue(4000, "Same frame")};
+    std::vector<WavCue> expected = {makeCue(0, "Start"), makeCue(4000, ""), makeCue(4000, "Same frame"), makeCue(7000, "Odd"),
+                                    makeCue(kFrameCount - 1, "At the end"), makeCue(kFrameCount - 1, "Past the end")};
+
+    WavInfoEntry comment;
+    comment.id = "ICMT";
+    comment.text = "Marker test";
+
+    passed = writeFile(filename, WavContainer::Riff, WavSampleFormat::Pcm16, kFrameCount, cues, {comment}) && passed;
+    Metadata metadata = readMetadata(filename);
+    passed = checkCues("RIFF 16-bit", metadata, kFrameCount, expected) && passed;
+    if (metadata.comment != comment.text)
+    {
+        std::cerr << "INFO comment next to the cues reads \"" << metadata.comment << "\"" << std::endl;
+        passed = false;
+    }
+
+    passed = writeFile(filename, WavContainer::Riff, WavSampleFormat::Float32, kFrameCount, cues, {}) && passed;
+    passed = checkCues("RIFF float", readMetadata(filename), kFrameCount, expected) && passed;
+
+    // Wave64 has no cue chunk, and a recording without audio has nothing to point at
+    passed = writeFile(filename, WavContainer::W64, WavSampleFormat::Pcm24, kFrameCount, cues, {}) && passed;
+    passed = checkCues("Wave64 without cues", readMetadata(filename), kFrameCount, {}) && passed;
+
+    passed = writeFile(filename, WavContainer::Riff, WavSampleFormat::Pcm16, 0, cues, {}) && passed;
+    passed = checkCues("empty recording", readMetadata(filename), 0, {}) && passed;
+
+    // The file sink hands its cues to the writer once the queued audio is written
+    WavFormat format;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavFileSink sink;
+    if (sink.open(filename, format))
+    {
+        std::vector<float> block(480 * kChannelCount, 0.5f);
+        for (uint64_t frame = 0; frame < kFrameCount; frame += 2000)
+        {
+            sink.push(block.data(), 480);
+            sink.pushSilence(1520);
+        }
+
+        sink.setCues(cues);
+        passed = sink.close() && passed;
+        passed = checkCues("file sink", readMetadata(filename), kFrameCount, expected) && passed;
+    }
+    else
+    {
+        passed = false;
+    }
+
+    std::remove(filename.c_str());
+
+    std::cout << (passed ? "Cue points read back as written" : "Cue points differ from the ones written") << std::endl;
+    return passed ? 0 : 1;
+}
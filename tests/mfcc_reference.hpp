@@ -0,0 +1,119 @@
+#pragma once
+
+// Generated by tests/mfcc_reference.py, do not edit
+
+#include <cstdint>
+
+namespace MfccReference
+{
+
+const int64_t kSignalSum = 644;
+const int64_t kSignalEnergy = 253345279570;
+
+const int kSpeechFrames = 48;
+const int kSpeechFeatures = 39;
+const float kSpeech[] = {
+    -12.83496f, -12.95724f, -5.04029f, 17.87249f, 8.190026f, -20.0043f, 44.23756f, 11.28081f, -10.73966f, 37.02518f, 52.85043f, 6.170411f, 19.49305f, 0.7287313f, 2.589887f, 2.629866f, 3.560143f, 1.01982f, 4.219186f, -0.2940658f, 7.493585f, 0.2927491f, 1.843413f, -4.93285f, -4.279787f, 1.306524f, -0.001581658f, 0.1452532f, 0.7357558f, 1.052561f, 1.331566f, 1.251959f, 1.594003f, 0.03870317f, 0.8466286f, 1.055708f, 1.501602f, -0.2192757f, -1.448477f,
+    -11.16842f, -5.795591f, -0.9416812f, 22.26587f, 12.00902f, -10.43586f, 36.78897f, 24.734f, -11.38992f, 34.50087f, 41.56335f, -5.957893f, 37.83131f, 0.6990357f, 3.102151f, 4.169914f, 6.127934f, 5.046955f, 7.801139f, 3.01479f, 7.810908f, 2.15907f, 5.268716f, -2.213999f, -5.682815f, -1.713386f, -0.02809828f, 0.00392691f, 0.8514488f, 0.9282825f, 1.398647f, 0.9300547f, 2.309404f, -0.2748888f, 0.6300451f, 0.6843605f, 2.076284f, 0.1649676f, -1.882781f,
+    -10.02457f, -3.588633f, 6.059734f, 33.47651f, 11.37963f, -3.692587f, 46.49153f, 42.02214f, -8.950791f, 47.5044f, 33.82971f, -9.16437f, 16.85654f, 0.7356708f, 3.060022f, 5.53862f, 7.53905f, 5.664084f, 8.688005f, 6.021519f, 7.528439f, 3.592732f, 5.409301f, 1.215733f, -4.674651f, -4.425905f, -0.04299972f, -0.1763578f, 0.3598423f, 0.2910777f, 1.133816f, 0.1306731f, 1.529686f, -0.9402491f, -0.1146798f, -1.544136f, 0.4933276f, -0.1472008f, -1.042223f,
+    -10.74497f, -2.130792f, 10.25927f, 40.71015f, 31.83f, 10.84554f, 58.18453f, 34.96468f, -0.8387498f, 58.12915f, 51.29079f, -14.57627f, 12.24437f, 0.5847701f, 2.374455f, 5.432732f, 6.212101f, 5.690923f, 6.63505f, 8.095163f, 6.101714f, 1.792983f, 3.482272f, 2.374277f, -3.257516f, -5.241166f, 0.01733957f, -0.284641f, -0.4909496f, -0.7319702f, -0.3587274f, -1.747174f, -0.8699283f, -1.67578f, -1.752529f, -4.514339f, -2.826039f, -0.7208037f, -0.5456735f,
+    -9.368325f, 0.5104645f, 17.05234f, 46.3456f, 26.59996f, 12.79503f, 63.64738f, 43.80766f, 1.948408f, 52.25754f, 54.06537f, -12.89365f, 10.15699f, 0.5708655f, 2.071947f, 3.797668f, 4.973448f, 6.366918f, 5.455596f, 4.814177f, 3.646936f, -0.0976062f, -4.984046f, -4.76035f, -6.22844f, -2.140703f, -0.02050442f, -0.319494f, -1.196651f, -1.252066f, -0.7525545f, -2.552997f, -3.477478f, -3.39737f, -3.391683f, -5.192812f, -4.993124f, -2.293572f, -0.9204705f,
+    -8.572688f, 4.027135f, 20.72568f, 46.89183f, 32.85347f, 14.49558f, 68.68686f, 54.34981f, -7.874603f, 49.53565f, 43.3169f, -20.38083f, 14.97525f, 0.8681362f, 2.172984f, 2.585642f, 3.750885f, 2.901901f, 0.6814713f, -0.7311809f, 1.372759f, -4.758404f, -12.10631f, -13.35615f, -8.509939f, -5.584355f, -0.06174245f, -0.3171989f, -1.363309f, -1.438624f, -1.70799f, -2.993604f, -4.664141f, -4.768155f, -4.032197f, -4.684064f, -4.914395f, -2.907162f, -2.361406f,
+    -8.256383f, 3.692137f, 19.81487f, 55.25291f, 42.70248f, 21.76037f, 65.31125f, 50.56426f, -5.920895f, 26.88091f, 14.01491f, -37.40429f, 4.787584f, 0.4914657f, 1.563287f, 0.97891f, 2.509331f, 3.295822f, -1.100192f, -6.952698f, -7.093934f, -10.08999f, -12.76047f, -15.88467f, -13.5163f, -8.856663f, -0.1550792f, -0.4160486f, -1.227226f, -1.87138f, -2.613271f, -3.392966f, -4.068383f, -5.028081f, -4.321015f, -2.372028f, -2.637761f, -2.155515f, -2.532136f,
+    -6.96026f, 7.14329f, 21.80621f, 55.01092f, 38.28824f, 9.770227f, 53.69669f, 38.45018f, -20.69612f, 10.28593f, 4.535254f, -44.87065f, -12.9927f, 0.3157578f, 1.04279f, 0.02556756f, 0.2510377f, -1.313482f, -5.055076f, -9.342105f, -12.36863f, -13.37181f, -16.04983f, -16.63554f, -14.1494f, -13.69021f, -0.2742728f, -0.6971023f, -1.062965f, -2.067327f, -2.424155f, -2.821542f, -2.995055f, -4.497755f, -3.102964f, -0.420244f, 0.05050434f, -0.7234868f, -0.1500715f,
+    -7.71721f, 6.768823f, 21.40662f, 54.83271f, 40.36169f, 9.656747f, 36.37898f, 16.2878f, -42.09079f, 8.080038f, -5.967152f, -68.23025f, -20.14235f, 0.07165853f, 0.5568004f, -1.058426f, -2.633526f, -4.591743f, -8.640959f, -11.22228f, -14.62277f, -17.39598f, -14.87242f, -16.30946f, -14.18628f, -10.74845f, -0.2003216f, -0.7003422f, -0.6246087f, -2.232192f, -2.662994f, -2.209891f, -1.067582f, -2.132832f, -1.59549f, 0.02426831f, 2.399738f, 2.364586f, 2.560131f,
+    -7.263485f, 7.702742f, 20.05764f, 48.35712f, 27.45646f, -4.727981f, 36.44247f, 9.644894f, -56.6487f, -21.31308f, -29.86977f, -75.71484f, -41.01086f, -0.293324f, -0.8092846f, -1.710517f, -4.014322f, -5.275092f, -9.655853f, -13.57167f, -17.3516f, -16.62023f, -13.15155f, -12.89124f, -11.79238f, -5.388817f, -0.1457938f, -0.5770571f, -0.4053969f, -1.531514f, -1.500989f, -0.8043992f, -0.2276513f, -0.7615509f, 0.4907841f, 1.937645f, 5.261948f, 4.940251f, 5.363704f,
+    -7.746478f, 6.196413f, 15.39703f, 45.41218f, 25.15966f, -14.19532f, 17.82698f, -8.146964f, -74.92449f, -31.68168f, -50.3299f, -92.91361f, -34.94561f, -0.2056014f, -1.012386f, -1.276091f, -6.518951f, -8.038344f, -9.849258f, -10.17583f, -15.26661f, -16.44323f, -14.08827f, -5.758132f, -2.87188f, -0.2067058f, -0.04327533f, -0.3278529f, -0.04222522f, -0.6038778f, -1.081254f, -0.08209294f, 0.6112998f, 0.8680567f, 3.14535f, 3.708354f, 7.052265f, 7.320189f, 5.99208f,
+    -8.412247f, 3.383072f, 16.25843f, 39.64957f, 19.5138f, -26.583f, -4.885639f, -36.09042f, -87.38042f, -35.59097f, -37.73955f, -91.49087f, -32.53516f, -0.2745813f, -1.057902f, -1.892584f, -5.463819f, -7.095125f, -8.472923f, -11.00358f, -15.85446f, -11.39426f, -6.753683f, 4.398535f, 4.894654f, 7.85743f, 0.01731221f, 0.06378322f, -0.02613233f, 0.2787396f, -0.2990544f, 0.3546342f, 0.8379714f, 3.107974f, 5.007859f, 5.387857f, 6.323293f, 7.34165f, 6.22308f,
+    -8.170836f, 3.866727f, 16.92577f, 26.59173f, 4.141296f, -28.66203f, 6.163887f, -37.17759f, -108.9411f, -55.22237f, -30.82292f, -74.70163f, -25.41373f, -0.1540895f, -0.9581552f, -1.178519f, -4.928168f, -9.087998f, -9.642889f, -9.449818f, -11.03106f, -4.282213f, 0.4704171f, 10.30698f, 14.07114f, 12.58883f, 0.02999739f, 0.2449358f, -0.1660506f, 1.158404f, 0.9652004f, 0.2307842f, 0.2618163f, 4.252628f, 6.989313f, 6.903435f, 4.477769f, 4.970389f, 4.764867f,
+    -8.424212f, 3.578074f, 9.830347f, 30.44825f, 2.490018f, -39.85924f, -12.74391f, -55.11211f, -96.61172f, -43.31115f, -17.63058f, -60.34756f, -6.489647f, -0.2325189f, -0.5174841f, -1.889965f, -3.416016f, -6.245536f, -7.985866f, -9.744814f, -3.929505f, 2.338555f, 6.508389f, 10.69268f, 16.44436f, 19.32882f, 0.04409303f, 0.2431008f, 0.08682193f, 0.9911731f, 1.313545f, 0.497101f, 1.678046f, 5.191012f, 6.10722f, 5.879268f, 2.923043f, 2.608626f, 1.525499f,
+    -8.510942f, 1.308136f, 12.71847f, 25.372f, -11.76844f, -55.77165f, -25.49298f, -53.7914f, -91.7199f, -25.46951f, -8.849487f, -38.12955f, 14.97577f, -0.0766456f, -0.0579161f, -2.107654f, -1.750833f, -3.637136f, -8.938865f, -9.496133f, 0.03404839f, 11.63693f, 13.79787f, 13.48364f, 16.20521f, 17.88194f, 0.0292258f, 0.1955807f, -0.06191375f, 0.3973875f, 1.508076f, 1.733753f, 3.299004f, 4.504463f, 4.100458f, 4.234204f, 2.442342f, -0.1772411f, -2.127901f,
+    -9.404788f, 2.074947f, 8.912251f, 23.17935f, -3.759011f, -52.95752f, -37.78128f, -47.43104f, -84.29823f, -17.92546f, 4.737113f, -27.55512f, 43.91419f, -0.09283804f, -0.2925176f, -0.9939067f, -2.09662f, -3.252829f, -6.33943f, -2.590196f, 4.568042f, 11.18227f, 15.97893f, 17.42542f, 16.87075f, 12.83837f, 0.02517163f, -0.06755554f, -0.2096669f, -0.4514568f, 0.1471043f, 1.860742f, 4.168944f, 3.335938f, 2.102076f, 2.463765f, 0.9351762f, -1.540306f, -4.978367f,
+    -8.063776f, 4.32871f, 6.84655f, 21.47201f, -10.91987f, -66.80721f, -28.79809f, -40.84789f, -56.91319f, 1.074133f, 25.41144f, -10.07179f, 38.79404f, -0.07780089f, -0.09273514f, -1.936116f, -3.600928f, -3.043973f, -1.797343f, 3.467892f, 7.242483f, 11.79822f, 16.90617f, 19.15232f, 12.97174f, 5.194547f, -0.09934465f, -0.4632562f, -0.3292828f, -0.6860801f, -0.5375798f, 2.394998f, 3.034437f, 2.206214f, -0.2902179f, 0.07549587f, -1.786212f, -2.819176f, -4.957871f,
+    -9.111985f, 0.6051987f, 7.796775f, 21.91514f, -14.19841f, -66.03861f, -24.04233f, -38.74366f, -58.10373f, 23.31168f, 52.36605f, 9.977316f, 45.79306f, -0.1060831f, -0.8378523f, -3.024068f, -4.748253f, -5.806596f, -2.252914f, 4.617893f, 9.145968f, 12.76828f, 17.27307f, 12.53422f, 10.35957f, 0.7806775f, -0.1272981f, -0.4553096f, -0.3327915f, -0.01179501f, -0.04028122f, 1.429099f, 0.9316484f, 1.187836f, -0.6480299f, -2.010261f, -4.26285f, -4.340576f, -5.158574f,
+    -9.046348f, 1.579334f, 3.595628f, 7.999468f, -21.76861f, -58.21782f, -15.02299f, -21.92267f, -45.82604f, 38.44276f, 63.09762f, 7.962935f, 40.00906f, -0.5667463f, -2.10153f, -2.738987f, -3.855417f, -5.048151f, 0.9928671f, 2.072008f, 8.776154f, 9.392828f, 13.52828f, 6.998181f, 5.364927f, -0.8785736f, -0.09918604f, -0.3995449f, 0.204863f, 0.8747026f, 0.8647012f, 0.6631196f, 0.2031093f, 0.5036438f, -1.136213f, -3.462004f, -4.65093f, -5.085895f, -4.871313f,
+    -9.443918f, -0.7396266f, -4.582628f, 6.174363f, -27.36762f, -68.51679f, -21.57936f, -11.1638f, -26.00038f, 49.75556f, 48.56512f, 15.22535f, 47.21006f, -0.4848556f, -1.564668f, -2.256429f, -2.028351f, -2.452146f, -0.5890406f, 2.765988f, 9.740386f, 9.144816f, 7.616565f, 2.188237f, -1.02872f, -9.91794f, 0.01467609f, 0.001950741f, 0.5859028f, 1.077286f, 1.72648f, 1.112356f, 0.7778755f, -0.3196476f, -1.335766f, -4.207618f, -3.032148f, -5.650971f, -4.307744f,
+    -10.73154f, -5.506527f, -0.6586855f, 10.06532f, -29.57602f, -60.60378f, -19.66954f, -10.75704f, -26.00073f, 55.4936f, 62.30281f, 14.12883f, 33.69267f, -0.3843448f, -1.727052f, -1.295621f, -0.587366f, -0.3976921f, 0.6863175f, 5.409391f, 9.463493f, 7.928892f, 4.424397f, 1.070657f, -6.763592f, -13.81271f, 0.1475891f, 0.3294657f, 0.3485527f, 0.4068245f, 1.196437f, 0.4703202f, 0.8869446f, -0.6137975f, -1.014131f, -3.889891f, -2.381901f, -5.242669f, -2.621066f,
+    -10.69367f, -3.675212f, -1.358212f, 10.74046f, -22.55544f, -67.79083f, -7.88912f, 4.37546f, -22.29231f, 52.86909f, 63.70464f, 1.750767f, -0.6384428f, -0.1239034f, -1.015338f, -0.8162373f, -0.9958476f, 0.5005758f, 3.462142f, 6.838579f, 7.204061f, 6.821422f, 0.7869161f, 0.3372425f, -11.83103f, -14.29097f, 0.09892337f, 0.2251531f, 0.01932053f, -0.2341804f, 0.1692231f, 0.876367f, 0.2604008f, -1.238909f, -0.9913122f, -2.205651f, -1.817015f, -3.389741f, 0.5487127f,
+    -10.3432f, -5.588131f, -4.494685f, 2.779589f, -26.16316f, -55.14922f, 5.178847f, 17.62516f, -8.035619f, 59.00798f, 60.88114f, -19.11773f, -5.130231f, -0.009277098f, -0.7288667f, -1.71632f, -2.337547f, -0.5423291f, 1.318877f, 4.470435f, 6.975329f, 5.483872f, -2.506351f, -3.985829f, -15.44726f, -11.79739f, 0.04972131f, 0.3268303f, -0.1600904f, -0.265676f, -0.03082604f, 0.6716643f, 0.08846014f, -1.081807f, -0.8560944f, -1.050702f, -2.067367f, -1.003636f, 1.657953f,
+    -10.25761f, -5.775513f, -6.745815f, 4.83799f, -26.57118f, -53.93336f, 0.1893415f, 10.6654f, -0.8758276f, 51.93295f, 50.96216f, -27.30653f, -4.833356f, -0.1777727f, -0.9379953f, -1.949477f, -2.324163f, -1.533712f, 3.476515f, 4.53747f, 4.789921f, 5.410765f, 0.05368468f, -4.368595f, -13.63559f, -8.182038f, 0.03721827f, 0.2998887f, -0.06155952f, 0.0534712f, 0.3161371f, 0.4491085f, 0.7293622f, -0.1216532f, -0.7302874f, -0.2806446f, -2.311439f, 1.145063f, 1.612747f,
+    -10.99596f, -8.10071f, -6.546483f, 1.32882f, -30.2798f, -60.93813f, -1.35659f, 20.97463f, -9.289612f, 43.42991f, 48.7449f, -48.57884f, -23.1968f, -0.1088036f, -0.1315716f, -1.529453f, -1.251589f, 0.4653216f, 4.037453f, 7.002247f, 5.261528f, 4.353748f, -0.4624986f, -6.913257f, -10.87949f, -8.577413f, 0.08769185f, 0.3603293f, 0.3490839f, 0.3495253f, 0.3278668f, 0.7663507f, 1.441434f, 0.07858949f, -0.9310617f, -0.6216232f, -2.518798f, 2.443036f, 2.042019f,
+    -11.25615f, -7.108899f, -10.0797f, -0.154967f, -28.16568f, -47.5138f, 18.06595f, 26.65033f, 5.388517f, 60.92655f, 47.92979f, -51.69663f, -32.51535f, 0.1119512f, 0.1854582f, -1.217468f, -1.271471f, 1.577436f, 4.348397f, 9.219485f, 7.452695f, 3.735047f, -1.638233f, -9.756237f, -8.389601f, -7.837223f, 0.1305049f, 0.4037044f, 0.7615144f, 0.4104137f, 0.01390272f, -0.345774f, 1.131561f, 0.2302744f, -1.784061f, -2.459989f, -2.601455f, 2.242086f, 2.278088f,
+    -10.38794f, -5.579296f, -10.47501f, -0.9818758f, -23.0393f, -38.17173f, 31.25178f, 35.94034f, 10.60095f, 52.19869f, 27.83104f, -61.32014f, -34.1763f, 0.2843202f, 0.5110531f, -0.3369048f, -1.116266f, -0.4585688f, 4.714689f, 9.336596f, 6.036889f, 1.666422f, -4.768509f, -13.886f, -5.855079f, -1.759697f, 0.06843876f, 0.1857964f, 0.4971325f, 0.1781267f, -0.5875543f, -1.143614f, -0.01228776f, -0.5686021f, -1.832557f, -3.21266f, -1.507897f, 1.793766f, 3.160612f,
+    -10.00186f, -6.108929f, -10.86889f, -0.3640157f, -22.30424f, -43.57458f, 29.98258f, 40.44602f, 7.854125f, 39.35739f, 12.63791f, -62.88389f, -38.52972f, 0.27819f, 0.7592141f, 1.261821f, -0.3397553f, -1.002253f, 1.409027f, 9.028101f, 5.553613f, -2.165877f, -10.09326f, -13.8895f, -4.93737f, -0.200457f, 0.01058242f, 0.07390713f, -0.1824619f, -0.05944926f, -0.09057848f, -1.092412f, -0.9485342f, -0.8651324f, -1.177935f, -2.480972f, -0.1671299f, 1.448362f, 3.970944f,
+    -10.2015f, -6.04543f, -7.83641f, -4.147986f, -35.50336f, -39.3343f, 39.36807f, 44.26123f, -2.190304f, 30.37194f, -3.039145f, -72.26061f, -28.9881f, 0.1502708f, 0.5105322f, -0.283435f, -0.8268128f, -1.182605f, -0.2109342f, 7.0365f, 3.368059f, -1.858573f, -12.29829f, -12.38611f, -3.636778f, 3.407264f, 0.009863546f, -0.04513564f, -0.790939f, -0.5507577f, 0.7712565f, -0.4044394f, -1.599652f, -0.8805281f, -1.164294f, -1.00475f, 1.180525f, 1.651248f, 3.851272f,
+    -9.958421f, -3.079762f, -5.089896f, -0.2706885f, -26.94491f, -39.88738f, 59.1483f, 50.25795f, 0.9547584f, 21.37364f, -6.082624f, -70.91325f, -36.11173f, 0.2318881f, 0.5552542f, -2.156512f, -1.713444f, 1.486562f, 1.349149f, 5.626862f, 4.461449f, -0.3921319f, -10.27821f, -11.34183f, -2.25694f, 9.434016f, -0.01603692f, -0.3197821f, -0.9175845f, -0.9762466f, 0.4861391f, 1.045841f, -1.509093f, -0.6427342f, -1.650336f, 0.5567357f, 1.642884f, 2.455283f, 3.97963f,
+    -9.658308f, -4.541219f, -14.78168f, -5.162604f, -26.63199f, -41.07f, 51.85142f, 47.87467f, 4.757765f, -0.300868f, -24.73923f, -75.48935f, -18.34898f, 0.3567889f, 0.3873548f, -2.582434f, -3.183211f, 2.153306f, 2.722431f, 3.038958f, 2.180331f, -5.041922f, -9.699782f, -9.257207f, 1.060944f, 12.67943f, -0.01547556f, -0.3419051f, -0.02935487f, -0.5519868f, -0.3287287f, 1.640578f, -0.2544089f, -0.9106847f, -2.154455f, 1.319448f, 3.095543f, 4.012011f, 2.921274f,
+    -9.114014f, -4.084763f, -18.17882f, -8.423925f, -19.30712f, -35.96098f, 51.87522f, 60.94655f, 2.419431f, 3.302767f, -33.22121f, -72.55421f, 3.320797f, 0.09474635f, -0.7781076f, -2.176603f, -4.04279f, -0.2395133f, 5.171549f, 3.481409f, 2.933806f, -8.825884f, -8.608829f, -7.239531f, 4.990185f, 15.06161f, -0.09036247f, -0.3023387f, 0.5435497f, -0.01877135f, -0.8737428f, 1.418381f, 0.5849551f, -1.943547f, -1.599684f, 1.217154f, 4.252903f, 4.563714f, 1.39183f,
+    -8.839762f, -3.606154f, -14.20412f, -15.98742f, -28.55573f, -27.68534f, 58.19941f, 49.81859f, -28.13225f, -9.091528f, -35.75589f, -66.13541f, 14.69276f, 0.1414638f, -0.5323125f, -0.4201641f, -2.422074f, -1.963211f, 6.080754f, 6.837182f, -0.4215431f, -8.413972f, -6.535735f, 1.040457f, 12.79971f, 15.19983f, -0.105623f, -0.1789216f, 0.1902952f, 0.4161635f, -0.2216467f, 0.4483498f, 0.4673021f, -1.641293f, 0.1883496f, 1.478613f, 3.990048f, 3.178798f, -0.336091f,
+    -9.893963f, -7.437832f, -16.26169f, -15.07223f, -27.18062f, -20.72196f, 73.38135f, 63.95502f, -26.72965f, -17.27518f, -36.77195f, -50.6393f, 22.67546f, -0.1122617f, -0.4966056f, -0.5198986f, -2.187869f, -0.8238933f, 6.761892f, 6.652525f, -3.955347f, -6.704525f, -5.77446f, 4.773854f, 14.69224f, 15.13296f, -0.0009342893f, 0.2457105f, -0.175088f, 0.5912695f, 0.9937586f, -0.1489952f, -0.8940578f, -1.97661f, 0.4179258f, 0.9794312f, 3.201838f, 0.9336365f, -2.166414f,
+    -8.561014f, -5.526247f, -17.84107f, -13.94882f, -32.5113f, -18.28574f, 75.28426f, 44.26272f, -22.73755f, -22.69057f, -17.76157f, -22.44824f, 47.97287f, -0.06782179f, -0.6480042f, -2.45931f, -2.029853f, 1.337263f, 4.169009f, 3.78991f, -2.58156f, -5.160853f, -3.7239f, 4.686342f, 12.1039f, 10.9633f, -0.02171562f, 0.09850606f, -0.4602317f, 0.3872253f, 1.328041f, -0.3347104f, -1.975756f, -1.050889f, -0.4463354f, -0.1349906f, 0.9159216f, -1.80701f, -4.250231f,
+    -9.814696f, -5.607745f, -18.95984f, -20.38257f, -21.44879f, -6.85132f, 76.59542f, 43.94775f, -33.80054f, -18.77001f, -18.3491f, -20.93658f, 62.34554f, 0.1947177f, 0.5082906f, -2.03247f, -1.282552f, 3.079042f, 5.382446f, 0.5347558f, -5.869236f, -8.362815f, -5.117591f, 6.946719f, 10.00627f, 6.34781f, 0.05948314f, 0.1266849f, -0.06199178f, 0.8414144f, 0.8299113f, -0.2529213f, -2.014376f, -1.409478f, -1.054388f, -0.588445f, 0.9685511f, -1.984342f, -5.034595f,
+    -9.218504f, -7.761219f, -25.15159f, -23.48152f, -24.73532f, -13.77562f, 75.54193f, 46.91442f, -50.40107f, -26.96361f, -21.53561f, -20.46724f, 49.6742f, -0.120604f, -0.5422303f, -1.965037f, -0.9386054f, 2.725524f, 5.096925f, 0.01728489f, -4.719041f, -9.816504f, -7.539122f, 4.533632f, 6.107649f, -1.658744f, -0.008505403f, 0.1209333f, 0.5630369f, 0.7809586f, 0.1518026f, 0.0698121f, -1.320197f, -2.358661f, -1.126406f, 0.4203738f, 1.794856f, -1.271609f, -3.744453f,
+    -8.59163f, -3.778893f, -22.76878f, -16.71864f, -15.67339f, 3.935204f, 75.9263f, 33.28298f, -54.71197f, -40.72661f, -0.1513411f, -1.598432f, 53.56384f, 0.2115451f, 0.08393176f, -1.076994f, 1.473579f, 2.631533f, 5.033328f, -1.533043f, -9.933998f, -9.648641f, -6.809074f, 9.692964f, 7.76866f, -3.728997f, -0.07823844f, -0.2317829f, 0.3631516f, 0.2756787f, -0.2237695f, -0.8082918f, -0.7470054f, -1.780876f, -0.1193926f, 3.18688f, 1.8756f, -0.3673936f, -1.948549f,
+    -9.775568f, -9.151825f, -25.76178f, -20.47381f, -21.77138f, 1.805621f, 75.70524f, 25.9999f, -61.36436f, -49.40788f, -4.192289f, -1.579068f, 44.07f, -0.1187625f, 0.1688414f, -0.1218633f, 0.4968737f, 2.320031f, 4.692628f, -1.777175f, -12.34248f, -10.14997f, -0.7762895f, 12.2875f, 6.864665f, -2.720564f, -0.05468269f, -0.2187678f, 0.1678826f, -0.1133166f, 0.2441855f, -0.648061f, -0.5872424f, -0.8947418f, 0.82262f, 4.971855f, 1.314211f, -0.3984569f, -0.4329617f,
+    -8.478439f, -4.492783f, -24.03971f, -14.51852f, -9.7731f, 10.5247f, 68.84854f, 4.735022f, -76.5621f, -41.59325f, 21.44407f, 8.462631f, 46.50266f, -0.1973952f, -1.00616f, -1.138299f, -0.6218981f, 2.162941f, 1.543135f, -2.303041f, -10.9619f, -8.793044f, 7.435391f, 12.44779f, 7.790797f, -2.864026f, -0.09444517f, -0.3873898f, -0.01385839f, -0.3711286f, 0.4117898f, -0.5430221f, -0.270292f, 1.438734f, 1.789052f, 4.454774f, -0.8202682f, -1.825262f, -1.315759f,
+    -9.868911f, -6.560067f, -25.12544f, -22.09721f, -16.08531f, 6.392775f, 70.19493f, -0.5240135f, -90.22587f, -30.41174f, 29.10417f, 8.825552f, 39.60197f, -0.1895473f, -1.091024f, -1.094971f, -0.45745f, 4.180747f, 3.601716f, -2.533928f, -8.678801f, -6.131203f, 10.19792f, 9.727275f, 4.104297f, -4.256038f, 0.04892834f, -0.1342274f, 0.08047308f, 0.5792395f, 0.9211459f, -0.3976749f, -0.779664f, 2.108019f, 2.78313f, 2.174042f, -1.141967f, -2.140819f, -2.264787f,
+    -9.531934f, -10.10557f, -28.77844f, -19.01643f, -7.701723f, 9.357303f, 67.16625f, -8.264543f, -84.24644f, -13.04772f, 45.43937f, 32.15324f, 41.47772f, -0.2252884f, -1.223085f, -0.6597319f, 0.0950978f, 3.760124f, 2.863673f, -2.506127f, -4.572167f, -2.712764f, 9.977688f, 6.871734f, 0.02253533f, -9.540056f, 0.1000197f, 0.4068037f, 0.514271f, 1.083041f, 0.6706307f, -0.3732939f, -1.084711f, 1.605146f, 2.629262f, 0.519267f, -0.7174848f, -3.000084f, -2.750415f,
+    -10.19656f, -11.80055f, -28.86727f, -20.51211f, -1.903339f, 20.3979f, 63.87675f, -10.89432f, -88.1782f, -12.69103f, 32.44643f, 7.097109f, 25.30228f, 0.1398258f, -0.393833f, 0.04121861f, 3.034573f, 6.127169f, 2.043985f, -5.573952f, -4.997255f, 0.7255396f, 8.822771f, 9.365687f, 0.04469861f, -10.70648f, 0.118799f, 0.4786956f, 0.4576947f, 0.6012343f, -0.6194621f, -1.268826f, -0.9095678f, 1.048122f, 2.095168f, -0.2149112f, 0.319538f, -2.33635f, -1.886032f,
+    -9.441058f, -7.987965f, -25.46746f, -14.83559f, 1.936531f, 17.8405f, 59.477f, -12.94066f, -91.14975f, -0.5651559f, 54.1316f, 9.439529f, 5.952228f, 0.1380166f, 0.6792634f, 0.8649611f, 3.047296f, 4.542883f, 0.4555315f, -6.206586f, -4.776939f, 0.9248936f, 10.7193f, 9.041158f, -5.179826f, -13.39088f, 0.04818408f, 0.2399762f, 0.2023785f, -0.1336222f, -1.291597f, -1.1376f, -0.3643464f, 0.3766734f, 1.374402f, -0.2450677f, -0.2367997f, -2.107319f, 0.3685877f,
+    -9.21522f, -9.588035f, -26.57484f, -9.014765f, 9.731405f, 12.3711f, 46.1698f, -23.17223f, -83.14651f, 7.46083f, 71.58649f, 20.4059f, 3.832298f, 0.2227951f, 0.3512804f, 0.4311558f, 1.072622f, 0.6920564f, -1.538343f, -5.231537f, -3.335806f, 2.525808f, 8.752559f, 10.24025f, -4.976271f, -11.76079f, -0.06566326f, -0.07063994f, 0.01719368f, -0.8238f, -1.774699f, -0.6479307f, 0.7940837f, 0.6759797f, 0.4729386f, -0.5060595f, -1.821822f, -1.936138f, 1.920684f,
+    -9.332519f, -7.815511f, -25.59985f, -9.528623f, 9.195323f, 15.64836f, 44.98679f, -26.01028f, -82.13782f, 30.47285f, 71.07513f, -0.4002824f, -14.74168f, -0.02585265f, -0.3957602f, 0.1571919f, 0.4079624f, 0.01969506f, -1.033162f, -4.499066f, -3.519525f, 3.259114f, 8.787456f, 5.250452f, -8.003573f, -7.169965f, -0.08107101f, -0.2584407f, -0.08987701f, -0.4601181f, -0.8764034f, -0.1668369f, 1.075055f, 0.6292362f, 0.05737547f, -1.463676f, -2.248239f, 0.1478856f, 3.501418f,
+    -9.136851f, -10.13037f, -26.6453f, -17.80248f, -2.072452f, 13.80226f, 44.96417f, -21.03854f, -80.05513f, 15.55276f, 75.17594f, -12.86434f, -23.15472f, -0.1065559f, -0.2095208f, 0.4810716f, 0.2352402f, -0.4847328f, -0.451322f, -2.457294f, -2.246064f, 1.923122f, 7.258396f, 2.151932f, -8.224117f, -4.213519f, -0.07277264f, -0.1304418f, 0.01523508f, 0.09429843f, 0.08439753f, 0.1343357f, 0.8306847f, 0.3664251f, -0.3771389f, -1.384857f, -2.019859f, 0.9506691f, 3.171928f,
+    -9.609506f, -9.695596f, -24.64627f, -8.401917f, 7.936935f, 11.95911f, 37.58448f, -31.60513f, -76.39987f, 39.32616f, 78.58914f, -13.94322f, -16.40409f, -0.102663f, -0.3325392f, 0.3906181f, 1.165397f, 0.7492611f, -0.9221635f, -2.218431f, -2.175628f, 1.513114f, 4.148001f, 1.844124f, -2.816475f, 0.3425792f, -0.01497277f, 0.0003423564f, 0.03763988f, 0.2445026f, 0.2693126f, -0.02488444f, 0.4800133f, 0.2758228f, -0.3902008f, -1.23893f, -0.7120465f, 1.578184f, 1.958119f,
+};
+
+const int kPlainFrames = 48;
+const int kPlainFeatures = 20;
+const float kPlain[] = {
+    -20.27396f, 0.6486958f, 7.412774f, 7.448438f, 2.071163f, -2.114869f, -0.401687f, -8.852066f, -7.884713f, -5.995748f, -8.942648f, -5.407417f, 0.1657224f, 0.7832896f, -0.08671818f, 2.676216f, -1.756447f, 0.5149897f, 4.587169f, 0.4163487f,
+    -19.67622f, 1.555194f, 4.383966f, 4.147306f, -1.54457f, -4.811856f, -4.126139f, -9.245934f, -9.386669f, -5.581711f, -7.400789f, -4.532669f, 0.7649081f, -0.2150299f, 2.87819f, 5.303374f, -0.3737212f, 1.442063f, 3.864939f, -1.796698f,
+    -19.40955f, 0.6691643f, 4.371326f, 3.041239f, -4.521665f, -6.013821f, -5.255151f, -10.09267f, -10.40595f, -3.759396f, -4.964204f, -1.060961f, 3.471744f, 1.203594f, 2.546607f, 5.056046f, 2.708019f, 0.2641751f, 2.947173f, -1.179365f,
+    -20.14292f, 1.356282f, 6.046431f, 4.196198f, -3.518129f, -7.932856f, -5.948402f, -9.930858f, -6.630169f, -1.246396f, -2.822403f, 2.260886f, 7.679428f, 3.401411f, 2.341065f, 5.72185f, 0.6651252f, -0.8006465f, 2.892363f, -1.612047f,
+    -19.40445f, 0.8033464f, 5.736345f, 2.397211f, -6.133291f, -7.897609f, -5.643915f, -9.82118f, -5.986513f, 0.2644144f, -0.1572542f, 3.110211f, 8.488029f, 3.692606f, 1.873719f, 3.548934f, -1.062018f, -1.328175f, 0.6658669f, -4.470616f,
+    -20.73606f, -0.5078781f, 3.039722f, -0.6520149f, -8.236429f, -10.05528f, -7.064617f, -10.31431f, -6.990843f, 2.681152f, 0.7929805f, 3.526415f, 7.711819f, 1.685386f, 0.7675062f, 0.8571391f, -4.476619f, -3.464313f, -0.6799674f, -2.331883f,
+    -20.63174f, -0.4871454f, 3.196327f, 1.759804f, -7.696067f, -10.50343f, -7.505158f, -8.648226f, -4.511106f, 4.744905f, 4.004718f, 5.260113f, 5.609356f, -0.7860295f, -0.7486485f, -0.4621319f, -5.108633f, -2.646403f, -1.504692f, -2.219249f,
+    -19.85463f, -0.6594963f, 1.72335f, -0.02939628f, -9.343855f, -10.67664f, -5.2076f, -5.53382f, -1.464462f, 7.094216f, 5.501081f, 5.271384f, 5.173774f, -1.018703f, -2.234554f, -1.687202f, -5.036863f, -1.778133f, 1.962921f, -0.8866521f,
+    -20.93748f, -0.9580713f, 1.991958f, -0.551782f, -8.709366f, -11.41593f, -5.448533f, -3.511714f, 1.362702f, 7.753783f, 4.264806f, 3.54654f, 4.640728f, -4.317981f, -3.652292f, -4.183269f, -5.605349f, -0.2443273f, 3.244523f, -1.025312f,
+    -19.69337f, 0.3188509f, 1.557991f, -1.452374f, -8.95002f, -9.62989f, -2.84412f, -3.016068f, 1.620493f, 9.391692f, 5.214665f, 2.823995f, 1.315845f, -4.881141f, -4.826219f, -1.458944f, -2.233979f, 1.161201f, 4.140854f, -0.03886393f,
+    -20.87414f, -1.104435f, 0.05340966f, -1.651489f, -8.902344f, -9.961335f, -2.096837f, -0.9816272f, 3.458224f, 9.547982f, 4.323011f, 1.926623f, -0.1713074f, -7.429328f, -3.696759f, 0.878729f, 0.8546394f, 1.369528f, 4.948817f, 1.719077f,
+    -22.2953f, -3.424468f, -0.4549601f, -3.259929f, -9.221717f, -9.375485f, -0.08769851f, 3.002078f, 6.755499f, 9.80005f, 1.900335f, -0.9018488f, -0.8864757f, -7.150934f, -4.670336f, 2.116316f, 0.2372919f, 3.138351f, 4.425124f, -1.251153f,
+    -22.48079f, -3.500339f, -0.7471778f, -5.268925f, -8.204443f, -6.104741f, 1.129968f, 1.846922f, 6.880373f, 12.05615f, 2.46192f, -3.073086f, -1.904086f, -4.619914f, -3.254943f, 5.449645f, 2.534953f, 2.326779f, 3.171971f, -3.911935f,
+    -22.13944f, -3.117119f, -2.186549f, -3.645527f, -8.788399f, -7.159777f, 1.655524f, 2.620565f, 6.68883f, 8.049298f, -0.6561707f, -4.304766f, -1.949529f, -3.90351f, -1.396525f, 7.426112f, 4.026508f, 2.497435f, 2.582151f, -3.002701f,
+    -22.5856f, -4.525792f, -1.594555f, -4.50854f, -9.299305f, -4.861896f, 4.635424f, 4.607167f, 6.283838f, 6.420425f, -3.148591f, -4.685798f, -2.980875f, -4.098529f, -0.4476688f, 5.392581f, 0.9341997f, 1.637487f, -0.2991396f, -6.365621f,
+    -23.17006f, -3.452445f, -1.56578f, -3.492056f, -7.368462f, -4.989613f, 4.223167f, 6.984411f, 6.271555f, 6.008696f, -2.255234f, -4.137346f, -0.4952258f, -2.281759f, 3.678206f, 8.397267f, 0.9051844f, -1.091174f, -0.1445934f, -5.783373f,
+    -22.45367f, -3.373824f, -3.36139f, -5.055703f, -8.478361f, -5.051497f, 6.135327f, 5.045881f, 4.023471f, 2.871865f, -3.595036f, -3.176977f, 1.037417f, 0.5282297f, 2.217172f, 6.917465f, -1.715198f, -3.26583f, -1.349361f, -4.520832f,
+    -21.92907f, -3.951866f, -1.116913f, -3.558127f, -7.955451f, -5.094084f, 5.675018f, 2.497306f, 1.810472f, 0.1339032f, -7.556826f, -5.815772f, 2.02708f, 1.351792f, 3.547377f, 4.769546f, -2.029309f, -4.051714f, -1.242617f, -3.903967f,
+    -22.92648f, -3.803561f, -3.010155f, -5.822688f, -6.357556f, -2.296664f, 4.782581f, 1.871733f, 0.2360529f, -0.01668927f, -6.359127f, -3.842718f, 4.34212f, 3.107154f, 2.988825f, 5.130787f, -2.623056f, -4.727204f, -0.003273718f, -1.25714f,
+    -22.58743f, -4.184122f, -4.115672f, -3.49423f, -4.886918f, -0.6648809f, 7.84491f, 4.005521f, -0.5908053f, -1.136285f, -5.829301f, -1.390711f, 3.87124f, 2.436578f, 4.591274f, 2.888597f, -4.030862f, -3.853262f, 1.548364f, -0.3619202f,
+    -24.92121f, -6.193006f, -1.95482f, -3.148089f, -6.135514f, -0.7949058f, 5.788259f, 2.559988f, -1.349727f, -2.586037f, -7.374205f, -2.912233f, 4.218867f, 2.128316f, 2.483308f, -0.7573864f, -5.945773f, -3.004618f, 3.959953f, 0.8563512f,
+    -24.12109f, -4.845447f, -1.859853f, -2.132152f, -5.049896f, -1.555161f, 7.43951f, 2.446481f, -2.07168f, -0.7131859f, -5.525645f, -1.863985f, 5.369493f, 2.341338f, -1.193029f, -2.408059f, -4.669217f, -0.2000822f, 3.703065f, 0.2094887f,
+    -24.09589f, -6.365753f, -2.915983f, -2.725711f, -3.608925f, 0.4577772f, 6.06172f, 0.07690209f, -3.616582f, -1.165746f, -4.375049f, -0.06334302f, 6.622902f, 1.04312f, -1.842883f, -0.03254537f, -4.142495f, -1.533793f, 5.570928f, 1.826143f,
+    -24.36891f, -6.740347f, -2.979186f, -1.927665f, -3.520922f, 0.308575f, 7.061276f, 1.463862f, -1.510633f, -1.530206f, -2.282922f, 0.7161191f, 6.544439f, -0.2187176f, -1.432305f, -1.249692f, -3.669725f, 0.2653689f, 4.869948f, -0.4338946f,
+    -25.90696f, -8.488988f, -4.145849f, -2.88604f, -3.689126f, 1.835469f, 9.008645f, 3.423788f, -1.421073f, 1.177353f, -1.087733f, 0.7558647f, 6.770642f, -1.028667f, -3.973742f, -1.505793f, -3.529049f, 1.253096f, 3.756978f, -0.9518218f,
+    -25.09228f, -6.574373f, -3.177172f, -1.364546f, -1.652338f, 1.932284f, 6.361592f, -0.849877f, -3.540051f, -1.26662f, -2.475563f, 1.526938f, 6.619685f, -2.11629f, -5.089364f, -1.148768f, -0.1808582f, 2.447084f, 2.493754f, -3.215272f,
+    -23.54952f, -5.72944f, -3.595426f, -1.476296f, -1.376982f, 1.39031f, 4.973699f, -3.662102f, -4.96669f, -1.102311f, -1.040701f, 3.418643f, 6.309489f, -2.567471f, -4.153347f, 0.173882f, 0.5300305f, 3.609245f, 4.15942f, -2.804106f,
+    -23.45671f, -6.20554f, -3.986919f, -1.636129f, -2.406591f, 0.6866342f, 4.847129f, -3.033498f, -5.547322f, -0.4630354f, -0.838235f, 3.082371f, 4.446119f, -2.581777f, -4.612379f, 0.794911f, 1.641484f, 5.276742f, 2.286324f, -5.155597f,
+    -24.85695f, -7.648637f, -4.333085f, -3.812713f, -3.209175f, 2.448097f, 4.846732f, -3.768937f, -4.91841f, 1.058896f, 0.4587134f, 2.518152f, 2.54255f, -5.220767f, -4.634836f, 1.024754f, 1.118027f, 1.750532f, -0.1225057f, -5.631526f,
+    -23.57854f, -4.876268f, -2.955913f, -2.748941f, -2.614724f, 1.620546f, 5.540691f, -5.799984f, -5.72066f, 2.177032f, 1.98377f, 3.766133f, 2.763508f, -3.99457f, -5.321033f, 1.546269f, 1.83501f, 1.241669f, -0.1303345f, -4.316082f,
+    -23.33812f, -6.321438f, -5.088883f, -2.089651f, -0.8332982f, 1.867908f, 6.916572f, -3.994732f, -3.801353f, 1.939548f, 3.673098f, 3.252466f, 0.6895726f, -5.989361f, -3.491338f, 3.953855f, 1.741268f, -1.718844f, -1.725652f, -4.786174f,
+    -22.9008f, -6.493849f, -6.207899f, -2.499388f, -0.4383273f, 0.5306344f, 4.544707f, -4.972307f, -6.835231f, 0.943781f, 3.021236f, 3.490133f, 0.315969f, -6.048681f, -1.405027f, 6.095537f, 1.333419f, -0.8552038f, -1.505628f, -2.933085f,
+    -23.42389f, -7.931118f, -7.336509f, -5.347426f, -1.011408f, 2.418772f, 4.149242f, -5.752631f, -4.83146f, 4.43613f, 2.630743f, 1.01965f, -1.270179f, -7.227346f, -0.9554896f, 4.480418f, -0.378919f, -2.4475f, -2.482555f, -3.491861f,
+    -25.54546f, -10.08056f, -7.302678f, -4.16302f, -0.01683321f, 3.679967f, 5.24497f, -5.605023f, -4.600128f, 6.703996f, 5.672776f, 3.015199f, -0.165218f, -5.211424f, 0.3397201f, 4.409374f, -0.7009687f, -4.399747f, -2.67565f, -2.588848f,
+    -22.7367f, -8.074682f, -6.894469f, -2.656439f, -0.2394081f, 4.331361f, 4.336675f, -7.639695f, -3.86948f, 4.537006f, 3.057991f, 0.4255817f, -1.409023f, -2.388695f, 2.710259f, 5.719809f, -2.513486f, -5.108001f, -1.90607f, -0.1717248f,
+    -22.34948f, -4.725989f, -3.626126f, -0.7770749f, 3.485551f, 4.663313f, 2.887949f, -7.664632f, -4.781282f, 3.737691f, 1.104507f, -0.8034018f, -2.144661f, -3.11398f, 3.938083f, 7.242338f, -4.376129f, -6.99474f, 0.3043673f, 0.2871828f,
+    -23.30478f, -8.242577f, -7.003645f, -2.116897f, 3.291536f, 4.67117f, 4.168285f, -6.534991f, -3.979389f, 6.391106f, 2.505358f, -1.275017f, -2.072728f, -3.774044f, 2.941837f, 2.602739f, -4.005213f, -3.861873f, 2.440253f, 3.173346f,
+    -21.69854f, -4.622621f, -5.674814f, -1.540107f, 3.025712f, 3.140574f, 0.4558088f, -7.527781f, -2.471526f, 5.61011f, 2.784358f, -3.354111f, -1.890918f, -0.00960645f, 4.177789f, 3.546226f, -4.627806f, -3.989115f, 4.008091f, 1.608039f,
+    -22.87518f, -7.329535f, -5.555085f, -0.7101812f, 4.15087f, 5.080248f, 2.108054f, -7.4147f, -1.487372f, 6.274631f, 2.702626f, -4.53837f, -2.933353f, -0.7175456f, 2.688182f, 1.352723f, -5.886926f, -1.31105f, 7.073446f, 1.468272f,
+    -21.894f, -6.594563f, -7.500701f, -1.707081f, 2.358645f, 1.915798f, -0.7564831f, -7.318357f, 0.5728102f, 7.21267f, 0.6490998f, -6.012713f, -1.090464f, 1.200305f, 3.258391f, 2.405802f, -5.723501f, -2.398858f, 5.434721f, 0.1924956f,
+    -23.61123f, -6.944422f, -6.99351f, -2.360651f, 3.711743f, 3.647735f, 0.6180946f, -7.449677f, 0.6864794f, 7.155223f, -1.497913f, -7.448915f, -1.318148f, 0.136046f, 2.15069f, 0.3660562f, -5.124618f, -1.102866f, 4.875671f, -0.8973714f,
+    -23.35969f, -8.360376f, -6.843565f, -0.6113549f, 4.525206f, 3.060457f, 0.3432578f, -6.684029f, 1.331523f, 6.991467f, -2.43097f, -5.694418f, 0.5675526f, 3.736249f, 4.250397f, 0.8936303f, -4.787874f, 0.4683309f, 5.876966f, -0.1454955f,
+    -24.86916f, -9.657835f, -7.045109f, -0.5441622f, 4.940284f, 2.755314f, -2.552106f, -7.427345f, 1.105302f, 7.085793f, -2.383686f, -5.081807f, 0.2112271f, 0.894782f, 2.199231f, -1.583991f, -5.117146f, 3.625511f, 6.92176f, -2.331738f,
+    -22.978f, -6.859242f, -6.373803f, -0.4324604f, 3.830668f, 1.43421f, -2.197029f, -6.650107f, 0.8314316f, 7.482013f, -3.591101f, -5.94907f, 1.971859f, 2.373995f, 0.6141093f, -0.8188743f, -3.720592f, 2.435729f, 5.302016f, -4.203122f,
+    -23.3146f, -8.648803f, -6.59479f, 0.4762303f, 3.527444f, -0.07141904f, -1.03594f, -4.530207f, 2.601353f, 6.465094f, -3.922189f, -5.815704f, 2.753713f, 3.767856f, 0.3326488f, -2.900295f, -3.863809f, 3.224074f, 2.622693f, -6.276373f,
+    -23.6755f, -7.802581f, -6.494074f, -0.8530909f, 2.409662f, -1.133688f, -3.188623f, -5.514887f, 1.565061f, 4.599122f, -6.089505f, -4.834299f, 4.825864f, 2.14619f, -1.63011f, -2.79092f, -2.097701f, 3.551693f, 2.954536f, -5.449918f,
+    -26.36781f, -12.63623f, -10.65066f, -3.777805f, 1.585807f, 1.18419f, -1.528075f, -3.59834f, 3.08777f, 7.611086f, -2.095544f, -3.063504f, 6.451229f, 3.672075f, -1.92221f, 0.03915881f, -0.09255583f, 3.413481f, 1.021858f, -4.717532f,
+    -24.32736f, -9.728954f, -7.192484f, -0.2477927f, 3.000386f, 0.587304f, -0.6336991f, -2.372247f, 5.153054f, 7.638288f, -3.487573f, -1.826542f, 8.562931f, 3.834999f, -0.3691022f, -0.4599935f, -0.235659f, 2.922145f, -0.7128979f, -5.184509f,
+};
+
+} // namespace MfccReference
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""Generate tests/mfcc_reference.hpp, the golden MFCC frames of mfcc_test.cpp.
+
+The reference is independent of the library: numpy's double precision FFT,
+the HTK mel filterbank as defined by librosa.filters.mel(htk=True, norm=None),
+scipy's orthonormal DCT-II, and the lifter and delta regression of
+python_speech_features. Run it from the repository root after changing the
+test signal or settings:
+
+    python3 tests/mfcc_reference.py > tests/mfcc_reference.hpp
+"""
+
+import numpy as np
+from scipy.fft import dct
+
+SAMPLE_RATE = 16000
+FRAME_COUNT = 8000
+
+# name, bands, min Hz, max Hz, coefficients, lifter, delta window (0 without deltas)
+SETTINGS = [
+    ("kSpeech", 40, 300.0, 7600.0, 13, 22.0, 2),
+    ("kPlain", 80, 0.0, 0.0, 20, 0.0, 0),
+]
+
+
+def signal():
+    """Test signal as 16-bit PCM, mirrored by testSignal() in mfcc_test.cpp."""
+    samples = np.zeros(FRAME_COUNT, dtype=np.int64)
+    state = 1
+    for n in range(FRAME_COUNT):
+        t = n / SAMPLE_RATE
+        state = (state * 1103515245 + 12345) % 2147483648
+        noise = ((state >> 16) % 2001 - 1000) / 1000.0
+        value = (0.3 * np.sin(2.0 * np.pi * (200.0 * t + 1500.0 * t * t)) * (0.6 + 0.4 * np.sin(2.0 * np.pi * 3.0 * t))
+                 + 0.1 * np.sin(2.0 * np.pi * 3100.0 * t) + 0.02 * noise)
+        samples[n] = max(-32768, min(32767, int(np.floor(value * 32767.0 + 0.5))))
+    return samples
+
+
+def hz_to_mel(frequency):
+    return 2595.0 * np.log10(1.0 + frequency / 700.0)
+
+
+def mel_to_hz(mel):
+    return 700.0 * (10.0 ** (mel / 2595.0) - 1.0)
+
+
+def mel_filters(bands, fft_size, min_hz, max_hz):
+    # librosa.filters.mel with htk=True and norm=None
+    fft_freqs = np.linspace(0.0, SAMPLE_RATE / 2.0, fft_size // 2 + 1)
+    mel_freqs = mel_to_hz(np.linspace(hz_to_mel(min_hz), hz_to_mel(max_hz), bands + 2))
+    fdiff = np.diff(mel_freqs)
+    ramps = np.subtract.outer(mel_freqs, fft_freqs)
+    weights = np.zeros((bands, len(fft_freqs)))
+    for i in range(bands):
+        lower = -ramps[i] / fdiff[i]
+        upper = ramps[i + 2] / fdiff[i + 1]
+        weights[i] = np.maximum(0.0, np.minimum(lower, upper))
+    return weights
+
+
+def deltas(features, window):
+    # python_speech_features.base.delta
+    denominator = 2.0 * sum(n * n for n in range(1, window + 1))
+    padded = np.pad(features, ((window, window), (0, 0)), mode="edge")
+    result = np.empty_like(features)
+    for t in range(len(features)):
+        result[t] = np.dot(np.arange(-window, window + 1), padded[t:t + 2 * window + 1]) / denominator
+    return result
+
+
+def mfcc(samples, bands, min_hz, max_hz, coefficients, lifter, delta_window):
+    window_size = int(round(0.025 * SAMPLE_RATE))
+    hop_size = int(round(0.01 * SAMPLE_RATE))
+    fft_size = 1 << (window_size - 1).bit_length()
+    max_hz = max_hz if max_hz > 0.0 else SAMPLE_RATE / 2.0
+
+    # Periodic Hann window, as scipy.signal.get_window("hann", fftbins=True)
+    window = 0.5 - 0.5 * np.cos(2.0 * np.pi * np.arange(window_size) / window_size)
+    frames = [samples[start:start + window_size] * window
+              for start in range(0, len(samples) - window_size + 1, hop_size)]
+    power = np.abs(np.fft.rfft(frames, n=fft_size)) ** 2
+    log_mel = np.log(np.maximum(power @ mel_filters(bands, fft_size, min_hz, max_hz).T, 1e-10))
+
+    cepstra = dct(log_mel, type=2, axis=1, norm="ortho")[:, :coefficients]
+    if lifter > 0.0:
+        cepstra *= 1.0 + (lifter / 2.0) * np.sin(np.pi * np.arange(coefficients) / lifter)
+    if delta_window == 0:
+        return cepstra
+
+    first = deltas(cepstra, delta_window)
+    return np.hstack([cepstra, first, deltas(first, delta_window)])
+
+
+def main():
+    pcm = signal()
+    samples = pcm / 32768.0
+
+    print("#pragma once")
+    print()
+    print("// Generated by tests/mfcc_reference.py, do not edit")
+    print()
+    print("#include <cstdint>")
+    print()
+    print("namespace MfccReference")
+    print("{")
+    print()
+    print(f"const int64_t kSignalSum = {int(pcm.sum())};")
+    print(f"const int64_t kSignalEnergy = {int((pcm * pcm).sum())};")
+    for name, *settings in SETTINGS:
+        frames = mfcc(samples, *settings)
+        print()
+        print(f"const int {name}Frames = {frames.shape[0]};")
+        print(f"const int {name}Features = {frames.shape[1]};")
+        print(f"const float {name}[] = {{")
+        for row in frames:
+            values = ", ".join(f"{value:.7g}f" for value in row)
+            print(f"    {values},")
+        print("};")
+    print()
+    print("} // namespace MfccReference")
+
+
+if __name__ == "__main__":
+    main()
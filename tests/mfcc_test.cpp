@@ -0,0 +1,143 @@
+/**
+ * AudioCaptureX MFCC Test
+ * Streams 16-bit PCM through the MFCC extractor and checks every coefficient,
+ * delta and delta-delta against golden frames from an independent reference
+ */
+
+#include "include/mfcc_extractor.hpp"
+#include "tests/mfcc_reference.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 16000;
+const size_t kFrameCount = 8000;
+const double kPi = 3.14159265358979323846;
+
+// Float rounding through the FFT, log and DCT against the double precision reference
+const double kTolerance = 5e-4;
+
+// Block sizes cycled through while streaming, from single frames to several hops
+const size_t kBlockFrames[] = {1, 37, 160, 999, 401, 4000, 3};
+
+// Chirp with a slow envelope, a steady tone and noise, mirrored by signal() in mfcc_reference.py
+std::vector<int16_t> testSignal()
+{
+    std::vector<int16_t> samples(kFrameCount);
+    uint64_t state = 1;
+    for (size_t n = 0; n < kFrameCount; ++n)
+    {
+        double t = static_cast<double>(n) / kSampleRate;
+        state = (state * 1103515245 + 12345) % 2147483648;
+        double noise = (static_cast<double>((state >> 16) % 2001) - 1000.0) / 1000.0;
+        double value = 0.3 * std::sin(2.0 * kPi * (200.0 * t + 1500.0 * t * t)) * (0.6 + 0.4 * std::sin(2.0 * kPi * 3.0 * t)) +
+                       0.1 * std::sin(2.0 * kPi * 3100.0 * t) + 0.02 * noise;
+        samples[n] = static_cast<int16_t>(std::clamp(std::floor(value * 32767.0 + 0.5), -32768.0, 32767.0));
+    }
+
+    return samples;
+}
+
+bool checkSettings(const std::string &name, const std::vector<float> &samples, int channelCount,
+                   const MfccSettings &settings, const float *expected, int expectedFrames, int expectedFeatures)
+{
+    MfccExtractor extractor(kSampleRate, channelCount, settings);
+    FeatureRing features(static_cast<size_t>(expectedFrames) + 8, extractor.getFeatureCount());
+
+    size_t frames = samples.size() / channelCount;
+    size_t block = 0;
+    for (size_t frame = 0; frame < frames; block++)
+    {
+        size_t count = std::min(kBlockFrames[block % std::size(kBlockFrames)], frames - frame);
+        extractor.process(samples.data() + frame * channelCount, count, features);
+        frame += count;
+    }
+
+    extractor.finish(features);
+
+    if (features.getFrameCount() != static_cast<uint64_t>(expectedFrames) ||
+        extractor.getFeatureCount() != static_cast<size_t>(expectedFeatures))
+    {
+        std::cerr << name << ": " << features.getFrameCount() << " frames of " << extractor.getFeatureCount()
+                  << " values, expected " << expectedFrames << " of " << expectedFeatures << std::endl;
+        return false;
+    }
+
+    double maxError = 0.0;
+    FeatureView view = features.getFrames(0, static_cast<size_t>(expectedFrames));
+    for (size_t i = 0; i < static_cast<size_t>(expectedFrames * expectedFeatures); ++i)
+    {
+        double error = std::abs(view.data[i] - expected[i]);
+        if (!(error <= kTolerance))
+        {
+            std::cerr << name << ": frame " << i / expectedFeatures << " value " << i % expectedFeatures << " is "
+                      << view.data[i] << ", expected " << expected[i] << std::endl;
+            return false;
+        }
+
+        maxError = std::max(maxError, error);
+    }
+
+    std::cout << name << ": " << expectedFrames << " frames, max error " << maxError << std::endl;
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    std::vector<int16_t> pcm = testSignal();
+    int64_t sum = 0;
+    int64_t energy = 0;
+    for (int16_t sample : pcm)
+    {
+        sum += sample;
+        energy += static_cast<int64_t>(sample) * sample;
+    }
+
+    if (sum != MfccReference::kSignalSum || energy != MfccReference::kSignalEnergy)
+    {
+        std::cerr << "Test signal differs from the one the reference was generated from" << std::endl;
+        return 1;
+    }
+
+    std::vector<float> mono(pcm.size());
+    std::vector<float> stereo(2 * pcm.size());
+    for (size_t i = 0; i < pcm.size(); ++i)
+    {
+        mono[i] = pcm[i] / 32768.0f;
+        stereo[2 * i] = mono[i];
+        stereo[2 * i + 1] = mono[i];
+    }
+
+    MfccSettings speech;
+    speech.mel.bandCount = 40;
+    speech.mel.minFrequency = 300.0f;
+    speech.mel.maxFrequency = 7600.0f;
+
+    MfccSettings plain;
+    plain.mel.bandCount = 80;
+    plain.coefficientCount = 20;
+    plain.lifter = 0.0f;
+    plain.deltas = false;
+
+    bool passed = checkSettings("13 of 40 bands, deltas", mono, 1, speech, MfccReference::kSpeech,
+                                MfccReference::kSpeechFrames, MfccReference::kSpeechFeatures);
+    passed = checkSettings("13 of 40 bands, stereo", stereo, 2, speech, MfccReference::kSpeech,
+                           MfccReference::kSpeechFrames, MfccReference::kSpeechFeatures) &&
+             passed;
+    passed = checkSettings("20 of 80 bands, plain", mono, 1, plain, MfccReference::kPlain, MfccReference::kPlainFrames,
+                           MfccReference::kPlainFeatures) &&
+             passed;
+
+    std::cout << (passed ? "MFCC frames match the reference" : "MFCC frames differ from the reference") << std::endl;
+    return passed ? 0 : 1;
+}
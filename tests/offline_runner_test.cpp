@@ -0,0 +1,260 @@
+/**
+ * AudioCaptureX Offline Runner Test
+ * Runs files spanning several chunks through the offline runner with one and
+ * several decoder threads and checks that the data callback and a stage see
+ * every frame once and in order
+ */
+
+#include "include/offline_runner.hpp"
+#include "include/wav_writer.hpp"
+#include "dr_wav.h"
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 48000;
+const int kChannelCount = 2;
+
+// Three full 65536 frame chunks and a partial one
+const uint64_t kFrameCount = 3 * 65536 + 1234;
+
+// Frames per data callback, not a divisor of the chunk size so blocks end early at chunk ends
+const size_t kBlockFrames = 1000;
+
+// Multiple of 1 / 32768, exact in float and in 32-bit PCM, distinct per frame and channel
+int sampleStep(uint64_t frame, int channel)
+{
+    return static_cast<int>((frame * 31 + channel * 7919) % 65536) - 32768;
+}
+
+float sampleValue(uint64_t frame, int channel)
+{
+    return static_cast<float>(sampleStep(frame, channel)) / 32768.0f;
+}
+
+// Stage keeping everything it is given
+class CollectingStage : public AudioStage
+{
+public:
+    bool prepare(int sampleRate, int channelCount, const std::string &) override
+    {
+        preparedRate = sampleRate;
+        preparedChannels = channelCount;
+        samples.clear();
+        finished = false;
+        return true;
+    }
+
+    void process(const float *block, size_t frameCount) override
+    {
+        samples.insert(samples.end(), block, block + frameCount * preparedChannels);
+    }
+
+    void finish() override
+    {
+        finished = true;
+    }
+
+    void describe(std::vector<WavInfoEntry> &info) const override
+    {
+        info.push_back({"ITST", std::to_string(samples.size() / preparedChannels) + " frames"});
+    }
+
+    int preparedRate = 0;
+    int preparedChannels = 0;
+    std::vector<float> samples;
+    bool finished = false;
+};
+
+// 32-bit PCM, which the runner cannot map and decodes with dr_wav
+bool writePcm32(const std::string &filename)
+{
+    drwav_data_format format;
+    format.container = drwav_container_riff;
+    format.format = DR_WAVE_FORMAT_PCM;
+    format.channels = kChannelCount;
+    format.sampleRate = kSampleRate;
+    format.bitsPerSample = 32;
+
+    drwav wav;
+    if (!drwav_init_file_write(&wav, filename.c_str(), &format, nullptr))
+    {
+        return false;
+    }
+
+    std::vector<int32_t> samples(kFrameCount * kChannelCount);
+    for (uint64_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            samples[frame * kChannelCount + channel] = sampleStep(frame, channel) * 65536;
+        }
+    }
+
+    bool ok = drwav_write_pcm_frames(&wav, kFrameCount, samples.data()) == kFrameCount;
+    drwav_uninit(&wav);
+    return ok;
+}
+
+// 32-bit float through the writer, which the runner decodes from a shared mapping
+bool writeFloat(const std::string &filename)
+{
+    WavFormat format;
+    format.sampleFormat = WavSampleFormat::Float32;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavWriter writer;
+    if (!writer.open(filename, format))
+    {
+        return false;
+    }
+
+    std::vector<float> samples(kFrameCount * kChannelCount);
+    for (uint64_t frame = 0; frame < kFrameCount; ++frame)
+    {
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            samples[frame * kChannelCount + channel] = sampleValue(frame, channel);
+        }
+    }
+
+    bool ok = writer.writeFrames(samples.data(), kFrameCount);
+    return writer.finalize() && ok;
+}
+
+// Index of the first frame that differs from the written signal, the frame count if none does
+uint64_t firstMismatch(const std::vector<float> &samples)
+{
+    uint64_t frames = samples.size() / kChannelCount;
+    for (uint64_t frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            if (samples[frame * kChannelCount + channel] != sampleValue(frame, channel))
+            {
+                return frame;
+            }
+        }
+    }
+
+    return frames;
+}
+
+bool checkRun(const std::string &name, const std::string &filename, unsigned decoderThreads)
+{
+    std::vector<float> delivered;
+    size_t oversizedBlocks = 0;
+    bool formatMatches = true;
+
+    OfflineRunner runner([&](const std::vector<float> &audioData, int frameCount, int sampleRate, int channelCount) {
+        delivered.insert(delivered.end(), audioData.begin(), audioData.end());
+        oversizedBlocks += static_cast<size_t>(frameCount) > kBlockFrames ? 1 : 0;
+        formatMatches = formatMatches && sampleRate == kSampleRate && channelCount == kChannelCount &&
+                        audioData.size() == static_cast<size_t>(frameCount) * channelCount;
+    });
+
+    auto stage = std::make_shared<CollectingStage>();
+    runner.addStage(stage);
+    runner.setDecoderThreads(decoderThreads);
+    runner.setBlockFrames(kBlockFrames);
+
+    OfflineResult result;
+    bool ok = runner.run(filename, result);
+
+    uint64_t callbackMismatch = firstMismatch(delivered);
+    uint64_t stageMismatch = firstMismatch(stage->samples);
+    uint64_t levelSamples = 0;
+    for (const ChannelLevelStats &channel : result.channelLevels)
+    {
+        for (uint64_t count : channel.histogram)
+        {
+            levelSamples += count;
+        }
+    }
+
+    bool described = false;
+    for (const WavInfoEntry &entry : result.info)
+    {
+        described = described || (entry.id == "ITST" && entry.text == std::to_string(kFrameCount) + " frames");
+    }
+
+    bool passed = ok && formatMatches && oversizedBlocks == 0 && result.frameCount == kFrameCount &&
+                  result.sampleRate == kSampleRate && result.channelCount == kChannelCount &&
+                  delivered.size() == kFrameCount * kChannelCount && callbackMismatch == kFrameCount &&
+                  stage->preparedRate == kSampleRate && stage->samples.size() == kFrameCount * kChannelCount &&
+                  stageMismatch == kFrameCount && stage->finished && described &&
+                  levelSamples == kFrameCount * kChannelCount;
+
+    if (!passed)
+    {
+        std::cerr << name << ": run " << (ok ? "succeeded" : "failed") << " on " << result.frameCount
+                  << " frames, callback got " << delivered.size() / kChannelCount << " frames (first mismatch "
+                  << callbackMismatch << ", " << oversizedBlocks << " oversized blocks), stage got "
+                  << stage->samples.size() / kChannelCount << " frames (first mismatch " << stageMismatch
+                  << (stage->finished ? ", finished" : ", not finished") << (described ? ", described" : "")
+                  << "), level statistics counted " << levelSamples << " samples" << std::endl;
+    }
+
+    std::cout << name << ", " << decoderThreads << (decoderThreads == 1 ? " decoder: " : " decoders: ")
+              << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    const std::string filename = "offline-runner-test.wav";
+    bool passed = true;
+
+    if (writeFloat(filename))
+    {
+        for (unsigned threads : {1u, 4u})
+        {
+            passed = checkRun("mapped float", filename, threads) && passed;
+        }
+    }
+    else
+    {
+        std::cerr << "Failed to write " << filename << std::endl;
+        passed = false;
+    }
+
+    if (writePcm32(filename))
+    {
+        for (unsigned threads : {1u, 4u})
+        {
+            passed = checkRun("decoded 32-bit PCM", filename, threads) && passed;
+        }
+    }
+    else
+    {
+        std::cerr << "Failed to write " << filename << std::endl;
+        passed = false;
+    }
+
+    std::remove(filename.c_str());
+
+    // A missing file fails without preparing the stages
+    OfflineRunner runner;
+    auto stage = std::make_shared<CollectingStage>();
+    runner.addStage(stage);
+    OfflineResult result;
+    if (runner.run(filename, result) || stage->preparedRate != 0)
+    {
+        std::cerr << "Missing file was processed" << std::endl;
+        passed = false;
+    }
+
+    std::cout << (passed ? "Offline runs delivered every frame in order" : "Offline runs lost or reordered frames")
+              << std::endl;
+    return passed ? 0 : 1;
+}
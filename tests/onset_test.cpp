@@ -0,0 +1,175 @@
+/**
+ * AudioCaptureX Onset Test
+ * Feeds synthetic bursts with known start positions through the onset detector
+ * and checks that every burst is found close to its first sample, and nothing else
+ */
+
+#include "include/onset_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+// Bursts per signal, spaced irregularly between 120 and 400 ms
+const int kBurstCount = 40;
+
+// Onsets are placed on the energy rise of the attack, within half a millisecond of it in practice
+const double kToleranceSeconds = 0.001;
+
+// Block sizes cycled through while streaming, from single frames to several hops
+const size_t kBlockFrames[] = {480, 1, 37, 1024, 999, 256, 7};
+
+enum class BurstKind
+{
+    Noise, // Decaying white noise, like a hit
+    Tone,  // Decaying harmonic tone with a sharp attack, like a plucked string
+};
+
+struct Signal
+{
+    std::vector<float> samples;
+    std::vector<uint64_t> starts;
+};
+
+// Quiet background noise with bursts of varying level starting at known frames
+Signal synthesize(int sampleRate, int channelCount, BurstKind kind, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> gap(0.12, 0.4);
+    std::uniform_real_distribution<double> level(0.25, 0.8);
+    std::uniform_real_distribution<double> pitch(110.0, 880.0);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+
+    Signal signal;
+    double position = 0.5;
+    for (int burst = 0; burst < kBurstCount; ++burst)
+    {
+        signal.starts.push_back(static_cast<uint64_t>(position * sampleRate));
+        position += gap(random);
+    }
+
+    size_t frames = static_cast<size_t>((position + 0.5) * sampleRate);
+    std::vector<double> mono(frames);
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        mono[frame] = 0.001 * noise(random);
+    }
+
+    for (uint64_t start : signal.starts)
+    {
+        double amplitude = level(random);
+        double frequency = pitch(random);
+
+        // Ten time constants, long enough to fade into the background instead of ending in a click
+        size_t length = static_cast<size_t>(0.3 * sampleRate);
+        for (size_t i = 0; i < length && start + i < frames; ++i)
+        {
+            double t = static_cast<double>(i) / sampleRate;
+            double envelope = amplitude * std::exp(-t / 0.03);
+            double value = 0.0;
+            if (kind == BurstKind::Noise)
+            {
+                value = noise(random);
+            }
+            else
+            {
+                for (int harmonic = 1; harmonic <= 4; ++harmonic)
+                {
+                    value += std::sin(2.0 * kPi * harmonic * frequency * t) / harmonic;
+                }
+            }
+
+            mono[start + i] += envelope * value;
+        }
+    }
+
+    signal.samples.resize(frames * channelCount);
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            signal.samples[frame * channelCount + channel] = static_cast<float>(mono[frame]);
+        }
+    }
+
+    return signal;
+}
+
+bool checkSignal(const std::string &name, int sampleRate, int channelCount, BurstKind kind, unsigned seed)
+{
+    Signal signal = synthesize(sampleRate, channelCount, kind, seed);
+    OnsetDetector detector(sampleRate, channelCount);
+
+    std::vector<OnsetEvent> onsets;
+    size_t frames = signal.samples.size() / channelCount;
+    size_t block = 0;
+    for (size_t frame = 0; frame < frames; block++)
+    {
+        size_t count = std::min(kBlockFrames[block % std::size(kBlockFrames)], frames - frame);
+        detector.process(signal.samples.data() + frame * channelCount, count, onsets);
+        frame += count;
+    }
+
+    uint64_t tolerance = static_cast<uint64_t>(kToleranceSeconds * sampleRate);
+    size_t found = 0;
+    uint64_t maxError = 0;
+    bool passed = true;
+
+    // Every onset has to belong to a burst, and each burst takes one onset
+    size_t next = 0;
+    for (const OnsetEvent &onset : onsets)
+    {
+        while (next < signal.starts.size() && signal.starts[next] + tolerance < onset.framePosition)
+        {
+            std::cerr << name << ": missed burst at frame " << signal.starts[next] << std::endl;
+            passed = false;
+            next++;
+        }
+
+        if (next == signal.starts.size() || onset.framePosition + tolerance < signal.starts[next])
+        {
+            std::cerr << name << ": onset at frame " << onset.framePosition << " has no burst" << std::endl;
+            passed = false;
+            continue;
+        }
+
+        uint64_t error = std::max(onset.framePosition, signal.starts[next]) - std::min(onset.framePosition, signal.starts[next]);
+        maxError = std::max(maxError, error);
+        found++;
+        next++;
+    }
+
+    for (; next < signal.starts.size(); ++next)
+    {
+        std::cerr << name << ": missed burst at frame " << signal.starts[next] << std::endl;
+        passed = false;
+    }
+
+    std::cout << name << ": " << found << " of " << signal.starts.size() << " bursts, " << onsets.size()
+              << " onsets, max error " << maxError << " frames" << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = checkSignal("noise bursts, 48 kHz stereo", 48000, 2, BurstKind::Noise, 1);
+    passed = checkSignal("tone bursts, 48 kHz mono", 48000, 1, BurstKind::Tone, 2) && passed;
+    passed = checkSignal("noise bursts, 44.1 kHz mono", 44100, 1, BurstKind::Noise, 3) && passed;
+    passed = checkSignal("tone bursts, 96 kHz stereo", 96000, 2, BurstKind::Tone, 4) && passed;
+    passed = checkSignal("tone bursts, 16 kHz mono", 16000, 1, BurstKind::Tone, 5) && passed;
+
+    std::cout << (passed ? "Onsets match the bursts" : "Onsets differ from the bursts") << std::endl;
+    return passed ? 0 : 1;
+}
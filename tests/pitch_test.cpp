@@ -0,0 +1,195 @@
+/**
+ * AudioCaptureX Pitch Test
+ * Tracks steady synthetic tones across the frequency range and checks the error
+ * in cents, the gross error rate and that noise is reported as unvoiced
+ */
+
+#include "include/pitch_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+const double kToneSeconds = 0.5;
+const size_t kBlockFrames = 480;
+
+// An estimate further than this from the true pitch is a gross error, such as an octave jump
+const double kGrossCents = 50.0;
+
+// Limits over all estimates of a setting
+const double kMaxMedianCents = 1.0;
+const double kMaxP95Cents = 5.0;
+const double kMaxGrossRate = 0.01;
+const double kMinVoicedRate = 0.98;
+const double kMaxNoiseVoicedRate = 0.05;
+
+enum class ToneKind
+{
+    Sine,     // Fundamental only
+    Harmonic, // Five harmonics falling off as 1/n
+    Bright,   // Weak fundamental under stronger second and third harmonics
+};
+
+struct Accuracy
+{
+    std::vector<double> cents;
+    size_t estimates = 0;
+    size_t voiced = 0;
+    size_t gross = 0;
+};
+
+// Steady tone with a little noise, mixed to every channel
+std::vector<float> synthesize(int sampleRate, int channelCount, ToneKind kind, double frequency, std::mt19937 &random)
+{
+    std::normal_distribution<double> noise(0.0, 0.003);
+    size_t frames = static_cast<size_t>(kToneSeconds * sampleRate);
+    std::vector<float> samples(frames * channelCount);
+
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        double phase = 2.0 * kPi * frequency * frame / sampleRate;
+        double value = 0.0;
+        switch (kind)
+        {
+        case ToneKind::Sine:
+            value = 0.5 * std::sin(phase);
+            break;
+        case ToneKind::Harmonic:
+            for (int harmonic = 1; harmonic <= 5; ++harmonic)
+            {
+                value += 0.3 / harmonic * std::sin(harmonic * phase);
+            }
+            break;
+        case ToneKind::Bright:
+            value = 0.1 * std::sin(phase) + 0.3 * std::sin(2.0 * phase + 0.5) + 0.2 * std::sin(3.0 * phase + 1.0);
+            break;
+        }
+
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            samples[frame * channelCount + channel] = static_cast<float>(value + noise(random));
+        }
+    }
+
+    return samples;
+}
+
+std::vector<PitchEstimate> track(int sampleRate, int channelCount, const PitchSettings &settings,
+                                 const std::vector<float> &samples)
+{
+    PitchDetector detector(sampleRate, channelCount, settings);
+    std::vector<PitchEstimate> estimates;
+    size_t frames = samples.size() / channelCount;
+    for (size_t frame = 0; frame < frames; frame += kBlockFrames)
+    {
+        size_t count = std::min(kBlockFrames, frames - frame);
+        detector.process(samples.data() + frame * channelCount, count, estimates);
+    }
+
+    return estimates;
+}
+
+// Frequencies spaced a little over a fifth apart from 5% above the lowest to 5% below the highest
+std::vector<double> testFrequencies(const PitchSettings &settings)
+{
+    std::vector<double> frequencies;
+    for (double frequency = settings.minFrequency * 1.05; frequency <= settings.maxFrequency * 0.95; frequency *= 1.55)
+    {
+        frequencies.push_back(frequency);
+    }
+
+    frequencies.push_back(settings.maxFrequency * 0.95);
+    return frequencies;
+}
+
+bool checkSetting(const std::string &name, int sampleRate, int channelCount, const PitchSettings &settings)
+{
+    std::mt19937 random(1);
+    Accuracy accuracy;
+
+    for (ToneKind kind : {ToneKind::Sine, ToneKind::Harmonic, ToneKind::Bright})
+    {
+        for (double frequency : testFrequencies(settings))
+        {
+            std::vector<float> samples = synthesize(sampleRate, channelCount, kind, frequency, random);
+            for (const PitchEstimate &estimate : track(sampleRate, channelCount, settings, samples))
+            {
+                accuracy.estimates++;
+                if (estimate.frequency <= 0.0f)
+                {
+                    continue;
+                }
+
+                double cents = std::abs(1200.0 * std::log2(estimate.frequency / frequency));
+                accuracy.cents.push_back(cents);
+                accuracy.voiced++;
+                accuracy.gross += cents > kGrossCents ? 1 : 0;
+            }
+        }
+    }
+
+    std::vector<float> noise(static_cast<size_t>(kToneSeconds * sampleRate) * channelCount);
+    std::normal_distribution<float> distribution(0.0f, 0.2f);
+    for (float &sample : noise)
+    {
+        sample = distribution(random);
+    }
+
+    std::vector<PitchEstimate> noiseEstimates = track(sampleRate, channelCount, settings, noise);
+    size_t noiseVoiced = std::count_if(noiseEstimates.begin(), noiseEstimates.end(),
+                                       [](const PitchEstimate &estimate) { return estimate.frequency > 0.0f; });
+
+    std::sort(accuracy.cents.begin(), accuracy.cents.end());
+    auto percentile = [&](double p) {
+        return accuracy.cents.empty() ? 1e9 : accuracy.cents[static_cast<size_t>(p * (accuracy.cents.size() - 1))];
+    };
+
+    double median = percentile(0.5);
+    double p95 = percentile(0.95);
+    double grossRate = static_cast<double>(accuracy.gross) / std::max<size_t>(1, accuracy.voiced);
+    double voicedRate = static_cast<double>(accuracy.voiced) / std::max<size_t>(1, accuracy.estimates);
+    double noiseRate = static_cast<double>(noiseVoiced) / std::max<size_t>(1, noiseEstimates.size());
+
+    std::cout << name << ": " << std::fixed << std::setprecision(2) << median << " cents median, " << p95
+              << " cents p95, " << 100.0 * grossRate << "% gross errors, " << 100.0 * voicedRate << "% voiced, "
+              << 100.0 * noiseRate << "% of noise voiced" << std::endl;
+
+    bool passed = median <= kMaxMedianCents && p95 <= kMaxP95Cents && grossRate <= kMaxGrossRate &&
+                  voicedRate >= kMinVoicedRate && noiseRate <= kMaxNoiseVoicedRate;
+    if (!passed)
+    {
+        std::cerr << name << ": accuracy outside the limits" << std::endl;
+    }
+
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    PitchSettings voice;
+    voice.minFrequency = 70.0f;
+    voice.maxFrequency = 800.0f;
+
+    PitchSettings instrument;
+    instrument.minFrequency = 100.0f;
+    instrument.maxFrequency = 2000.0f;
+    instrument.hopSeconds = 0.02;
+
+    bool passed = checkSetting("default 60-1000 Hz, 48 kHz stereo", 48000, 2, PitchSettings());
+    passed = checkSetting("voice 70-800 Hz, 16 kHz mono", 16000, 1, voice) && passed;
+    passed = checkSetting("instrument 100-2000 Hz, 44.1 kHz mono", 44100, 1, instrument) && passed;
+
+    std::cout << (passed ? "Pitch estimates are within the limits" : "Pitch estimates are outside the limits") << std::endl;
+    return passed ? 0 : 1;
+}
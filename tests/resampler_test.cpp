@@ -0,0 +1,149 @@
+/**
+ * AudioCaptureX Resampler Test
+ * Converts tones between common rates in odd block sizes and checks the output
+ * length, the error against the ideal tone in the passband and the level left
+ * of tones above the output Nyquist frequency
+ */
+
+#include "include/resampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+const int kChannelCount = 2;
+const double kSeconds = 1.0;
+
+// Block sizes cycled through, from single frames to more than the resampler's history
+const size_t kBlockFrames[] = {480, 1, 4096, 37, 10000, 999};
+
+// Frames at either end left out of the level checks, where the filter sees the edges of the tone
+const size_t kEdgeFrames = 1000;
+
+// Limits of the filter: passband error, images included, and rejection of tones in the stopband
+const double kMaxPassbandError = -90.0;
+const double kMaxStopbandLevel = -90.0;
+
+// Sine of one frequency per channel, channel 1 a little higher than channel 0
+std::vector<float> synthesize(int sampleRate, size_t frames, double frequency)
+{
+    std::vector<float> samples(frames * kChannelCount);
+    for (size_t frame = 0; frame < frames; ++frame)
+    {
+        double seconds = static_cast<double>(frame) / sampleRate;
+        for (int channel = 0; channel < kChannelCount; ++channel)
+        {
+            double phase = 2.0 * kPi * frequency * (1.0 + 0.1 * channel) * seconds;
+            samples[frame * kChannelCount + channel] = static_cast<float>(0.5 * std::sin(phase));
+        }
+    }
+
+    return samples;
+}
+
+std::vector<float> convert(Resampler &resampler, const std::vector<float> &input, bool &bounded, uint64_t expectedFrames)
+{
+    std::vector<float> output;
+    size_t frames = input.size() / kChannelCount;
+    size_t block = 0;
+    for (size_t frame = 0; frame < frames; block++)
+    {
+        size_t count = std::min(kBlockFrames[block % std::size(kBlockFrames)], frames - frame);
+        resampler.process(input.data() + frame * kChannelCount, count, output);
+        frame += count;
+        bounded = bounded && output.size() / kChannelCount <= expectedFrames;
+    }
+
+    resampler.flush(output);
+    return output;
+}
+
+// Level in dB relative to the input tone of the samples away from the edges
+double level(const std::vector<float> &samples, const std::vector<float> &reference)
+{
+    size_t frames = samples.size() / kChannelCount;
+    double power = 0.0;
+    size_t count = 0;
+    for (size_t i = kEdgeFrames * kChannelCount; i + kEdgeFrames * kChannelCount < samples.size(); ++i)
+    {
+        double difference = samples[i] - (reference.empty() ? 0.0f : reference[i]);
+        power += difference * difference;
+        count++;
+    }
+
+    // A 0.5 amplitude sine has a power of 0.125
+    return frames > 2 * kEdgeFrames ? 10.0 * std::log10(std::max(power / count, 1e-30) / 0.125) : 0.0;
+}
+
+bool checkRates(int inputRate, int outputRate, double passFrequency, double stopFrequency)
+{
+    std::string name = std::to_string(inputRate) + " -> " + std::to_string(outputRate) + " Hz";
+    size_t inputFrames = static_cast<size_t>(kSeconds * inputRate) + 7;
+    uint64_t expectedFrames = (static_cast<uint64_t>(inputFrames) * outputRate + inputRate - 1) / inputRate;
+
+    // Output frame k lies at input time k / outputRate, the tone is compared there
+    Resampler resampler(inputRate, outputRate, kChannelCount);
+    bool bounded = true;
+    std::vector<float> pass = convert(resampler, synthesize(inputRate, inputFrames, passFrequency), bounded, expectedFrames);
+    double passError = level(pass, synthesize(outputRate, pass.size() / kChannelCount, passFrequency));
+
+    // A new stream after reset() converts exactly like a fresh resampler. When
+    // upsampling there is no input above the output Nyquist frequency, the
+    // stopband only has to hold the images counted in the passband error.
+    resampler.reset();
+    std::vector<float> stop = convert(resampler, synthesize(inputRate, inputFrames, stopFrequency), bounded, expectedFrames);
+    double stopLevel = outputRate < inputRate ? level(stop, {}) : -200.0;
+
+    Resampler fresh(inputRate, outputRate, kChannelCount);
+    bool freshBounded = true;
+    bool reproducible = convert(fresh, synthesize(inputRate, inputFrames, stopFrequency), freshBounded, expectedFrames) == stop;
+
+    bool lengthOk = pass.size() == expectedFrames * kChannelCount && stop.size() == expectedFrames * kChannelCount && bounded;
+    bool passed = lengthOk && reproducible && passError <= kMaxPassbandError && stopLevel <= kMaxStopbandLevel;
+
+    std::cout << name << ": " << pass.size() / kChannelCount << " of " << expectedFrames << " frames, " << std::fixed
+              << std::setprecision(1) << passError << " dB error at " << passFrequency << " Hz";
+    if (outputRate < inputRate)
+    {
+        std::cout << ", " << stopLevel << " dB left at " << stopFrequency << " Hz";
+    }
+
+    std::cout << (reproducible ? "" : ", differs after reset") << (passed ? "" : "  FAILED") << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = true;
+
+    // Up, down and across the common rates, with tones in the passband and in the stopband of the lower rate
+    passed = checkRates(44100, 48000, 1000.0, 20000.0) && passed;
+    passed = checkRates(48000, 44100, 1000.0, 23000.0) && passed;
+    passed = checkRates(48000, 16000, 3000.0, 9000.0) && passed;
+    passed = checkRates(16000, 48000, 6000.0, 7000.0) && passed;
+    passed = checkRates(96000, 44100, 15000.0, 30000.0) && passed;
+    passed = checkRates(22050, 8000, 2000.0, 5000.0) && passed;
+
+    // Equal rates pass through unchanged
+    Resampler passThrough(48000, 48000, kChannelCount);
+    std::vector<float> input = synthesize(48000, 4801, 1000.0);
+    bool bounded = true;
+    if (convert(passThrough, input, bounded, 4801) != input)
+    {
+        std::cerr << "Equal rates changed the samples" << std::endl;
+        passed = false;
+    }
+
+    std::cout << (passed ? "Resampled output is within the limits" : "Resampled output is outside the limits") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,359 @@
+/**
+ * AudioCaptureX Sliding Window Test
+ * Checks the double mapping and pool of the mirrored buffers, window positions
+ * and contents across the wrap of the ring, resets while views are held and
+ * readers on other threads that must never accept an overwritten window
+ */
+
+#include "include/mirrored_buffer.hpp"
+#include "include/sliding_window.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 16000;
+const int kChannelCount = 2;
+
+// Block sizes cycled through while writing, including ones longer than the ring's write chunks
+const size_t kBlockFrames[] = {160, 1, 4000, 37, 1600, 999};
+
+// The producer writes at least kConcurrentFrames, and goes on until every reader accepted kMinAccepted windows
+const uint64_t kConcurrentFrames = 2000000;
+const uint64_t kMinAccepted = 2000;
+const int kReaderCount = 3;
+
+// Stereo input whose mono mix is the frame index, wrapped to stay exact in float
+float inputValue(uint64_t frame, int channel)
+{
+    return static_cast<float>(frame % (1u << 20)) + (channel == 0 ? -1.0f : 1.0f);
+}
+
+float monoValue(uint64_t frame)
+{
+    return static_cast<float>(frame % (1u << 20));
+}
+
+// Write frames from firstFrame on in the block sizes above
+void writeFrames(SlidingWindow &window, uint64_t firstFrame, uint64_t frameCount)
+{
+    std::vector<float> block;
+    size_t index = 0;
+    for (uint64_t frame = firstFrame; frame < firstFrame + frameCount; index++)
+    {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(kBlockFrames[index % std::size(kBlockFrames)],
+                                                              firstFrame + frameCount - frame));
+        block.resize(count * kChannelCount);
+        for (size_t i = 0; i < count; ++i)
+        {
+            for (int channel = 0; channel < kChannelCount; ++channel)
+            {
+                block[i * kChannelCount + channel] = inputValue(frame + i, channel);
+            }
+        }
+
+        window.write(block.data(), count);
+        frame += count;
+    }
+}
+
+// Check that samples read through a view hold the frames the view names, counted from the start of its session
+bool holdsFrames(const SampleWindow &view, const float *data)
+{
+    for (size_t frame = 0; frame < view.frameCount; ++frame)
+    {
+        for (int channel = 0; channel < view.channelCount; ++channel)
+        {
+            uint64_t source = view.firstFrame + frame;
+            float expected = view.channelCount == 1 ? monoValue(source) : inputValue(source, channel);
+            if (data[frame * view.channelCount + channel] != expected)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool check(const std::string &name, bool passed)
+{
+    if (!passed)
+    {
+        std::cerr << name << ": FAILED" << std::endl;
+    }
+
+    return passed;
+}
+
+bool checkMirroredBuffer()
+{
+    MirroredBuffer buffer;
+    bool passed = check("allocate", buffer.allocate(1000) && buffer.size() == MirroredBuffer::roundSize(1000) &&
+                                        buffer.size() >= 1000 && MirroredBuffer::roundSize(buffer.size()) == buffer.size());
+
+    // A write across the wrap reads back contiguously from the second copy
+    std::vector<uint8_t> bytes(300);
+    for (size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<uint8_t>(i * 7 + 1);
+    }
+
+    size_t size = buffer.size();
+    buffer.write(size - 100, bytes.data(), bytes.size());
+    passed = check("write across the wrap", std::memcmp(buffer.data() + size - 100, bytes.data(), bytes.size()) == 0 &&
+                                                std::memcmp(buffer.data(), bytes.data() + 100, 200) == 0) &&
+             passed;
+
+    // With the double mapping a store to one copy shows in the other
+    if (buffer.isMirrored())
+    {
+        buffer.data()[5] = 0xAB;
+        passed = check("second copy is the same memory", buffer.data()[size + 5] == 0xAB) && passed;
+    }
+    else
+    {
+        std::cout << "double mapping unavailable, checked the heap fallback" << std::endl;
+    }
+
+    // The pool hands a returned buffer out again for the same rounded size only
+    MirroredBufferPool pool(1);
+    std::unique_ptr<MirroredBuffer> first = pool.acquire(1000);
+    std::unique_ptr<MirroredBuffer> second = pool.acquire(4 * size + 1);
+    uint8_t *firstData = first ? first->data() : nullptr;
+    pool.recycle(std::move(first));
+    pool.recycle(std::move(second));
+    passed = check("pool keeps up to its limit", pool.getIdleCount() == 1) && passed;
+
+    std::unique_ptr<MirroredBuffer> other = pool.acquire(2 * size + 1);
+    passed = check("pool allocates other sizes", other && other->data() != firstData && pool.getIdleCount() == 1) && passed;
+
+    std::unique_ptr<MirroredBuffer> reused = pool.acquire(size);
+    passed = check("pool reuses the same size", reused && reused->data() == firstData && pool.getIdleCount() == 0) && passed;
+    return passed;
+}
+
+bool checkWindows(bool mixToMono)
+{
+    std::string name = mixToMono ? "mono windows" : "interleaved windows";
+    WindowSettings settings;
+    settings.windowSeconds = 0.5;
+    settings.strideSeconds = 0.1;
+    settings.historySeconds = 0.5;
+    settings.mixToMono = mixToMono;
+
+    SlidingWindow window(std::make_shared<MirroredBufferPool>());
+    bool passed = check(name + " reset", window.reset(kSampleRate, kChannelCount, settings));
+    int channels = mixToMono ? 1 : kChannelCount;
+    passed = check(name + " layout", window.getWindowFrames() == 8000 && window.getStrideFrames() == 1600 &&
+                                         window.getChannelCount() == channels && window.getCapacityFrames() >= 16000) &&
+             passed;
+
+    // Less than one window gives no window yet
+    writeFrames(window, 0, 7999);
+    passed = check(name + " incomplete window", window.getWindowCount() == 0 && !window.getWindow(0).data) && passed;
+
+    // Several times the ring, in odd blocks
+    const uint64_t frameCount = 3 * kSampleRate + 7;
+    writeFrames(window, 7999, frameCount - 7999);
+    uint64_t windowCount = (frameCount - 8000) / 1600 + 1;
+    passed = check(name + " counts", window.getFrameCount() == frameCount && window.getWindowCount() == windowCount) && passed;
+
+    // The latest windows are contiguous in place, the ones the ring no longer holds are not viewable
+    size_t viewable = 0;
+    for (uint64_t index = 0; index < windowCount; ++index)
+    {
+        SampleWindow view = window.getWindow(index);
+        if (!view.data)
+        {
+            passed = check(name + " window " + std::to_string(index) + " dropped too early", viewable == 0) && passed;
+            continue;
+        }
+
+        viewable++;
+        passed = check(name + " window " + std::to_string(index),
+                       view.firstFrame == index * 1600 && view.frameCount == 8000 && view.channelCount == channels &&
+                           holdsFrames(view, view.data) && window.isValid(view)) &&
+                 passed;
+    }
+
+    passed = check(name + " history", viewable >= 6 && viewable < windowCount) && passed;
+    passed = check(name + " future window", !window.getWindow(windowCount).data) && passed;
+
+    SampleWindow latest = window.getLatest(window.getCapacityFrames());
+    passed = check(name + " latest", latest.data && latest.firstFrame + latest.frameCount == frameCount &&
+                                         holdsFrames(latest, latest.data)) &&
+             passed;
+    passed = check(name + " longer than the ring", !window.getLatest(window.getCapacityFrames() + 1).data) && passed;
+
+    // Writing the ring's length again overwrites a held view
+    SampleWindow held = window.getWindow(windowCount - 1);
+    writeFrames(window, frameCount, window.getCapacityFrames() + 2048);
+    passed = check(name + " overwritten view", !window.isValid(held)) && passed;
+    return passed;
+}
+
+// Views held across reset() stay mapped and fail isValid()
+bool checkReset()
+{
+    WindowSettings settings;
+    settings.windowSeconds = 0.25;
+    settings.strideSeconds = 0.05;
+    settings.historySeconds = 0.0;
+
+    auto pool = std::make_shared<MirroredBufferPool>();
+    WindowStage stage(settings, pool);
+    const SlidingWindow &windows = stage.getWindows();
+
+    bool passed = check("stage prepare", stage.prepare(kSampleRate, kChannelCount, ""));
+    std::vector<float> block(4000 * kChannelCount);
+    for (size_t i = 0; i < 4000; ++i)
+    {
+        block[i * kChannelCount] = inputValue(i, 0);
+        block[i * kChannelCount + 1] = inputValue(i, 1);
+    }
+
+    stage.process(block.data(), 4000);
+    SampleWindow before = windows.getWindow(0);
+    passed = check("window before the next session", before.data && holdsFrames(before, before.data)) && passed;
+
+    // The next session of the same size keeps the storage and starts counting at zero
+    passed = check("second session", stage.prepare(kSampleRate, kChannelCount, "")) && passed;
+    passed = check("view after reset", !windows.isValid(before) && windows.getFrameCount() == 0 &&
+                                           windows.getWindowCount() == 0) &&
+             passed;
+
+    // Positions keep counting across sessions, so the window lands 4000 samples on in the same ring
+    stage.process(block.data(), 4000);
+    SampleWindow after = windows.getWindow(0);
+    passed = check("storage kept for the same size", after.data && after.data == before.data + 4000 &&
+                                                          holdsFrames(after, after.data)) &&
+             passed;
+
+    // Another size replaces the storage, but an older view still points at mapped memory
+    std::vector<float> copy(before.frameCount * before.channelCount);
+    passed = check("longer session", stage.prepare(kSampleRate * 4, kChannelCount, "")) && passed;
+    std::copy(after.data, after.data + copy.size(), copy.begin());
+    passed = check("view of replaced storage", !windows.isValid(after) && windows.getWindowFrames() == 16000) && passed;
+
+    // Going back to the first size reuses the first storage, which is still mapped so nothing else can lie in it
+    passed = check("first size again", stage.prepare(kSampleRate, kChannelCount, "")) && passed;
+    stage.process(block.data(), 4000);
+    SampleWindow again = windows.getWindow(0);
+    passed = check("storage reused", again.data && again.data >= before.data &&
+                                         again.data < before.data + 2 * windows.getCapacityFrames() &&
+                                         holdsFrames(again, again.data) && windows.isValid(again)) &&
+             passed;
+
+    // Invalid settings leave no windows
+    WindowSettings invalid = settings;
+    invalid.strideSeconds = 0.0;
+    SlidingWindow empty;
+    passed = check("invalid settings", !empty.reset(kSampleRate, kChannelCount, invalid) && !empty.getLatest(1).data) && passed;
+    return passed;
+}
+
+// Readers accept a window only if isValid() says the producer has not reached it since it was taken
+bool checkConcurrent()
+{
+    WindowSettings settings;
+    settings.windowSeconds = 0.1;
+    settings.strideSeconds = 0.01;
+    settings.historySeconds = 0.0;
+
+    SlidingWindow window;
+    if (!check("concurrent reset", window.reset(kSampleRate, kChannelCount, settings)))
+    {
+        return false;
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> accepted[kReaderCount] = {};
+    std::vector<uint64_t> torn(kReaderCount, 0);
+
+    std::vector<std::thread> readers;
+    for (int reader = 0; reader < kReaderCount; ++reader)
+    {
+        readers.emplace_back([&, reader] {
+            std::vector<float> copy(window.getCapacityFrames());
+            while (!done.load(std::memory_order_acquire))
+            {
+                // The newest window, or the oldest one the ring may still hold
+                uint64_t count = window.getWindowCount();
+                uint64_t index = reader == 0 || count < 4 ? count - 1 : count - 4;
+                SampleWindow view = count > 0 ? window.getWindow(index) : SampleWindow();
+                if (!view.data)
+                {
+                    continue;
+                }
+
+                std::copy(view.data, view.data + view.frameCount, copy.begin());
+                if (!window.isValid(view))
+                {
+                    continue;
+                }
+
+                accepted[reader]++;
+                torn[reader] += holdsFrames(view, copy.data()) ? 0 : 1;
+            }
+        });
+    }
+
+    auto readersBehind = [&accepted] {
+        for (const std::atomic<uint64_t> &count : accepted)
+        {
+            if (count.load(std::memory_order_relaxed) < kMinAccepted)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    uint64_t frame = 0;
+    while (frame < kConcurrentFrames || readersBehind())
+    {
+        writeFrames(window, frame, 16000);
+        frame += 16000;
+    }
+
+    done.store(true, std::memory_order_release);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    bool passed = true;
+    for (int reader = 0; reader < kReaderCount; ++reader)
+    {
+        std::cout << "reader " << reader << " accepted " << accepted[reader].load() << " windows, " << torn[reader]
+                  << " torn" << std::endl;
+        passed = torn[reader] == 0 && passed;
+    }
+
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    bool passed = checkMirroredBuffer();
+    passed = checkWindows(true) && passed;
+    passed = checkWindows(false) && passed;
+    passed = checkReset() && passed;
+    passed = checkConcurrent() && passed;
+
+    std::cout << (passed ? "Windows hold the frames they name" : "Windows differ from the frames written") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+/**
+ * AudioCaptureX WAV Reader Test
+ * Writes every container and sample format the writer supports and checks the
+ * mapped reads against dr_wav decoding the same file, along with seeking,
+ * reads at the end, truncated files and unsupported formats
+ */
+
+#include "include/wav_reader.hpp"
+#include "include/wav_writer.hpp"
+#include "dr_wav.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+const int kSampleRate = 44100;
+const int kChannelCount = 3;
+const uint64_t kFrameCount = 12345;
+
+// Frames read at a time by the positional checks, ending past the last frame
+const uint64_t kReadFrames = 1000;
+
+std::vector<float> randomSamples(uint64_t frameCount)
+{
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> samples(frameCount * kChannelCount);
+    for (float &sample : samples)
+    {
+        sample = distribution(random);
+    }
+
+    return samples;
+}
+
+bool writeFile(const std::string &filename, const WavFormat &format, const std::vector<float> &samples)
+{
+    WavWriter writer;
+    if (!writer.open(filename, format))
+    {
+        return false;
+    }
+
+    bool ok = writer.writeFrames(samples.data(), samples.size() / format.channelCount);
+    return writer.finalize() && ok;
+}
+
+// Samples as dr_wav decodes them, the reference for the mapped reads
+std::vector<float> decode(const std::string &filename)
+{
+    drwav wav;
+    if (!drwav_init_file(&wav, filename.c_str(), nullptr))
+    {
+        return {};
+    }
+
+    std::vector<float> samples(wav.totalPCMFrameCount * wav.channels);
+    samples.resize(drwav_read_pcm_frames_f32(&wav, wav.totalPCMFrameCount, samples.data()) * wav.channels);
+    drwav_uninit(&wav);
+    return samples;
+}
+
+bool checkFormat(const std::string &filename, WavContainer container, WavSampleFormat sampleFormat)
+{
+    std::string name = std::string(containerName(container)) + " " + sampleFormatName(sampleFormat);
+
+    WavFormat format;
+    format.sampleFormat = sampleFormat;
+    format.container = container;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    std::vector<float> written = randomSamples(kFrameCount);
+    WavReader reader;
+    if (!writeFile(filename, format, written) || !reader.open(filename))
+    {
+        std::cerr << name << ": failed to write or open" << std::endl;
+        return false;
+    }
+
+    std::vector<float> expected = decode(filename);
+    const WavFormat &parsed = reader.getFormat();
+    bool passed = parsed.sampleFormat == sampleFormat && parsed.container == container &&
+                  parsed.channelCount == kChannelCount && parsed.sampleRate == kSampleRate &&
+                  reader.getFrameCount() == kFrameCount && expected.size() == kFrameCount * kChannelCount;
+
+    // Positional reads at odd offsets, the last one running past the end
+    std::vector<float> frames(kReadFrames * kChannelCount);
+    for (uint64_t first = 0; passed && first < kFrameCount; first += 2 * kReadFrames + 333)
+    {
+        uint64_t count = std::min(kReadFrames, kFrameCount - first);
+        passed = reader.readFrames(first, frames.data(), kReadFrames) == count &&
+                 std::memcmp(frames.data(), expected.data() + first * kChannelCount, count * kChannelCount * sizeof(float)) == 0;
+    }
+
+    // Sequential reads from a seek position to the end
+    const float *last = expected.data() + (kFrameCount - 500) * kChannelCount;
+    passed = passed && reader.seek(kFrameCount - 1500) && reader.tell() == kFrameCount - 1500 &&
+             reader.readFrames(frames.data(), kReadFrames) == kReadFrames &&
+             reader.readFrames(frames.data(), kReadFrames) == 500 && reader.tell() == kFrameCount &&
+             std::memcmp(frames.data(), last, 500 * kChannelCount * sizeof(float)) == 0 &&
+             reader.readFrames(frames.data(), kReadFrames) == 0 && !reader.seek(kFrameCount + 1) &&
+             reader.readFrames(kFrameCount, frames.data(), 1) == 0;
+
+    // Spans in place are only given for the format of the file
+    std::span<const float> floats = reader.getFloat(100, kFrameCount);
+    std::span<const int16_t> pcm16 = reader.getPcm16(100, kFrameCount);
+    uint64_t tailSamples = (kFrameCount - 100) * kChannelCount;
+    if (sampleFormat == WavSampleFormat::Float32)
+    {
+        passed = passed && pcm16.empty() && floats.size() == tailSamples &&
+                 std::memcmp(floats.data(), written.data() + 100 * kChannelCount, tailSamples * sizeof(float)) == 0;
+    }
+    else if (sampleFormat == WavSampleFormat::Pcm16)
+    {
+        passed = passed && floats.empty() && pcm16.size() == tailSamples &&
+                 static_cast<float>(pcm16[0]) / 32768.0f == expected[100 * kChannelCount];
+    }
+    else
+    {
+        passed = passed && floats.empty() && pcm16.empty();
+    }
+
+    passed = passed && reader.getBytes(0, kFrameCount + 1).size() == kFrameCount * kChannelCount * bytesPerSample(sampleFormat);
+
+    std::cout << name << ": " << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+// A recording cut off mid-frame reads up to its last whole frame
+bool checkTruncated(const std::string &filename)
+{
+    WavFormat format;
+    format.channelCount = kChannelCount;
+    format.sampleRate = kSampleRate;
+
+    WavReader reader;
+    uint64_t frameBytes = kChannelCount * bytesPerSample(format.sampleFormat);
+    bool passed = writeFile(filename, format, randomSamples(kFrameCount));
+    if (passed)
+    {
+        std::filesystem::resize_file(filename, std::filesystem::file_size(filename) - 1000 * frameBytes - 1);
+        std::vector<float> frame(kChannelCount);
+        passed = reader.open(filename) && reader.getFrameCount() == kFrameCount - 1001 &&
+                 reader.readFrames(kFrameCount - 1002, frame.data(), 2) == 1;
+    }
+
+    std::cout << "truncated recording: " << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+// 32-bit PCM has no mapped reads, open() refuses it
+bool checkUnsupported(const std::string &filename)
+{
+    drwav_data_format format;
+    format.container = drwav_container_riff;
+    format.format = DR_WAVE_FORMAT_PCM;
+    format.channels = kChannelCount;
+    format.sampleRate = kSampleRate;
+    format.bitsPerSample = 32;
+
+    drwav wav;
+    bool passed = drwav_init_file_write(&wav, filename.c_str(), &format, nullptr);
+    if (passed)
+    {
+        std::vector<int32_t> samples(100 * kChannelCount, 0);
+        drwav_write_pcm_frames(&wav, 100, samples.data());
+        drwav_uninit(&wav);
+
+        WavReader reader;
+        passed = !reader.open(filename) && !reader.isOpen() && reader.getFrameCount() == 0;
+    }
+
+    std::cout << "unsupported format: " << (passed ? "ok" : "FAILED") << std::endl;
+    return passed;
+}
+
+} // namespace
+
+int main()
+{
+    const std::string filename = "wav-reader-test.wav";
+    bool passed = true;
+
+    for (WavContainer container : {WavContainer::Riff, WavContainer::Rf64, WavContainer::W64})
+    {
+        for (WavSampleFormat sampleFormat : {WavSampleFormat::Pcm16, WavSampleFormat::Pcm24, WavSampleFormat::Float32})
+        {
+            passed = checkFormat(filename, container, sampleFormat) && passed;
+        }
+    }
+
+    passed = checkTruncated(filename) && passed;
+    passed = checkUnsupported(filename) && passed;
+
+    std::remove(filename.c_str());
+
+    std::cout << (passed ? "Mapped reads match dr_wav" : "Mapped reads differ from dr_wav") << std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+/**
+ * AudioCaptureX Fingerprint Lookup Tool
+ * Finds segments shared between recordings through their fingerprint sidecars
+ */
+
+#include "include/fingerprint.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+// Agreeing landmarks needed to report a match, see FingerprintMatch::score
+const double kDefaultMinScore = 20.0;
+
+// Share of the best candidate's score a match needs; far weaker candidates are
+// chance agreements of common hashes rather than shared segments
+const double kDefaultMinShare = 0.1;
+
+bool hasExtension(const std::filesystem::path &path, const char *extension)
+{
+    std::string actual = path.extension().string();
+    for (char &c : actual)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    return actual == extension;
+}
+
+// Expand directories into the sidecars they contain
+std::vector<std::string> collectSidecars(const std::vector<std::string> &paths)
+{
+    std::vector<std::string> files;
+    for (const std::string &path : paths)
+    {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(path, error))
+            {
+                if (entry.is_regular_file() && hasExtension(entry.path(), ".afp"))
+                {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            files.push_back(path);
+        }
+    }
+
+    return files;
+}
+
+// Read a sidecar, or fingerprint a WAV file
+bool loadFingerprint(const std::string &path, Fingerprint &fingerprint)
+{
+    if (hasExtension(path, ".wav"))
+    {
+        return fingerprintWavFile(path, fingerprint);
+    }
+
+    return readFingerprintFile(path, fingerprint);
+}
+
+// Drop candidates far below the best one, ignoring the query's own recording
+std::vector<FingerprintMatch> strongMatches(const std::vector<FingerprintMatch> &matches, double minShare, uint32_t self)
+{
+    double best = 0.0;
+    for (const FingerprintMatch &match : matches)
+    {
+        if (match.recording != self)
+        {
+            best = std::max(best, match.score);
+        }
+    }
+
+    std::vector<FingerprintMatch> strong;
+    for (const FingerprintMatch &match : matches)
+    {
+        if (match.recording != self && match.score >= minShare * best)
+        {
+            strong.push_back(match);
+        }
+    }
+
+    return strong;
+}
+
+void printMatch(const std::string &query, const std::string &recording, const FingerprintMatch &match, double frameSeconds)
+{
+    double queryStart = match.queryStart * frameSeconds;
+    double queryEnd = match.queryEnd * frameSeconds;
+    double recordingStart = (static_cast<int64_t>(match.queryStart) + match.offset) * frameSeconds;
+
+    std::cout << std::fixed << std::setprecision(2) << query << " @ " << queryStart << "s matches " << recording << " @ "
+              << recordingStart << "s for " << (queryEnd - queryStart) << "s (score " << std::setprecision(1) << match.score << ")"
+              << std::endl;
+}
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  " << program << " fingerprint <file.wav> [file.wav ...]" << std::endl;
+    std::cout << "      Write the .afp sidecar of existing recordings" << std::endl;
+    std::cout << "  " << program << " match [options] <query.wav|query.afp> <archive.afp|directory> [...]" << std::endl;
+    std::cout << "      Find segments of the query in the archive" << std::endl;
+    std::cout << "  " << program << " duplicates [options] <archive.afp|directory> [...]" << std::endl;
+    std::cout << "      Find segments shared between recordings of the archive" << std::endl;
+    std::cout << "Options:" << std::endl;
+    std::cout << "  --min-score N  Agreeing landmarks needed for a match (default " << kDefaultMinScore << ")" << std::endl;
+    std::cout << "  --min-share F  Share of the best match's score needed (default " << kDefaultMinShare << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[1];
+    std::vector<std::string> arguments(argv + 2, argv + argc);
+
+    if (command == "fingerprint")
+    {
+        int failures = 0;
+        for (const std::string &path : arguments)
+        {
+            Fingerprint fingerprint;
+            std::string sidecar = fingerprintSidecarPath(path);
+            if (!fingerprintWavFile(path, fingerprint) || !writeFingerprintFile(sidecar, fingerprint))
+            {
+                failures++;
+                continue;
+            }
+
+            std::cout << sidecar << ": " << fingerprint.landmarks.size() << " landmarks" << std::endl;
+        }
+
+        return failures == 0 ? 0 : 1;
+    }
+
+    double minScore = kDefaultMinScore;
+    double minShare = kDefaultMinShare;
+    while (arguments.size() >= 2 && (arguments[0] == "--min-score" || arguments[0] == "--min-share"))
+    {
+        (arguments[0] == "--min-score" ? minScore : minShare) = std::stod(arguments[1]);
+        arguments.erase(arguments.begin(), arguments.begin() + 2);
+    }
+
+    bool duplicates = command == "duplicates";
+    if ((command != "match" && !duplicates) || arguments.size() < (duplicates ? 1u : 2u))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string queryPath;
+    if (!duplicates)
+    {
+        queryPath = arguments.front();
+        arguments.erase(arguments.begin());
+    }
+
+    // Index the archive
+    std::vector<std::string> archive = collectSidecars(arguments);
+    std::vector<Fingerprint> fingerprints(archive.size());
+    FingerprintIndex index;
+
+    for (size_t i = 0; i < archive.size(); ++i)
+    {
+        if (readFingerprintFile(archive[i], fingerprints[i]))
+        {
+            index.add(static_cast<uint32_t>(i), fingerprints[i].landmarks);
+        }
+    }
+
+    index.build();
+    std::cout << "Indexed " << index.size() << " landmarks from " << archive.size() << " recordings" << std::endl;
+
+    double frameSeconds = Fingerprinter::frameSeconds();
+    size_t found = 0;
+
+    if (!duplicates)
+    {
+        Fingerprint query;
+        if (!loadFingerprint(queryPath, query))
+        {
+            return 1;
+        }
+
+        for (const FingerprintMatch &match : strongMatches(index.find(query.landmarks, minScore), minShare, UINT32_MAX))
+        {
+            printMatch(queryPath, archive[match.recording], match, frameSeconds);
+            found++;
+        }
+    }
+    else
+    {
+        // Each pair is reported once, from the recording listed first
+        for (size_t i = 0; i < archive.size(); ++i)
+        {
+            uint32_t self = static_cast<uint32_t>(i);
+            for (const FingerprintMatch &match : strongMatches(index.find(fingerprints[i].landmarks, minScore), minShare, self))
+            {
+                if (match.recording > i)
+                {
+                    printMatch(archive[i], archive[match.recording], match, frameSeconds);
+                    found++;
+                }
+            }
+        }
+    }
+
+    std::cout << found << " matches" << std::endl;
+    return 0;
+}
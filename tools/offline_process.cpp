@@ -0,0 +1,263 @@
+/**
+ * AudioCaptureX Offline Processing Tool
+ * Runs recorded WAV files through the analysis stages used while capturing
+ */
+
+#include "include/fingerprint.hpp"
+#include "include/loudness_meter.hpp"
+#include "include/offline_runner.hpp"
+#include "include/onset_detector.hpp"
+#include "include/pitch_detector.hpp"
+#include <cctype>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+// Events read from a stage queue per call
+const size_t kReadBatch = 256;
+
+// Onset stage counting its events on the stage thread, so the queue never overflows
+class OnsetCounter : public OnsetStage
+{
+public:
+    void process(const float *samples, size_t frameCount) override
+    {
+        OnsetStage::process(samples, frameCount);
+
+        OnsetEvent events[kReadBatch];
+        size_t read = 0;
+        while ((read = readEvents(events, kReadBatch)) > 0)
+        {
+            count += read;
+        }
+    }
+
+    uint64_t count = 0;
+};
+
+// Pitch stage counting voiced estimates on the stage thread
+class PitchCounter : public PitchStage
+{
+public:
+    void process(const float *samples, size_t frameCount) override
+    {
+        PitchStage::process(samples, frameCount);
+
+        PitchEstimate estimates[kReadBatch];
+        size_t read = 0;
+        while ((read = readEstimates(estimates, kReadBatch)) > 0)
+        {
+            for (size_t i = 0; i < read; ++i)
+            {
+                voiced += estimates[i].frequency > 0.0f ? 1 : 0;
+            }
+
+            count += read;
+        }
+    }
+
+    uint64_t count = 0;
+    uint64_t voiced = 0;
+};
+
+// Loudness stage discarding its readings, only the summary is reported
+class LoudnessSummaryStage : public LoudnessStage
+{
+public:
+    void process(const float *samples, size_t frameCount) override
+    {
+        LoudnessStage::process(samples, frameCount);
+
+        LoudnessReading readings[kReadBatch];
+        while (readReadings(readings, kReadBatch) > 0)
+        {
+        }
+    }
+};
+
+bool hasExtension(const std::filesystem::path &path, const char *extension)
+{
+    std::string actual = path.extension().string();
+    for (char &c : actual)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    return actual == extension;
+}
+
+// Expand directories into the WAV files they contain
+std::vector<std::string> collectWavFiles(const std::vector<std::string> &paths)
+{
+    std::vector<std::string> files;
+    for (const std::string &path : paths)
+    {
+        std::error_code error;
+        if (std::filesystem::is_directory(path, error))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(path, error))
+            {
+                if (entry.is_regular_file() && hasExtension(entry.path(), ".wav"))
+                {
+                    files.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            files.push_back(path);
+        }
+    }
+
+    return files;
+}
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options] <file.wav|directory> [...]" << std::endl;
+    std::cout << "  --threads N     Decoder threads (default: one per hardware thread)" << std::endl;
+    std::cout << "  --loudness      Measure EBU R128 loudness (default if no stage is given)" << std::endl;
+    std::cout << "  --onsets        Count onsets" << std::endl;
+    std::cout << "  --pitch         Track pitch" << std::endl;
+    std::cout << "  --fingerprint   Write fingerprint sidecars next to the files" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    unsigned threads = 0;
+    bool loudness = false;
+    bool onsets = false;
+    bool pitch = false;
+    bool fingerprint = false;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        if (argument == "--threads" && i + 1 < argc)
+        {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        }
+        else if (argument == "--loudness")
+        {
+            loudness = true;
+        }
+        else if (argument == "--onsets")
+        {
+            onsets = true;
+        }
+        else if (argument == "--pitch")
+        {
+            pitch = true;
+        }
+        else if (argument == "--fingerprint")
+        {
+            fingerprint = true;
+        }
+        else if (argument.rfind("--", 0) == 0)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    std::vector<std::string> files = collectWavFiles(paths);
+    if (files.empty())
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!onsets && !pitch && !fingerprint)
+    {
+        loudness = true;
+    }
+
+    OfflineRunner runner;
+    runner.setDecoderThreads(threads);
+
+    auto onsetStage = std::make_shared<OnsetCounter>();
+    auto pitchStage = std::make_shared<PitchCounter>();
+    if (loudness)
+    {
+        runner.addStage(std::make_shared<LoudnessSummaryStage>());
+    }
+
+    if (onsets)
+    {
+        runner.addStage(onsetStage);
+    }
+
+    if (pitch)
+    {
+        runner.addStage(pitchStage);
+    }
+
+    if (fingerprint)
+    {
+        runner.addStage(std::make_shared<FingerprintStage>());
+    }
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    for (const std::string &file : files)
+    {
+        onsetStage->count = 0;
+        pitchStage->count = 0;
+        pitchStage->voiced = 0;
+
+        OfflineResult result;
+        if (!runner.run(file, result))
+        {
+            failures++;
+            continue;
+        }
+
+        double duration = static_cast<double>(result.frameCount) / result.sampleRate;
+        audioSeconds += duration;
+        wallSeconds += result.seconds;
+
+        std::cout << std::fixed << std::setprecision(2) << file << ": " << duration << " s in " << result.seconds
+                  << " s (" << std::setprecision(0) << result.realtimeFactor << "x real time)" << std::endl;
+
+        for (const WavInfoEntry &entry : result.info)
+        {
+            if (entry.id == "ICMT")
+            {
+                std::cout << "  " << entry.text << std::endl;
+            }
+        }
+
+        if (onsets)
+        {
+            std::cout << "  " << onsetStage->count << " onsets" << std::endl;
+        }
+
+        if (pitch && pitchStage->count > 0)
+        {
+            std::cout << "  " << std::setprecision(1) << 100.0 * pitchStage->voiced / pitchStage->count << "% voiced"
+                      << std::endl;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2) << files.size() - failures << " files, " << audioSeconds
+              << " s of audio in " << wallSeconds << " s (" << std::setprecision(0)
+              << (wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0) << "x real time)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+/**
+ * AudioCaptureX WAV Recovery Tool
+ * Repairs the header of WAV files left behind by an interrupted recording
+ */
+
+#include "include/wav_recovery.hpp"
+#include <iostream>
+
+using namespace AudioCaptureX;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <file.wav> [file.wav ...]" << std::endl;
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (!recoverWavFile(argv[i]))
+        {
+            failures++;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,445 @@
+/**
+ * AudioCaptureX WAV Transcoding Tool
+ * Converts batches of WAV files between sample formats, channel layouts and rates
+ */
+
+#include "include/resampler.hpp"
+#include "include/sample_convert.hpp"
+#include "include/wav_reader.hpp"
+#include "include/wav_writer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dr_wav.h"
+
+using namespace AudioCaptureX;
+
+namespace
+{
+
+// Frames read, converted and written at a time, bounds the memory of a worker
+const uint64_t kChunkFrames = 16384;
+
+struct TranscodeJob
+{
+    std::string input;
+    std::string output;
+};
+
+struct TranscodeSettings
+{
+    WavSampleFormat format = WavSampleFormat::Pcm16;
+    WavContainer container = WavContainer::Riff;
+    int sampleRate = 0;        // 0 keeps the input rate
+    std::vector<int> channels; // Input channels to keep, empty keeps all
+};
+
+// Buffers reused for every file a worker converts
+struct WorkerBuffers
+{
+    std::vector<float> decoded;
+    std::vector<float> selected;
+    std::vector<float> resampled;
+};
+
+bool hasExtension(const std::filesystem::path &path, const char *extension)
+{
+    std::string actual = path.extension().string();
+    for (char &c : actual)
+    {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+
+    return actual == extension;
+}
+
+// Sample formats WavReader converts straight from the mapping
+bool directFormat(const drwav &wav)
+{
+    return (wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && (wav.bitsPerSample == 16 || wav.bitsPerSample == 24)) ||
+           (wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT && wav.bitsPerSample == 32);
+}
+
+bool transcodeFile(const TranscodeJob &job, const TranscodeSettings &settings, WorkerBuffers &buffers, uint64_t &bytesRead)
+{
+    std::error_code error;
+    if (std::filesystem::equivalent(job.input, job.output, error))
+    {
+        std::cerr << "Output would overwrite the input: " << job.input << std::endl;
+        return false;
+    }
+
+    drwav wav;
+    if (!drwav_init_file(&wav, job.input.c_str(), nullptr))
+    {
+        std::cerr << "Not a WAV file: " << job.input << std::endl;
+        return false;
+    }
+
+    // PCM16, PCM24 and float data is converted straight from a mapping, other encodings are decoded by dr_wav
+    WavReader reader;
+    if (directFormat(wav))
+    {
+        drwav_uninit(&wav);
+        if (!reader.open(job.input))
+        {
+            return false;
+        }
+
+        reader.adviseSequential();
+    }
+
+    int inputChannels = reader.isOpen() ? reader.getFormat().channelCount : static_cast<int>(wav.channels);
+    int inputRate = reader.isOpen() ? reader.getFormat().sampleRate : static_cast<int>(wav.sampleRate);
+    uint64_t frameCount = reader.isOpen() ? reader.getFrameCount() : wav.totalPCMFrameCount;
+    auto closeInput = [&reader, &wav]() {
+        if (!reader.isOpen())
+        {
+            drwav_uninit(&wav);
+        }
+    };
+
+    for (int channel : settings.channels)
+    {
+        if (channel >= inputChannels)
+        {
+            std::cerr << job.input << " has no channel " << channel << std::endl;
+            closeInput();
+            return false;
+        }
+    }
+
+    WavFormat format;
+    format.sampleFormat = settings.format;
+    format.container = settings.container;
+    format.channelCount = settings.channels.empty() ? inputChannels : static_cast<int>(settings.channels.size());
+    format.sampleRate = settings.sampleRate > 0 ? settings.sampleRate : inputRate;
+
+    // Written next to the output and renamed once complete, a failed file leaves nothing behind
+    std::string partial = job.output + ".part";
+    std::filesystem::create_directories(std::filesystem::path(job.output).parent_path(), error);
+    WavWriter writer;
+    if (!writer.open(partial, format))
+    {
+        std::filesystem::remove(partial, error);
+        closeInput();
+        return false;
+    }
+
+    bool resample = format.sampleRate != inputRate;
+    Resampler resampler(inputRate, format.sampleRate, format.channelCount);
+    buffers.decoded.resize(kChunkFrames * inputChannels);
+    buffers.selected.resize(kChunkFrames * format.channelCount);
+
+    bool ok = true;
+    for (uint64_t first = 0; first < frameCount && ok; first += kChunkFrames)
+    {
+        size_t frames = static_cast<size_t>(std::min(kChunkFrames, frameCount - first));
+        if (reader.isOpen())
+        {
+            uint64_t read = reader.readFrames(first, buffers.decoded.data(), frames);
+            reader.release(first, frames);
+            if (read != frames)
+            {
+                std::cerr << "Failed to read " << job.input << " at frame " << first + read << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        else if (drwav_read_pcm_frames_f32(&wav, frames, buffers.decoded.data()) != frames)
+        {
+            std::cerr << "Failed to decode " << job.input << std::endl;
+            ok = false;
+            break;
+        }
+
+        const float *samples = buffers.decoded.data();
+        if (!settings.channels.empty())
+        {
+            selectChannels(samples, inputChannels, settings.channels.data(), format.channelCount, buffers.selected.data(), frames);
+            samples = buffers.selected.data();
+        }
+
+        if (resample)
+        {
+            buffers.resampled.clear();
+            resampler.process(samples, frames, buffers.resampled);
+            ok = writer.writeFrames(buffers.resampled.data(), buffers.resampled.size() / format.channelCount);
+        }
+        else
+        {
+            ok = writer.writeFrames(samples, frames);
+        }
+    }
+
+    if (ok && resample)
+    {
+        buffers.resampled.clear();
+        resampler.flush(buffers.resampled);
+        ok = writer.writeFrames(buffers.resampled.data(), buffers.resampled.size() / format.channelCount);
+    }
+
+    closeInput();
+    ok = writer.finalize() && ok;
+    if (ok)
+    {
+        std::filesystem::rename(partial, job.output, error);
+        ok = !error;
+    }
+
+    if (!ok)
+    {
+        std::filesystem::remove(partial, error);
+        std::cerr << "Failed to write " << job.output << std::endl;
+        return false;
+    }
+
+    bytesRead += std::filesystem::file_size(job.input, error);
+    return true;
+}
+
+// Inputs with their outputs below the output directory, keeping the layout below input directories
+bool collectJobs(const std::vector<std::string> &paths, const std::filesystem::path &outputDirectory,
+                 std::vector<TranscodeJob> &jobs)
+{
+    for (const std::string &path : paths)
+    {
+        std::error_code error;
+        if (!path.empty() && path[0] == '@')
+        {
+            // Manifest: one input per line, optionally followed by a tab and the output path
+            std::ifstream manifest(path.substr(1));
+            if (!manifest)
+            {
+                std::cerr << "Failed to open manifest: " << path.substr(1) << std::endl;
+                return false;
+            }
+
+            std::string line;
+            while (std::getline(manifest, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.pop_back();
+                }
+
+                if (line.empty())
+                {
+                    continue;
+                }
+
+                size_t tab = line.find('\t');
+                std::string input = line.substr(0, tab);
+                std::filesystem::path output = tab == std::string::npos ? std::filesystem::path(input).filename()
+                                                                        : std::filesystem::path(line.substr(tab + 1));
+                jobs.push_back({input, (outputDirectory / output).string()});
+            }
+        }
+        else if (std::filesystem::is_directory(path, error))
+        {
+            for (const auto &entry : std::filesystem::recursive_directory_iterator(path, error))
+            {
+                if (entry.is_regular_file() && hasExtension(entry.path(), ".wav"))
+                {
+                    std::filesystem::path relative = std::filesystem::relative(entry.path(), path, error);
+                    jobs.push_back({entry.path().string(), (outputDirectory / relative).string()});
+                }
+            }
+        }
+        else
+        {
+            jobs.push_back({path, (outputDirectory / std::filesystem::path(path).filename()).string()});
+        }
+    }
+
+    return true;
+}
+
+bool parseChannels(const std::string &list, std::vector<int> &channels)
+{
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = std::min(list.find(',', start), list.size());
+        std::string item = list.substr(start, end - start);
+        if (item.empty() || !std::all_of(item.begin(), item.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); }))
+        {
+            return false;
+        }
+
+        channels.push_back(std::stoi(item));
+        start = end + 1;
+    }
+
+    return !channels.empty();
+}
+
+void printUsage(const char *program)
+{
+    std::cout << "Usage: " << program << " [options] --output <directory> <file.wav|directory|@manifest> [...]" << std::endl;
+    std::cout << "  --output DIR        Directory for the converted files, mirrors input directories" << std::endl;
+    std::cout << "  --format FORMAT     s16, s24 or f32 (default: s16)" << std::endl;
+    std::cout << "  --container TYPE    riff, rf64 or w64 (default: riff, RF64 past 4 GB)" << std::endl;
+    std::cout << "  --rate HZ           Resample to this rate" << std::endl;
+    std::cout << "  --channels LIST     Keep these input channels in this order, e.g. 1,0 (0-based)" << std::endl;
+    std::cout << "  --threads N         Worker threads (default: one per hardware thread)" << std::endl;
+    std::cout << "A manifest lists one input per line, optionally followed by a tab and the output path" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    TranscodeSettings settings;
+    std::string outputDirectory;
+    unsigned threadCount = 0;
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (argument == "--output" && hasValue)
+        {
+            outputDirectory = argv[++i];
+        }
+        else if (argument == "--format" && hasValue)
+        {
+            std::string value = argv[++i];
+            if (value == "s16")
+            {
+                settings.format = WavSampleFormat::Pcm16;
+            }
+            else if (value == "s24")
+            {
+                settings.format = WavSampleFormat::Pcm24;
+            }
+            else if (value == "f32")
+            {
+                settings.format = WavSampleFormat::Float32;
+            }
+            else
+            {
+                std::cerr << "Unknown format: " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--container" && hasValue)
+        {
+            std::string value = argv[++i];
+            if (value == "riff")
+            {
+                settings.container = WavContainer::Riff;
+            }
+            else if (value == "rf64")
+            {
+                settings.container = WavContainer::Rf64;
+            }
+            else if (value == "w64")
+            {
+                settings.container = WavContainer::W64;
+            }
+            else
+            {
+                std::cerr << "Unknown container: " << value << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--rate" && hasValue)
+        {
+            settings.sampleRate = std::atoi(argv[++i]);
+            if (settings.sampleRate <= 0)
+            {
+                std::cerr << "Invalid rate: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--channels" && hasValue)
+        {
+            if (!parseChannels(argv[++i], settings.channels))
+            {
+                std::cerr << "Invalid channel list: " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--threads" && hasValue)
+        {
+            threadCount = static_cast<unsigned>(std::atoi(argv[++i]));
+        }
+        else if (argument.rfind("--", 0) == 0)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    std::vector<TranscodeJob> jobs;
+    if (outputDirectory.empty() || paths.empty() || !collectJobs(paths, outputDirectory, jobs))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    threadCount = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threadCount, jobs.size())));
+
+    // Workers take the next file until none are left
+    std::atomic<size_t> nextJob{0};
+    std::atomic<uint64_t> totalBytes{0};
+    std::atomic<size_t> failures{0};
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([&] {
+            WorkerBuffers buffers;
+            size_t index = 0;
+            while ((index = nextJob.fetch_add(1)) < jobs.size())
+            {
+                uint64_t bytes = 0;
+                if (transcodeFile(jobs[index], settings, buffers, bytes))
+                {
+                    totalBytes.fetch_add(bytes);
+                }
+                else
+                {
+                    failures.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t converted = jobs.size() - failures.load();
+    double megabytes = totalBytes.load() / 1e6;
+
+    std::cout << std::fixed << std::setprecision(1) << "Converted " << converted << " of " << jobs.size() << " files ("
+              << megabytes << " MB) in " << std::setprecision(2) << seconds << " s with " << threadCount
+              << " threads: " << std::setprecision(1) << converted / std::max(seconds, 1e-9) << " files/s, "
+              << megabytes / std::max(seconds, 1e-9) << " MB/s" << std::endl;
+
+    return failures.load() == 0 ? 0 : 1;
+}